@@ -45,6 +45,7 @@ BEGIN_FECORE_CLASS(FEErosionAdaptor, FEMeshAdaptor)
 	ADD_PARAMETER(m_maxelem, "max_elems");
 	ADD_PARAMETER(m_nsort, "sort");
 	ADD_PARAMETER(m_bremoveIslands, "remove_islands");
+	ADD_PARAMETER(m_bincrementalUpdate, "incremental_update");
 
 	ADD_PROPERTY(m_criterion, "criterion");
 END_FECORE_CLASS();
@@ -54,6 +55,7 @@ FEErosionAdaptor::FEErosionAdaptor(FEModel* fem) : FEMeshAdaptor(fem)
 	m_maxIters = -1;
 	m_criterion = nullptr;
 	m_bremoveIslands = false;
+	m_bincrementalUpdate = true;
 }
 
 bool FEErosionAdaptor::Apply(int iteration)
@@ -140,6 +142,7 @@ bool FEErosionAdaptor::Apply(int iteration)
 	}
 
 	// any facets attached to a eroded element will be eroded as well. 
+	std::vector<FESurface*> modifiedSurfaces;
 	for (int i = 0; i < mesh.Surfaces(); ++i)
 	{
 		int erodedFaces = 0;
@@ -154,7 +157,11 @@ bool FEErosionAdaptor::Apply(int iteration)
 				erodedFaces++;
 			}
 		}
-		if (erodedFaces != 0) surf.Init();
+		if (erodedFaces != 0)
+		{
+			surf.Init();
+			modifiedSurfaces.push_back(&surf);
+		}
 	}
 
 	// remove any linear constraints of exclude nodes
@@ -188,7 +195,10 @@ bool FEErosionAdaptor::Apply(int iteration)
 	}
 
 	// update model
-	UpdateModel();
+	if (m_bincrementalUpdate)
+		UpdateModelIncremental(modifiedSurfaces);
+	else
+		UpdateModel();
 
 	return (nsize != 0);
 }
@@ -42,6 +42,7 @@ private:
 	bool	m_bremoveIslands;	// remove disconnected elements
 	int		m_maxelem;			// the max nr of elements to erode per adaptation iteration
 	int		m_nsort;			// sort option (0 = none, 1 = smallest to largest, 2 = largest to smallest)
+	bool	m_bincrementalUpdate;	// mask eroded equations instead of rebuilding the linear system
 
 	FEMeshAdaptorCriterion*	m_criterion;
 
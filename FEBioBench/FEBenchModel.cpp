@@ -0,0 +1,494 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEBenchModel.h"
+#include <FECore/FECube.h>
+#include <FECore/FEMesh.h>
+#include <FECore/FESolidDomain.h>
+#include <FECore/FESurface.h>
+#include <FECore/FESurfacePairConstraint.h>
+#include <FECore/FEAnalysis.h>
+#include <FECore/FEMaterial.h>
+#include <FECore/FEFixedBC.h>
+#include <FECore/FEPrescribedDOF.h>
+#include <FECore/FELoadCurve.h>
+#include <FECore/FECoreKernel.h>
+#include <FECore/fecore_enum.h>
+#include <FECore/FEPlotDataStore.h>
+#include <FECore/ClassDescriptor.h>
+#include <FEBioLib/FEBox.h>
+
+//-----------------------------------------------------------------------------
+// set a (double) parameter of a model component
+static bool SetParam(FECoreBase* pc, const char* szname, double v)
+{
+	FEParam* p = pc->FindParameter(szname);
+	if (p == nullptr) return false;
+	switch (p->type())
+	{
+	case FE_PARAM_DOUBLE       : p->value<double>() = v; break;
+	case FE_PARAM_DOUBLE_MAPPED: p->value<FEParamDouble>() = v; break;
+	case FE_PARAM_INT          : p->value<int>() = (int) v; break;
+	default:
+		assert(false);
+		return false;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// set a bool parameter of a model component
+static bool SetParam(FECoreBase* pc, const char* szname, bool b)
+{
+	FEParam* p = pc->FindParameter(szname);
+	if ((p == nullptr) || (p->type() != FE_PARAM_BOOL)) return false;
+	p->value<bool>() = b;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+FEBenchModel::FEBenchModel(FEModel* fem) : m_fem(fem)
+{
+}
+
+//-----------------------------------------------------------------------------
+const char* FEBenchModel::ModuleName(FEBenchProblem problem)
+{
+	switch (problem)
+	{
+	case BENCH_ELASTIC : return "solid";
+	case BENCH_BIPHASIC: return "biphasic";
+	case BENCH_CONTACT : return "solid";
+	case BENCH_FLUID   : return "fluid";
+	}
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// The biphasic problem uses the symmetric formulation, so all problems but the
+// fluid can be solved with the skyline solver. The fluid matrix is unsymmetric,
+// so it is solved with FGMRES, right-preconditioned with ILU(0).
+ClassDescriptor* FEBenchModel::DefaultLinearSolver(FEBenchProblem problem)
+{
+	if (problem == BENCH_FLUID)
+	{
+		ClassDescriptor* cd = new ClassDescriptor("native_fgmres");
+		cd->AddVariable(new ClassDescriptor::ClassVariable("pc_right", "native_ilu0"));
+		return cd;
+	}
+	return new ClassDescriptor("skyline");
+}
+
+//-----------------------------------------------------------------------------
+bool FEBenchModel::GetProblem(const char* sz, FEBenchProblem& problem)
+{
+	if      (strcmp(sz, "elastic" ) == 0) problem = BENCH_ELASTIC;
+	else if (strcmp(sz, "biphasic") == 0) problem = BENCH_BIPHASIC;
+	else if (strcmp(sz, "contact" ) == 0) problem = BENCH_CONTACT;
+	else if (strcmp(sz, "fluid"   ) == 0) problem = BENCH_FLUID;
+	else return false;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBenchModel::GetElement(const char* sz, FEBenchElement& elem)
+{
+	if      (strcmp(sz, "hex8") == 0) elem = BENCH_HEX8;
+	else if (strcmp(sz, "tet4") == 0) elem = BENCH_TET4;
+	else return false;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+const char* FEBenchModel::ProblemName(FEBenchProblem problem)
+{
+	switch (problem)
+	{
+	case BENCH_ELASTIC : return "elastic";
+	case BENCH_BIPHASIC: return "biphasic";
+	case BENCH_CONTACT : return "contact";
+	case BENCH_FLUID   : return "fluid";
+	}
+	return "";
+}
+
+//-----------------------------------------------------------------------------
+const char* FEBenchModel::ElementName(FEBenchElement elem)
+{
+	return (elem == BENCH_HEX8 ? "hex8" : "tet4");
+}
+
+//-----------------------------------------------------------------------------
+bool FEBenchModel::Build(FEBenchProblem problem, FEBenchElement elem, int n)
+{
+	if (n < 1) return false;
+
+	switch (problem)
+	{
+	case BENCH_ELASTIC : return BuildElastic (elem, n);
+	case BENCH_BIPHASIC: return BuildBiphasic(elem, n);
+	case BENCH_CONTACT : return BuildContact (elem, n);
+	case BENCH_FLUID   : return BuildFluid   (elem, n);
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+FEAnalysis* FEBenchModel::CreateStep(const char* szsolver)
+{
+	FEModel& fem = *m_fem;
+
+	FEAnalysis* pstep = new FEAnalysis(&fem);
+	pstep->m_ntime = 1;
+	pstep->m_dt0 = 0.1;
+
+	// create the solver
+	// NOTE: This must be done before the mesh is created since
+	// the solver allocates the degrees of freedom.
+	FESolver* psolver = fecore_new<FESolver>(szsolver, &fem);
+	if (psolver == nullptr) { delete pstep; return nullptr; }
+	pstep->SetFESolver(psolver);
+
+	fem.AddStep(pstep);
+	fem.SetCurrentStep(pstep);
+
+	return pstep;
+}
+
+//-----------------------------------------------------------------------------
+// The grid nodes and hexes are created with the FEBoxMesh helpers. Hexes are split
+// into six tets along the 0-6 diagonal, which gives a conforming tet mesh.
+FESolidDomain* FEBenchModel::CreateBlock(int nx, int ny, int nz, const vec3d& r0, const vec3d& r1, FEBenchElement elem, int matID)
+{
+	FEModel& fem = *m_fem;
+	FEMesh& mesh = fem.GetMesh();
+
+	// create the nodes
+	int N0 = FEBoxMesh::AddGridNodes(mesh, nx, ny, nz, r0, r1);
+
+	// create the domain
+	FEMaterial* pmat = fem.GetMaterial(matID);
+	FE_Element_Spec spec = FEElementLibrary::GetElementSpecFromType(elem == BENCH_HEX8 ? FE_HEX8G8 : FE_TET4G4);
+	FECoreKernel& fecore = FECoreKernel::GetInstance();
+	FESolidDomain* dom = dynamic_cast<FESolidDomain*>(fecore.CreateDomain(spec, &mesh, pmat));
+	if (dom == nullptr) return nullptr;
+
+	const int tet[6][4] = { { 0,1,2,6 },{ 0,2,3,6 },{ 0,3,7,6 },{ 0,7,4,6 },{ 0,4,5,6 },{ 0,5,1,6 } };
+	int cells = nx*ny*nz;
+	int elems = (elem == BENCH_HEX8 ? cells : 6 * cells);
+	dom->Create(elems, spec);
+	dom->SetMatID(matID);
+
+	// element IDs continue from the elements that are already in the mesh
+	int nid = mesh.Elements() + 1;
+	int ne = 0;
+	for (int i = 0; i < nx; ++i)
+		for (int j = 0; j < ny; ++j)
+			for (int k = 0; k < nz; ++k)
+			{
+				int hn[8];
+				FEBoxMesh::GridHexNodes(N0, ny, nz, i, j, k, hn);
+
+				if (elem == BENCH_HEX8)
+				{
+					FESolidElement& el = dom->Element(ne++);
+					el.SetID(nid++);
+					for (int l = 0; l < 8; ++l) el.m_node[l] = hn[l];
+				}
+				else
+				{
+					for (int m = 0; m < 6; ++m)
+					{
+						FESolidElement& el = dom->Element(ne++);
+						el.SetID(nid++);
+						for (int l = 0; l < 4; ++l) el.m_node[l] = hn[tet[m][l]];
+					}
+				}
+			}
+
+	mesh.AddDomain(dom);
+	dom->CreateMaterialPointData();
+
+	return dom;
+}
+
+//-----------------------------------------------------------------------------
+FENodeSet* FEBenchModel::NodeSet(FESurface* surf)
+{
+	FENodeSet* nset = new FENodeSet(m_fem);
+	nset->Add(surf->GetNodeList());
+	m_fem->GetMesh().AddNodeSet(nset);
+	return nset;
+}
+
+//-----------------------------------------------------------------------------
+void FEBenchModel::FixNodes(FENodeSet* nset, const char* szdof)
+{
+	int dof = m_fem->GetDOFIndex(szdof);
+	assert(dof >= 0);
+	m_fem->AddBoundaryCondition(new FEFixedBC(m_fem, dof, nset));
+}
+
+//-----------------------------------------------------------------------------
+void FEBenchModel::PrescribeNodes(FENodeSet* nset, const char* szdof, double scale, int lc)
+{
+	int dof = m_fem->GetDOFIndex(szdof);
+	assert(dof >= 0);
+	FEPrescribedDOF* pdc = new FEPrescribedDOF(m_fem, dof, nset);
+	pdc->SetScale(scale, lc);
+	m_fem->AddBoundaryCondition(pdc);
+}
+
+//-----------------------------------------------------------------------------
+int FEBenchModel::AddLoadCurve()
+{
+	FELoadCurve* plc = new FELoadCurve(m_fem);
+	plc->Add(0.0, 0.0);
+	plc->Add(1.0, 1.0);
+	m_fem->AddLoadController(plc);
+	return m_fem->LoadControllers() - 1;
+}
+
+//-----------------------------------------------------------------------------
+void FEBenchModel::AddPlotVariable(const char* szvar)
+{
+	std::vector<int> item;
+	m_fem->GetPlotDataStore().AddPlotVariable(szvar, item);
+}
+
+//-----------------------------------------------------------------------------
+// Cube of neo-Hookean material. The bottom face is fixed and the top face is
+// compressed.
+bool FEBenchModel::BuildElastic(FEBenchElement elem, int n)
+{
+	FEModel& fem = *m_fem;
+	if (CreateStep("solid") == nullptr) return false;
+
+	FEMaterial* pmat = fecore_new<FEMaterial>("neo-Hookean", &fem);
+	SetParam(pmat, "E", 1.0);
+	SetParam(pmat, "v", 0.3);
+	fem.AddMaterial(pmat);
+
+	if (CreateBlock(n, n, n, vec3d(0, 0, 0), vec3d(1, 1, 1), elem, 0) == nullptr) return false;
+
+	FECube cube;
+	if (cube.Build(&fem) == false) return false;
+
+	FENodeSet* bottom = NodeSet(cube.GetSurface(5));
+	FixNodes(bottom, "x");
+	FixNodes(bottom, "y");
+	FixNodes(bottom, "z");
+
+	int lc = AddLoadCurve();
+	FENodeSet* top = NodeSet(cube.GetSurface(4));
+	PrescribeNodes(top, "z", -0.1, lc);
+
+	AddPlotVariable("displacement");
+	AddPlotVariable("stress");
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Confined compression of a biphasic cube. The lateral faces are constrained 
+// in their normal direction. The top face is compressed and free-draining.
+bool FEBenchModel::BuildBiphasic(FEBenchElement elem, int n)
+{
+	FEModel& fem = *m_fem;
+	FEAnalysis* step = CreateStep("biphasic");
+	if (step == nullptr) return false;
+
+	// use the symmetric formulation, which can be solved with the skyline solver
+	step->GetFESolver()->m_msymm = REAL_SYMMETRIC;
+
+	FEMaterial* pmat = fecore_new<FEMaterial>("biphasic", &fem);
+	SetParam(pmat, "phi0", 0.2);
+
+	FEMaterial* solid = fecore_new<FEMaterial>("neo-Hookean", &fem);
+	SetParam(solid, "E", 1.0);
+	SetParam(solid, "v", 0.0);
+	pmat->SetProperty("solid", solid);
+
+	FEMaterial* perm = fecore_new<FEMaterial>("perm-const-iso", &fem);
+	SetParam(perm, "perm", 1e-3);
+	pmat->SetProperty("permeability", perm);
+	fem.AddMaterial(pmat);
+
+	if (CreateBlock(n, n, n, vec3d(0, 0, 0), vec3d(1, 1, 1), elem, 0) == nullptr) return false;
+
+	FECube cube;
+	if (cube.Build(&fem) == false) return false;
+
+	FixNodes(NodeSet(cube.GetSurface(0)), "x");
+	FixNodes(NodeSet(cube.GetSurface(1)), "x");
+	FixNodes(NodeSet(cube.GetSurface(2)), "y");
+	FixNodes(NodeSet(cube.GetSurface(3)), "y");
+	FixNodes(NodeSet(cube.GetSurface(5)), "z");
+
+	FENodeSet* top = NodeSet(cube.GetSurface(4));
+	FixNodes(top, "p");
+
+	int lc = AddLoadCurve();
+	PrescribeNodes(top, "z", -0.1, lc);
+
+	AddPlotVariable("displacement");
+	AddPlotVariable("stress");
+	AddPlotVariable("effective fluid pressure");
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Two neo-Hookean blocks on top of each other. The bottom of the lower block is
+// fixed and the top of the upper block is pushed down.
+bool FEBenchModel::BuildContact(FEBenchElement elem, int n)
+{
+	FEModel& fem = *m_fem;
+	if (CreateStep("solid") == nullptr) return false;
+
+	FEMaterial* pmat = fecore_new<FEMaterial>("neo-Hookean", &fem);
+	SetParam(pmat, "E", 1.0);
+	SetParam(pmat, "v", 0.3);
+	fem.AddMaterial(pmat);
+
+	FEMesh& mesh = fem.GetMesh();
+	int nz = (n > 1 ? n / 2 : 1);
+	FESolidDomain* lower = CreateBlock(n, n, nz, vec3d(0, 0, 0.0), vec3d(1, 1, 0.5), elem, 0);
+	FESolidDomain* upper = CreateBlock(n, n, nz, vec3d(0, 0, 0.5), vec3d(1, 1, 1.0), elem, 0);
+	if ((lower == nullptr) || (upper == nullptr)) return false;
+
+	// split the boundary in the contact surfaces and the loaded faces
+	// (same strategy as FECube, but we also check on which block the face is)
+	FESurfacePairConstraint* pc = fecore_new<FESurfacePairConstraint>("sliding-elastic", &fem);
+	if (pc == nullptr) return false;
+	SetParam(pc, "penalty", 1.0);
+	SetParam(pc, "auto_penalty", true);
+	FESurface* primary = pc->GetPrimarySurface();
+	FESurface* secondary = pc->GetSecondarySurface();
+
+	FESurface* boundary = mesh.ElementBoundarySurface();
+	FENodeSet* bottom = new FENodeSet(&fem);
+	FENodeSet* top = new FENodeSet(&fem);
+	mesh.AddNodeSet(bottom);
+	mesh.AddNodeSet(top);
+	vector<FESurfaceElement*> pf, sf;
+	const double eps = 1e-6;
+	for (int i = 0; i < boundary->Elements(); ++i)
+	{
+		FESurfaceElement& face = boundary->Element(i);
+		vec3d Ni = boundary->SurfaceNormal(face, 0, 0);
+		vec3d c(0, 0, 0);
+		int nf = face.Nodes();
+		for (int j = 0; j < nf; ++j) c += mesh.Node(face.m_node[j]).m_r0;
+		c /= (double) nf;
+
+		if (Ni.z < -0.9999)
+		{
+			if (c.z < eps) { for (int j = 0; j < nf; ++j) bottom->Add(face.m_node[j]); }
+			else if (fabs(c.z - 0.5) < eps) pf.push_back(&face);
+		}
+		else if (Ni.z > 0.9999)
+		{
+			if (c.z > 1.0 - eps) { for (int j = 0; j < nf; ++j) top->Add(face.m_node[j]); }
+			else if (fabs(c.z - 0.5) < eps) sf.push_back(&face);
+		}
+	}
+
+	primary->Create((int)pf.size());
+	for (size_t i = 0; i < pf.size(); ++i) primary->Element((int)i) = *pf[i];
+	secondary->Create((int)sf.size());
+	for (size_t i = 0; i < sf.size(); ++i) secondary->Element((int)i) = *sf[i];
+	primary->CreateMaterialPointData();
+	secondary->CreateMaterialPointData();
+	delete boundary;
+
+	fem.AddSurfacePairConstraint(pc);
+
+	FixNodes(bottom, "x");
+	FixNodes(bottom, "y");
+	FixNodes(bottom, "z");
+
+	FixNodes(top, "x");
+	FixNodes(top, "y");
+	int lc = AddLoadCurve();
+	PrescribeNodes(top, "z", -0.05, lc);
+
+	AddPlotVariable("displacement");
+	AddPlotVariable("stress");
+	AddPlotVariable("contact pressure");
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Flow of a Newtonian fluid through a cube. The inflow velocity is prescribed
+// on the -X face, the lateral faces are no-slip walls and the dilatation is 
+// fixed on the outflow face.
+bool FEBenchModel::BuildFluid(FEBenchElement elem, int n)
+{
+	FEModel& fem = *m_fem;
+	FEAnalysis* step = CreateStep("fluid");
+	if (step == nullptr) return false;
+	step->m_nanalysis = FE_DYNAMIC;
+	step->GetFESolver()->m_msymm = REAL_UNSYMMETRIC;
+
+	FEMaterial* pmat = fecore_new<FEMaterial>("fluid", &fem);
+	SetParam(pmat, "density", 1.0);
+	SetParam(pmat, "k", 1.0);
+
+	FEMaterial* visc = fecore_new<FEMaterial>("Newtonian fluid", &fem);
+	SetParam(visc, "mu", 1.0);
+	SetParam(visc, "kappa", 0.0);
+	pmat->SetProperty("viscous", visc);
+	fem.AddMaterial(pmat);
+
+	if (CreateBlock(n, n, n, vec3d(0, 0, 0), vec3d(1, 1, 1), elem, 0) == nullptr) return false;
+
+	FECube cube;
+	if (cube.Build(&fem) == false) return false;
+
+	for (int i = 2; i < 6; ++i)
+	{
+		FENodeSet* wall = NodeSet(cube.GetSurface(i));
+		FixNodes(wall, "wx");
+		FixNodes(wall, "wy");
+		FixNodes(wall, "wz");
+	}
+
+	FixNodes(NodeSet(cube.GetSurface(0)), "ef");
+
+	int lc = AddLoadCurve();
+	FENodeSet* inlet = NodeSet(cube.GetSurface(1));
+	PrescribeNodes(inlet, "wx", 1.0, lc);
+
+	AddPlotVariable("fluid velocity");
+	AddPlotVariable("fluid pressure");
+
+	return true;
+}
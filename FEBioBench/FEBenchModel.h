@@ -0,0 +1,109 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/FEModel.h>
+#include <string>
+
+class FESolidDomain;
+class FESurface;
+class ClassDescriptor;
+
+//-----------------------------------------------------------------------------
+// Element types that can be used for the benchmark meshes
+enum FEBenchElement
+{
+	BENCH_HEX8,
+	BENCH_TET4
+};
+
+//-----------------------------------------------------------------------------
+// Benchmark problems
+enum FEBenchProblem
+{
+	BENCH_ELASTIC,		// neo-Hookean cube under uniaxial compression
+	BENCH_BIPHASIC,		// confined compression of a biphasic cube
+	BENCH_CONTACT,		// two neo-Hookean blocks pressed together with sliding-elastic contact
+	BENCH_FLUID			// channel flow through a cube of Newtonian fluid
+};
+
+//-----------------------------------------------------------------------------
+//! This class builds the synthetic models that are used by the benchmark suite.
+//! All models are built from structured n x n x n grids of the unit cube (the contact
+//! problem uses two stacked blocks) so that the problem size can be scaled with
+//! a single parameter. The boundary surfaces are identified with FECube.
+class FEBenchModel
+{
+public:
+	FEBenchModel(FEModel* fem);
+
+	//! build the model
+	bool Build(FEBenchProblem problem, FEBenchElement elem, int n);
+
+	//! name of the module that needs to be activated before building the problem
+	static const char* ModuleName(FEBenchProblem problem);
+
+	//! default linear solver for the problem (the caller takes ownership)
+	static ClassDescriptor* DefaultLinearSolver(FEBenchProblem problem);
+
+	//! convert from/to strings
+	static bool GetProblem(const char* sz, FEBenchProblem& problem);
+	static bool GetElement(const char* sz, FEBenchElement& elem);
+	static const char* ProblemName(FEBenchProblem problem);
+	static const char* ElementName(FEBenchElement elem);
+
+private:
+	bool BuildElastic(FEBenchElement elem, int n);
+	bool BuildBiphasic(FEBenchElement elem, int n);
+	bool BuildContact(FEBenchElement elem, int n);
+	bool BuildFluid(FEBenchElement elem, int n);
+
+	// create an analysis step for the solver
+	FEAnalysis* CreateStep(const char* szsolver);
+
+	// create a block of nx x ny x nz cells between r0 and r1. Returns the new domain.
+	FESolidDomain* CreateBlock(int nx, int ny, int nz, const vec3d& r0, const vec3d& r1, FEBenchElement elem, int matID);
+
+	// helper for fixing a dof on all nodes of a surface
+	void FixNodes(FENodeSet* nset, const char* szdof);
+
+	// helper for prescribing a dof on all nodes of a surface
+	void PrescribeNodes(FENodeSet* nset, const char* szdof, double scale, int lc);
+
+	// add a ramp load curve
+	int AddLoadCurve();
+
+	// make a node set from the nodes of a surface
+	FENodeSet* NodeSet(FESurface* surf);
+
+	// add a variable to the plot file
+	void AddPlotVariable(const char* szvar);
+
+private:
+	FEModel*	m_fem;
+};
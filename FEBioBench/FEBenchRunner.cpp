@@ -0,0 +1,293 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEBenchRunner.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEAnalysis.h>
+#include <FECore/FENewtonSolver.h>
+#include <FECore/FEGlobalMatrix.h>
+#include <FECore/FESolidDomain.h>
+#include <FECore/LinearSolver.h>
+#include <FECore/Timer.h>
+#include <FEBioMech/FEElasticMaterial.h>
+#include <FEBioFluid/FEFluidMaterial.h>
+#include <FEBioFluid/FEViscousFluid.h>
+#include <FEBioPlot/FEBioPlotFile.h>
+#include <functional>
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+// Run a phase nrepeat times and collect the timings.
+// The phase function returns the number of items processed (or <0 on failure).
+// The phase is recorded as the failed phase until it completes, which also
+// covers phases that throw.
+static bool TimePhase(const char* szname, int nrepeat, std::function<double()> f, FEBenchResult& res)
+{
+	res.failed = szname;
+
+	FEBenchPhase phase;
+	phase.name = szname;
+	phase.tmin = 0.0;
+	phase.tavg = 0.0;
+	phase.rate = 0.0;
+
+	double items = 0.0;
+	for (int i = 0; i < nrepeat; ++i)
+	{
+		Timer timer;
+		timer.start();
+		items = f();
+		timer.stop();
+		if (items < 0) return false;
+
+		double t = timer.GetTime();
+		phase.tmin = (i == 0 ? t : std::min(phase.tmin, t));
+		phase.tavg += t;
+	}
+	phase.tavg /= nrepeat;
+	if ((items > 0) && (phase.tmin > 0.0)) phase.rate = items / phase.tmin;
+
+	res.phases.push_back(phase);
+	res.failed.clear();
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+FEBenchRunner::FEBenchRunner(FEModel* fem) : m_fem(fem)
+{
+	m_solver = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// This mimics what FEModel::Solve and FEAnalysis::Solve do up to the first
+// Newton iteration of the first time step.
+bool FEBenchRunner::Init()
+{
+	FEModel& fem = *m_fem;
+	if (fem.Init() == false) return false;
+
+	FEAnalysis* step = fem.GetCurrentStep();
+	if (step->Activate() == false) return false;
+	if (step->InitSolver() == false) return false;
+
+	m_solver = dynamic_cast<FENewtonSolver*>(step->GetFESolver());
+	if (m_solver == nullptr) return false;
+
+	FETimeInfo& tp = fem.GetTime();
+	tp.timeIncrement = step->m_dt0;
+	tp.currentTime = step->m_dt0;
+	if (m_solver->InitStep(tp.currentTime) == false) return false;
+
+	// apply the prescribed dofs and update the model state
+	m_solver->PrepStep();
+
+	int neq = m_solver->m_neq;
+	m_R.assign(neq, 0.0);
+	m_b.assign(neq, 0.0);
+	m_u.assign(neq, 0.0);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBenchRunner::Profile()
+{
+	FEGlobalMatrix& K = *m_solver->GetStiffnessMatrix();
+	m_solver->GetLinearSolver()->Destroy();
+	K.Clear();
+	return K.Create(m_fem, m_solver->m_neq, true);
+}
+
+//-----------------------------------------------------------------------------
+bool FEBenchRunner::Symbolic()
+{
+	return m_solver->GetLinearSolver()->PreProcess();
+}
+
+//-----------------------------------------------------------------------------
+bool FEBenchRunner::Stiffness()
+{
+	m_solver->GetStiffnessMatrix()->Zero();
+	zero(m_solver->m_Fd);
+	return m_solver->StiffnessMatrix();
+}
+
+//-----------------------------------------------------------------------------
+bool FEBenchRunner::Residual()
+{
+	return m_solver->Residual(m_R);
+}
+
+//-----------------------------------------------------------------------------
+bool FEBenchRunner::Factor()
+{
+	return m_solver->GetLinearSolver()->Factor();
+}
+
+//-----------------------------------------------------------------------------
+bool FEBenchRunner::BackSolve()
+{
+	return m_solver->GetLinearSolver()->BackSolve(m_u, m_b);
+}
+
+//-----------------------------------------------------------------------------
+int FEBenchRunner::MaterialPoints()
+{
+	FEMesh& mesh = m_fem->GetMesh();
+	int points = 0;
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FESolidDomain* dom = dynamic_cast<FESolidDomain*>(&mesh.Domain(i));
+		if (dom == nullptr) continue;
+		for (int j = 0; j < dom->Elements(); ++j) points += dom->Element(j).GaussPoints();
+	}
+	return points;
+}
+
+//-----------------------------------------------------------------------------
+// Evaluate the stress at all material points. The trace of the stresses is
+// accumulated so that the compiler cannot discard the evaluations.
+double FEBenchRunner::MaterialStress()
+{
+	FEMesh& mesh = m_fem->GetMesh();
+	double sum = 0.0;
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FESolidDomain* dom = dynamic_cast<FESolidDomain*>(&mesh.Domain(i));
+		if (dom == nullptr) continue;
+
+		FEMaterial* pmat = dom->GetMaterial();
+		FEElasticMaterial* solid = pmat->ExtractProperty<FEElasticMaterial>();
+		FEFluidMaterial* fluid = dynamic_cast<FEFluidMaterial*>(pmat);
+		if ((solid == nullptr) && (fluid == nullptr)) continue;
+
+		int NE = dom->Elements();
+#pragma omp parallel for reduction(+:sum)
+		for (int j = 0; j < NE; ++j)
+		{
+			FESolidElement& el = dom->Element(j);
+			for (int n = 0; n < el.GaussPoints(); ++n)
+			{
+				FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+				mat3ds s = (solid ? solid->Stress(mp) : fluid->Stress(mp));
+				sum += s.tr();
+			}
+		}
+	}
+	return sum;
+}
+
+//-----------------------------------------------------------------------------
+double FEBenchRunner::MaterialTangent()
+{
+	FEMesh& mesh = m_fem->GetMesh();
+	double sum = 0.0;
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FESolidDomain* dom = dynamic_cast<FESolidDomain*>(&mesh.Domain(i));
+		if (dom == nullptr) continue;
+
+		FEMaterial* pmat = dom->GetMaterial();
+		FEElasticMaterial* solid = pmat->ExtractProperty<FEElasticMaterial>();
+		FEFluidMaterial* fluid = dynamic_cast<FEFluidMaterial*>(pmat);
+		if ((solid == nullptr) && (fluid == nullptr)) continue;
+
+		int NE = dom->Elements();
+#pragma omp parallel for reduction(+:sum)
+		for (int j = 0; j < NE; ++j)
+		{
+			FESolidElement& el = dom->Element(j);
+			for (int n = 0; n < el.GaussPoints(); ++n)
+			{
+				FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+				tens4ds c = (solid ? solid->Tangent(mp) : fluid->GetViscous()->Tangent_RateOfDeformation(mp));
+				sum += c(0, 0, 0, 0);
+			}
+		}
+	}
+	return sum;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBenchRunner::Run(int nrepeat, const std::string& plotFile, FEBenchResult& res)
+{
+	res.failed.clear();
+	if (m_solver == nullptr) { res.failed = "init"; return false; }
+	if (nrepeat < 1) nrepeat = 1;
+
+	FEMesh& mesh = m_fem->GetMesh();
+	res.nodes = mesh.Nodes();
+	res.elems = mesh.Elements();
+	res.neq = m_solver->m_neq;
+	res.points = MaterialPoints();
+	res.phases.clear();
+
+	double elems = (double) res.elems;
+	double neq = (double) res.neq;
+	double points = (double) res.points;
+
+	// The order matters here: the profile has to be built before the symbolic 
+	// factorization, and the stiffness matrix must be assembled before it is factored.
+	if (!TimePhase("profile", nrepeat, [=]() { return (Profile() ? elems : -1.0); }, res)) return false;
+	if (!TimePhase("symbolic", 1, [=]() { return (Symbolic() ? neq : -1.0); }, res)) return false;
+	res.nnz = (double) m_solver->GetStiffnessMatrix()->NonZeroes();
+
+	if (!TimePhase("stiffness", nrepeat, [=]() { return (Stiffness() ? elems : -1.0); }, res)) return false;
+	if (!TimePhase("residual" , nrepeat, [=]() { return (Residual() ? elems : -1.0); }, res)) return false;
+
+	// Like the first Newton iteration, solve for the residual plus the loads
+	// from the prescribed dofs, which were collected by the stiffness phase.
+	// (Otherwise the right-hand side is zero for problems that are only driven
+	// by prescribed dofs, and iterative solvers return immediately.)
+	for (size_t i = 0; i < m_b.size(); ++i) m_b[i] = m_R[i] + m_solver->m_Fd[i];
+
+	// factor only once, since some solvers cannot refactor an already factored matrix
+	if (!TimePhase("factor"   , 1      , [=]() { return (Factor()    ? neq : -1.0); }, res)) return false;
+	if (!TimePhase("backsolve", nrepeat, [=]() { return (BackSolve() ? neq : -1.0); }, res)) return false;
+
+	volatile double checksum = 0.0;
+	if (!TimePhase("stress" , nrepeat, [&]() { checksum += MaterialStress (); return points; }, res)) return false;
+	if (!TimePhase("tangent", nrepeat, [&]() { checksum += MaterialTangent(); return points; }, res)) return false;
+
+	// plot file output
+	if (plotFile.empty() == false)
+	{
+		// NOTE: the plot variables are defined by FEBenchModel
+		FEBioPlotFile plt(m_fem);
+		if (plt.Open(plotFile.c_str()) == false) { res.failed = "plot"; return false; }
+
+		float time = 0.f;
+		bool bok = TimePhase("plot", nrepeat, [&]() { time += 1.f; return (plt.Write(time) ? elems : -1.0); }, res);
+		plt.Close();
+		remove(plotFile.c_str());
+		if (bok == false) return false;
+	}
+
+	return true;
+}
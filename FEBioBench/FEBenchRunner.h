@@ -0,0 +1,103 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <string>
+#include <vector>
+
+class FEModel;
+class FENewtonSolver;
+
+//-----------------------------------------------------------------------------
+// Timing results of a single benchmark phase (in seconds)
+struct FEBenchPhase
+{
+	std::string	name;
+	double		tmin;	// fastest of all repetitions
+	double		tavg;	// average over all repetitions
+	double		rate;	// items per second (based on tmin), or zero if not applicable
+};
+
+//-----------------------------------------------------------------------------
+// Results of a benchmark run
+struct FEBenchResult
+{
+	int		nodes;
+	int		elems;
+	int		neq;
+	double	nnz;			// nr of nonzeroes in the global stiffness matrix
+	int		points;			// nr of material points
+	std::vector<FEBenchPhase>	phases;
+	std::string	failed;		// name of the phase that failed (empty if all phases succeeded)
+};
+
+//-----------------------------------------------------------------------------
+//! This class times the isolated phases of a nonlinear solve on an FE model that
+//! was built (but not yet initialized) by FEBenchModel. The phases are:
+//!
+//!   profile  : building the sparse matrix profile (FEGlobalMatrix::Create)
+//!   symbolic : preprocessing of the linear solver
+//!   stiffness: assembly of the global stiffness matrix
+//!   residual : evaluation of the global residual
+//!   factor   : numerical factorization
+//!   backsolve: back substitution
+//!   stress   : evaluation of the material stress at all material points
+//!   tangent  : evaluation of the material tangent at all material points
+//!   plot     : writing a state to the plot file
+class FEBenchRunner
+{
+public:
+	FEBenchRunner(FEModel* fem);
+
+	// initialize the model and prepare the first time step
+	bool Init();
+
+	// run all phases. Each phase is repeated nrepeat times.
+	bool Run(int nrepeat, const std::string& plotFile, FEBenchResult& res);
+
+private:
+	// phases that are timed
+	bool Profile();
+	bool Symbolic();
+	bool Stiffness();
+	bool Residual();
+	bool Factor();
+	bool BackSolve();
+	double MaterialStress();
+	double MaterialTangent();
+
+	int MaterialPoints();
+
+private:
+	FEModel*		m_fem;
+	FENewtonSolver*	m_solver;
+
+	std::vector<double>	m_R;	// residual
+	std::vector<double>	m_b;	// right-hand side of the first Newton iteration (residual + prescribed dof contributions)
+	std::vector<double>	m_u;	// solution
+};
@@ -0,0 +1,305 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEBenchModel.h"
+#include "FEBenchRunner.h"
+#include <FEBioLib/febio.h>
+#include <FEBioLib/version.h>
+#include <FEBioMech/FEMechModel.h>
+#include <FECore/FECoreKernel.h>
+#include <FECore/ClassDescriptor.h>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// benchmark options
+struct BenchOptions
+{
+	std::vector<FEBenchProblem>	problems;
+	std::vector<FEBenchElement>	elems;
+	std::vector<int>			sizes;
+	std::vector<int>			threads;
+	int							nrepeat;
+	std::string					solver;
+	std::string					outFile;
+	std::string					plotFile;
+};
+
+//-----------------------------------------------------------------------------
+// results of a single run
+struct BenchRun
+{
+	FEBenchProblem	problem;
+	FEBenchElement	elem;
+	int				size;
+	int				threads;
+	std::string		solver;
+	bool			ok;
+	FEBenchResult	res;
+};
+
+//-----------------------------------------------------------------------------
+static void print_usage()
+{
+	fprintf(stderr, "usage: febiobench [options]\n");
+	fprintf(stderr, "  -m <list>    problems: elastic,biphasic,contact,fluid (default: all)\n");
+	fprintf(stderr, "  -e <list>    element types: hex8,tet4 (default: hex8)\n");
+	fprintf(stderr, "  -n <list>    nr of element divisions per side (default: 10)\n");
+	fprintf(stderr, "  -t <list>    nr of threads (default: 1)\n");
+	fprintf(stderr, "  -r <n>       nr of repetitions per phase (default: 3)\n");
+	fprintf(stderr, "  -s <solver>  linear solver for all problems (default: skyline, and fgmres for fluid)\n");
+	fprintf(stderr, "  -o <file>    JSON output file (default: stdout)\n");
+	fprintf(stderr, "  -p <file>    temporary plot file (default: febiobench.xplt)\n");
+}
+
+//-----------------------------------------------------------------------------
+// split a comma separated list
+static std::vector<std::string> split(const char* sz)
+{
+	std::vector<std::string> items;
+	std::string s(sz);
+	size_t n0 = 0;
+	while (n0 <= s.size())
+	{
+		size_t n1 = s.find(',', n0);
+		if (n1 == std::string::npos) n1 = s.size();
+		if (n1 > n0) items.push_back(s.substr(n0, n1 - n0));
+		n0 = n1 + 1;
+	}
+	return items;
+}
+
+//-----------------------------------------------------------------------------
+static bool split_int(const char* sz, std::vector<int>& v)
+{
+	v.clear();
+	std::vector<std::string> items = split(sz);
+	for (size_t i = 0; i < items.size(); ++i)
+	{
+		int n = atoi(items[i].c_str());
+		if (n <= 0) return false;
+		v.push_back(n);
+	}
+	return (v.empty() == false);
+}
+
+//-----------------------------------------------------------------------------
+static bool parse_options(int argc, char* argv[], BenchOptions& ops)
+{
+	ops.nrepeat = 3;
+	ops.plotFile = "febiobench.xplt";
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* sz = argv[i];
+		if ((sz[0] != '-') || (i + 1 >= argc)) return false;
+		const char* szval = argv[++i];
+
+		if (strcmp(sz, "-m") == 0)
+		{
+			std::vector<std::string> items = split(szval);
+			for (size_t j = 0; j < items.size(); ++j)
+			{
+				FEBenchProblem problem;
+				if (FEBenchModel::GetProblem(items[j].c_str(), problem) == false) return false;
+				ops.problems.push_back(problem);
+			}
+		}
+		else if (strcmp(sz, "-e") == 0)
+		{
+			std::vector<std::string> items = split(szval);
+			for (size_t j = 0; j < items.size(); ++j)
+			{
+				FEBenchElement elem;
+				if (FEBenchModel::GetElement(items[j].c_str(), elem) == false) return false;
+				ops.elems.push_back(elem);
+			}
+		}
+		else if (strcmp(sz, "-n") == 0) { if (split_int(szval, ops.sizes  ) == false) return false; }
+		else if (strcmp(sz, "-t") == 0) { if (split_int(szval, ops.threads) == false) return false; }
+		else if (strcmp(sz, "-r") == 0) ops.nrepeat = atoi(szval);
+		else if (strcmp(sz, "-s") == 0) ops.solver = szval;
+		else if (strcmp(sz, "-o") == 0) ops.outFile = szval;
+		else if (strcmp(sz, "-p") == 0) ops.plotFile = szval;
+		else return false;
+	}
+
+	if (ops.problems.empty())
+	{
+		ops.problems.push_back(BENCH_ELASTIC);
+		ops.problems.push_back(BENCH_BIPHASIC);
+		ops.problems.push_back(BENCH_CONTACT);
+		ops.problems.push_back(BENCH_FLUID);
+	}
+	if (ops.elems.empty()) ops.elems.push_back(BENCH_HEX8);
+	if (ops.sizes.empty()) ops.sizes.push_back(10);
+	if (ops.threads.empty()) ops.threads.push_back(1);
+	if (ops.nrepeat < 1) ops.nrepeat = 1;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// build and time a single model
+static bool run_benchmark(BenchRun& run, const BenchOptions& ops)
+{
+	FECoreKernel& fecore = FECoreKernel::GetInstance();
+	fecore.SetActiveModule(FEBenchModel::ModuleName(run.problem));
+
+	// Unless a solver was requested, pick one that supports the problem's matrix type.
+	ClassDescriptor* solver = (ops.solver.empty() ? FEBenchModel::DefaultLinearSolver(run.problem) : new ClassDescriptor(ops.solver));
+	run.solver = solver->ClassType();
+	fecore.SetDefaultSolver(solver);
+
+	febio::SetOMPThreads(run.threads);
+
+	FEMechModel fem;
+	fem.BlockLog();
+
+	// the failed phase is overwritten by the runner once the model is initialized
+	run.res.failed = "build";
+	try
+	{
+		FEBenchModel bench(&fem);
+		if (bench.Build(run.problem, run.elem, run.size) == false) return false;
+
+		run.res.failed = "init";
+		FEBenchRunner runner(&fem);
+		if (runner.Init() == false) return false;
+
+		return runner.Run(ops.nrepeat, ops.plotFile, run.res);
+	}
+	catch (...)
+	{
+		return false;
+	}
+}
+
+//-----------------------------------------------------------------------------
+static void write_json(FILE* fp, const std::vector<BenchRun>& runs, const BenchOptions& ops)
+{
+	fprintf(fp, "{\n");
+	fprintf(fp, "  \"version\": \"%d.%d.%d\",\n", VERSION, SUBVERSION, SUBSUBVERSION);
+	fprintf(fp, "  \"repeat\": %d,\n", ops.nrepeat);
+	fprintf(fp, "  \"runs\": [");
+	for (size_t i = 0; i < runs.size(); ++i)
+	{
+		const BenchRun& run = runs[i];
+		const FEBenchResult& res = run.res;
+		fprintf(fp, "%s\n    {\n", (i == 0 ? "" : ","));
+		fprintf(fp, "      \"problem\": \"%s\",\n", FEBenchModel::ProblemName(run.problem));
+		fprintf(fp, "      \"element\": \"%s\",\n", FEBenchModel::ElementName(run.elem));
+		fprintf(fp, "      \"size\": %d,\n", run.size);
+		fprintf(fp, "      \"threads\": %d,\n", run.threads);
+		fprintf(fp, "      \"solver\": \"%s\",\n", run.solver.c_str());
+		fprintf(fp, "      \"status\": \"%s\"", (run.ok ? "ok" : "failed"));
+		if (run.ok == false)
+		{
+			fprintf(fp, ",\n");
+			fprintf(fp, "      \"failed_phase\": \"%s\"", res.failed.c_str());
+		}
+		else
+		{
+			fprintf(fp, ",\n");
+			fprintf(fp, "      \"nodes\": %d,\n", res.nodes);
+			fprintf(fp, "      \"elements\": %d,\n", res.elems);
+			fprintf(fp, "      \"equations\": %d,\n", res.neq);
+			fprintf(fp, "      \"nonzeroes\": %.0f,\n", res.nnz);
+			fprintf(fp, "      \"material_points\": %d,\n", res.points);
+			fprintf(fp, "      \"phases\": {");
+			for (size_t j = 0; j < res.phases.size(); ++j)
+			{
+				const FEBenchPhase& p = res.phases[j];
+				fprintf(fp, "%s\n        \"%s\": { \"min\": %.6e, \"avg\": %.6e, \"rate\": %.6e }", (j == 0 ? "" : ","), p.name.c_str(), p.tmin, p.tavg, p.rate);
+			}
+			fprintf(fp, "\n      }");
+		}
+		fprintf(fp, "\n    }");
+	}
+	fprintf(fp, "\n  ]\n}\n");
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+	BenchOptions ops;
+	if (parse_options(argc, argv, ops) == false)
+	{
+		print_usage();
+		return 1;
+	}
+
+	febio::InitLibrary();
+
+	FECoreKernel& fecore = FECoreKernel::GetInstance();
+	if ((ops.solver.empty() == false) && (fecore.SetDefaultSolverType(ops.solver.c_str()) == nullptr))
+	{
+		fprintf(stderr, "Unknown linear solver: %s\n", ops.solver.c_str());
+		return 1;
+	}
+
+	std::vector<BenchRun> runs;
+	int nfail = 0;
+	for (size_t i = 0; i < ops.problems.size(); ++i)
+		for (size_t j = 0; j < ops.elems.size(); ++j)
+			for (size_t k = 0; k < ops.sizes.size(); ++k)
+				for (size_t l = 0; l < ops.threads.size(); ++l)
+				{
+					BenchRun run;
+					run.problem = ops.problems[i];
+					run.elem = ops.elems[j];
+					run.size = ops.sizes[k];
+					run.threads = ops.threads[l];
+
+					fprintf(stderr, "running %s (%s, n = %d, threads = %d) ... ", FEBenchModel::ProblemName(run.problem), FEBenchModel::ElementName(run.elem), run.size, run.threads);
+					run.ok = run_benchmark(run, ops);
+					if (run.ok) fprintf(stderr, "done\n");
+					else fprintf(stderr, "FAILED (%s)\n", run.res.failed.c_str());
+					if (run.ok == false) nfail++;
+
+					runs.push_back(run);
+				}
+
+	FILE* fp = stdout;
+	if (ops.outFile.empty() == false)
+	{
+		fp = fopen(ops.outFile.c_str(), "wt");
+		if (fp == nullptr)
+		{
+			fprintf(stderr, "Failed to open %s\n", ops.outFile.c_str());
+			return 1;
+		}
+	}
+	write_json(fp, runs, ops);
+	if (fp != stdout) fclose(fp);
+
+	febio::FinishLibrary();
+
+	return (nfail == 0 ? 0 : 1);
+}
@@ -0,0 +1,55 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include <FECore/DataRecord.h>
+#include <stdio.h>
+
+//-----------------------------------------------------------------------------
+// Converts a binary data file (written by a node_data or element_data record
+// with binary="on") to the text format of the regular data files.
+//
+// usage: febiodata input.bin [output.txt]
+//
+// When no output file is given, the text is written to the standard output.
+int main(int argc, char* argv[])
+{
+	if ((argc < 2) || (argc > 3))
+	{
+		fprintf(stderr, "usage: febiodata input [output]\n");
+		return 1;
+	}
+
+	const char* szout = (argc == 3 ? argv[2] : nullptr);
+	if (DataRecord::BinaryToText(argv[1], szout) == false)
+	{
+		fprintf(stderr, "ERROR: Failed converting data file %s\n", argv[1]);
+		return 1;
+	}
+
+	return 0;
+}
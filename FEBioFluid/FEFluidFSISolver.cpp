@@ -108,6 +108,9 @@ m_dofU(pfem), m_dofV(pfem), m_dofSU(pfem), m_dofSV(pfem), m_dofSA(pfem),m_dofR(p
     m_gamma = 1;
     m_pred = 0;
     m_order = 2;
+
+	// the residual is reduced before it is read (see FE_ASSEMBLE_REDUCE)
+	m_breduceAssembly = true;
     
 	// Preferred strategy is Broyden's method
 	SetDefaultStrategy(QN_BROYDEN);
@@ -1487,6 +1490,9 @@ bool FEFluidFSISolver::Residual(vector<double>& R)
         }
     }
     
+    // add the recorded contributions before the reaction forces are read
+    RHS.Reduce();
+
     // set the nodal reaction forces
     // TODO: Is this a good place to do this?
     for (int i=0; i<mesh.Nodes(); ++i)
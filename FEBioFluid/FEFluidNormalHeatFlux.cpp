@@ -66,7 +66,7 @@ void FEFluidNormalHeatFlux::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
     FESurface& surf = GetSurface();
 
     // evaluate the integral
-    surf.LoadVector(R, m_dof, false, [&](FESurfaceMaterialPoint& pt, const FESurfaceDofShape& dof_a, std::vector<double>& val) {
+    surf.LoadVector<1>(R, m_dof, false, [&](FESurfaceMaterialPoint& pt, const FESurfaceDofShape& dof_a, double* val) {
         
         // evaluate pressure at this material point
         double q = m_flux(pt);
@@ -67,7 +67,7 @@ bool FEFluidNormalTraction::Init()
 void FEFluidNormalTraction::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
 	// evaluate integral over surface
-	m_psurf->LoadVector(R, m_dofW, false, [&](FESurfaceMaterialPoint& mp, const FESurfaceDofShape &dof_a, vector<double>& fa) {
+	m_psurf->LoadVector<3>(R, m_dofW, false, [&](FESurfaceMaterialPoint& mp, const FESurfaceDofShape &dof_a, double* fa) {
 
 		FESurfaceElement& el = *mp.SurfaceElement();
 
@@ -48,6 +48,7 @@ void FEFluidResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<d
 {
     
     vector<double>& R = m_R;
+    FEAssemblyBuffer::Log* log = ThreadLog();
     
     int i, I;
     
@@ -63,14 +64,12 @@ void FEFluidResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<d
             I = elm[i];
             
             if ( I >= 0){
-#pragma omp atomic
-                R[I] += fe[i];
+                AddTo(log, R[I], fe[i]);
             }
             // TODO: Find another way to store reaction forces
             
             else if (-I-2 >= 0){
-#pragma omp atomic
-                m_Fr[-I-2] -= fe[i];
+                AddTo(log, m_Fr[-I-2], -fe[i]);
             }
         }
         
@@ -83,7 +82,7 @@ void FEFluidResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<d
 		FELinearConstraintManager& LCM = m_fem.GetLinearConstraintManager();
 		if (LCM.LinearConstraints())
 		{
-			LCM.AssembleResidual(R, en, elm, fe);
+			LCM.AssembleResidual(*this, en, elm, fe);
         }
     }
 }
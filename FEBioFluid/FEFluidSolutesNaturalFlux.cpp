@@ -144,7 +144,7 @@ void FEFluidSolutesNaturalFlux::Serialize(DumpStream& ar)
 //-----------------------------------------------------------------------------
 void FEFluidSolutesNaturalFlux::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
-    m_psurf->LoadStiffness(LS, m_dof, m_dof, [=](FESurfaceMaterialPoint& mp, const FESurfaceDofShape& dof_a, const FESurfaceDofShape& dof_b, matrix& Kab) {
+    m_psurf->LoadStiffness<4, 4>(LS, m_dof, m_dof, [=](FESurfaceMaterialPoint& mp, const FESurfaceDofShape& dof_a, const FESurfaceDofShape& dof_b, fixed_matrix<4, 4>& Kab) {
         
         FESurfaceElement& el = *mp.SurfaceElement();
         int iel = el.m_lid;
@@ -172,7 +172,7 @@ void FEFluidSolutesNaturalFlux::StiffnessMatrix(FELinearSystem& LS, const FETime
         
         double alpha = tp.alphaf;
         
-        vector<vec3d> gradN(neln);
+        vec3d gradN[FEElement::MAX_NODES];
         
         // Fluid velocity
         vec3d v = FluidVelocity(mp, tp.alphaf);
@@ -294,7 +294,7 @@ vec3d FEFluidSolutesNaturalFlux::FluidVelocityElm(FESurfaceMaterialPoint& pt)
 //-----------------------------------------------------------------------------
 void FEFluidSolutesNaturalFlux::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
-    m_psurf->LoadVector(R, m_dofC, false, [=](FESurfaceMaterialPoint& mp, const FESurfaceDofShape& dof_a, vector<double>& fa) {
+    m_psurf->LoadVector<1>(R, m_dofC, false, [=](FESurfaceMaterialPoint& mp, const FESurfaceDofShape& dof_a, double* fa) {
         
         FESurfaceElement& el = *mp.SurfaceElement();
         
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEFluidSolver.h"
+#include <FECore/FETaskList.h>
 #include "FEFluidDomain.h"
 #include "FEFluidResidualVector.h"
 #include "FECore/FEModel.h"
@@ -86,6 +87,9 @@ FEFluidSolver::FEFluidSolver(FEModel* pfem) : FENewtonSolver(pfem), m_dofW(pfem)
 
     m_rhoi = 0;
     m_pred = 0;
+
+	// the residual is reduced before it is read (see FE_ASSEMBLE_REDUCE)
+	m_breduceAssembly = true;
     
 	// Preferred strategy is Broyden's method
 	SetDefaultStrategy(QN_BROYDEN);
@@ -779,11 +783,15 @@ bool FEFluidSolver::StiffnessMatrix(FELinearSystem& LS)
     // get the mesh
     FEMesh& mesh = fem.GetMesh();
     
+    // the domain, load and contact contributions are independent of each other.
+    // The light ones run concurrently, so every Assemble path they use must be atomic.
+    FETaskList tasks(TaskAssembly());
+
     // calculate the stiffness matrix for each domain
     for (int i=0; i<mesh.Domains(); ++i)
     {
         FEFluidDomain& dom = dynamic_cast<FEFluidDomain&>(mesh.Domain(i));
-        dom.StiffnessMatrix(LS, tp);
+        tasks.AddTask([&]() { dom.StiffnessMatrix(LS, tp); }, FETaskCost(mesh.Domain(i)));
     }
     
     // calculate the body force stiffness matrix for each domain
@@ -796,20 +804,20 @@ bool FEFluidSolver::StiffnessMatrix(FELinearSystem& LS)
 			for (int i = 0; i<pbf->Domains(); ++i)
 			{
 				FEFluidDomain& dom = dynamic_cast<FEFluidDomain&>(*pbf->Domain(i));
-				dom.BodyForceStiffness(LS, tp, *pbf);
+				tasks.AddTask([&, pbf]() { dom.BodyForceStiffness(LS, tp, *pbf); }, FETaskCost(*pbf->Domain(i)));
 			}
         }
     }
     
     // calculate contact stiffness
-    ContactStiffness(LS);
+    ContactStiffness(LS, tasks);
     
     // calculate stiffness matrix due to surface loads
     int nsl = fem.SurfaceLoads();
     for (int i=0; i<nsl; ++i)
     {
         FESurfaceLoad* psl = fem.SurfaceLoad(i);
-        if (psl->IsActive() && HasActiveDofs(psl->GetDofList())) psl->StiffnessMatrix(LS, tp);
+        if (psl->IsActive() && HasActiveDofs(psl->GetDofList())) tasks.AddTask([=, &LS, &tp]() { psl->StiffnessMatrix(LS, tp); }, FETaskCost(*psl));
     }
     
     // Add mass matrix
@@ -817,8 +825,9 @@ bool FEFluidSolver::StiffnessMatrix(FELinearSystem& LS)
     for (int i=0; i<mesh.Domains(); ++i)
     {
         FEFluidDomain& dom = dynamic_cast<FEFluidDomain&>(mesh.Domain(i));
-        dom.MassMatrix(LS, tp);
+        tasks.AddTask([&]() { dom.MassMatrix(LS, tp); }, FETaskCost(mesh.Domain(i)));
     }
+    tasks.Run();
     
     // calculate nonlinear constraint stiffness
     // note that this is the contribution of the
@@ -846,6 +855,15 @@ void FEFluidSolver::NonLinearConstraintStiffness(FELinearSystem& LS, const FETim
 //! This function calculates the contact stiffness matrix
 
 void FEFluidSolver::ContactStiffness(FELinearSystem& LS)
+{
+    FETaskList tasks;
+    ContactStiffness(LS, tasks);
+    tasks.Run();
+}
+
+//-----------------------------------------------------------------------------
+//! Adds the contact stiffness contributions to a task list
+void FEFluidSolver::ContactStiffness(FELinearSystem& LS, FETaskList& tasks)
 {
 	FEModel& fem = *GetFEModel();
 
@@ -853,13 +871,22 @@ void FEFluidSolver::ContactStiffness(FELinearSystem& LS)
     for (int i = 0; i<fem.SurfacePairConstraints(); ++i)
     {
         FEContactInterface* pci = dynamic_cast<FEContactInterface*>(fem.SurfacePairConstraint(i));
-        if (pci->IsActive()) pci->StiffnessMatrix(LS, tp);
+        if (pci->IsActive()) tasks.AddTask([=, &LS]() { pci->StiffnessMatrix(LS, tp); }, FETaskCost(*pci));
     }
 }
 
 //-----------------------------------------------------------------------------
 //! Calculates the contact forces
 void FEFluidSolver::ContactForces(FEGlobalVector& R)
+{
+    FETaskList tasks;
+    ContactForces(R, tasks);
+    tasks.Run();
+}
+
+//-----------------------------------------------------------------------------
+//! Adds the contact force contributions to a task list
+void FEFluidSolver::ContactForces(FEGlobalVector& R, FETaskList& tasks)
 {
 	FEModel& fem = *GetFEModel();
 
@@ -867,7 +894,7 @@ void FEFluidSolver::ContactForces(FEGlobalVector& R)
     for (int i = 0; i<fem.SurfacePairConstraints(); ++i)
     {
         FEContactInterface* pci = dynamic_cast<FEContactInterface*>(fem.SurfacePairConstraint(i));
-        if (pci->IsActive()) pci->LoadVector(R, tp);
+        if (pci->IsActive()) tasks.AddTask([=, &R]() { pci->LoadVector(R, tp); }, FETaskCost(*pci));
     }
 }
 
@@ -896,11 +923,15 @@ bool FEFluidSolver::Residual(vector<double>& R)
     // get the mesh
     FEMesh& mesh = fem.GetMesh();
     
+    // the domain, load and contact contributions are independent of each other
+    // (the light ones run concurrently and rely on FEGlobalVector's atomic assembly)
+    FETaskList tasks(TaskAssembly());
+
     // calculate the internal (stress) forces
     for (int i=0; i<mesh.Domains(); ++i)
     {
         FEFluidDomain& dom = dynamic_cast<FEFluidDomain&>(mesh.Domain(i));
-        dom.InternalForces(RHS, tp);
+        tasks.AddTask([&]() { dom.InternalForces(RHS, tp); }, FETaskCost(mesh.Domain(i)));
     }
     
     // calculate the body forces
@@ -912,7 +943,7 @@ bool FEFluidSolver::Residual(vector<double>& R)
 			for (int i = 0; i<pbf->Domains(); ++i)
 			{
 				FEFluidDomain& dom = dynamic_cast<FEFluidDomain&>(*pbf->Domain(i));
-				dom.BodyForce(RHS, tp, *pbf);
+				tasks.AddTask([&, pbf]() { dom.BodyForce(RHS, tp, *pbf); }, FETaskCost(*pbf->Domain(i)));
 			}
         }
     }
@@ -921,7 +952,7 @@ bool FEFluidSolver::Residual(vector<double>& R)
     for (int i=0; i<mesh.Domains(); ++i)
     {
         FEFluidDomain& dom = dynamic_cast<FEFluidDomain&>(mesh.Domain(i));
-        dom.InertialForces(RHS, tp);
+        tasks.AddTask([&]() { dom.InertialForces(RHS, tp); }, FETaskCost(mesh.Domain(i)));
     }
 
     // calculate forces due to surface loads
@@ -929,11 +960,12 @@ bool FEFluidSolver::Residual(vector<double>& R)
     for (int i=0; i<nsl; ++i)
     {
         FESurfaceLoad* psl = fem.SurfaceLoad(i);
-        if (psl->IsActive() && HasActiveDofs(psl->GetDofList())) psl->LoadVector(RHS, tp);
+        if (psl->IsActive() && HasActiveDofs(psl->GetDofList())) tasks.AddTask([=, &RHS, &tp]() { psl->LoadVector(RHS, tp); }, FETaskCost(*psl));
     }
     
     // calculate contact forces
-    ContactForces(RHS);
+    ContactForces(RHS, tasks);
+    tasks.Run();
     
     // calculate nonlinear constraint forces
     // note that these are the linear constraints
@@ -951,6 +983,9 @@ bool FEFluidSolver::Residual(vector<double>& R)
         }
     }
     
+    // add the recorded contributions before the reaction forces are read
+    RHS.Reduce();
+
     // set the nodal reaction forces
     // TODO: Is this a good place to do this?
     for (int i=0; i<mesh.Nodes(); ++i)
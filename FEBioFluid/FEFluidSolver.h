@@ -36,6 +36,7 @@ SOFTWARE.*/
 
 //-----------------------------------------------------------------------------
 class FELinearSystem;
+class FETaskList;
 
 //-----------------------------------------------------------------------------
 //! The FEFluidSolver class solves fluid mechanics problems
@@ -87,6 +88,7 @@ public:
     
     //! contact stiffness
     void ContactStiffness(FELinearSystem& LS);
+    void ContactStiffness(FELinearSystem& LS, FETaskList& tasks);
     
     //! calculates stiffness contributon of nonlinear constraints
     void NonLinearConstraintStiffness(FELinearSystem& LS, const FETimeInfo& tp);
@@ -95,6 +97,7 @@ public:
     
     //! Calculate the contact forces
     void ContactForces(FEGlobalVector& R);
+    void ContactForces(FEGlobalVector& R, FETaskList& tasks);
     
     //! Calculates residual
     bool Residual(vector<double>& R) override;
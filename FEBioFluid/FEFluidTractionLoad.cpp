@@ -67,7 +67,7 @@ bool FEFluidTractionLoad::Init()
 //! Calculate the residual for the traction load
 void FEFluidTractionLoad::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
-	m_psurf->LoadVector(R, m_dof, true, [&](FESurfaceMaterialPoint& mp, const FESurfaceDofShape& dof_a, vector<double>& fa) {
+	m_psurf->LoadVector<3>(R, m_dof, true, [&](FESurfaceMaterialPoint& mp, const FESurfaceDofShape& dof_a, double* fa) {
 
 		// fluid traction
 		vec3d t = m_TC(mp)*m_scale;
@@ -50,6 +50,7 @@ SOFTWARE.*/
 #include "FECore/log.h"
 #include "FECore/FECoreKernel.h"
 #include "FECore/DumpFile.h"
+#include "FECore/AsyncDumpFile.h"
 #include "FECore/DOFS.h"
 #include <FECore/FEAnalysis.h>
 #include <NumCore/MatrixTools.h>
@@ -111,6 +112,7 @@ FEBioModel::FEBioModel()
 	m_ndebug = 0;
 	m_becho = true;
 	m_plot = nullptr;
+	m_dump = nullptr;
 	m_writeMesh = false;
 
 	m_ntimeSteps = 0;
@@ -132,6 +134,9 @@ FEBioModel::~FEBioModel()
 {
 	// close the plot file
 	if (m_plot) { delete m_plot; m_plot = 0; }
+
+	// finish writing the restart archive
+	if (m_dump) { delete m_dump; m_dump = nullptr; }
 	m_log.close();
 }
 
@@ -595,16 +600,22 @@ void FEBioModel::DumpData(int nevent)
 	if ((nevent == CB_MAJOR_ITERS) && (ndump == FE_DUMP_MAJOR_ITRS)) bdump = true;
 	if (bdump)
 	{
-		DumpFile ar(*this);
-		if (ar.Create(m_sdump.c_str()) == false)
-		{
-			feLogWarning("Failed creating restart file (%s).\n", m_sdump.c_str());
-		}
-		else
+		// The archive is written in the background. We only have to wait
+		// when the previous archive is still being written.
+		if (m_dump == nullptr) m_dump = new AsyncDumpFile(*this);
+		if (m_dump->Wait() == false)
 		{
-			Serialize(ar);
-			feLogInfo("\nRestart point created. Archive name is %s.", m_sdump.c_str());
+			feLogWarning("Failed creating restart file (%s).\n", m_dump->FileName().c_str());
 		}
+
+		m_dump->Write(m_sdump.c_str());
+		feLogInfo("\nRestart point created. Archive name is %s.", m_sdump.c_str());
+	}
+
+	// make sure the last archive is complete when the model is done
+	if ((nevent == CB_SOLVED) && m_dump && (m_dump->Wait() == false))
+	{
+		feLogWarning("Failed creating restart file (%s).\n", m_dump->FileName().c_str());
 	}
 }
 
@@ -35,6 +35,8 @@ SOFTWARE.*/
 #include "febiolib_api.h"
 #include <FEBioLib/Logfile.h>
 
+class AsyncDumpFile;
+
 //-----------------------------------------------------------------------------
 // Dump level determines the times the restart file is written
 enum FE_Dump_Level {
@@ -186,6 +188,7 @@ private:
 	Timer		m_IOTimer;		//!< timer to track output (include plot, dump, and data)
 
 	PlotFile*	m_plot;			//!< the plot file
+	AsyncDumpFile*	m_dump;		//!< writes the restart archives
 	bool		m_becho;		//!< echo input to logfile
 	int			m_ndebug;		//!< debug level flag
 	bool		m_writeMesh;	//!< write a new mesh section
@@ -47,39 +47,62 @@ FEBoxMesh::~FEBoxMesh()
 
 void FEBoxMesh::Create(int nx, int ny, int nz, vec3d r0, vec3d r1, FE_Element_Type nhex)
 {
-	int i, j, k, n;
-
 	// make sure the parameters make sense
 	assert((nx > 0) && (ny > 0) && (nz > 0));
 
-	// count items
-	int nodes = (nx+1)*(ny+1)*(nz+1);
+	// create the nodes
+	assert(Nodes() == 0);
+	AddGridNodes(*this, nx, ny, nz, r0, r1);
+
+	// create the elements
+	FEModel* fem = GetFEModel();
 	int elems = nx*ny*nz;
+	FEElasticSolidDomain* pbd = new FEElasticSolidDomain(fem);
+	pbd->Create(elems, FEElementLibrary::GetElementSpecFromType(nhex));
+	pbd->SetMatID(-1);
+	AddDomain(pbd);
+	int n = 0;
+	for (int i=0; i<nx; ++i)
+	{
+		for (int j=0; j<ny; ++j)
+		{
+			for (int k=0; k<nz; ++k, ++n)
+			{
+				FESolidElement& el = pbd->Element(n);
+				el.SetID(n+1);
+				GridHexNodes(0, ny, nz, i, j, k, &el.m_node[0]);
+			}
+		}
+	}
+}
 
-	// allocate data
-	FEMesh::CreateNodes(nodes);
+//-----------------------------------------------------------------------------
+int FEBoxMesh::AddGridNodes(FEMesh& mesh, int nx, int ny, int nz, const vec3d& r0, const vec3d& r1)
+{
+	assert((nx > 0) && (ny > 0) && (nz > 0));
 
-	FEModel* fem = GetFEModel();
+	int N0 = mesh.Nodes();
+	int nodes = (nx+1)*(ny+1)*(nz+1);
+	mesh.AddNodes(nodes);
+
+	FEModel* fem = mesh.GetFEModel();
 	int MAX_DOFS = fem->GetDOFS().GetTotalDOFS();
-	FEMesh::SetDOFS(MAX_DOFS);
 
 	// create the nodes
-	double x, y, z;
-	n = 0;
-	for (i=0; i<=nx; ++i)
+	int n = N0;
+	for (int i=0; i<=nx; ++i)
 	{
-		x = r0.x + ((r1.x - r0.x)*i)/nx;
-		for (j=0; j<=ny; ++j)
+		double x = r0.x + ((r1.x - r0.x)*i)/nx;
+		for (int j=0; j<=ny; ++j)
 		{
-			y = r0.y + ((r1.y - r0.y)*j)/ny;
-			for (k=0; k<=nz; ++k, ++n)
+			double y = r0.y + ((r1.y - r0.y)*j)/ny;
+			for (int k=0; k<=nz; ++k, ++n)
 			{
-				z = r0.z + ((r1.z - r0.z)*k)/nz;
-
-				FENode& node = Node(n);
+				double z = r0.z + ((r1.z - r0.z)*k)/nz;
 
+				FENode& node = mesh.Node(n);
+				node.SetDOFS(MAX_DOFS);
 				node.m_r0 = vec3d(x, y, z);
-
 				node.m_rt = node.m_r0;
 
 				// set rigid body id
@@ -88,34 +111,18 @@ void FEBoxMesh::Create(int nx, int ny, int nz, vec3d r0, vec3d r1, FE_Element_Ty
 		}
 	}
 
-	// create the elements
-	int *en;
-	n = 0;
-	FEElasticSolidDomain* pbd = new FEElasticSolidDomain(fem);
-	pbd->Create(elems, FEElementLibrary::GetElementSpecFromType(nhex));
-	pbd->SetMatID(-1);
-	AddDomain(pbd);
-	for (i=0; i<nx; ++i)
-	{
-		for (j=0; j<ny; ++j)
-		{
-			for (k=0; k<nz; ++k, ++n)
-			{
-				FESolidElement& el = pbd->Element(n);
-
-				el.SetID(n+1);
-
-				en = &el.m_node[0];
+	return N0;
+}
 
-				en[0] = (i  )*(ny+1)*(nz+1) + (j  )*(nz+1) + (k  );
-				en[1] = (i+1)*(ny+1)*(nz+1) + (j  )*(nz+1) + (k  );
-				en[2] = (i+1)*(ny+1)*(nz+1) + (j+1)*(nz+1) + (k  );
-				en[3] = (i  )*(ny+1)*(nz+1) + (j+1)*(nz+1) + (k  );
-				en[4] = (i  )*(ny+1)*(nz+1) + (j  )*(nz+1) + (k+1);
-				en[5] = (i+1)*(ny+1)*(nz+1) + (j  )*(nz+1) + (k+1);
-				en[6] = (i+1)*(ny+1)*(nz+1) + (j+1)*(nz+1) + (k+1);
-				en[7] = (i  )*(ny+1)*(nz+1) + (j+1)*(nz+1) + (k+1);
-			}
-		}
-	}
+//-----------------------------------------------------------------------------
+void FEBoxMesh::GridHexNodes(int n0, int ny, int nz, int i, int j, int k, int* en)
+{
+	en[0] = n0 + (i  )*(ny+1)*(nz+1) + (j  )*(nz+1) + (k  );
+	en[1] = n0 + (i+1)*(ny+1)*(nz+1) + (j  )*(nz+1) + (k  );
+	en[2] = n0 + (i+1)*(ny+1)*(nz+1) + (j+1)*(nz+1) + (k  );
+	en[3] = n0 + (i  )*(ny+1)*(nz+1) + (j+1)*(nz+1) + (k  );
+	en[4] = n0 + (i  )*(ny+1)*(nz+1) + (j  )*(nz+1) + (k+1);
+	en[5] = n0 + (i+1)*(ny+1)*(nz+1) + (j  )*(nz+1) + (k+1);
+	en[6] = n0 + (i+1)*(ny+1)*(nz+1) + (j+1)*(nz+1) + (k+1);
+	en[7] = n0 + (i  )*(ny+1)*(nz+1) + (j+1)*(nz+1) + (k+1);
 }
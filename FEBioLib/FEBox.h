@@ -36,4 +36,12 @@ public:
 	virtual ~FEBoxMesh();
 
 	void Create(int nx, int ny, int nz, vec3d r0, vec3d r1, FE_Element_Type nhex = FE_HEX8G8);
+
+public:
+	// Append the (nx+1)*(ny+1)*(nz+1) grid nodes of the box [r0,r1] to a mesh.
+	// Returns the index of the first new node.
+	static int AddGridNodes(FEMesh& mesh, int nx, int ny, int nz, const vec3d& r0, const vec3d& r1);
+
+	// Get the node indices of hex cell (i,j,k) of a grid whose first node is n0.
+	static void GridHexNodes(int n0, int ny, int nz, int i, int j, int k, int* en);
 };
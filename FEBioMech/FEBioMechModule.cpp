@@ -244,6 +244,8 @@ SOFTWARE.*/
 
 #include "FEDeformationMapGenerator.h"
 
+#include "FEFatigueCycleJump.h"
+
 //-----------------------------------------------------------------------------
 //! Register all the classes of the FEBioMech module with the FEBio framework.
 void FEBioMech::InitModule()
@@ -935,6 +937,10 @@ void FEBioMech::InitModule()
 	// Derived from FEDataGenerator
 	REGISTER_FECORE_CLASS(FEDeformationMapGenerator, "defgrad");
 
+	//-----------------------------------------------------------------------------
+	// Derived from FECallBack
+	REGISTER_FECORE_CLASS(FEFatigueCycleJump, "fatigue cycle jump");
+
 	febio.CreateModule("explicit-solid");
 	febio.SetModuleDependency("solid");
 	REGISTER_FECORE_CLASS(FEExplicitSolidSolver, "explicit-solid");
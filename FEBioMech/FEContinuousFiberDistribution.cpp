@@ -77,118 +77,89 @@ void FEContinuousFiberDistribution::Serialize(DumpStream& ar)
 mat3ds FEContinuousFiberDistribution::Stress(FEMaterialPoint& mp)
 { 
 	FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
-    FEFiberMaterialPoint& fp = *mp.ExtractData<FEFiberMaterialPoint>();
+	FEFiberMaterialPoint& fp = *mp.ExtractData<FEFiberMaterialPoint>();
 
-	// calculate stress
 	mat3ds s; s.zero();
+	return IntegrateFibers(mp, s, [&](const vec3d& n0) {
+		return m_pFmat->FiberStress(pt, fp.FiberPreStretch(n0));
+	});
+}
 
-	// get the local coordinate system
-	mat3d Q = GetLocalCS(mp);
-    
-    double IFD = IntegratedFiberDensity(mp);
-
-	// obtain an integration point iterator
-	FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(&pt);
-	if (it->IsValid())
-	{
-		do
-		{
-			// get the fiber direction for that fiber distribution
-			vec3d& N = it->m_fiber;
+//-----------------------------------------------------------------------------
+//! calculate tangent stiffness at material point
+tens4ds FEContinuousFiberDistribution::Tangent(FEMaterialPoint& mp)
+{
+	FEFiberMaterialPoint& fp = *mp.ExtractData<FEFiberMaterialPoint>();
 
-			// evaluate ellipsoidally distributed material coefficients
-			double R = m_pFDD->FiberDensity(mp, N);
-            
-            // convert fiber to global coordinates
-            vec3d n0 = Q*N;
-            
-			// calculate the stress
-			double wn = it->m_weight;
-			s += m_pFmat->FiberStress(pt, fp.FiberPreStretch(n0))*(R*wn);
-		}
-		while (it->Next());
-	}
+	tens4ds c; c.zero();
+	return IntegrateFibers(mp, c, [&](const vec3d& n0) {
+		return m_pFmat->FiberTangent(mp, fp.FiberPreStretch(n0));
+	});
+}
 
-	// don't forget to delete the iterator
-	delete it;
+//-----------------------------------------------------------------------------
+//! calculate strain energy density at material point
+double FEContinuousFiberDistribution::StrainEnergyDensity(FEMaterialPoint& mp)
+{ 
+	FEFiberMaterialPoint& fp = *mp.ExtractData<FEFiberMaterialPoint>();
 
-	// divide by IFD
-	return s / IFD;
+	return IntegrateFibers(mp, 0.0, [&](const vec3d& n0) {
+		return m_pFmat->FiberStrainEnergyDensity(mp, fp.FiberPreStretch(n0));
+	});
 }
 
 //-----------------------------------------------------------------------------
-//! calculate tangent stiffness at material point
-tens4ds FEContinuousFiberDistribution::Tangent(FEMaterialPoint& mp)
+template <class T, class F> T FEContinuousFiberDistribution::IntegrateFibers(FEMaterialPoint& mp, T sum, F f)
 {
-	FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
-    FEFiberMaterialPoint& fp = *mp.ExtractData<FEFiberMaterialPoint>();
-
 	// get the local coordinate system
 	mat3d Q = GetLocalCS(mp);
-    
-    double IFD = IntegratedFiberDensity(mp);
 
-	// initialize stress tensor
-	tens4ds c;
-	c.zero();
-
-	FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(&pt);
-	if (it->IsValid())
+	// If the integration points do not depend on the deformation, we can loop over
+	// the scheme's precomputed table. Since the same points are used for the 
+	// integrated fiber density, it is accumulated in the same pass.
+	if (m_pFint->DependsOnDeformation() == false)
 	{
-		do
+		const FEFiberIntegrationTable& table = m_pFint->GetTable();
+		const int nint = table.Points();
+		const vec3d* N = (nint > 0 ? &table.m_fiber[0] : nullptr);
+		const double* w = (nint > 0 ? &table.m_weight[0] : nullptr);
+
+		double IFD = 0.0;
+		for (int n = 0; n < nint; ++n)
 		{
-            // get the fiber direction for that fiber distribution
-            vec3d& N = it->m_fiber;
-            
-            // evaluate ellipsoidally distributed material coefficients
-            double R = m_pFDD->FiberDensity(mp, N);
-            
-            // convert fiber to global coordinates
-            vec3d n0 = Q*N;
-
-			// calculate the tangent
-			c += m_pFmat->FiberTangent(mp, fp.FiberPreStretch(n0))*(R*it->m_weight);
+			// evaluate the fiber density times the integration weight
+			double Rw = m_pFDD->FiberDensity(mp, N[n])*w[n];
+			IFD += Rw;
+
+			// convert fiber to global coordinates and evaluate the fiber quantity
+			sum += f(Q*N[n])*Rw;
 		}
-		while (it->Next());
-	}
 
-	// don't forget to delete the iterator
-	delete it;
-    
-	// divide by IFD
-	return c / IFD;
-}
+		// just in case
+		if (IFD == 0.0) IFD = 1.0;
 
-//-----------------------------------------------------------------------------
-//! calculate strain energy density at material point
-//double FEContinuousFiberDistribution::StrainEnergyDensity(FEMaterialPoint& pt) { return m_pFint->StrainEnergyDensity(pt); }
-double FEContinuousFiberDistribution::StrainEnergyDensity(FEMaterialPoint& mp)
-{ 
-	FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
-    FEFiberMaterialPoint& fp = *mp.ExtractData<FEFiberMaterialPoint>();
+		return sum / IFD;
+	}
 
-	// get the local coordinate system
-	mat3d Q = GetLocalCS(mp);
-    
-    double IFD = IntegratedFiberDensity(mp);
+	double IFD = IntegratedFiberDensity(mp);
 
-	double sed = 0.0;
+	// obtain an integration point iterator
+	FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
 	FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(&pt);
 	if (it->IsValid())
 	{
 		do
 		{
-            // get the fiber direction for that fiber distribution
-            vec3d& N = it->m_fiber;
-            
-            // evaluate ellipsoidally distributed material coefficients
-            double R = m_pFDD->FiberDensity(mp, N);
-            
-            // convert fiber to global coordinates
-            vec3d n0 = Q*N;
-
-			// calculate the stress
-			sed += m_pFmat->FiberStrainEnergyDensity(mp, fp.FiberPreStretch(n0))*(R*it->m_weight);
+			// get the fiber direction for that fiber distribution
+			vec3d& N = it->m_fiber;
+
+			// evaluate ellipsoidally distributed material coefficients
+			double R = m_pFDD->FiberDensity(mp, N);
+
+			// convert fiber to global coordinates
+			vec3d n0 = Q*N;
+
+			sum += f(n0)*(R*it->m_weight);
 		}
 		while (it->Next());
 	}
@@ -197,33 +168,25 @@ double FEContinuousFiberDistribution::StrainEnergyDensity(FEMaterialPoint& mp)
 	delete it;
 
 	// divide by IFD
-	return sed / IFD;
+	return sum / IFD;
 }
 
 //-----------------------------------------------------------------------------
 double FEContinuousFiberDistribution::IntegratedFiberDensity(FEMaterialPoint& mp)
 {
+	// NOTE: This uses the points for the undeformed state, i.e. GetIterator(nullptr),
+	//       to avoid issues with the GK rule.
+	const FEFiberIntegrationTable& table = m_pFint->GetTable();
+	const int nint = table.Points();
+
 	double IFD = 0;
-	// NOTE: Pass nullptr to GetIterator to avoid issues with GK rule!
-	FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(nullptr);
-	if (it->IsValid())
+	for (int n = 0; n < nint; ++n)
 	{
-		do
-		{
-            // get the fiber direction for that fiber distribution
-            vec3d& N = it->m_fiber;
-
-			double R = m_pFDD->FiberDensity(mp, N);
-
-			// integrate the fiber distribution
-			IFD += R * it->m_weight;
-
-		} while (it->Next());
+		// integrate the fiber distribution
+		double R = m_pFDD->FiberDensity(mp, table.m_fiber[n]);
+		IFD += R * table.m_weight[n];
 	}
 
-	// don't forget to delete the iterator
-	delete it;
-
 	// just in case
 	if (IFD == 0.0) IFD = 1.0;
 
@@ -60,112 +60,83 @@ mat3ds FEContinuousFiberDistributionUC::DevStress(FEMaterialPoint& mp)
 { 
 	FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
 
-	// calculate stress
 	mat3ds s; s.zero();
-
-	// get the local coordinate system
-	mat3d Q = GetLocalCS(mp);
-
-	double IFD = IntegratedFiberDensity(mp);
-
-	// obtain an integration point iterator
-	FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(&pt);
-	if (it->IsValid())
-	{
-		do
-		{
-            // get the fiber direction for that fiber distribution
-            vec3d& N = it->m_fiber;
-            
-            // evaluate ellipsoidally distributed material coefficients
-            double R = m_pFDD->FiberDensity(mp, N);
-            
-            // convert fiber to global coordinates
-            vec3d n0 = Q*N;
-
-			// calculate the stress
-			double wn = it->m_weight;
-			s += m_pFmat->DevFiberStress(pt, m_pFmat->FiberPreStretch(n0))*(R*wn);
-		}
-		while (it->Next());
-	}
-
-	// don't forget to delete the iterator
-	delete it;
-
-	// divide by IFD
-	return s / IFD;
+	return IntegrateFibers(mp, s, [&](const vec3d& n0) {
+		return m_pFmat->DevFiberStress(pt, m_pFmat->FiberPreStretch(n0));
+	});
 }
 
 //-----------------------------------------------------------------------------
 //! calculate tangent stiffness at material point
 tens4ds FEContinuousFiberDistributionUC::DevTangent(FEMaterialPoint& mp)
+{
+	tens4ds c; c.zero();
+	return IntegrateFibers(mp, c, [&](const vec3d& n0) {
+		return m_pFmat->DevFiberTangent(mp, m_pFmat->FiberPreStretch(n0));
+	});
+}
+
+//-----------------------------------------------------------------------------
+//! calculate deviatoric strain energy density
+double FEContinuousFiberDistributionUC::DevStrainEnergyDensity(FEMaterialPoint& mp)
 { 
-	FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
+	return IntegrateFibers(mp, 0.0, [&](const vec3d& n0) {
+		return m_pFmat->DevFiberStrainEnergyDensity(mp, m_pFmat->FiberPreStretch(n0));
+	});
+}
 
+//-----------------------------------------------------------------------------
+template <class T, class F> T FEContinuousFiberDistributionUC::IntegrateFibers(FEMaterialPoint& mp, T sum, F f)
+{
 	// get the local coordinate system
 	mat3d Q = GetLocalCS(mp);
 
-	// initialize stress tensor
-	tens4ds c;
-	c.zero();
-
-	double IFD = IntegratedFiberDensity(pt);
-
-	FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(&pt);
-	if (it->IsValid())
+	// If the integration points do not depend on the deformation, we can loop over
+	// the scheme's precomputed table. Since the same points are used for the 
+	// integrated fiber density, it is accumulated in the same pass.
+	if (m_pFint->DependsOnDeformation() == false)
 	{
-		do
+		const FEFiberIntegrationTable& table = m_pFint->GetTable();
+		const int nint = table.Points();
+		const vec3d* N = (nint > 0 ? &table.m_fiber[0] : nullptr);
+		const double* w = (nint > 0 ? &table.m_weight[0] : nullptr);
+
+		double IFD = 0.0;
+		for (int n = 0; n < nint; ++n)
 		{
-            // get the fiber direction for that fiber distribution
-            vec3d& N = it->m_fiber;
-            
-            // evaluate ellipsoidally distributed material coefficients
-            double R = m_pFDD->FiberDensity(mp, N);
-            
-            // convert fiber to global coordinates
-            vec3d n0 = Q*N;
-
-			// calculate the tangent
-			c += m_pFmat->DevFiberTangent(mp, m_pFmat->FiberPreStretch(n0))*(R*it->m_weight);
-		}
-		while (it->Next());
-	}
-	
-	// don't forget to delete the iterator
-	delete it;
+			// evaluate the fiber density times the integration weight
+			double Rw = m_pFDD->FiberDensity(mp, N[n])*w[n];
+			IFD += Rw;
 
-	// divide by IFD
-	return c / IFD;
-}
+			// convert fiber to global coordinates and evaluate the fiber quantity
+			sum += f(Q*N[n])*Rw;
+		}
 
-//-----------------------------------------------------------------------------
-//! calculate deviatoric strain energy density
-double FEContinuousFiberDistributionUC::DevStrainEnergyDensity(FEMaterialPoint& mp)
-{ 
-	FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
+		// just in case
+		if (IFD == 0.0) IFD = 1.0;
 
-	// get the local coordinate system
-	mat3d Q = GetLocalCS(mp);
+		return sum / IFD;
+	}
 
 	double IFD = IntegratedFiberDensity(mp);
-	double sed = 0.0;
+
+	// obtain an integration point iterator
+	FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
 	FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(&pt);
 	if (it->IsValid())
 	{
 		do
 		{
-            // get the fiber direction for that fiber distribution
-            vec3d& N = it->m_fiber;
-            
-            // evaluate ellipsoidally distributed material coefficients
-            double R = m_pFDD->FiberDensity(mp, N);
-            
-            // convert fiber to global coordinates
-            vec3d n0 = Q*N;
-
-			// calculate the stress
-			sed += m_pFmat->DevFiberStrainEnergyDensity(mp, m_pFmat->FiberPreStretch(n0))*(R*it->m_weight);
+			// get the fiber direction for that fiber distribution
+			vec3d& N = it->m_fiber;
+
+			// evaluate ellipsoidally distributed material coefficients
+			double R = m_pFDD->FiberDensity(mp, N);
+
+			// convert fiber to global coordinates
+			vec3d n0 = Q*N;
+
+			sum += f(n0)*(R*it->m_weight);
 		}
 		while (it->Next());
 	}
@@ -174,33 +145,25 @@ double FEContinuousFiberDistributionUC::DevStrainEnergyDensity(FEMaterialPoint&
 	delete it;
 
 	// divide by IFD
-	return sed / IFD;
+	return sum / IFD;
 }
 
 //-----------------------------------------------------------------------------
 double FEContinuousFiberDistributionUC::IntegratedFiberDensity(FEMaterialPoint& mp)
 {
+	// NOTE: This uses the points for the undeformed state, i.e. GetIterator(nullptr),
+	//       to avoid issues with the GK rule.
+	const FEFiberIntegrationTable& table = m_pFint->GetTable();
+	const int nint = table.Points();
+
 	double IFD = 0;
-	// NOTE: Pass nullptr to GetIterator to avoid issues with GK rule!
-	FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(nullptr);
-	if (it->IsValid())
+	for (int n = 0; n < nint; ++n)
 	{
-		do
-		{
-			// set fiber direction in global coordinate system
-			vec3d& N = it->m_fiber;
-
-			double R = m_pFDD->FiberDensity(mp, N);
-
-			// integrate the fiber distribution
-			IFD += R * it->m_weight;
-
-		} while (it->Next());
+		// integrate the fiber distribution
+		double R = m_pFDD->FiberDensity(mp, table.m_fiber[n]);
+		IFD += R * table.m_weight[n];
 	}
 
-	// don't forget to delete the iterator
-	delete it;
-
 	// just in case
 	if (IFD == 0.0) IFD = 1.0;
 
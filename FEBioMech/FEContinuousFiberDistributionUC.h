@@ -58,6 +58,11 @@ public:
 private:
 	double IntegratedFiberDensity(FEMaterialPoint& pt);
 
+	// Integrate a fiber quantity over the distribution. The functor f is evaluated
+	// for each integration point with the (global) fiber direction and the result
+	// is divided by the integrated fiber density.
+	template <class T, class F> T IntegrateFibers(FEMaterialPoint& mp, T sum, F f);
+
 protected:
     FEElasticFiberMaterialUC*   m_pFmat;    // pointer to fiber material
 	FEFiberDensityDistribution* m_pFDD;     // pointer to fiber density distribution
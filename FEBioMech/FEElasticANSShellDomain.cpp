@@ -175,12 +175,12 @@ void FEElasticANSShellDomain::ElementInternalForce(FEShellElementNew& el, vector
     // ANS method: Evaluate collocation strains
     CollocationStrainsANS(el, EE, HU, HW, NS, NN);
     
-    vector<matrix> hu(neln, matrix(3,6));
-    vector<matrix> hw(neln, matrix(3,6));
+    vector<hmatrix> hu(neln);
+    vector<hmatrix> hw(neln);
     vector<vec3d> Nu(neln);
     vector<vec3d> Nw(neln);
     
-    matrix Fu(3,1), Fw(3,1);
+    fixed_matrix<3,1> Fu, Fw;
     
     // repeat for all integration points
     for (n=0; n<nint; ++n)
@@ -193,7 +193,7 @@ void FEElasticANSShellDomain::ElementInternalForce(FEShellElementNew& el, vector
         EvaluateANS(el, n, Gcnt, el.m_E[n], hu, hw, EE, HU, HW);
         
         // evaluate 2nd P-K stress
-        matrix SC(6,1);
+        fixed_matrix<6,1> SC;
         mat3ds S = m_pMat->PK2Stress(mp, el.m_E[n]);
         mat3dsCntMat61(S, Gcnt, SC);
         
@@ -547,14 +547,14 @@ void FEElasticANSShellDomain::ElementStiffness(int iel, matrix& ke)
     if (ANS) CollocationStrainsANS(el, EE, HU, HW, NS, NN);
     
     // calculate element stiffness matrix
-    vector<matrix> hu(neln, matrix(3,6));
-    vector<matrix> hw(neln, matrix(3,6));
+    vector<hmatrix> hu(neln);
+    vector<hmatrix> hw(neln);
     vector<vec3d> Nu(neln);
     vector<vec3d> Nw(neln);
     
     ke.zero();
     
-    matrix KUU(3,3), KUW(3,3), KWU(3,3), KWW(3,3);
+    fixed_matrix<3,3> KUU, KUW, KWU, KWW;
     for (n=0; n<nint; ++n)
     {
         FEMaterialPoint& mp = *(el.GetMaterialPoint(n));
@@ -568,12 +568,12 @@ void FEElasticANSShellDomain::ElementStiffness(int iel, matrix& ke)
         detJt = detJ0(el, n)*gw[n];
         
         // evaluate 2nd P-K stress
-        matrix SC(6,1);
+        fixed_matrix<6,1> SC;
         mat3ds S = m_pMat->PK2Stress(mp, el.m_E[n]);
         mat3dsCntMat61(S, Gcnt, SC);
         
         // evaluate the material tangent
-        matrix CC(6,6);
+        fixed_matrix<6,6> CC;
         tens4dmm c = m_pMat->MaterialTangent(mp, el.m_E[n]);
         tens4dmmCntMat66(c, Gcnt, CC);
 //        tens4dsCntMat66(c, Gcnt, CC);
@@ -582,13 +582,14 @@ void FEElasticANSShellDomain::ElementStiffness(int iel, matrix& ke)
         
         for (i=0, i6=0; i<neln; ++i, i6 += 6)
         {
+            hmatrix huC = hu[i]*CC;
+            hmatrix hwC = hw[i]*CC;
             for (j=0, j6 = 0; j<neln; ++j, j6 += 6)
             {
-                matrix KUU(3,3), KUW(3,3), KWU(3,3), KWW(3,3);
-                KUU = hu[i]*CC*hu[j].transpose();
-                KUW = hu[i]*CC*hw[j].transpose();
-                KWU = hw[i]*CC*hu[j].transpose();
-                KWW = hw[i]*CC*hw[j].transpose();
+                KUU = huC.mult_transpose(hu[j]);
+                KUW = huC.mult_transpose(hw[j]);
+                KWU = hwC.mult_transpose(hu[j]);
+                KWW = hwC.mult_transpose(hw[j]);
                 KUU *= detJt; KUW *= detJt; KWU *= detJt; KWW *= detJt;
                 
                 ke[i6  ][j6  ] += KUU(0,0); ke[i6  ][j6+1] += KUU(0,1); ke[i6  ][j6+2] += KUU(0,2);
@@ -932,9 +933,8 @@ void FEElasticANSShellDomain::UnpackLM(FEElement& el, vector<int>& lm)
 
 //-----------------------------------------------------------------------------
 //! Evaluate contravariant components of mat3ds tensor
-void FEElasticANSShellDomain::mat3dsCntMat61(const mat3ds s, const vec3d* Gcnt, matrix& S)
+void FEElasticANSShellDomain::mat3dsCntMat61(const mat3ds s, const vec3d* Gcnt, fixed_matrix<6,1>& S)
 {
-    S.resize(6, 1);
     S(0,0) = Gcnt[0]*(s*Gcnt[0]);
     S(1,0) = Gcnt[1]*(s*Gcnt[1]);
     S(2,0) = Gcnt[2]*(s*Gcnt[2]);
@@ -947,9 +947,8 @@ void FEElasticANSShellDomain::mat3dsCntMat61(const mat3ds s, const vec3d* Gcnt,
 //-----------------------------------------------------------------------------
 //! Evaluate contravariant components of tens4ds tensor
 //! Cijkl = Gj.(Gi.c.Gl).Gk
-void FEElasticANSShellDomain::tens4dsCntMat66(const tens4ds c, const vec3d* Gcnt, matrix& C)
+void FEElasticANSShellDomain::tens4dsCntMat66(const tens4ds c, const vec3d* Gcnt, fixed_matrix<6,6>& C)
 {
-    C.resize(6, 6);
     C(0,0) =          Gcnt[0]*(vdotTdotv(Gcnt[0], c, Gcnt[0])*Gcnt[0]);  // i=0, j=0, k=0, l=0
     C(0,1) = C(1,0) = Gcnt[0]*(vdotTdotv(Gcnt[0], c, Gcnt[1])*Gcnt[1]);  // i=0, j=0, k=1, l=1
     C(0,2) = C(2,0) = Gcnt[0]*(vdotTdotv(Gcnt[0], c, Gcnt[2])*Gcnt[2]);  // i=0, j=0, k=2, l=2
@@ -977,9 +976,8 @@ void FEElasticANSShellDomain::tens4dsCntMat66(const tens4ds c, const vec3d* Gcnt
 //-----------------------------------------------------------------------------
 //! Evaluate contravariant components of tens4dm tensor
 //! Cijkl = Gj.(Gi.c.Gl).Gk
-void FEElasticANSShellDomain::tens4dmmCntMat66(const tens4dmm c, const vec3d* Gcnt, matrix& C)
+void FEElasticANSShellDomain::tens4dmmCntMat66(const tens4dmm c, const vec3d* Gcnt, fixed_matrix<6,6>& C)
 {
-    C.resize(6, 6);
     C(0,0) =          Gcnt[0]*(vdotTdotv(Gcnt[0], c, Gcnt[0])*Gcnt[0]);  // i=0, j=0, k=0, l=0
     C(0,1) = C(1,0) = Gcnt[0]*(vdotTdotv(Gcnt[0], c, Gcnt[1])*Gcnt[1]);  // i=0, j=0, k=1, l=1
     C(0,2) = C(2,0) = Gcnt[0]*(vdotTdotv(Gcnt[0], c, Gcnt[2])*Gcnt[2]);  // i=0, j=0, k=2, l=2
@@ -1170,7 +1168,7 @@ void FEElasticANSShellDomain::CollocationStrainsANS(FEShellElementNew& el, vecto
 //-----------------------------------------------------------------------------
 //! Evaluate assumed natural strain (ANS)
 void FEElasticANSShellDomain::EvaluateANS(FEShellElementNew& el, const int n, const vec3d* Gcnt,
-                                          mat3ds& Ec, vector<matrix>& hu, vector<matrix>& hw,
+                                          mat3ds& Ec, vector<hmatrix>& hu, vector<hmatrix>& hw,
                                           vector<double>& E, vector< vector<vec3d>>& HU, vector< vector<vec3d>>& HW)
 {
     // ANS method for 4-node quadrilaterials
@@ -1234,7 +1232,7 @@ void FEElasticANSShellDomain::EvaluateANS(FEShellElementNew& el, const int n, co
 //-----------------------------------------------------------------------------
 //! Evaluate strain E and matrix hu and hw
 void FEElasticANSShellDomain::EvaluateEh(FEShellElementNew& el, const int n, const vec3d* Gcnt, mat3ds& E,
-                                         vector<matrix>& hu, vector<matrix>& hw, vector<vec3d>& Nu, vector<vec3d>& Nw)
+                                         vector<hmatrix>& hu, vector<hmatrix>& hw, vector<vec3d>& Nu, vector<vec3d>& Nw)
 {
     const double* Mr, *Ms, *M;
     vec3d gcov[3];
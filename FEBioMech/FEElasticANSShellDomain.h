@@ -30,11 +30,16 @@ SOFTWARE.*/
 #include "FESSIShellDomain.h"
 #include "FEElasticDomain.h"
 #include "FESolidMaterial.h"
+#include <FECore/fixed_matrix.h>
 
 //-----------------------------------------------------------------------------
 //! Domain described by 3D shell elements
 class FEElasticANSShellDomain : public FESSIShellDomain, public FEElasticDomain
 {
+public:
+    // small matrices used by the element kernels
+    typedef fixed_matrix<3, 6>  hmatrix;
+
 public:
     FEElasticANSShellDomain(FEModel* pfem);
     
@@ -83,7 +88,7 @@ public: // overrides from FEElasticDomain
     void BodyForceStiffness(FELinearSystem& LS, FEBodyForce& bf) override;
     
     // evaluate strain E and matrix hu and hw
-	void EvaluateEh(FEShellElementNew& el, const int n, const vec3d* Gcnt, mat3ds& E, vector<matrix>& hu, vector<matrix>& hw, vector<vec3d>& Nu, vector<vec3d>& Nw);
+	void EvaluateEh(FEShellElementNew& el, const int n, const vec3d* Gcnt, mat3ds& E, vector<hmatrix>& hu, vector<hmatrix>& hw, vector<vec3d>& Nu, vector<vec3d>& Nw);
     
 public:
     
@@ -114,16 +119,16 @@ public:
     // --- A N S  M E T H O D ---
     
     // Evaluate contravariant components of mat3ds tensor
-    void mat3dsCntMat61(const mat3ds s, const vec3d* Gcnt, matrix& S);
+    void mat3dsCntMat61(const mat3ds s, const vec3d* Gcnt, fixed_matrix<6,1>& S);
     
     // Evaluate contravariant components of tens4ds tensor
-    void tens4dsCntMat66(const tens4ds c, const vec3d* Gcnt, matrix& C);
-    void tens4dmmCntMat66(const tens4dmm c, const vec3d* Gcnt, matrix& C);
+    void tens4dsCntMat66(const tens4ds c, const vec3d* Gcnt, fixed_matrix<6,6>& C);
+    void tens4dmmCntMat66(const tens4dmm c, const vec3d* Gcnt, fixed_matrix<6,6>& C);
 
     // Evaluate the strain using the ANS method
 	void CollocationStrainsANS(FEShellElementNew& el, vector<double>& E, vector< vector<vec3d>>& HU, vector< vector<vec3d>>& HW, matrix& NS, matrix& NN);
     
-	void EvaluateANS(FEShellElementNew& el, const int n, const vec3d* Gcnt, mat3ds& Ec, vector<matrix>& hu, vector<matrix>& hw, vector<double>& E, vector< vector<vec3d>>& HU, vector< vector<vec3d>>& HW);
+	void EvaluateANS(FEShellElementNew& el, const int n, const vec3d* Gcnt, mat3ds& Ec, vector<hmatrix>& hu, vector<hmatrix>& hw, vector<double>& E, vector< vector<vec3d>>& HU, vector< vector<vec3d>>& HW);
     
 protected:
     FESolidMaterial*    m_pMat;
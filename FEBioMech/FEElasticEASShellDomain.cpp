@@ -76,7 +76,7 @@ bool FEElasticEASShellDomain::Init()
 	FESSIShellDomain::Init();
     
     // set up EAS arrays
-	m_nEAS = 7;
+	m_nEAS = NEAS;
 	for (int i=0; i<Elements(); ++i)
     {
         FEShellElementNew& el = ShellElement(i);
@@ -205,20 +205,19 @@ void FEElasticEASShellDomain::ElementInternalForce(FEShellElementNew& el, vector
     // EAS method: Evaluate Kua, Kwa, and Kaa
     // Also evaluate PK2 stress and material tangent using enhanced strain
     EvaluateEAS(el, EE, HU, HW, S, C);
-    matrix Kif(7,1);
-    Kif = el.m_Kaai*el.m_fa;
+    fixed_matrix<NEAS,1> Kif = fixed_matrix<NEAS,NEAS>(el.m_Kaai)*fixed_matrix<NEAS,1>(el.m_fa);
     
-    vector<matrix> hu(neln, matrix(3,6));
-    vector<matrix> hw(neln, matrix(3,6));
+    vector<hmatrix> hu(neln);
+    vector<hmatrix> hw(neln);
     vector<vec3d> Nu(neln);
     vector<vec3d> Nw(neln);
     
     // EAS contribution
-    matrix Fu(3,1), Fw(3,1);
+    fixed_matrix<3,1> Fu, Fw;
     for (i=0; i<neln; ++i)
     {
-        Fu = el.m_Kua[i]*Kif;
-        Fw = el.m_Kwa[i]*Kif;
+        Fu = fixed_matrix<3,NEAS>(el.m_Kua[i])*Kif;
+        Fw = fixed_matrix<3,NEAS>(el.m_Kwa[i])*Kif;
         
         // calculate internal force
         // the '-' sign is so that the internal forces get subtracted
@@ -242,7 +241,7 @@ void FEElasticEASShellDomain::ElementInternalForce(FEShellElementNew& el, vector
         EvaluateANS(el, n, Gcnt, E, hu, hw, EE, HU, HW);
         
         // evaluate 2nd P-K stress
-        matrix SC(6,1);
+        fixed_matrix<6,1> SC;
         mat3dsCntMat61(S[n], Gcnt, SC);
         //        mat3ds S = m_pMat->PK2Stress(E);
         //        mat3dsCntMat61(S, Gcnt, SC);
@@ -604,22 +603,33 @@ void FEElasticEASShellDomain::ElementStiffness(int iel, matrix& ke)
     EvaluateEAS(el, EE, HU, HW, S, C);
     
     // calculate element stiffness matrix
-    vector<matrix> hu(neln, matrix(3,6));
-    vector<matrix> hw(neln, matrix(3,6));
+    vector<hmatrix> hu(neln);
+    vector<hmatrix> hw(neln);
     vector<vec3d> Nu(neln);
     vector<vec3d> Nw(neln);
     
     ke.zero();
     
-    matrix KUU(3,3), KUW(3,3), KWU(3,3), KWW(3,3);
+    // EAS contribution: Kua*inv(Kaa)*Kua^T, etc.
+    fixed_matrix<NEAS,NEAS> Kaai(el.m_Kaai);
+    vector< fixed_matrix<3,NEAS> > Kua(neln), Kwa(neln), KuaKaai(neln), KwaKaai(neln);
+    for (i=0; i<neln; ++i)
+    {
+        Kua[i] = fixed_matrix<3,NEAS>(el.m_Kua[i]);
+        Kwa[i] = fixed_matrix<3,NEAS>(el.m_Kwa[i]);
+        KuaKaai[i] = Kua[i]*Kaai;
+        KwaKaai[i] = Kwa[i]*Kaai;
+    }
+    
+    fixed_matrix<3,3> KUU, KUW, KWU, KWW;
     for (i=0, i6=0; i<neln; ++i, i6 += 6)
     {
         for (j=0, j6 = 0; j<neln; ++j, j6 += 6)
         {
-            KUU = (el.m_Kua[i]*el.m_Kaai*el.m_Kua[j].transpose());
-            KUW = (el.m_Kua[i]*el.m_Kaai*el.m_Kwa[j].transpose());
-            KWU = (el.m_Kwa[i]*el.m_Kaai*el.m_Kua[j].transpose());
-            KWW = (el.m_Kwa[i]*el.m_Kaai*el.m_Kwa[j].transpose());
+            KUU = KuaKaai[i].mult_transpose(Kua[j]);
+            KUW = KuaKaai[i].mult_transpose(Kwa[j]);
+            KWU = KwaKaai[i].mult_transpose(Kua[j]);
+            KWW = KwaKaai[i].mult_transpose(Kwa[j]);
             
             ke[i6  ][j6  ] -= KUU(0,0); ke[i6  ][j6+1] -= KUU(0,1); ke[i6  ][j6+2] -= KUU(0,2);
             ke[i6+1][j6  ] -= KUU(1,0); ke[i6+1][j6+1] -= KUU(1,1); ke[i6+1][j6+2] -= KUU(1,2);
@@ -651,13 +661,13 @@ void FEElasticEASShellDomain::ElementStiffness(int iel, matrix& ke)
         detJt = detJ0(el, n)*gw[n];
         
         // evaluate 2nd P-K stress
-        matrix SC(6,1);
+        fixed_matrix<6,1> SC;
         mat3dsCntMat61(S[n], Gcnt, SC);
         //        mat3ds S = m_pMat->PK2Stress(E);
         //        mat3dsCntMat61(S, Gcnt, SC);
         
         // evaluate the material tangent
-        matrix CC(6,6);
+        fixed_matrix<6,6> CC;
         tens4dmmCntMat66(C[n], Gcnt, CC);
 //        tens4dsCntMat66(C[n], Gcnt, CC);
         //        tens4ds c = m_pMat->MaterialTangent(E);
@@ -667,13 +677,14 @@ void FEElasticEASShellDomain::ElementStiffness(int iel, matrix& ke)
         
         for (i=0, i6=0; i<neln; ++i, i6 += 6)
         {
+            hmatrix huC = hu[i]*CC;
+            hmatrix hwC = hw[i]*CC;
             for (j=0, j6 = 0; j<neln; ++j, j6 += 6)
             {
-                matrix KUU(3,3), KUW(3,3), KWU(3,3), KWW(3,3);
-                KUU = hu[i]*CC*hu[j].transpose();
-                KUW = hu[i]*CC*hw[j].transpose();
-                KWU = hw[i]*CC*hu[j].transpose();
-                KWW = hw[i]*CC*hw[j].transpose();
+                KUU = huC.mult_transpose(hu[j]);
+                KUW = huC.mult_transpose(hw[j]);
+                KWU = hwC.mult_transpose(hu[j]);
+                KWW = hwC.mult_transpose(hw[j]);
                 KUU *= detJt; KUW *= detJt; KWU *= detJt; KWW *= detJt;
                 
                 ke[i6  ][j6  ] += KUU(0,0); ke[i6  ][j6+1] += KUU(0,1); ke[i6  ][j6+2] += KUU(0,2);
@@ -943,11 +954,10 @@ void FEElasticEASShellDomain::UpdateEAS(vector<double>& ui)
         int neln = el.Nodes();
         
         // allocate arrays
-        matrix dalpha(m_nEAS,1);
-        matrix Du(3,1), Dw(3,1);
+        fixed_matrix<NEAS,1> dalpha(el.m_fa);
+        fixed_matrix<3,1> Du, Dw;
         
         // nodal coordinates and EAS vector alpha update
-        dalpha = el.m_fa;
         for (int j=0; j<neln; ++j)
         {
             FENode& nj = mesh.Node(el.m_node[j]);
@@ -957,10 +967,10 @@ void FEElasticEASShellDomain::UpdateEAS(vector<double>& ui)
             Dw(0,0) = (nj.m_ID[m_dofSU[0]] >=0) ? ui[nj.m_ID[m_dofSU[0]]] : 0;
             Dw(1,0) = (nj.m_ID[m_dofSU[1]] >=0) ? ui[nj.m_ID[m_dofSU[1]]] : 0;
             Dw(2,0) = (nj.m_ID[m_dofSU[2]] >=0) ? ui[nj.m_ID[m_dofSU[2]]] : 0;
-            dalpha += el.m_Kua[j].transpose()*Du + el.m_Kwa[j].transpose()*Dw;
+            dalpha += fixed_matrix<3,NEAS>(el.m_Kua[j]).transpose_mult(Du) + fixed_matrix<3,NEAS>(el.m_Kwa[j]).transpose_mult(Dw);
         }
-        dalpha = el.m_Kaai*dalpha;
-        el.m_alpha = el.m_alphat + el.m_alphai - dalpha;
+        dalpha = fixed_matrix<NEAS,NEAS>(el.m_Kaai)*dalpha;
+        for (int k=0; k<NEAS; ++k) el.m_alpha(k,0) = el.m_alphat(k,0) + el.m_alphai(k,0) - dalpha(k,0);
     }
 }
 
@@ -980,11 +990,10 @@ void FEElasticEASShellDomain::UpdateIncrementsEAS(vector<double>& ui, const bool
             int neln = el.Nodes();
             
             // allocate arrays
-            matrix dalpha(m_nEAS,1);
-            matrix Du(3,1), Dw(3,1);
+            fixed_matrix<NEAS,1> dalpha(el.m_fa);
+            fixed_matrix<3,1> Du, Dw;
             
             // nodal coordinates and EAS vector alpha update
-            dalpha = el.m_fa;
             for (int j=0; j<neln; ++j)
             {
                 FENode& nj = mesh.Node(el.m_node[j]);
@@ -994,10 +1003,10 @@ void FEElasticEASShellDomain::UpdateIncrementsEAS(vector<double>& ui, const bool
                 Dw(0,0) = (nj.m_ID[m_dofSU[0]] >=0) ? ui[nj.m_ID[m_dofSU[0]]] : 0;
                 Dw(1,0) = (nj.m_ID[m_dofSU[1]] >=0) ? ui[nj.m_ID[m_dofSU[1]]] : 0;
                 Dw(2,0) = (nj.m_ID[m_dofSU[2]] >=0) ? ui[nj.m_ID[m_dofSU[2]]] : 0;
-                dalpha += el.m_Kua[j].transpose()*Du + el.m_Kwa[j].transpose()*Dw;
+                dalpha += fixed_matrix<3,NEAS>(el.m_Kua[j]).transpose_mult(Du) + fixed_matrix<3,NEAS>(el.m_Kwa[j]).transpose_mult(Dw);
             }
-            dalpha = el.m_Kaai*dalpha;
-            el.m_alphai -= dalpha;
+            dalpha = fixed_matrix<NEAS,NEAS>(el.m_Kaai)*dalpha;
+            for (int k=0; k<NEAS; ++k) el.m_alphai(k,0) -= dalpha(k,0);
         }
         else el.m_alphat += el.m_alphai;
     }
@@ -1136,7 +1145,7 @@ void FEElasticEASShellDomain::UnpackLM(FEElement& el, vector<int>& lm)
 
 //-----------------------------------------------------------------------------
 //! Generate the G matrix for EAS method
-void FEElasticEASShellDomain::GenerateGMatrix(FEShellElementNew& el, const int n, const double Jeta, matrix& G)
+void FEElasticEASShellDomain::GenerateGMatrix(FEShellElementNew& el, const int n, const double Jeta, gmatrix& G)
 {
     vec3d Gcnt[3], Gcov[3];
     CoBaseVectors0(el, n, Gcov);
@@ -1154,7 +1163,7 @@ void FEElasticEASShellDomain::GenerateGMatrix(FEShellElementNew& el, const int n
     double G21 = Gcov[2]*Gcnt[1];
     double G22 = Gcov[2]*Gcnt[2];
     
-    matrix T0(6,6);
+    fixed_matrix<6,6> T0;
     T0(0,0) = G00*G00; T0(0,1) = G01*G01; T0(0,2) = G02*G02; T0(0,3) = G00*G01; T0(0,4) = G01*G02; T0(0,5) = G00*G02;
     T0(1,0) = G10*G10; T0(1,1) = G11*G11; T0(1,2) = G12*G12; T0(1,3) = G10*G11; T0(1,4) = G11*G12; T0(1,5) = G10*G12;
     T0(2,0) = G20*G20; T0(2,1) = G21*G21; T0(2,2) = G22*G22; T0(2,3) = G20*G21; T0(2,4) = G21*G22; T0(2,5) = G20*G22;
@@ -1162,7 +1171,6 @@ void FEElasticEASShellDomain::GenerateGMatrix(FEShellElementNew& el, const int n
     T0(4,0) = 2*G10*G20; T0(4,1) = 2*G11*G21; T0(4,2) = 2*G12*G22; T0(4,3) = G10*G21+G11*G20; T0(4,4) = G11*G22+G12*G21; T0(4,5) = G10*G22+G12*G20;
     T0(5,0) = 2*G00*G20; T0(5,1) = 2*G01*G21; T0(5,2) = 2*G02*G22; T0(5,3) = G00*G21+G01*G20; T0(5,4) = G01*G22+G02*G21; T0(5,5) = G00*G22+G02*G20;
     
-    G.resize(6, m_nEAS);
     double r = el.gr(n);
     double s = el.gs(n);
     double t = el.gt(n);
@@ -1219,9 +1227,8 @@ void FEElasticEASShellDomain::GenerateGMatrix(FEShellElementNew& el, const int n
 
 //-----------------------------------------------------------------------------
 //! Evaluate contravariant components of mat3ds tensor
-void FEElasticEASShellDomain::mat3dsCntMat61(const mat3ds s, const vec3d* Gcnt, matrix& S)
+void FEElasticEASShellDomain::mat3dsCntMat61(const mat3ds s, const vec3d* Gcnt, fixed_matrix<6,1>& S)
 {
-    S.resize(6, 1);
     S(0,0) = Gcnt[0]*(s*Gcnt[0]);
     S(1,0) = Gcnt[1]*(s*Gcnt[1]);
     S(2,0) = Gcnt[2]*(s*Gcnt[2]);
@@ -1234,9 +1241,8 @@ void FEElasticEASShellDomain::mat3dsCntMat61(const mat3ds s, const vec3d* Gcnt,
 //-----------------------------------------------------------------------------
 //! Evaluate contravariant components of tens4ds tensor
 //! Cijkl = Gj.(Gi.c.Gl).Gk
-void FEElasticEASShellDomain::tens4dsCntMat66(const tens4ds c, const vec3d* Gcnt, matrix& C)
+void FEElasticEASShellDomain::tens4dsCntMat66(const tens4ds c, const vec3d* Gcnt, fixed_matrix<6,6>& C)
 {
-    C.resize(6, 6);
     C(0,0) =          Gcnt[0]*(vdotTdotv(Gcnt[0], c, Gcnt[0])*Gcnt[0]);  // i=0, j=0, k=0, l=0
     C(0,1) = C(1,0) = Gcnt[0]*(vdotTdotv(Gcnt[0], c, Gcnt[1])*Gcnt[1]);  // i=0, j=0, k=1, l=1
     C(0,2) = C(2,0) = Gcnt[0]*(vdotTdotv(Gcnt[0], c, Gcnt[2])*Gcnt[2]);  // i=0, j=0, k=2, l=2
@@ -1264,9 +1270,8 @@ void FEElasticEASShellDomain::tens4dsCntMat66(const tens4ds c, const vec3d* Gcnt
 //-----------------------------------------------------------------------------
 //! Evaluate contravariant components of tens4dmm tensor
 //! Cijkl = Gj.(Gi.c.Gl).Gk
-void FEElasticEASShellDomain::tens4dmmCntMat66(const tens4dmm c, const vec3d* Gcnt, matrix& C)
+void FEElasticEASShellDomain::tens4dmmCntMat66(const tens4dmm c, const vec3d* Gcnt, fixed_matrix<6,6>& C)
 {
-    C.resize(6, 6);
     C(0,0) =          Gcnt[0]*(vdotTdotv(Gcnt[0], c, Gcnt[0])*Gcnt[0]);  // i=0, j=0, k=0, l=0
     C(0,1) = C(1,0) = Gcnt[0]*(vdotTdotv(Gcnt[0], c, Gcnt[1])*Gcnt[1]);  // i=0, j=0, k=1, l=1
     C(0,2) = C(2,0) = Gcnt[0]*(vdotTdotv(Gcnt[0], c, Gcnt[2])*Gcnt[2]);  // i=0, j=0, k=2, l=2
@@ -1307,8 +1312,8 @@ void FEElasticEASShellDomain::EvaluateEAS(FEShellElementNew& el, vector<double>&
     int nint = el.GaussPoints();
     int neln = el.Nodes();
     
-    vector<matrix> hu(neln, matrix(3,6));
-    vector<matrix> hw(neln, matrix(3,6));
+    vector<hmatrix> hu(neln);
+    vector<hmatrix> hw(neln);
     vector<vec3d> Nu(neln);
     vector<vec3d> Nw(neln);
     matrix NS(neln,16);
@@ -1319,11 +1324,12 @@ void FEElasticEASShellDomain::EvaluateEAS(FEShellElementNew& el, vector<double>&
     vec3d Gcnt[3];
     
     // Evaluate fa, Kua, Kwa, and Kaa by integrating over the element
-    el.m_fa.zero();
-    el.m_Kaai.zero();
+    fixed_matrix<NEAS,1> fa; fa.zero();
+    fixed_matrix<NEAS,NEAS> Kaa; Kaa.zero();
+    vector< fixed_matrix<3,NEAS> > Kua(neln), Kwa(neln);
     for (i=0; i< neln; ++i) {
-        el.m_Kua[i].zero();
-        el.m_Kwa[i].zero();
+        Kua[i].zero();
+        Kwa[i].zero();
     }
     
     // repeat for all integration points
@@ -1342,14 +1348,13 @@ void FEElasticEASShellDomain::EvaluateEAS(FEShellElementNew& el, vector<double>&
         detJt = detJ0(el, n);
         
         // generate G matrix for EAS method
-        matrix G;
+        gmatrix G;
         GenerateGMatrix(el, n, detJt, G);
         
         detJt *= gw[n];
         
         // Evaluate enhancing strain ES (covariant components)
-        matrix ES(6,1);
-        ES = G*el.m_alpha;
+        fixed_matrix<6,1> ES = G*fixed_matrix<NEAS,1>(el.m_alpha);
         // Evaluate the tensor form of ES
         mat3ds Es = ((Gcnt[0] & Gcnt[0])*ES(0,0) + (Gcnt[1] & Gcnt[1])*ES(1,0) + (Gcnt[2] & Gcnt[2])*ES(2,0) +
                      ((Gcnt[0] & Gcnt[1]) + (Gcnt[1] & Gcnt[0]))*(ES(3,0)/2) +
@@ -1360,27 +1365,22 @@ void FEElasticEASShellDomain::EvaluateEAS(FEShellElementNew& el, vector<double>&
         
         // get the stress tensor for this integration point and evaluate its contravariant components
         S[n] = m_pMat->PK2Stress(mp, el.m_E[n]);
-        matrix SM;
+        fixed_matrix<6,1> SM;
         mat3dsCntMat61(S[n], Gcnt, SM);
         
         // get the material tangent
         c[n] = m_pMat->MaterialTangent(mp, el.m_E[n]);
         // get contravariant components of material tangent
-        matrix CC;
+        fixed_matrix<6,6> CC;
         tens4dmmCntMat66(c[n], Gcnt, CC);
 //        tens4dsCntMat66(c[n], Gcnt, CC);
         
         // Evaluate fa
-        matrix tmp(m_nEAS,1);
-        tmp = G.transpose()*SM;
-        tmp *= detJt;
-        el.m_fa += tmp;
+        fa += G.transpose_mult(SM)*detJt;
         
         // Evaluate Kaa
-        matrix Tmpa(m_nEAS,m_nEAS);
-        Tmpa = G.transpose()*CC*G;
-        Tmpa *= detJt;
-        el.m_Kaai += Tmpa;
+        gmatrix CG = CC*G;
+        Kaa += G.transpose_mult(CG)*detJt;
         
         eta = el.gt(n);
         Mr = el.Hr(n);
@@ -1388,19 +1388,21 @@ void FEElasticEASShellDomain::EvaluateEAS(FEShellElementNew& el, vector<double>&
         M  = el.H(n);
         
         // Evaluate Kua and Kwa
-        matrix Tmp(3,m_nEAS);
         for (i=0; i<neln; ++i)
         {
-            Tmp = hu[i]*CC*G;
-            Tmp *= detJt;
-            el.m_Kua[i] += Tmp;
-            Tmp = hw[i]*CC*G;
-            Tmp *= detJt;
-            el.m_Kwa[i] += Tmp;
+            Kua[i] += (hu[i]*CG)*detJt;
+            Kwa[i] += (hw[i]*CG)*detJt;
         }
     }
-    // invert Kaa
-    el.m_Kaai = el.m_Kaai.inverse();
+    
+    // store the element's EAS matrices and invert Kaa
+    fa.copy_to(el.m_fa);
+    Kaa.inverse().copy_to(el.m_Kaai);
+    for (i=0; i<neln; ++i)
+    {
+        Kua[i].copy_to(el.m_Kua[i]);
+        Kwa[i].copy_to(el.m_Kwa[i]);
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -1569,7 +1571,7 @@ void FEElasticEASShellDomain::CollocationStrainsANS(FEShellElementNew& el, vecto
 //-----------------------------------------------------------------------------
 //! Evaluate assumed natural strain (ANS)
 void FEElasticEASShellDomain::EvaluateANS(FEShellElementNew& el, const int n, const vec3d* Gcnt,
-                                       mat3ds& Ec, vector<matrix>& hu, vector<matrix>& hw,
+                                       mat3ds& Ec, vector<hmatrix>& hu, vector<hmatrix>& hw,
                                        vector<double>& E, vector< vector<vec3d>>& HU, vector< vector<vec3d>>& HW)
 {
     // ANS method for 4-node quadrilaterials
@@ -1633,7 +1635,7 @@ void FEElasticEASShellDomain::EvaluateANS(FEShellElementNew& el, const int n, co
 //-----------------------------------------------------------------------------
 //! Evaluate strain E and matrix hu and hw
 void FEElasticEASShellDomain::EvaluateEh(FEShellElementNew& el, const int n, const vec3d* Gcnt, mat3ds& E,
-                                      vector<matrix>& hu, vector<matrix>& hw, vector<vec3d>& Nu, vector<vec3d>& Nw)
+                                      vector<hmatrix>& hu, vector<hmatrix>& hw, vector<vec3d>& Nu, vector<vec3d>& Nw)
 {
     const double* Mr, *Ms, *M;
     vec3d gcov[3];
@@ -30,11 +30,20 @@ SOFTWARE.*/
 #include "FESSIShellDomain.h"
 #include "FEElasticDomain.h"
 #include "FESolidMaterial.h"
+#include <FECore/fixed_matrix.h>
 
 //-----------------------------------------------------------------------------
 //! Domain described by 3D shell elements
 class FEBIOMECH_API FEElasticEASShellDomain : public FESSIShellDomain, public FEElasticDomain
 {
+public:
+    // number of enhanced strain parameters
+    enum { NEAS = 7 };
+
+    // small matrices used by the element kernels
+    typedef fixed_matrix<3, 6>      hmatrix;
+    typedef fixed_matrix<6, NEAS>   gmatrix;
+
 public:
     FEElasticEASShellDomain(FEModel* pfem);
     
@@ -89,7 +98,7 @@ public: // overrides from FEElasticDomain
     void BodyForceStiffness(FELinearSystem& LS, FEBodyForce& bf) override;
     
     // evaluate strain E and matrix hu and hw
-	void EvaluateEh(FEShellElementNew& el, const int n, const vec3d* Gcnt, mat3ds& E, vector<matrix>& hu, vector<matrix>& hw, vector<vec3d>& Nu, vector<vec3d>& Nw);
+	void EvaluateEh(FEShellElementNew& el, const int n, const vec3d* Gcnt, mat3ds& E, vector<hmatrix>& hu, vector<hmatrix>& hw, vector<vec3d>& Nu, vector<vec3d>& Nw);
     
 public:
     
@@ -120,14 +129,14 @@ public:
     // --- E A S  M E T H O D ---
     
     // Generate the G matrix for the EAS method
-	void GenerateGMatrix(FEShellElementNew& el, const int n, const double Jeta, matrix& G);
+	void GenerateGMatrix(FEShellElementNew& el, const int n, const double Jeta, gmatrix& G);
     
     // Evaluate contravariant components of mat3ds tensor
-    void mat3dsCntMat61(const mat3ds s, const vec3d* Gcnt, matrix& S);
+    void mat3dsCntMat61(const mat3ds s, const vec3d* Gcnt, fixed_matrix<6,1>& S);
     
     // Evaluate contravariant components of tens4ds tensor
-    void tens4dsCntMat66(const tens4ds c, const vec3d* Gcnt, matrix& C);
-    void tens4dmmCntMat66(const tens4dmm c, const vec3d* Gcnt, matrix& C);
+    void tens4dsCntMat66(const tens4ds c, const vec3d* Gcnt, fixed_matrix<6,6>& C);
+    void tens4dmmCntMat66(const tens4dmm c, const vec3d* Gcnt, fixed_matrix<6,6>& C);
 
     // Evaluate the matrices and vectors relevant to the EAS method
 	void EvaluateEAS(FEShellElementNew& el, vector<double>& E, vector< vector<vec3d>>& HU, vector< vector<vec3d>>& HW, vector<mat3ds>& S, vector<tens4dmm>& c);
@@ -135,7 +144,7 @@ public:
     // Evaluate the strain using the ANS method
 	void CollocationStrainsANS(FEShellElementNew& el, vector<double>& E, vector< vector<vec3d>>& HU, vector< vector<vec3d>>& HW, matrix& NS, matrix& NN);
     
-	void EvaluateANS(FEShellElementNew& el, const int n, const vec3d* Gcnt, mat3ds& Ec, vector<matrix>& hu, vector<matrix>& hw, vector<double>& E, vector< vector<vec3d>>& HU, vector< vector<vec3d>>& HW);
+	void EvaluateANS(FEShellElementNew& el, const int n, const vec3d* Gcnt, mat3ds& Ec, vector<hmatrix>& hu, vector<hmatrix>& hw, vector<double>& E, vector< vector<vec3d>>& HU, vector< vector<vec3d>>& HW);
     
     // Update alpha in EAS method
     void UpdateEAS(vector<double>& ui) override;
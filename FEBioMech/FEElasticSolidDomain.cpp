@@ -254,7 +254,7 @@ void FEElasticSolidDomain::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
 	// dofs for interface nodes (see UnpackLM). Is that an issue?
 
 	// evaluate the residual contribution
-	LoadVector(R, m_dofU, [=](FEMaterialPoint& mp, int node_a, std::vector<double>& fa) {
+	LoadVector<3>(R, m_dofU, [=](FEMaterialPoint& mp, int node_a, double* fa) {
 
 		// evaluate density
 		double density = m_pMat->Density(mp);
@@ -461,7 +461,7 @@ void FEElasticSolidDomain::MassMatrix(FELinearSystem& LS, double scale)
 	// dofs for interface nodes (see UnpackLM). Is that an issue?
 
 	// evaluate body force stiffness
-	LoadStiffness(LS, m_dofU, m_dofU, [=](FEMaterialPoint& mp, int node_a, int node_b, matrix& Kab) {
+	LoadStiffness<3, 3>(LS, m_dofU, m_dofU, [=](FEMaterialPoint& mp, int node_a, int node_b, fixed_matrix<3, 3>& Kab) {
 
 		// density
 		double density = m_pMat->Density(mp);
@@ -492,7 +492,7 @@ void FEElasticSolidDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& b
 	// dofs for interface nodes (see UnpackLM). Is that an issue?
 
 	// evaluate body force stiffness
-	LoadStiffness(LS, m_dofU, m_dofU, [=](FEMaterialPoint& mp, int node_a, int node_b, matrix& Kab) {
+	LoadStiffness<3, 3>(LS, m_dofU, m_dofU, [=](FEMaterialPoint& mp, int node_a, int node_b, fixed_matrix<3, 3>& Kab) {
 
 		// loop over integration points
 		double detJ = mp.m_J0 * m_alphaf;
@@ -507,7 +507,7 @@ void FEElasticSolidDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& b
 		double* H = mp.m_shape;
 
 		// put it together
-		Kab = K*(-H[node_a] * H[node_b] * dens_n*detJ);
+		Kab.set(0, 0, K*(-H[node_a] * H[node_b] * dens_n*detJ));
 	});
 }
 
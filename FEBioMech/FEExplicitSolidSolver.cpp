@@ -44,12 +44,19 @@ SOFTWARE.*/
 #include <FECore/FELinearConstraintManager.h>
 #include "FEResidualVector.h"
 #include "FEBioMech.h"
+#include <algorithm>
+#include <float.h>
 
 //-----------------------------------------------------------------------------
 // define the parameter list
 BEGIN_FECORE_CLASS(FEExplicitSolidSolver, FESolver)
 	ADD_PARAMETER(m_mass_lumping, "mass_lumping");
 	ADD_PARAMETER(m_dyn_damping, "dyn_damping");
+	ADD_PARAMETER(m_printNorms, "print_norms");
+	ADD_PARAMETER(m_dtScale, "dt_scale");
+	ADD_PARAMETER(m_subcycling, "subcycling");
+	ADD_PARAMETER(m_maxLevels, "max_subcycle_levels");
+	ADD_PARAMETER(m_massScaling, "mass_scaling");
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
@@ -59,11 +66,24 @@ FEExplicitSolidSolver::FEExplicitSolidSolver(FEModel* pfem) :
 	m_dofSU(pfem), m_dofSV(pfem), m_dofSA(pfem)
 {
 	m_dyn_damping = 0.99;
+	m_printNorms = false;
+	m_dtScale = 0.9;
+	m_subcycling = false;
+	m_maxLevels = 4;
+	m_massScaling = 0.0;
+	m_dtStable = 0.0;
 	m_niter = 0;
 	m_nreq = 0;
 
+	m_bsubcycle = false;
+	m_nlevels = 1;
+	m_levelDt = 0.0;
+
 	m_mass_lumping = HRZ_LUMPING;
 
+	// the residual is reduced before it is read (see FE_ASSEMBLE_REDUCE)
+	m_breduceAssembly = true;
+
 	// Allocate degrees of freedom
 	DOFS& dofs = pfem->GetDOFS();
 	int varD = dofs.AddVariable("displacement", VAR_VEC3);
@@ -169,12 +189,13 @@ bool FEExplicitSolidSolver::CalculateMassMatrix()
 					}
 
 					// reduce to a lumped mass vector and add up the total
+					double sf = (m_mscale[nd].empty() ? 1.0 : m_mscale[nd][iel]);
 					el_lumped_mass.assign(3 * neln, 0.0);
 					for (int i = 0; i < neln; ++i)
 					{
 						for (int j = 0; j < neln; ++j)
 						{
-							double kab = me[i][j];
+							double kab = me[i][j]*sf;
 							el_lumped_mass[3 * i] += kab;
 							el_lumped_mass[3 * i + 1] += kab;
 							el_lumped_mass[3 * i + 2] += kab;
@@ -271,10 +292,11 @@ bool FEExplicitSolidSolver::CalculateMassMatrix()
 					for (int i = 0; i < neln; ++i) S += me[i][i];
 
 					// reduce to a lumped mass vector and add up the total
+					double sf = (m_mscale[nd].empty() ? 1.0 : m_mscale[nd][iel]);
 					el_lumped_mass.assign(3 * neln, 0.0);
 					for (int i = 0; i < neln; ++i)
 					{
-						double mab = me[i][i] * Me / S;
+						double mab = me[i][i] * Me / S * sf;
 						el_lumped_mass[3 * i    ] = mab;
 						el_lumped_mass[3 * i + 1] = mab;
 						el_lumped_mass[3 * i + 2] = mab;
@@ -344,6 +366,9 @@ bool FEExplicitSolidSolver::CalculateMassMatrix()
 		return false;
 	}
 
+	// add the recorded contributions before the masses are read
+	Mi.Reduce();
+
 	// we need the inverse of the lumped masses later
 	// Also, make sure the lumped masses are positive.
 	for (int i = 0; i < m_Mi.size(); ++i)
@@ -355,6 +380,302 @@ bool FEExplicitSolidSolver::CalculateMassMatrix()
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+//! Estimates the critical time step of each solid element from the dilatational
+//! wave speed of its material and its characteristic length. The wave speed
+//! is evaluated from the diagonal of the material tangent in the current
+//! (usually the initial) configuration. The characteristic length is the
+//! smallest distance between two element nodes, or the smallest altitude for
+//! tetrahedral elements. When mass scaling is requested, the density of the
+//! most critical elements is increased so that their time step is raised
+//! toward the analysis time step, without exceeding the allowed added mass.
+bool FEExplicitSolidSolver::EstimateTimeSteps()
+{
+	FEModel& fem = *GetFEModel();
+	FEMesh& mesh = fem.GetMesh();
+	const int ND = mesh.Domains();
+
+	m_dte.assign(ND, vector<double>());
+	m_mscale.assign(ND, vector<double>());
+	m_dtStable = DBL_MAX;
+
+	// element masses (needed for mass scaling)
+	vector< vector<double> > emass(ND);
+	double Mtot = 0.0;
+
+	for (int nd = 0; nd < ND; ++nd)
+	{
+		FEElasticSolidDomain* pbd = dynamic_cast<FEElasticSolidDomain*>(&mesh.Domain(nd));
+		if (pbd == nullptr) continue;
+
+		FESolidMaterial* pme = dynamic_cast<FESolidMaterial*>(pbd->GetMaterial());
+		if (pme == nullptr) continue;
+
+		const int NE = pbd->Elements();
+		m_dte[nd].assign(NE, DBL_MAX);
+		m_mscale[nd].assign(NE, 1.0);
+		emass[nd].assign(NE, 0.0);
+
+		for (int iel = 0; iel < NE; ++iel)
+		{
+			FESolidElement& el = pbd->Element(iel);
+			if (el.isActive() == false) continue;
+
+			// element mass and largest squared wave speed
+			double Me = 0.0, c2 = 0.0;
+			double* w = el.GaussWeights();
+			for (int n = 0; n < el.GaussPoints(); ++n)
+			{
+				FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+				double d = pme->Density(mp);
+				Me += d*pbd->detJ0(el, n)*w[n];
+
+				tens4ds C = pme->Tangent(mp);
+				double Cm = C(0, 0);
+				if (C(1, 1) > Cm) Cm = C(1, 1);
+				if (C(2, 2) > Cm) Cm = C(2, 2);
+				if ((d > 0.0) && (Cm / d > c2)) c2 = Cm / d;
+			}
+			emass[nd][iel] = Me;
+			Mtot += Me;
+			if (c2 <= 0.0) continue;
+
+			// characteristic length
+			const int neln = el.Nodes();
+			vec3d r[FEElement::MAX_NODES];
+			for (int i = 0; i < neln; ++i) r[i] = mesh.Node(el.m_node[i]).m_rt;
+
+			double L = DBL_MAX;
+			for (int i = 0; i < neln; ++i)
+				for (int j = i + 1; j < neln; ++j)
+				{
+					double Lij = (r[j] - r[i]).norm();
+					if (Lij < L) L = Lij;
+				}
+
+			int shape = el.Shape();
+			if ((shape == ET_TET4) || (shape == ET_TET5) || (shape == ET_TET10) || (shape == ET_TET15) || (shape == ET_TET20))
+			{
+				// altitude of each corner node over the opposite face
+				double V6 = fabs((r[1] - r[0])*((r[2] - r[0]) ^ (r[3] - r[0])));
+				const int face[4][3] = { { 1, 2, 3 }, { 0, 2, 3 }, { 0, 1, 3 }, { 0, 1, 2 } };
+				for (int i = 0; i < 4; ++i)
+				{
+					const int* f = face[i];
+					double A2 = ((r[f[1]] - r[f[0]]) ^ (r[f[2]] - r[f[0]])).norm();
+					if ((A2 > 0.0) && (V6 / A2 < L)) L = V6 / A2;
+				}
+			}
+
+			double dte = m_dtScale*L / sqrt(c2);
+			m_dte[nd][iel] = dte;
+			if (dte < m_dtStable) m_dtStable = dte;
+		}
+	}
+
+	feLog("\n\tEstimated stable time step ............ : %lg\n", m_dtStable);
+
+	// selective mass scaling
+	FEAnalysis* step = fem.GetCurrentStep();
+	if ((m_massScaling > 0.0) && (Mtot > 0.0) && step && (m_dtStable < step->m_dt0))
+	{
+		const double dtTarget = step->m_dt0;
+
+		// sort the elements by their time step
+		vector< std::pair<double, double> > elist;
+		for (int nd = 0; nd < ND; ++nd)
+			for (size_t i = 0; i < m_dte[nd].size(); ++i)
+				if (m_dte[nd][i] < DBL_MAX) elist.push_back(std::pair<double, double>(m_dte[nd][i], emass[nd][i]));
+		std::sort(elist.begin(), elist.end());
+
+		// Scaling the elements with dt_e < dt to a time step dt adds the mass
+		// sum(m_e*((dt/dt_e)^2 - 1)). Find the largest dt for which this does
+		// not exceed the budget.
+		double S1 = 0.0, S2 = 0.0, dts = 0.0;
+		const double Madd = m_massScaling*Mtot;
+		for (size_t i = 0; i < elist.size(); ++i)
+		{
+			const double dti = elist[i].first;
+			S1 += elist[i].second;
+			S2 += elist[i].second / (dti*dti);
+
+			double dtnext = (i + 1 < elist.size() ? elist[i + 1].first : DBL_MAX);
+			double dtmax = (dtnext < dtTarget ? dtnext : dtTarget);
+			double dt = sqrt((Madd + S1) / S2);
+			if (dt <= dtmax) { dts = dt; break; }
+			if (dtTarget <= dtnext) { dts = dtTarget; break; }
+		}
+
+		// apply the scale factors
+		int nscaled = 0;
+		double Mscaled = 0.0;
+		m_dtStable = DBL_MAX;
+		for (int nd = 0; nd < ND; ++nd)
+			for (size_t i = 0; i < m_dte[nd].size(); ++i)
+			{
+				double& dte = m_dte[nd][i];
+				if (dte < dts)
+				{
+					double sf = (dts / dte)*(dts / dte);
+					m_mscale[nd][i] = sf;
+					Mscaled += (sf - 1.0)*emass[nd][i];
+					dte = dts;
+					nscaled++;
+				}
+				if (dte < m_dtStable) m_dtStable = dte;
+			}
+
+		feLog("\tMass scaling\n");
+		feLog("\t   Number of scaled elements ......... : %d\n", nscaled);
+		feLog("\t   Added mass (percentage) ........... : %lg\n", 100.0*Mscaled / Mtot);
+		feLog("\t   Stable time step after scaling .... : %lg\n", m_dtStable);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! Subcycling is only supported when all the forces come from the solid
+//! elements and the nodal loads, since these are the only contributions that
+//! are evaluated at the intermediate substeps.
+bool FEExplicitSolidSolver::CanSubcycle()
+{
+	FEMechModel& fem = static_cast<FEMechModel&>(*GetFEModel());
+	FEMesh& mesh = fem.GetMesh();
+
+	const char* szfeature = nullptr;
+	if      (fem.RigidBodies() > 0) szfeature = "rigid bodies";
+	else if (fem.SurfacePairConstraints() > 0) szfeature = "contact";
+	else if (fem.NonlinearConstraints() > 0) szfeature = "nonlinear constraints";
+	else if (fem.GetLinearConstraintManager().LinearConstraints() > 0) szfeature = "linear constraints";
+	else if (fem.SurfaceLoads() > 0) szfeature = "surface loads";
+	else if (fem.BodyLoads() > 0) szfeature = "body loads";
+	else
+	{
+		for (int i = 0; i < mesh.Domains(); ++i)
+		{
+			if (strcmp(mesh.Domain(i).GetTypeStr(), "elastic-solid") != 0)
+			{
+				szfeature = "domains other than elastic solids";
+				break;
+			}
+		}
+	}
+
+	if (szfeature)
+	{
+		feLogWarning("Subcycling is not supported for models with %s.\nAll elements will use the same time step.", szfeature);
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! Each element is assigned the smallest level k for which dt/2^k does not 
+//! exceed its critical time step. A node is advanced with the step of the 
+//! finest element it is connected to, and an element is evaluated at the rate 
+//! of its finest node, so that the forces of a node are complete whenever it
+//! is updated.
+void FEExplicitSolidSolver::AssignLevels(double dt)
+{
+	m_levelDt = dt;
+	m_nlevels = 1;
+
+	if (m_bsubcycle == false)
+	{
+		if (dt > m_dtStable) feLogWarning("The time step (%lg) exceeds the estimated stable time step (%lg).", dt, m_dtStable);
+		return;
+	}
+
+	FEMesh& mesh = GetFEModel()->GetMesh();
+	const int NN = mesh.Nodes();
+	const int ND = mesh.Domains();
+
+	// node levels
+	int nunstable = 0;
+	m_nodeLevel.assign(NN, 0);
+	for (int nd = 0; nd < ND; ++nd)
+	{
+		if (m_dte[nd].empty()) continue;
+		FEElasticSolidDomain& dom = static_cast<FEElasticSolidDomain&>(mesh.Domain(nd));
+		for (int iel = 0; iel < dom.Elements(); ++iel)
+		{
+			FESolidElement& el = dom.Element(iel);
+			if (el.isActive() == false) continue;
+
+			double dte = m_dte[nd][iel];
+			int k = 0;
+			while ((k < m_maxLevels) && (dt / (1 << k) > dte)) ++k;
+			if (dt / (1 << k) > dte) nunstable++;
+
+			for (int i = 0; i < el.Nodes(); ++i)
+			{
+				int& nl = m_nodeLevel[el.m_node[i]];
+				if (k > nl) nl = k;
+			}
+		}
+	}
+
+	int K = 0;
+	for (int i = 0; i < NN; ++i) if (m_nodeLevel[i] > K) K = m_nodeLevel[i];
+	m_nlevels = K + 1;
+
+	m_levelElems.assign(m_nlevels, vector< std::pair<int, int> >());
+	m_levelNodes.assign(m_nlevels, vector<int>());
+	m_levelElemNodes.assign(m_nlevels, vector<int>());
+
+	// element levels
+	for (int nd = 0; nd < ND; ++nd)
+	{
+		if (m_dte[nd].empty()) continue;
+		FEElasticSolidDomain& dom = static_cast<FEElasticSolidDomain&>(mesh.Domain(nd));
+		for (int iel = 0; iel < dom.Elements(); ++iel)
+		{
+			FESolidElement& el = dom.Element(iel);
+			if (el.isActive() == false) continue;
+
+			int l = 0;
+			for (int i = 0; i < el.Nodes(); ++i) if (m_nodeLevel[el.m_node[i]] > l) l = m_nodeLevel[el.m_node[i]];
+			m_levelElems[l].push_back(std::pair<int, int>(nd, iel));
+		}
+	}
+
+	// node lists
+	vector<int> tag(NN, -1);
+	for (int l = 0; l < m_nlevels; ++l)
+	{
+		for (size_t i = 0; i < m_levelElems[l].size(); ++i)
+		{
+			FEElasticSolidDomain& dom = static_cast<FEElasticSolidDomain&>(mesh.Domain(m_levelElems[l][i].first));
+			FESolidElement& el = dom.Element(m_levelElems[l][i].second);
+			for (int j = 0; j < el.Nodes(); ++j)
+			{
+				int n = el.m_node[j];
+				if (tag[n] != l) { tag[n] = l; m_levelElemNodes[l].push_back(n); }
+			}
+		}
+	}
+	for (int i = 0; i < NN; ++i) m_levelNodes[m_nodeLevel[i]].push_back(i);
+
+	if (m_nlevels > 1)
+	{
+		m_db.assign(m_neq, 0.0);
+		m_Fs.assign(m_neq, 0.0);
+	}
+
+	feLog("\tSubcycle levels for time step %lg\n", dt);
+	for (int l = 0; l < m_nlevels; ++l)
+	{
+		feLog("\t   level %d (dt = %lg): %d elements, %d nodes\n", l, dt / (1 << l), (int)m_levelElems[l].size(), (int)m_levelNodes[l].size());
+	}
+
+	if (nunstable > 0)
+	{
+		feLogWarning("%d elements need more than %d subcycle levels.\nThe time step may be unstable.", nunstable, m_maxLevels);
+	}
+}
+
 //-----------------------------------------------------------------------------
 bool FEExplicitSolidSolver::Init()
 {
@@ -369,6 +690,8 @@ bool FEExplicitSolidSolver::Init()
 	m_ui.assign(neq, 0);
 	m_Ut.assign(neq, 0);
 	m_Mi.assign(neq, 0.0);
+	m_vh.assign(neq, 0.0);
+	m_R1.assign(neq, 0.0);
 
 	GetFEModel()->Update();
 
@@ -385,6 +708,14 @@ bool FEExplicitSolidSolver::Init()
 	gather(m_Ut, mesh, m_dofSU[1]);
 	gather(m_Ut, mesh, m_dofSU[2]);
 
+	// estimate the element time steps (this also determines the mass scale factors)
+	if (EstimateTimeSteps() == false) return false;
+
+	// see if we can use subcycling
+	m_bsubcycle = (m_subcycling ? CanSubcycle() : false);
+	m_levelDt = 0.0;
+	m_nlevels = 1;
+
 	// calculate the inverse mass vector for the explicit analysis
 	if (CalculateMassMatrix() == false)
 	{
@@ -448,23 +779,20 @@ void FEExplicitSolidSolver::UpdateKinematics(vector<double>& ui)
 	// update rigid bodies
 	UpdateRigidBodies(ui);
 
-	// total displacements
-	vector<double> U(m_Ut.size());
-	for (size_t i=0; i<m_Ut.size(); ++i) U[i] = ui[i] + m_Ut[i];
-
-	// update flexible nodes
-	// translational dofs
-	scatter(U, mesh, m_dofU[0]);
-	scatter(U, mesh, m_dofU[1]);
-	scatter(U, mesh, m_dofU[2]);
-	// rotational dofs
-	scatter(U, mesh, m_dofSQ[0]);
-	scatter(U, mesh, m_dofSQ[1]);
-	scatter(U, mesh, m_dofSQ[2]);
-	// shell displacement
-	scatter(U, mesh, m_dofSU[0]);
-	scatter(U, mesh, m_dofSU[1]);
-	scatter(U, mesh, m_dofSU[2]);
+	// update flexible nodes with the total displacements
+	const int NN = mesh.Nodes();
+	#pragma omp parallel for
+	for (int i = 0; i < NN; ++i)
+	{
+		FENode& node = mesh.Node(i);
+		for (int j = 0; j < 3; ++j)
+		{
+			int n;
+			if ((n = node.m_ID[m_dofU [j]]) >= 0) node.set(m_dofU [j], ui[n] + m_Ut[n]);
+			if ((n = node.m_ID[m_dofSQ[j]]) >= 0) node.set(m_dofSQ[j], ui[n] + m_Ut[n]);
+			if ((n = node.m_ID[m_dofSU[j]]) >= 0) node.set(m_dofSU[j], ui[n] + m_Ut[n]);
+		}
+	}
 
 	// make sure the prescribed displacements are fullfilled
 	int ndis = fem.BoundaryConditions();
@@ -485,7 +813,8 @@ void FEExplicitSolidSolver::UpdateKinematics(vector<double>& ui)
 
 	// Update the spatial nodal positions
 	// Don't update rigid nodes since they are already updated
-	for (int i=0; i<mesh.Nodes(); ++i)
+	#pragma omp parallel for
+	for (int i=0; i<NN; ++i)
 	{
 		FENode& node = mesh.Node(i);
 		if (node.m_rid == -1)
@@ -665,7 +994,9 @@ void FEExplicitSolidSolver::PrepStep()
 	// we need them for velocity and acceleration calculations
 	FEMechModel& fem = static_cast<FEMechModel&>(*GetFEModel());
 	FEMesh& mesh = fem.GetMesh();
-	for (i=0; i<mesh.Nodes(); ++i)
+	const int NN = mesh.Nodes();
+	#pragma omp parallel for
+	for (i=0; i<NN; ++i)
 	{
 		FENode& ni = mesh.Node(i);
 		ni.m_rp = ni.m_rt;
@@ -679,9 +1010,9 @@ void FEExplicitSolidSolver::PrepStep()
 	// apply concentrated nodal forces
 	// since these forces do not depend on the geometry
 	// we can do this once outside the NR loop.
-	vector<double> dummy(m_neq, 0.0);
+	// (The reaction forces are reset when the residual is evaluated, so m_Fr can take the dummy contributions.)
 	zero(m_Fn);
-	FEResidualVector Fn(*GetFEModel(), m_Fn, dummy);
+	FEResidualVector Fn(*GetFEModel(), m_Fn, m_Fr);
 	NodalLoads(Fn, tp);
 
 	// apply prescribed displacements
@@ -795,102 +1126,283 @@ void FEExplicitSolidSolver::PrepStep()
 	}
 
 	// intialize material point data
+	// NOTE: The model is not updated here. The stresses would be evaluated at the
+	//       old configuration and DoSolve updates the model before they are needed.
 	for (i=0; i<mesh.Domains(); ++i) mesh.Domain(i).PreSolveUpdate(tp);
-
-	fem.Update();
 }
 
 //-----------------------------------------------------------------------------
+//! Advances the solution with one central difference step. The per-step work
+//! is done in fused passes over the nodes that read and write the nodal values
+//! directly, using persistent work vectors, so that no allocations are needed.
 bool FEExplicitSolidSolver::DoSolve()
 {
 	// Get the current step
 	FEModel& fem = *GetFEModel();
-	FEAnalysis* pstep = fem.GetCurrentStep();
 
 	// prepare for solve
 	PrepStep();
 
-//	feLog(" %d\n", m_niter+1);
-
 	// get the mesh
 	FEMesh& mesh = fem.GetMesh();
-	int N = mesh.Nodes(); // this is the total number of nodes in the mesh
-    double dt = fem.GetTime().timeIncrement;
+	const int NN = mesh.Nodes();
+	const double dt = fem.GetTime().timeIncrement;
 
-	// collect accelerations, velocities, displacements
-	vector<double> an(m_neq, 0.0), vn(m_neq, 0.0), un(m_neq, 0.0);
-	for (int i = 0; i < mesh.Nodes(); ++i)
+	// (re)assign the subcycle levels when the time step changes
+	if (dt != m_levelDt) AssignLevels(dt);
+	if (m_nlevels > 1) return SubcycleStep();
+
+	// velocity predictor and displacement increment
+	// (Only the nodal equations are predicted, all others have zero increments.)
+	vector<double>& vh = m_vh;
+	vector<double>& ui = m_ui;
+	zero(ui);
+	#pragma omp parallel for
+	for (int i = 0; i < NN; ++i)
 	{
 		FENode& node = mesh.Node(i);
 		vec3d vt = node.get_vec3d(m_dofV[0], m_dofV[1], m_dofV[2]);
 		int n;
-		if ((n = node.m_ID[m_dofU[0]]) >= 0) { un[n] = node.m_rt.x - node.m_r0.x; vn[n] = vt.x; an[n] = node.m_at.x; }
-		if ((n = node.m_ID[m_dofU[1]]) >= 0) { un[n] = node.m_rt.y - node.m_r0.y; vn[n] = vt.y; an[n] = node.m_at.y; }
-		if ((n = node.m_ID[m_dofU[2]]) >= 0) { un[n] = node.m_rt.z - node.m_r0.z; vn[n] = vt.z; an[n] = node.m_at.z; }
+		if ((n = node.m_ID[m_dofU[0]]) >= 0) { vh[n] = vt.x + node.m_at.x*dt*0.5; ui[n] = dt*vh[n]; }
+		if ((n = node.m_ID[m_dofU[1]]) >= 0) { vh[n] = vt.y + node.m_at.y*dt*0.5; ui[n] = dt*vh[n]; }
+		if ((n = node.m_ID[m_dofU[2]]) >= 0) { vh[n] = vt.z + node.m_at.z*dt*0.5; ui[n] = dt*vh[n]; }
 
-		if ((n = node.m_ID[m_dofSU[0]]) >= 0) { un[n] = node.get(m_dofSU[0]); vn[n] = node.get(m_dofSV[0]); an[n] = node.get(m_dofSA[0]); }
-		if ((n = node.m_ID[m_dofSU[1]]) >= 0) { un[n] = node.get(m_dofSU[1]); vn[n] = node.get(m_dofSV[1]); an[n] = node.get(m_dofSA[1]); }
-		if ((n = node.m_ID[m_dofSU[2]]) >= 0) { un[n] = node.get(m_dofSU[2]); vn[n] = node.get(m_dofSV[2]); an[n] = node.get(m_dofSA[2]); }
-	}
-
-	// velocity predictor
-	vector<double> v_pred(m_neq, 0.0);
-	for (int i = 0; i < m_neq; ++i)
-	{
-		v_pred[i] = vn[i] + an[i] * dt*0.5;
+		if ((n = node.m_ID[m_dofSU[0]]) >= 0) { vh[n] = node.get(m_dofSV[0]) + node.get(m_dofSA[0])*dt*0.5; ui[n] = dt*vh[n]; }
+		if ((n = node.m_ID[m_dofSU[1]]) >= 0) { vh[n] = node.get(m_dofSV[1]) + node.get(m_dofSA[1])*dt*0.5; ui[n] = dt*vh[n]; }
+		if ((n = node.m_ID[m_dofSU[2]]) >= 0) { vh[n] = node.get(m_dofSV[2]) + node.get(m_dofSA[2])*dt*0.5; ui[n] = dt*vh[n]; }
 	}
+	if (m_printNorms) feLog("\t displacement norm : %lg\n", sqrt(ui*ui));
 
 	// update displacements
-	for (int i = 0; i < m_neq; ++i)
-	{
-		m_ui[i] = dt * v_pred[i];
-	}
-	double Dnorm = sqrt(m_ui * m_ui);
-	feLog("\t displacement norm : %lg\n", Dnorm);
-	Update(m_ui);
+	Update(ui);
 
 	// evaluate acceleration
 	Residual(m_R1);
-	double Rnorm = sqrt(m_R1 * m_R1);
-	feLog("\t force vector norm : %lg\n", Rnorm);
+	if (m_printNorms) feLog("\t force vector norm : %lg\n", sqrt(m_R1*m_R1));
 
-	vector<double> anp1(m_neq);
-	for (int i = 0; i < m_neq; ++i)
+	// update accelerations, velocities and total displacements
+	const vector<double>& R = m_R1;
+	#pragma omp parallel for
+	for (int i = 0; i < NN; ++i)
 	{
-		anp1[i] = m_R1[i] * m_Mi[i];
+		FENode& node = mesh.Node(i);
+		int n;
+		double a;
+		if ((n = node.m_ID[m_dofU[0]]) >= 0) { a = R[n] * m_Mi[n]; node.set(m_dofV[0], vh[n] + a*dt*0.5); node.m_at.x = a; m_Ut[n] += ui[n]; }
+		if ((n = node.m_ID[m_dofU[1]]) >= 0) { a = R[n] * m_Mi[n]; node.set(m_dofV[1], vh[n] + a*dt*0.5); node.m_at.y = a; m_Ut[n] += ui[n]; }
+		if ((n = node.m_ID[m_dofU[2]]) >= 0) { a = R[n] * m_Mi[n]; node.set(m_dofV[2], vh[n] + a*dt*0.5); node.m_at.z = a; m_Ut[n] += ui[n]; }
+
+		if ((n = node.m_ID[m_dofSU[0]]) >= 0) { a = R[n] * m_Mi[n]; node.set(m_dofSV[0], vh[n] + a*dt*0.5); node.set(m_dofSA[0], a); m_Ut[n] += ui[n]; }
+		if ((n = node.m_ID[m_dofSU[1]]) >= 0) { a = R[n] * m_Mi[n]; node.set(m_dofSV[1], vh[n] + a*dt*0.5); node.set(m_dofSA[1], a); m_Ut[n] += ui[n]; }
+		if ((n = node.m_ID[m_dofSU[2]]) >= 0) { a = R[n] * m_Mi[n]; node.set(m_dofSV[2], vh[n] + a*dt*0.5); node.set(m_dofSA[2], a); m_Ut[n] += ui[n]; }
 	}
 
-	// update velocity
-	vector<double> vnp1(m_neq, 0.0);
-	for (int i = 0; i < m_neq; ++i)
+	// increase iteration number
+	m_niter++;
+
+	// do minor iterations callbacks
+	fem.DoCallback(CB_MINOR_ITERS);
+
+	m_R0.swap(m_R1);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! Advances the solution with one multi-rate central difference step. The 
+//! step is divided in 2^K substeps and the nodes of level l are updated every
+//! 2^(K-l) substeps. In between their updates, nodes move with their current
+//! (half-step) velocity and prescribed dofs are interpolated linearly, so that
+//! the elements of the finer levels see a consistent configuration. At the
+//! last substep all nodes are synchronized and the full residual is evaluated.
+bool FEExplicitSolidSolver::SubcycleStep()
+{
+	FEModel& fem = *GetFEModel();
+	FEMesh& mesh = fem.GetMesh();
+	const int NN = mesh.Nodes();
+
+	const FETimeInfo& tp = fem.GetTime();
+	const double dt = tp.timeIncrement;
+	const int K = m_nlevels - 1;
+	const int ns = (1 << K);
+	const double ds = dt / ns;
+
+	// The prescribed displacement increments are stored in ui (see PrepStep).
+	vector<double>& vh = m_vh;
+	vector<double>& ui = m_ui;
+	vector<double>& db = m_db;
+	vector<double>& F = m_Fs;
+
+	// velocity predictor for each node with its own time step
+	// (The start values of the prescribed dofs are stored in m_Ut, which is otherwise not used for these dofs.)
+	#pragma omp parallel for
+	for (int i = 0; i < NN; ++i)
 	{
-		vnp1[i] = v_pred[i] + anp1[i]*dt*0.5;
+		FENode& node = mesh.Node(i);
+		double h = ds*(1 << (K - m_nodeLevel[i]));
+		double at[3] = { node.m_at.x, node.m_at.y, node.m_at.z };
+		for (int j = 0; j < 3; ++j)
+		{
+			int n = node.m_ID[m_dofU[j]];
+			if (n >= 0) { vh[n] = node.get(m_dofV[j]) + at[j]*h*0.5; db[n] = 0.0; }
+			else if ((n = -n - 2) >= 0) m_Ut[n] = node.get(m_dofU[j]);
+		}
 	}
 
-	// increase iteration number
-	m_niter++;
+	// intermediate substeps
+	FETimeInfo tps = tp;
+	const double t0 = tp.currentTime - dt;
+	for (int s = 1; s < ns; ++s)
+	{
+		// the levels lmin to K are due at this substep
+		int lmin = K;
+		for (int m = s; (m & 1) == 0; m >>= 1) --lmin;
 
-	// scatter velocity and accelerations
-	for (int i = 0; i < mesh.Nodes(); ++i)
+		// update the nodes of the elements that will be evaluated
+		const double frac = (double) s / ns;
+		for (int l = lmin; l <= K; ++l)
+		{
+			const vector<int>& nodes = m_levelElemNodes[l];
+			const int nn = (int) nodes.size();
+			#pragma omp parallel for
+			for (int i = 0; i < nn; ++i)
+			{
+				FENode& node = mesh.Node(nodes[i]);
+				int stride = (1 << (K - m_nodeLevel[nodes[i]]));
+				int sb = ((s - 1) / stride)*stride;
+				for (int j = 0; j < 3; ++j)
+				{
+					int n = node.m_ID[m_dofU[j]];
+					if (n >= 0) { node.set(m_dofU[j], m_Ut[n] + db[n] + (s - sb)*ds*vh[n]); F[n] = 0.0; }
+					else if ((n = -n - 2) >= 0) node.set(m_dofU[j], m_Ut[n] + frac*ui[n]);
+				}
+				node.m_rt = node.m_r0 + node.get_vec3d(m_dofU[0], m_dofU[1], m_dofU[2]);
+			}
+		}
+
+		// evaluate the stresses and internal forces of the due elements
+		tps.currentTime = t0 + s*ds;
+		tps.timeIncrement = s*ds;
+		bool berr = false;
+		for (int l = lmin; l <= K; ++l)
+		{
+			const vector< std::pair<int, int> >& elems = m_levelElems[l];
+			const int ne = (int) elems.size();
+			#pragma omp parallel shared(berr)
+			{
+				vector<double> fe;
+				vector<int> lm;
+				#pragma omp for
+				for (int i = 0; i < ne; ++i)
+				{
+					FEElasticSolidDomain& dom = static_cast<FEElasticSolidDomain&>(mesh.Domain(elems[i].first));
+					FESolidElement& el = dom.Element(elems[i].second);
+					try
+					{
+						dom.UpdateElementStress(elems[i].second, tps);
+					}
+					catch (NegativeJacobian e)
+					{
+						#pragma omp critical
+						{
+							berr = true;
+							if (e.DoOutput()) feLogError(e.what());
+						}
+						continue;
+					}
+
+					fe.assign(3 * el.Nodes(), 0.0);
+					dom.ElementInternalForce(el, fe);
+					dom.UnpackLM(el, lm);
+					for (size_t j = 0; j < fe.size(); ++j)
+					{
+						if (lm[j] >= 0)
+						{
+							#pragma omp atomic
+							F[lm[j]] += fe[j];
+						}
+					}
+				}
+			}
+		}
+
+		// if we encountered an error, we request a running restart
+		if (berr)
+		{
+			if (NegativeJacobian::DoOutput() == false) feLogError("Negative jacobian was detected.");
+			throw DoRunningRestart();
+		}
+
+		// update the velocities of the due nodes
+		for (int l = lmin; l <= K; ++l)
+		{
+			const vector<int>& nodes = m_levelNodes[l];
+			const int nn = (int) nodes.size();
+			const double h = ds*(1 << (K - l));
+			#pragma omp parallel for
+			for (int i = 0; i < nn; ++i)
+			{
+				FENode& node = mesh.Node(nodes[i]);
+				for (int j = 0; j < 3; ++j)
+				{
+					int n = node.m_ID[m_dofU[j]];
+					if (n >= 0)
+					{
+						double a = (F[n] + m_Fn[n])*m_Mi[n];
+						db[n] += h*vh[n];
+						vh[n] += a*h;
+					}
+				}
+			}
+		}
+	}
+
+	// last substep: all nodes are due
+	#pragma omp parallel for
+	for (int i = 0; i < NN; ++i)
 	{
 		FENode& node = mesh.Node(i);
-		int n;
-		if ((n = node.m_ID[m_dofU[0]]) >= 0) { node.set(m_dofV[0], vnp1[n]); node.m_at.x = anp1[n]; }
-		if ((n = node.m_ID[m_dofU[1]]) >= 0) { node.set(m_dofV[1], vnp1[n]); node.m_at.y = anp1[n]; }
-		if ((n = node.m_ID[m_dofU[2]]) >= 0) { node.set(m_dofV[2], vnp1[n]); node.m_at.z = anp1[n]; }
+		double h = ds*(1 << (K - m_nodeLevel[i]));
+		for (int j = 0; j < 3; ++j)
+		{
+			int n = node.m_ID[m_dofU[j]];
+			if (n >= 0) ui[n] = db[n] + h*vh[n];
+		}
+	}
 
-		if ((n = node.m_ID[m_dofSU[0]]) >= 0) { node.set(m_dofSV[0], vnp1[n]); node.set(m_dofSA[0], anp1[n]); }
-		if ((n = node.m_ID[m_dofSU[1]]) >= 0) { node.set(m_dofSV[1], vnp1[n]); node.set(m_dofSA[1], anp1[n]); }
-		if ((n = node.m_ID[m_dofSU[2]]) >= 0) { node.set(m_dofSV[2], vnp1[n]); node.set(m_dofSA[2], anp1[n]); }
+	// update displacements and evaluate the full residual
+	Update(ui);
+	Residual(m_R1);
+	if (m_printNorms) feLog("\t force vector norm : %lg\n", sqrt(m_R1*m_R1));
+
+	// update accelerations, velocities and total displacements
+	const vector<double>& R = m_R1;
+	#pragma omp parallel for
+	for (int i = 0; i < NN; ++i)
+	{
+		FENode& node = mesh.Node(i);
+		double h = ds*(1 << (K - m_nodeLevel[i]));
+		double at[3] = { node.m_at.x, node.m_at.y, node.m_at.z };
+		for (int j = 0; j < 3; ++j)
+		{
+			int n = node.m_ID[m_dofU[j]];
+			if (n >= 0)
+			{
+				at[j] = R[n] * m_Mi[n];
+				node.set(m_dofV[j], vh[n] + at[j]*h*0.5);
+				m_Ut[n] += ui[n];
+			}
+		}
+		node.m_at = vec3d(at[0], at[1], at[2]);
 	}
 
+	// increase iteration number
+	m_niter++;
+
 	// do minor iterations callbacks
 	fem.DoCallback(CB_MINOR_ITERS);
 
-	// update the total displacements
-	m_Ut += m_ui;
-
-	m_R0 = m_R1;
+	m_R0.swap(m_R1);
 
 	return true;
 }
@@ -970,9 +1482,14 @@ bool FEExplicitSolidSolver::Residual(vector<double>& R)
 	// forces due to point constraints
 //	for (i=0; i<(int) fem.m_PC.size(); ++i) fem.m_PC[i]->LoadVector(this, R);
 
+	// add the recorded contributions before the reaction forces are read
+	RHS.Reduce();
+
 	// set the nodal reaction forces
 	// TODO: Is this a good place to do this?
-	for (int i=0; i<mesh.Nodes(); ++i)
+	const int NN = mesh.Nodes();
+	#pragma omp parallel for
+	for (int i=0; i<NN; ++i)
 	{
 		FENode& node = mesh.Node(i);
 		node.set_load(m_dofU[0], 0);
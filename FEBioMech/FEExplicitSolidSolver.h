@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "FECore/FEGlobalVector.h"
 #include <FECore/FETimeInfo.h>
 #include <FECore/FEDofList.h>
+#include <utility>
 
 //-----------------------------------------------------------------------------
 //! This class implements a nonlinear explicit solver for solid mechanics
@@ -88,9 +89,28 @@ public:
 private:
 	bool CalculateMassMatrix();
 
+	//! estimate the critical time step of each solid element (and apply mass scaling)
+	bool EstimateTimeSteps();
+
+	//! assign the elements and nodes to subcycle levels for the time step dt
+	void AssignLevels(double dt);
+
+	//! check whether the model can be subcycled
+	bool CanSubcycle();
+
+	//! advance the solution with one multi-rate (subcycled) step
+	bool SubcycleStep();
+
 public:
 	int			m_mass_lumping;	//!< specify mass lumping method
 	double		m_dyn_damping;	//!< velocity damping for the explicit solver
+	bool		m_printNorms;	//!< print the displacement and force norms of each time step
+	double		m_dtScale;		//!< safety factor applied to the element critical time steps
+	bool		m_subcycling;	//!< advance the elements with their own (power-of-two) time steps
+	int			m_maxLevels;	//!< max nr of subcycle levels (i.e. largest step ratio is 2^m_maxLevels)
+	double		m_massScaling;	//!< allowed added mass for selective mass scaling (fraction of total mass)
+
+	double		m_dtStable;		//!< estimated stable time step (smallest element critical time step)
 
 public:
 	// equation numbers
@@ -106,6 +126,24 @@ public:
 	vector<double> m_R0;	//!< residual at iteration i-1
 	vector<double> m_R1;	//!< residual at iteration i
 
+	vector<double> m_vh;	//!< velocity predictor (velocities at the half step)
+
+private:
+	// element time step data (indexed by domain and element; empty for non-solid domains)
+	vector< vector<double> >	m_dte;		//!< element critical time steps
+	vector< vector<double> >	m_mscale;	//!< element mass scale factors
+
+	// subcycling data
+	bool	m_bsubcycle;		//!< subcycling is used for this step
+	int		m_nlevels;			//!< nr of subcycle levels in use
+	double	m_levelDt;			//!< time step for which the levels were assigned
+	vector<int>	m_nodeLevel;	//!< subcycle level of each node
+	vector< vector< std::pair<int, int> > >	m_levelElems;	//!< elements (domain, element) of each level
+	vector< vector<int> >	m_levelNodes;		//!< nodes of each level
+	vector< vector<int> >	m_levelElemNodes;	//!< nodes connected to the elements of each level
+	vector<double>	m_db;		//!< displacement increment at the last update of each node
+	vector<double>	m_Fs;		//!< internal force vector of the subcycled elements
+
 protected:
 	FEDofList	m_dofU, m_dofV, m_dofSQ, m_dofRQ;
 	FEDofList	m_dofSU, m_dofSV, m_dofSA;
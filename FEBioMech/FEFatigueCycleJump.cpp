@@ -0,0 +1,236 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEFatigueCycleJump.h"
+#include "FEFatigueMaterial.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEAnalysis.h>
+#include <FECore/FEDomain.h>
+#include <FECore/log.h>
+
+//-----------------------------------------------------------------------------
+BEGIN_FECORE_CLASS(FEFatigueCycleJump, FECallBack)
+	ADD_PARAMETER(m_T    , FE_RANGE_GREATER(0.0), "period");
+	ADD_PARAMETER(m_nmin , FE_RANGE_GREATER_OR_EQUAL(3), "min_cycles");
+	ADD_PARAMETER(m_jmin , FE_RANGE_GREATER_OR_EQUAL(1), "min_jump");
+	ADD_PARAMETER(m_jmax , FE_RANGE_GREATER_OR_EQUAL(1), "max_jump");
+	ADD_PARAMETER(m_tol  , FE_RANGE_GREATER(0.0), "tol");
+	ADD_PARAMETER(m_dwmax, FE_RANGE_GREATER(0.0), "max_change");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+FEFatigueCycleJump::FEFatigueCycleJump(FEModel* fem) : FECallBack(fem, CB_INIT | CB_MAJOR_ITERS | CB_UPDATE_TIME)
+{
+	m_T = 1.0;
+	m_nmin = 3;
+	m_jmin = 2;
+	m_jmax = 100;
+	m_tol = 1e-3;
+	m_dwmax = 0.05;
+
+	m_t0 = 0.0;
+	m_tnext = 0.0;
+	m_ncycles = 0;
+	m_njumped = 0;
+	m_njump = 0;
+}
+
+//-----------------------------------------------------------------------------
+bool FEFatigueCycleJump::Execute(FEModel& fem, int nwhen)
+{
+	if (nwhen == CB_INIT)
+	{
+		m_t0 = fem.GetCurrentTime();
+		m_tnext = m_t0 + m_T;
+		m_ncycles = 0;
+		m_njumped = 0;
+		m_njump = 0;
+		for (int i = 0; i < 3; ++i) m_s[i].clear();
+		Sample(fem, m_s[2]);
+	}
+	else if (nwhen == CB_MAJOR_ITERS)
+	{
+		const double eps = 1e-6*m_T;
+		double t = fem.GetCurrentTime();
+
+		// If a time step after a jump had to be retried, the model was restored to the 
+		// state before the jump. In that case the cycle count restarts from the current time.
+		if (t + eps < m_tnext - m_T)
+		{
+			m_tnext = m_t0 + m_T*ceil((t - m_t0) / m_T - 1e-6);
+			m_ncycles = 0;
+			for (int i = 0; i < 3; ++i) m_s[i].clear();
+		}
+
+		// only act at the end of a cycle
+		if (t + eps < m_tnext) return true;
+		CycleCompleted(fem);
+	}
+	else if (nwhen == CB_UPDATE_TIME)
+	{
+		// The jump is done before the next time step starts, so that all output of
+		// the last resolved cycle has been written.
+		if (m_njump > 0) Jump(fem, m_njump);
+		m_njump = 0;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FEFatigueCycleJump::Sample(FEModel& fem, std::vector<double>& s)
+{
+	s.clear();
+	FEMesh& mesh = fem.GetMesh();
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FEDomain& dom = mesh.Domain(i);
+		dom.ForEachMaterialPoint([&](FEMaterialPoint& mp) {
+			FEFatigueMaterialPoint* pt = mp.ExtractData<FEFatigueMaterialPoint>();
+			if (pt)
+			{
+				s.push_back(pt->m_wit);
+				s.push_back(pt->m_wft);
+			}
+		});
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEFatigueCycleJump::CycleCompleted(FEModel& fem)
+{
+	const double eps = 1e-6*m_T;
+	double t = fem.GetCurrentTime();
+	m_tnext += m_T;
+	if (m_tnext < t + eps)
+	{
+		feLogWarning("fatigue cycle jump: time step does not land on cycle boundary.");
+		m_tnext = t + m_T;
+	}
+
+	// shift the samples
+	m_s[0].swap(m_s[1]);
+	m_s[1].swap(m_s[2]);
+	Sample(fem, m_s[2]);
+	m_ncycles++;
+
+	// see if we have enough resolved cycles
+	if (m_ncycles < m_nmin) return;
+	if (m_s[2].empty()) return;
+	if ((m_s[0].size() != m_s[2].size()) || (m_s[1].size() != m_s[2].size())) return;
+
+	// estimate the per-cycle increment and its rate of change
+	double d1max = 0.0, d2max = 0.0;
+	const std::vector<double>& s0 = m_s[0];
+	const std::vector<double>& s1 = m_s[1];
+	const std::vector<double>& s2 = m_s[2];
+	for (size_t i = 0; i < s2.size(); ++i)
+	{
+		double d1 = fabs(s2[i] - s1[i]);
+		double d2 = fabs(s2[i] - 2.0*s1[i] + s0[i]);
+		if (d1 > d1max) d1max = d1;
+		if (d2 > d2max) d2max = d2;
+	}
+
+	// the truncation error of the linear extrapolation is N^2*d2/2
+	double N = m_jmax;
+	if (d2max > 0.0) N = fmin(N, sqrt(2.0*m_tol / d2max));
+	if (d1max > 0.0) N = fmin(N, m_dwmax / d1max);
+
+	// don't jump past the end of the step (keep the last cycle resolved)
+	FEAnalysis* step = fem.GetCurrentStep();
+	double tend = step->m_tend;
+	N = fmin(N, floor((tend - t) / m_T + 1e-6) - 1.0);
+
+	// don't jump past a must-point either, so that its state is resolved
+	FETimeStepController* tc = step->m_timeController;
+	if (tc)
+	{
+		for (double tm : tc->m_must_points)
+		{
+			if (tm > t + eps)
+			{
+				N = fmin(N, floor((tm - t) / m_T + 1e-6) - 1.0);
+				break;
+			}
+		}
+	}
+
+	// the jump is done when the next time step starts
+	int njump = (int)floor(N);
+	m_njump = (njump < m_jmin ? 0 : njump);
+}
+
+//-----------------------------------------------------------------------------
+void FEFatigueCycleJump::Jump(FEModel& fem, int ncycles)
+{
+	const std::vector<double>& s1 = m_s[1];
+	const std::vector<double>& s2 = m_s[2];
+
+	size_t n = 0;
+	FEMesh& mesh = fem.GetMesh();
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FEDomain& dom = mesh.Domain(i);
+		dom.ForEachMaterialPoint([&](FEMaterialPoint& mp) {
+			FEFatigueMaterialPoint* pt = mp.ExtractData<FEFatigueMaterialPoint>();
+			if (pt)
+			{
+				// extrapolate the bond fractions and make sure they remain admissible
+				double wi = s2[n] + ncycles*(s2[n] - s1[n]);
+				double wf = s2[n + 1] + ncycles*(s2[n + 1] - s1[n + 1]);
+				if (wi < 0.0) wi = 0.0; else if (wi > 1.0) wi = 1.0;
+				if (wf < 0.0) wf = 0.0; else if (wf > 1.0 - wi) wf = 1.0 - wi;
+
+				// shift all time points by the same amount so the rates are unaffected
+				double dwi = wi - pt->m_wit;
+				double dwf = wf - pt->m_wft;
+				pt->m_wi += dwi; pt->m_wip += dwi; pt->m_wit += dwi;
+				pt->m_wf += dwf; pt->m_wfp += dwf; pt->m_wft += dwf;
+				pt->m_D = 1.0 - pt->m_wit - pt->m_wft;
+				n += 2;
+			}
+		});
+	}
+
+	// advance the time (this also lets the time controller adjust the next time step)
+	FEAnalysis* step = fem.GetCurrentStep();
+	double t0 = fem.GetCurrentTime();
+	step->AdvanceTime(ncycles*m_T);
+	double t1 = fem.GetCurrentTime();
+	m_tnext = t1 + m_T;
+	m_njumped += ncycles;
+
+	feLog("fatigue cycle jump: skipped %d cycles (t = %lg -> %lg, total skipped = %d)\n", ncycles, t0, t1, m_njumped);
+
+	// restart the sampling from the extrapolated state
+	m_ncycles = 0;
+	m_s[0].clear();
+	m_s[1].clear();
+	Sample(fem, m_s[2]);
+}
@@ -0,0 +1,78 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/FECallBack.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Cycle-jump controller for high-cycle fatigue simulations with the reactive
+// fatigue material. Every "period" the intact and fatigued bond fractions of
+// all fatigue material points are sampled. Once the per-cycle increments are
+// stable, the bond fractions are extrapolated over a number of cycles that is
+// bounded by the extrapolation error estimate (from the second difference of
+// the last three cycles), and the model time is advanced accordingly through
+// FEAnalysis::AdvanceTime. The jump is done right before the next time step
+// starts, and it never passes a must-point or the last cycle of the step.
+// NOTE: The loading must be periodic in time and the time steps must land on
+// the cycle boundaries (i.e. the step size must divide the period).
+class FEFatigueCycleJump : public FECallBack
+{
+public:
+	FEFatigueCycleJump(FEModel* fem);
+
+	bool Execute(FEModel& fem, int nwhen) override;
+
+private:
+	// collect the bond fractions of all fatigue material points
+	void Sample(FEModel& fem, std::vector<double>& s);
+
+	// extrapolate the bond fractions over the given number of cycles
+	void Jump(FEModel& fem, int ncycles);
+
+	// decide how many cycles to jump at the end of a resolved cycle
+	void CycleCompleted(FEModel& fem);
+
+private:
+	double	m_T;		//!< load period
+	int		m_nmin;		//!< min nr of resolved cycles between jumps
+	int		m_jmin;		//!< min nr of cycles to jump
+	int		m_jmax;		//!< max nr of cycles to jump
+	double	m_tol;		//!< allowed extrapolation error of the bond fractions
+	double	m_dwmax;	//!< max change of bond fractions per jump
+
+private:
+	double	m_t0;				//!< time at which the first cycle starts
+	double	m_tnext;			//!< time at which the current cycle ends
+	int		m_ncycles;			//!< resolved cycles since the last jump
+	int		m_njumped;			//!< total nr of cycles that were jumped
+	int		m_njump;			//!< nr of cycles to jump when the next time step starts
+	std::vector<double>	m_s[3];	//!< bond fractions at the last three cycle boundaries
+
+	DECLARE_FECORE_CLASS();
+};
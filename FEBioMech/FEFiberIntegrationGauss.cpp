@@ -216,6 +216,7 @@ void FEFiberIntegrationGauss::Serialize(DumpStream& ar)
 	if ((ar.IsSaving() == false) && (ar.IsShallow() == false))
 	{
 		InitRule();
+		BuildTable();
 	}
 }
 
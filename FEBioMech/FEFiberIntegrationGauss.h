@@ -57,6 +57,9 @@ public:
 	// get iterator
 	virtual FEFiberIntegrationSchemeIterator* GetIterator(FEMaterialPoint* mp) override;
 
+	// the integration domain depends on the principal stretches
+	bool DependsOnDeformation() const override { return true; }
+
 protected:
 	bool InitRule();
     
@@ -217,6 +217,7 @@ void FEFiberIntegrationGaussKronrod::Serialize(DumpStream& ar)
 	if ((ar.IsShallow() == false) && (ar.IsSaving() == false))
 	{
 		InitRule();
+		BuildTable();
 	}
 }
 
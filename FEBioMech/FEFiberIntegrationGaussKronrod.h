@@ -58,6 +58,9 @@ public:
 	// get the iterator
 	FEFiberIntegrationSchemeIterator* GetIterator(FEMaterialPoint* mp) override;
 
+	// the integration domain depends on the principal stretches
+	bool DependsOnDeformation() const override { return true; }
+
 protected:
 	bool InitRule();
     
@@ -99,6 +99,7 @@ void FEFiberIntegrationGeodesic::Serialize(DumpStream& ar)
 	if (ar.IsSaving() == false)
 	{
 		InitIntegrationRule();
+		BuildTable();
 	}
 }
 
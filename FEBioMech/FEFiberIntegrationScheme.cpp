@@ -32,3 +32,28 @@ SOFTWARE.*/
 FEFiberIntegrationScheme::FEFiberIntegrationScheme(FEModel* pfem) : FEMaterial(pfem)
 {
 }
+
+//-----------------------------------------------------------------------------
+bool FEFiberIntegrationScheme::Init()
+{
+	// the rule is set up by now, so we can tabulate the integration points
+	BuildTable();
+
+	return FEMaterial::Init();
+}
+
+//-----------------------------------------------------------------------------
+void FEFiberIntegrationScheme::BuildTable()
+{
+	m_table.Clear();
+	FEFiberIntegrationSchemeIterator* it = GetIterator(nullptr);
+	if (it->IsValid())
+	{
+		do
+		{
+			m_table.Add(it->m_fiber, it->m_weight);
+		}
+		while (it->Next());
+	}
+	delete it;
+}
@@ -54,6 +54,25 @@ public:
 	double	m_weight;		// current integration weight
 };
 
+//----------------------------------------------------------------------------------
+// Precomputed integration points (fiber directions and weights) of a scheme.
+class FEFiberIntegrationTable
+{
+public:
+	FEFiberIntegrationTable() {}
+
+	// number of integration points
+	int Points() const { return (int)m_weight.size(); }
+
+	void Clear() { m_fiber.clear(); m_weight.clear(); }
+
+	void Add(const vec3d& n, double w) { m_fiber.push_back(n); m_weight.push_back(w); }
+
+public:
+	std::vector<vec3d>	m_fiber;	// fiber vectors at integration points
+	std::vector<double>	m_weight;	// integration weights
+};
+
 //----------------------------------------------------------------------------------
 // Base clase for integration schemes for continuous fiber distributions.
 // The purpose of this class is mainly to provide an interface to the integration schemes
@@ -69,4 +88,22 @@ public:
 	// In general, the integration scheme may depend on the material point.
 	// The passed material point pointer will be zero when evaluating the integrated fiber density
 	virtual FEFiberIntegrationSchemeIterator* GetIterator(FEMaterialPoint* mp = 0) = 0;
+
+	// Returns true if the integration points depend on the deformation at the material point.
+	// If not, the precomputed table can be used instead of an iterator.
+	virtual bool DependsOnDeformation() const { return false; }
+
+	// Returns the precomputed integration points for the undeformed state (i.e. the points
+	// returned by GetIterator(nullptr)). This is only valid after Init.
+	const FEFiberIntegrationTable& GetTable() const { return m_table; }
+
+	// Initialization (derived classes must call this after they set up their rule)
+	bool Init() override;
+
+protected:
+	// (Re)build the table of integration points from the iterator
+	void BuildTable();
+
+private:
+	FEFiberIntegrationTable	m_table;
 };
@@ -100,6 +100,16 @@ FEFiberIntegrationTrapezoidal::~FEFiberIntegrationTrapezoidal()
 {
 }
 
+//-----------------------------------------------------------------------------
+void FEFiberIntegrationTrapezoidal::Serialize(DumpStream& ar)
+{
+	FEFiberIntegrationScheme::Serialize(ar);
+	if (ar.IsSaving() == false)
+	{
+		BuildTable();
+	}
+}
+
 //-----------------------------------------------------------------------------
 FEFiberIntegrationSchemeIterator* FEFiberIntegrationTrapezoidal::GetIterator(FEMaterialPoint* mp)
 {
@@ -40,6 +40,9 @@ public:
     FEFiberIntegrationTrapezoidal(FEModel* pfem);
     ~FEFiberIntegrationTrapezoidal();
 
+	//! Serialization
+	void Serialize(DumpStream& ar) override;
+
 	// get iterator	
 	FEFiberIntegrationSchemeIterator* GetIterator(FEMaterialPoint* mp) override;
     
@@ -113,6 +113,7 @@ void FEFiberIntegrationTriangle::Serialize(DumpStream& ar)
 	if (ar.IsSaving() == false)
 	{
 		InitIntegrationRule();
+		BuildTable();
 	}
 }
 
@@ -75,7 +75,7 @@ void FEPressureLoad::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 	surf.SetShellBottom(m_bshellb);
 
 	// evaluate the integral
-	surf.LoadVector(R, m_dof, m_blinear, [&](FESurfaceMaterialPoint& pt, const FESurfaceDofShape& dof_a, std::vector<double>& val) {
+	surf.LoadVector<3>(R, m_dof, m_blinear, [&](FESurfaceMaterialPoint& pt, const FESurfaceDofShape& dof_a, double* val) {
 		
 		// evaluate pressure at this material point
 		double P = -m_pressure(pt);
@@ -105,7 +105,7 @@ void FEPressureLoad::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 	surf.SetShellBottom(m_bshellb);
 
 	// evaluate the integral
-	surf.LoadStiffness(LS, m_dof, m_dof, [&](FESurfaceMaterialPoint& mp, const FESurfaceDofShape& dof_a, const FESurfaceDofShape& dof_b, matrix& kab) {
+	surf.LoadStiffness<3, 3>(LS, m_dof, m_dof, [&](FESurfaceMaterialPoint& mp, const FESurfaceDofShape& dof_a, const FESurfaceDofShape& dof_b, fixed_matrix<3, 3>& kab) {
 
 		// evaluate pressure at this material point
 		double P = -m_pressure(mp);
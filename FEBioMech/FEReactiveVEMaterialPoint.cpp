@@ -110,3 +110,84 @@ void FEReactiveVEMaterialPoint::Serialize(DumpStream& ar)
         for (int i=0; i<n; ++i) ar >> m_Uv[i] >> m_Jv[i] >> m_v[i] >> m_f[i];
     }
 }
+
+//-----------------------------------------------------------------------------
+//! Merge generation ig into generation ig+1. The state of the merged generation
+//! is the average of both, weighted by their bond mass fractions.
+void FEReactiveVEMaterialPoint::MergeGenerations(int ig, double wi, double wj)
+{
+    int jg = ig + 1;
+    assert((ig >= 0) && (jg < (int)m_v.size()));
+    
+    double w = wi + wj;
+    if (w > 0)
+    {
+        m_v[jg] = (wi*m_v[ig] + wj*m_v[jg])/w;
+        m_Uv[jg] = (m_Uv[ig]*wi + m_Uv[jg]*wj)/w;
+        m_Jv[jg] = m_Uv[jg].det();
+        m_f[jg] = (wi*m_f[ig] + wj*m_f[jg])/w;
+    }
+    
+    m_Uv.erase(m_Uv.begin() + ig);
+    m_Jv.erase(m_Jv.begin() + ig);
+    m_v.erase(m_v.begin() + ig);
+    m_f.erase(m_f.begin() + ig);
+}
+
+//-----------------------------------------------------------------------------
+//! Merge generations so that the cost per time step remains bounded.
+//! Older generations whose breaking bond mass fraction has decayed below wtol
+//! are merged into the next generation. If more than nmax generations remain,
+//! the adjacent pair with the smallest combined mass fraction is merged until
+//! the limit is met. The most recent generation is never merged.
+void FEReactiveVEMaterialPoint::CompactGenerations(FEElasticMaterialPoint& ep, double wtol, int nmax, std::function<double(int)> wfnc)
+{
+    int ng = (int)m_v.size();
+    
+    // don't compact if we have too few generations
+    if (ng < 3) return;
+    
+    // keep safe copy of deformation gradient
+    mat3d F = ep.m_F;
+    double J = ep.m_J;
+    
+    // evaluate the breaking bond mass fraction of all generations
+    vector<double> w(ng);
+    for (int ig=0; ig<ng; ++ig) {
+        ep.m_F = m_Uv[ig];
+        ep.m_J = m_Jv[ig];
+        w[ig] = wfnc(ig);
+    }
+    
+    // restore safe copy of deformation gradient
+    ep.m_F = F;
+    ep.m_J = J;
+    
+    // merge generations that have relaxed below the tolerance
+    if (wtol > 0) {
+        int ig = 0;
+        while ((ig < ng-2) && (ng > 2)) {
+            if (w[ig] < wtol) {
+                MergeGenerations(ig, w[ig], w[ig+1]);
+                w[ig+1] += w[ig];
+                w.erase(w.begin() + ig);
+                --ng;
+            }
+            else ++ig;
+        }
+    }
+    
+    // enforce the maximum number of generations
+    if (nmax > 0) {
+        nmax = max(nmax, 2);
+        while (ng > nmax) {
+            int imin = 0;
+            for (int ig=1; ig<ng-2; ++ig)
+                if (w[ig] + w[ig+1] < w[imin] + w[imin+1]) imin = ig;
+            MergeGenerations(imin, w[imin], w[imin+1]);
+            w[imin+1] += w[imin];
+            w.erase(w.begin() + imin);
+            --ng;
+        }
+    }
+}
@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "FEReactiveViscoelastic.h"
 #include "FEUncoupledReactiveViscoelastic.h"
 #include <deque>
+#include <functional>
 
 class FEReactiveViscoelasticMaterial;
 class FEUncoupledReactiveViscoelasticMaterial;
@@ -71,6 +72,15 @@ public:
     //! Serialize data to archive
     void Serialize(DumpStream& ar) override;
     
+    //! merge generation ig into the next generation, using the bond mass fractions wi and wj of both as weights
+    void MergeGenerations(int ig, double wi, double wj);
+    
+    //! merge generations whose breaking bond mass fraction is below wtol and, if nmax > 0, 
+    //! keep merging until at most nmax generations remain. The function wfnc returns the
+    //! breaking bond mass fraction of a generation and is evaluated with the deformation 
+    //! of ep set to that of the generation.
+    void CompactGenerations(FEElasticMaterialPoint& ep, double wtol, int nmax, std::function<double(int)> wfnc);
+    
 public:
     // multigenerational material data
     deque <mat3ds> m_Uv;	//!< right stretch tensor at tv (when generation u starts breaking)
@@ -48,6 +48,8 @@ BEGIN_FECORE_CLASS(FEReactiveViscoelasticMaterial, FEElasticMaterial)
     ADD_PARAMETER(m_btype, FE_RANGE_CLOSED(1,2), "kinetics");
     ADD_PARAMETER(m_ttype, FE_RANGE_CLOSED(0,2), "trigger");
     ADD_PARAMETER(m_emin , FE_RANGE_GREATER_OR_EQUAL(0.0), "emin");
+    ADD_PARAMETER(m_gtol , FE_RANGE_GREATER_OR_EQUAL(0.0), "cull_tol");
+    ADD_PARAMETER(m_gmax , FE_RANGE_GREATER_OR_EQUAL(0), "max_generations");
 
 	// set material properties
 	ADD_PROPERTY(m_pBase, "elastic");
@@ -66,6 +68,8 @@ FEReactiveViscoelasticMaterial::FEReactiveViscoelasticMaterial(FEModel* pfem) :
     m_emin = 0;
     
     m_nmax = 0;
+    m_gtol = 0;
+    m_gmax = 0;
 
 	m_pBase = nullptr;
 	m_pBond = nullptr;
@@ -587,6 +591,13 @@ double FEReactiveViscoelasticMaterial::StrainEnergyDensity(FEMaterialPoint& mp)
 //! Cull generations that have relaxed below a threshold
 void FEReactiveViscoelasticMaterial::CullGenerations(FEMaterialPoint& mp)
 {
+    // use the compaction mode if requested
+    if ((m_gtol > 0) || (m_gmax > 0))
+    {
+        CompactGenerations(mp);
+        return;
+    }
+    
     // get the elastic material point data
     FEElasticMaterialPoint& ep = *mp.ExtractData<FEElasticMaterialPoint>();
     
@@ -616,14 +627,7 @@ void FEReactiveViscoelasticMaterial::CullGenerations(FEMaterialPoint& mp)
         ep.m_F = pt.m_Uv[1];
         ep.m_J = pt.m_Jv[1];
         double w1 = BreakingBondMassFraction(mp, 1, D);
-        pt.m_v[1] = (w0*pt.m_v[0] + w1*pt.m_v[1])/(w0+w1);
-        pt.m_Uv[1] = (pt.m_Uv[0]*w0 + pt.m_Uv[1]*w1)/(w0+w1);
-        pt.m_Jv[1] = pt.m_Uv[1].det();
-        pt.m_f[1] = (w0*pt.m_f[0] + w1*pt.m_f[1])/(w0+w1);
-        pt.m_Uv.pop_front();
-        pt.m_Jv.pop_front();
-        pt.m_v.pop_front();
-        pt.m_f.pop_front();
+        pt.MergeGenerations(0, w0, w1);
     }
     
     // restore safe copy of deformation gradient
@@ -633,6 +637,21 @@ void FEReactiveViscoelasticMaterial::CullGenerations(FEMaterialPoint& mp)
     return;
 }
 
+//-----------------------------------------------------------------------------
+//! Merge generations so that the cost per time step remains bounded
+//! (see FEReactiveVEMaterialPoint::CompactGenerations).
+void FEReactiveViscoelasticMaterial::CompactGenerations(FEMaterialPoint& mp)
+{
+    // get the elastic material point data
+    FEElasticMaterialPoint& ep = *mp.ExtractData<FEElasticMaterialPoint>();
+    
+    // get the reactive viscoelastic point data
+    FEReactiveVEMaterialPoint& pt = *mp.ExtractData<FEReactiveVEMaterialPoint>();
+    
+    mat3ds D = ep.RateOfDeformation();
+    pt.CompactGenerations(ep, m_gtol, m_gmax, [&](int ig) { return BreakingBondMassFraction(mp, ig, D); });
+}
+
 //-----------------------------------------------------------------------------
 //! Update specialized material points
 void FEReactiveViscoelasticMaterial::UpdateSpecializedMaterialPoints(FEMaterialPoint& mp, const FETimeInfo& tp)
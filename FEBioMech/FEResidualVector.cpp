@@ -48,6 +48,7 @@ void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double
 {
     
     vector<double>& R = m_R;
+    FEAssemblyBuffer::Log* log = ThreadLog();
     
     int i, I, n;
     
@@ -62,14 +63,12 @@ void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double
             I = elm[i];
             
             if ( I >= 0){
-#pragma omp atomic
-                R[I] += fe[i];
+                AddTo(log, R[I], fe[i]);
             }
             // TODO: Find another way to store reaction forces
             
             else if (-I-2 >= 0){
-#pragma omp atomic
-                m_Fr[-I-2] -= fe[i];
+                AddTo(log, m_Fr[-I-2], -fe[i]);
             }
         }
         
@@ -82,7 +81,7 @@ void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double
 		FELinearConstraintManager& LCM = m_fem.GetLinearConstraintManager();
 		if (LCM.LinearConstraints())
 		{
-			LCM.AssembleResidual(R, en, elm, fe);
+			LCM.AssembleResidual(*this, en, elm, fe);
 		}
         
         // If there are rigid bodies we need to look for rigid dofs
@@ -128,28 +127,22 @@ void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double
 							n = lm[3];
 							if (n >= 0)
 							{
-#pragma omp atomic
-								R[n] += m.x;
+								AddTo(log, R[n], m.x);
 							}
-#pragma omp atomic
-							RB.m_Mr.x -= m.x;
+							AddTo(log, RB.m_Mr.x, -m.x);
 							n = lm[4];
 							if (n >= 0)
 							{
-#pragma omp atomic
-								R[n] += m.y;
+								AddTo(log, R[n], m.y);
 							}
 
-#pragma omp atomic
-							RB.m_Mr.y -= m.y;
+							AddTo(log, RB.m_Mr.y, -m.y);
 							n = lm[5];
 							if (n >= 0)
 							{
-#pragma omp atomic
-								R[n] += m.z;
+								AddTo(log, R[n], m.z);
 							}
-#pragma omp atomic
-							RB.m_Mr.z -= m.z;
+							AddTo(log, RB.m_Mr.z, -m.z);
 							/*
 							 // if the rotational degrees of freedom are constrained for a rigid node
 							 // then we need to add an additional component to the residual
@@ -165,28 +158,22 @@ void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double
 							n = lm[0];
 							if (n >= 0)
 							{
-#pragma omp atomic
-								R[n] += f.x;
+								AddTo(log, R[n], f.x);
 							}
-#pragma omp atomic
-							RB.m_Fr.x -= f.x;
+							AddTo(log, RB.m_Fr.x, -f.x);
 							n = lm[1];
 							if (n >= 0)
 							{
-#pragma omp atomic
-								R[n] += f.y;
+								AddTo(log, R[n], f.y);
 							}
-#pragma omp atomic
-							RB.m_Fr.y -= f.y;
+							AddTo(log, RB.m_Fr.y, -f.y);
 
 							n = lm[2];
 							if (n >= 0)
 							{
-#pragma omp atomic
-								R[n] += f.z;
+								AddTo(log, R[n], f.z);
 							}
-#pragma omp atomic
-							RB.m_Fr.z -= f.z;
+							AddTo(log, RB.m_Fr.z, -f.z);
 						}
 					}
 				}
@@ -208,15 +195,14 @@ void FEResidualVector::Assemble(int node_id, int dof, double f)
 
 	// assemble into global vector
 	if (n >= 0) {
-#pragma omp atomic
-		m_R[n] += f;
+		Add(n, f);
 	}
 	else {
 		FESolidSolver2* solver = dynamic_cast<FESolidSolver2*>(m_fem.GetCurrentStep()->GetFESolver());
 		if (solver)
 		{
 			FERigidSolver* rigidSolver = solver->GetRigidSolver();
-			rigidSolver->AssembleResidual(node_id, dof, f, m_R);
+			rigidSolver->AssembleResidual(node_id, dof, f, *this);
 		}
 	}
 }
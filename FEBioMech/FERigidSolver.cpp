@@ -40,6 +40,7 @@ SOFTWARE.*/
 #include <FECore/Archive.h>
 #include "FEMechModel.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEGlobalVector.h>
 
 FERigidSolver::FERigidSolver(FEModel* fem)
 {
@@ -866,7 +867,7 @@ void FERigidSolver::RigidStiffnessShell(SparseMatrix& K, vector<double>& ui, vec
 }
 
 //-----------------------------------------------------------------------------
-void FERigidSolver::AssembleResidual(int node_id, int dof, double f, vector<double>& R)
+void FERigidSolver::AssembleResidual(int node_id, int dof, double f, FEGlobalVector& R)
 {
 	if (m_fem == nullptr) return;
 	FEMechModel& fem = *m_fem;
@@ -878,7 +879,7 @@ void FERigidSolver::AssembleResidual(int node_id, int dof, double f, vector<doub
     int n = node.m_ID[dof];
     
     // assemble into global vector
-    if (n >= 0) R[n] += f;
+    if (n >= 0) R.Add(n, f);
     else if (node.m_rid >= 0)
     {
         // this is a rigid body node
@@ -890,21 +891,21 @@ void FERigidSolver::AssembleResidual(int node_id, int dof, double f, vector<doub
         int* lm = RB.m_LM;
         if (dof == m_dofX)
         {
-            if (lm[0] >= 0) R[lm[0]] += f;
-            if (lm[4] >= 0) R[lm[4]] += a.z*f;
-            if (lm[5] >= 0) R[lm[5]] += -a.y*f;
+            if (lm[0] >= 0) R.Add(lm[0], f);
+            if (lm[4] >= 0) R.Add(lm[4], a.z*f);
+            if (lm[5] >= 0) R.Add(lm[5], -a.y*f);
         }
         else if (dof == m_dofY)
         {
-            if (lm[1] >= 0) R[lm[1]] += f;
-            if (lm[3] >= 0) R[lm[3]] += -a.z*f;
-            if (lm[5] >= 0) R[lm[5]] += a.x*f;
+            if (lm[1] >= 0) R.Add(lm[1], f);
+            if (lm[3] >= 0) R.Add(lm[3], -a.z*f);
+            if (lm[5] >= 0) R.Add(lm[5], a.x*f);
         }
         else if (dof == m_dofZ)
         {
-            if (lm[2] >= 0) R[lm[2]] += f;
-            if (lm[3] >= 0) R[lm[3]] += a.y*f;
-            if (lm[4] >= 0) R[lm[4]] += -a.x*f;
+            if (lm[2] >= 0) R.Add(lm[2], f);
+            if (lm[3] >= 0) R.Add(lm[3], a.y*f);
+            if (lm[4] >= 0) R.Add(lm[4], -a.x*f);
         }
 		if (node.HasFlags(FENode::SHELL) && node.HasFlags(FENode::RIGID_CLAMP)) {
             // get the shell director
@@ -912,21 +913,21 @@ void FERigidSolver::AssembleResidual(int node_id, int dof, double f, vector<doub
             vec3d b = a - d;
             if (dof == m_dofSX)
             {
-                if (lm[0] >= 0) R[lm[0]] +=  f;
-                if (lm[4] >= 0) R[lm[4]] += b.z*f;
-                if (lm[5] >= 0) R[lm[5]] += -b.y*f;
+                if (lm[0] >= 0) R.Add(lm[0], f);
+                if (lm[4] >= 0) R.Add(lm[4], b.z*f);
+                if (lm[5] >= 0) R.Add(lm[5], -b.y*f);
             }
             else if (dof == m_dofSY)
             {
-                if (lm[1] >= 0) R[lm[1]] +=  f;
-                if (lm[3] >= 0) R[lm[3]] += -b.z*f;
-                if (lm[5] >= 0) R[lm[5]] += b.x*f;
+                if (lm[1] >= 0) R.Add(lm[1], f);
+                if (lm[3] >= 0) R.Add(lm[3], -b.z*f);
+                if (lm[5] >= 0) R.Add(lm[5], b.x*f);
             }
             else if (dof == m_dofSZ)
             {
-                if (lm[2] >= 0) R[lm[2]] +=  f;
-                if (lm[3] >= 0) R[lm[3]] += b.y*f;
-                if (lm[4] >= 0) R[lm[4]] += -b.x*f;
+                if (lm[2] >= 0) R.Add(lm[2], f);
+                if (lm[3] >= 0) R.Add(lm[3], b.y*f);
+                if (lm[4] >= 0) R.Add(lm[4], -b.x*f);
             }
         }
     }
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FESolidSolver2.h"
+#include <FECore/FETaskList.h>
 #include "FERigidConnector.h"
 #include "FESlidingElasticInterface.h"
 #include "FE3FieldElasticSolidDomain.h"
@@ -96,6 +97,9 @@ m_dofU(pfem), m_dofV(pfem), m_dofSQ(pfem), m_dofRQ(pfem), m_dofSU(pfem), m_dofSV
 	m_al_inc = 0.0;
 	m_al_ds = 0.0;
 
+	// the residual is reduced before it is read (see FE_ASSEMBLE_REDUCE)
+	m_breduceAssembly = true;
+
 	// Allocate degrees of freedom
 	DOFS& dofs = pfem->GetDOFS();
 	int varD = dofs.AddVariable(FEBioMech::GetVariableName(FEBioMech::DISPLACEMENT), VAR_VEC3);
@@ -1076,13 +1080,19 @@ bool FESolidSolver2::StiffnessMatrix()
 	// setup the linear system
 	FESolidLinearSystem LS(this, &m_rigidSolver, *m_pK, m_Fd, m_ui, (m_msymm == REAL_SYMMETRIC), m_alpha, m_nreq);
 
+	// The domains, body loads, contact interfaces and surface loads are independent
+	// of each other, so they are collected in a task list that may run them concurrently.
+	// The light tasks run at the same time, so every path through which they assemble
+	// into the linear system has to be atomic.
+	FETaskList tasks(TaskAssembly());
+
 	// calculate the stiffness matrix for each domain
 	for (int i=0; i<mesh.Domains(); ++i) 
 	{
 		if (mesh.Domain(i).IsActive()) 
 		{
 			FEElasticDomain& dom = dynamic_cast<FEElasticDomain&>(mesh.Domain(i));
-			dom.StiffnessMatrix(LS);
+			tasks.AddTask([&]() { dom.StiffnessMatrix(LS); }, FETaskCost(mesh.Domain(i)));
 		}
 	}
 
@@ -1090,7 +1100,7 @@ bool FESolidSolver2::StiffnessMatrix()
 	for (int j = 0; j<fem.BodyLoads(); ++j)
 	{
 		FEBodyLoad* pbl =fem.GetBodyLoad(j);
-		if (pbl->IsActive()) pbl->StiffnessMatrix(LS, tp);
+		if (pbl->IsActive()) tasks.AddTask([=, &LS, &tp]() { pbl->StiffnessMatrix(LS, tp); }, FETaskCost(*pbl));
 	}
     
     // TODO: add body force stiffness for rigid bodies
@@ -1111,29 +1121,36 @@ bool FESolidSolver2::StiffnessMatrix()
 			if (mat && (mat->IsRigid() == false))
 			{
 				FEElasticDomain& edom = dynamic_cast<FEElasticDomain&>(dom);
-				edom.MassMatrix(LS, a);
+				tasks.AddTask([=, &edom, &LS]() { edom.MassMatrix(LS, a); }, FETaskCost(dom));
 			}
 		}
+		tasks.Run();
 
 		m_rigidSolver.RigidMassMatrix(LS, tp);
 	}
 
 	// calculate contact stiffness
-	ContactStiffness(LS);
+	ContactStiffness(LS, tasks);
 
 	// calculate stiffness matrices for surface loads
 	// for arclength method we need to apply the scale factor to all the 
-	// external forces stiffness matrix. 
-	if (m_arcLength > 0) LS.StiffnessAssemblyScaleFactor(m_al_lam);
+	// external forces stiffness matrix. Since the scale factor is a property
+	// of the linear system, the surface loads are then evaluated separately.
+	if (m_arcLength > 0)
+	{
+		tasks.Run();
+		LS.StiffnessAssemblyScaleFactor(m_al_lam);
+	}
 	int nsl = fem.SurfaceLoads();
 	for (int i = 0; i<nsl; ++i)
 	{
 		FESurfaceLoad* psl = fem.SurfaceLoad(i);
 		if (psl->IsActive())
 		{
-			psl->StiffnessMatrix(LS, tp);
+			tasks.AddTask([=, &LS, &tp]() { psl->StiffnessMatrix(LS, tp); }, FETaskCost(*psl));
 		}
 	}
+	tasks.Run();
 	if (m_arcLength > 0) LS.StiffnessAssemblyScaleFactor(1.0);
 
 	// calculate nonlinear constraint stiffness
@@ -1167,26 +1184,44 @@ void FESolidSolver2::NonLinearConstraintStiffness(FELinearSystem& LS, const FETi
 //! This function calculates the contact stiffness matrix
 
 void FESolidSolver2::ContactStiffness(FELinearSystem& LS)
+{
+	FETaskList tasks;
+	ContactStiffness(LS, tasks);
+	tasks.Run();
+}
+
+//-----------------------------------------------------------------------------
+//! Adds the contact stiffness contributions to a task list
+void FESolidSolver2::ContactStiffness(FELinearSystem& LS, FETaskList& tasks)
 {
 	FEModel& fem = *GetFEModel();
 	const FETimeInfo& tp = fem.GetTime();
 	for (int i = 0; i<fem.SurfacePairConstraints(); ++i)
 	{
 		FEContactInterface* pci = dynamic_cast<FEContactInterface*>(fem.SurfacePairConstraint(i));
-		if (pci->IsActive()) pci->StiffnessMatrix(LS, tp);
+		if (pci->IsActive()) tasks.AddTask([=, &LS]() { pci->StiffnessMatrix(LS, tp); }, FETaskCost(*pci));
 	}
 }
 
 //-----------------------------------------------------------------------------
 //! Calculates the contact forces
 void FESolidSolver2::ContactForces(FEGlobalVector& R)
+{
+	FETaskList tasks;
+	ContactForces(R, tasks);
+	tasks.Run();
+}
+
+//-----------------------------------------------------------------------------
+//! Adds the contact force contributions to a task list
+void FESolidSolver2::ContactForces(FEGlobalVector& R, FETaskList& tasks)
 {
 	FEModel& fem = *GetFEModel();
 	const FETimeInfo& tp = fem.GetTime();
 	for (int i = 0; i<fem.SurfacePairConstraints(); ++i)
 	{
 		FEContactInterface* pci = dynamic_cast<FEContactInterface*>(fem.SurfacePairConstraint(i));
-		if (pci->IsActive()) pci->LoadVector(R, tp);
+		if (pci->IsActive()) tasks.AddTask([=, &R]() { pci->LoadVector(R, tp); }, FETaskCost(*pci));
 	}
 }
 
@@ -1214,6 +1249,7 @@ bool FESolidSolver2::Residual(vector<double>& R)
 
 	// calculate the internal (stress) forces
 	InternalForces(RHS);
+	RHS.Reduce();
 
 	// extract the internal forces
 	// (only when we really need it, below)
@@ -1232,6 +1268,7 @@ bool FESolidSolver2::Residual(vector<double>& R)
 
 	// calculate external forces
 	ExternalForces(RHS);
+	RHS.Reduce();
 
 	// For arc-length we need the external loads
 	if (m_arcLength > 0)
@@ -1279,6 +1316,7 @@ bool FESolidSolver2::Residual(vector<double>& R)
 void FESolidSolver2::InternalForces(FEGlobalVector& R)
 {
 	FEMesh& mesh = GetFEModel()->GetMesh();
+	FETaskList tasks(TaskAssembly());
 	for (int i = 0; i<mesh.Domains(); ++i)
 	{
 		FEDomain& dom = mesh.Domain(i);
@@ -1286,9 +1324,10 @@ void FESolidSolver2::InternalForces(FEGlobalVector& R)
 		if ((mat == nullptr) || (mat->IsRigid() == false))
 		{
 			FEElasticDomain& edom = dynamic_cast<FEElasticDomain&>(dom);
-			edom.InternalForces(R);
+			tasks.AddTask([&]() { edom.InternalForces(R); }, FETaskCost(dom));
 		}
 	}
+	tasks.Run();
 }
 
 //-----------------------------------------------------------------------------
@@ -1303,11 +1342,13 @@ void FESolidSolver2::ExternalForces(FEGlobalVector& RHS)
 	RHS += m_Fn;
 
 	// calculate the body forces
+	FETaskList tasks(TaskAssembly());
 	for (int j = 0; j<fem.BodyLoads(); ++j)
 	{
 		FEBodyLoad* pbl = fem.GetBodyLoad(j);
-		if (pbl->IsActive()) pbl->LoadVector(RHS, tp);
+		if (pbl->IsActive()) tasks.AddTask([=, &RHS, &tp]() { pbl->LoadVector(RHS, tp); }, FETaskCost(*pbl));
 	}
+	tasks.Run();
 
 	// calculate body forces for rigid bodies
 	for (int j = 0; j<fem.BodyLoads(); ++j)
@@ -1344,11 +1385,17 @@ void FESolidSolver2::ExternalForces(FEGlobalVector& RHS)
 	for (int i = 0; i<nsl; ++i)
 	{
 		FESurfaceLoad* psl = fem.SurfaceLoad(i);
-		if (psl->IsActive()) psl->LoadVector(RHS, tp);
+		if (psl->IsActive()) tasks.AddTask([=, &RHS, &tp]() { psl->LoadVector(RHS, tp); }, FETaskCost(*psl));
 	}
 
 	// calculate contact forces
-	ContactForces(RHS);
+	// NOTE: The surface loads and contact interfaces run concurrently, so they
+	// must only assemble through the (atomic) FEGlobalVector interface.
+	ContactForces(RHS, tasks);
+	tasks.Run();
+
+	// The nonlinear constraints and model loads are evaluated sequentially since
+	// many of them (e.g. rigid connectors) update rigid body data directly.
 
 	// calculate nonlinear constraint forces
 	// note that these are the linear constraints
@@ -1369,6 +1416,9 @@ void FESolidSolver2::ExternalForces(FEGlobalVector& RHS)
 		}
 	}
 
+	// add the recorded contributions before the reaction forces are read
+	RHS.Reduce();
+
 	// set the nodal reaction forces
 	// TODO: Is this a good place to do this?
 	for (int i = 0; i<mesh.Nodes(); ++i)
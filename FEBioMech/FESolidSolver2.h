@@ -34,6 +34,8 @@ SOFTWARE.*/
 #include "FERigidSolver.h"
 #include <FECore/FEDofList.h>
 
+class FETaskList;
+
 //-----------------------------------------------------------------------------
 //! The FESolidSolver2 class solves large deformation solid mechanics problems
 //! It can deal with quasi-static and dynamic problems
@@ -110,6 +112,7 @@ public:
 
 		//! contact stiffness
 		void ContactStiffness(FELinearSystem& LS);
+		void ContactStiffness(FELinearSystem& LS, FETaskList& tasks);
 
 		//! calculates stiffness contributon of nonlinear constraints
 		void NonLinearConstraintStiffness(FELinearSystem& LS, const FETimeInfo& tp);
@@ -119,6 +122,7 @@ public:
 
 		//! Calculate the contact forces
 		void ContactForces(FEGlobalVector& R);
+		void ContactForces(FEGlobalVector& R, FETaskList& tasks);
 
 		//! Calculates residual
 		virtual bool Residual(vector<double>& R) override;
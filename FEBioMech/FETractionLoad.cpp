@@ -84,7 +84,7 @@ void FETractionLoad::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 
 	// evaluate the integral
 	FETractionLoad* load = this;
-	surf.LoadVector(R, m_dof, m_blinear, [=](FESurfaceMaterialPoint& pt, const FESurfaceDofShape& dof_a, std::vector<double>& val) {
+	surf.LoadVector<3>(R, m_dof, m_blinear, [=](FESurfaceMaterialPoint& pt, const FESurfaceDofShape& dof_a, double* val) {
 
 		// evaluate traction at this material point
 		vec3d t = m_traction(pt)*m_scale;
@@ -76,6 +76,9 @@ public:
     //! cull generations
     void CullGenerations(FEMaterialPoint& pt);
     
+    //! merge generations to keep their number bounded
+    void CompactGenerations(FEMaterialPoint& pt);
+    
     //! evaluate bond mass fraction for a given generation
     double BreakingBondMassFraction(FEMaterialPoint& pt, const int ig, const mat3ds D);
     
@@ -113,5 +116,8 @@ public:
 
     int     m_nmax;     //!< highest number of generations achieved in analysis
     
+    double  m_gtol;     //!< generations whose bond mass fraction drops below this value are merged (compaction mode)
+    int     m_gmax;     //!< maximum number of generations kept per point (compaction mode, 0 = unlimited)
+    
     DECLARE_FECORE_CLASS();
 };
@@ -41,6 +41,7 @@ SOFTWARE.*/
 #include <FECore/FENodalLoad.h>
 #include <FECore/FESurfaceLoad.h>
 #include "FECore/sys.h"
+#include <FECore/FETaskList.h>
 
 //-----------------------------------------------------------------------------
 // define the parameter list
@@ -430,7 +431,13 @@ bool FEBiphasicSoluteSolver::Residual(vector<double>& R)
 	// get the mesh
 	FEMesh& mesh = fem.GetMesh();
 
+	// The domains, surface loads and contact interfaces are independent of each other,
+	// so they may be evaluated concurrently. The light ones run at the same time, which
+	// is why they all have to assemble atomically (see FETaskList).
+	FETaskList tasks(TaskAssembly());
+
 	// internal stress work
+	bool bsteady = (fem.GetCurrentStep()->m_nanalysis == FE_STEADY_STATE);
 	for (i=0; i<mesh.Domains(); ++i)
 	{
         FEDomain& dom = mesh.Domain(i);
@@ -438,26 +445,21 @@ bool FEBiphasicSoluteSolver::Residual(vector<double>& R)
         FEBiphasicDomain*  pbd = dynamic_cast<FEBiphasicDomain* >(&dom);
         FEBiphasicSoluteDomain* psd = dynamic_cast<FEBiphasicSoluteDomain*>(&dom);
         FETriphasicDomain*      ptd = dynamic_cast<FETriphasicDomain*     >(&dom);
+        double cost = FETaskCost(dom);
         if (psd) {
-            if (fem.GetCurrentStep()->m_nanalysis == FE_STEADY_STATE)
-                psd->InternalForcesSS(RHS);
-            else
-                psd->InternalForces(RHS);
+            if (bsteady) tasks.AddTask([=, &RHS]() { psd->InternalForcesSS(RHS); }, cost);
+            else tasks.AddTask([=, &RHS]() { psd->InternalForces(RHS); }, cost);
         }
         else if (ptd) {
-            if (fem.GetCurrentStep()->m_nanalysis == FE_STEADY_STATE)
-                ptd->InternalForcesSS(RHS);
-            else
-                ptd->InternalForces(RHS);
+            if (bsteady) tasks.AddTask([=, &RHS]() { ptd->InternalForcesSS(RHS); }, cost);
+            else tasks.AddTask([=, &RHS]() { ptd->InternalForces(RHS); }, cost);
         }
         else if (pbd) {
-            if (fem.GetCurrentStep()->m_nanalysis == FE_STEADY_STATE)
-                pbd->InternalForcesSS(RHS);
-            else
-                pbd->InternalForces(RHS);
+            if (bsteady) tasks.AddTask([=, &RHS]() { pbd->InternalForcesSS(RHS); }, cost);
+            else tasks.AddTask([=, &RHS]() { pbd->InternalForces(RHS); }, cost);
         }
         else if (ped)
-            ped->InternalForces(RHS);
+            tasks.AddTask([=, &RHS]() { ped->InternalForces(RHS); }, cost);
     }
     
 	// calculate forces due to surface loads
@@ -465,14 +467,12 @@ bool FEBiphasicSoluteSolver::Residual(vector<double>& R)
 	for (i=0; i<nsl; ++i)
 	{
 		FESurfaceLoad* psl = fem.SurfaceLoad(i);
-		if (psl->IsActive()) psl->LoadVector(RHS, tp);
+		if (psl->IsActive()) tasks.AddTask([=, &RHS, &tp]() { psl->LoadVector(RHS, tp); }, FETaskCost(*psl));
 	}
 
 	// calculate contact forces
-	if (fem.SurfacePairConstraints() > 0)
-	{
-		ContactForces(RHS);
-	}
+	ContactForces(RHS, tasks);
+	tasks.Run();
 
 	// calculate linear constraint forces
 	// note that these are the linear constraints
@@ -490,6 +490,9 @@ bool FEBiphasicSoluteSolver::Residual(vector<double>& R)
 		}
 	}
 
+	// add the recorded contributions before the reaction forces are read
+	RHS.Reduce();
+
 	// set the nodal reaction forces
 	// TODO: Is this a good place to do this?
 	for (i=0; i<mesh.Nodes(); ++i)
@@ -525,45 +528,42 @@ bool FEBiphasicSoluteSolver::StiffnessMatrix()
 	// setup the linear system
 	FESolidLinearSystem LS(this, &m_rigidSolver, *m_pK, m_Fd, m_ui, (m_msymm == REAL_SYMMETRIC), m_alpha, m_nreq);
 
+	// The domains, contact interfaces and surface loads are evaluated in a task list.
+	// The light ones run concurrently, so they have to assemble atomically.
+	FETaskList tasks(TaskAssembly());
+
 	// calculate the stiffness matrix for each domain
 	FEAnalysis* pstep = fem.GetCurrentStep();
 	bool bsymm = (m_msymm == REAL_SYMMETRIC);
-	if (pstep->m_nanalysis == FE_STEADY_STATE)
+	bool bsteady = (pstep->m_nanalysis == FE_STEADY_STATE);
+	for (int i=0; i<mesh.Domains(); ++i) 
 	{
-		for (int i=0; i<mesh.Domains(); ++i) 
+        // Biphasic-solute analyses may also include biphasic and elastic domains
+		FETriphasicDomain*      ptdom = dynamic_cast<FETriphasicDomain*>(&mesh.Domain(i));
+		FEBiphasicSoluteDomain* psdom = dynamic_cast<FEBiphasicSoluteDomain*>(&mesh.Domain(i));
+		FEBiphasicDomain*  pbdom = dynamic_cast<FEBiphasicDomain*>(&mesh.Domain(i));
+		FEElasticDomain*   pedom = dynamic_cast<FEElasticDomain*>(&mesh.Domain(i));
+		double cost = FETaskCost(mesh.Domain(i));
+		if (psdom)
 		{
-            // Biphasic-solute analyses may also include biphasic and elastic domains
-			FETriphasicDomain*      ptdom = dynamic_cast<FETriphasicDomain*>(&mesh.Domain(i));
-			FEBiphasicSoluteDomain* psdom = dynamic_cast<FEBiphasicSoluteDomain*>(&mesh.Domain(i));
-			FEBiphasicDomain*  pbdom = dynamic_cast<FEBiphasicDomain*>(&mesh.Domain(i));
-			FEElasticDomain*   pedom = dynamic_cast<FEElasticDomain*>(&mesh.Domain(i));
-			if (psdom) psdom->StiffnessMatrixSS(LS, bsymm);
-			else if (ptdom) ptdom->StiffnessMatrixSS(LS, bsymm);
-			else if (pbdom) pbdom->StiffnessMatrixSS(LS, bsymm);
-            else if (pedom) pedom->StiffnessMatrix(LS);
+			if (bsteady) tasks.AddTask([=, &LS]() { psdom->StiffnessMatrixSS(LS, bsymm); }, cost);
+			else tasks.AddTask([=, &LS]() { psdom->StiffnessMatrix(LS, bsymm); }, cost);
 		}
-	}
-	else
-	{
-		for (int i = 0; i<mesh.Domains(); ++i)
+		else if (ptdom)
+		{
+			if (bsteady) tasks.AddTask([=, &LS]() { ptdom->StiffnessMatrixSS(LS, bsymm); }, cost);
+			else tasks.AddTask([=, &LS]() { ptdom->StiffnessMatrix(LS, bsymm); }, cost);
+		}
+		else if (pbdom)
 		{
-            // Biphasic-solute analyses may also include biphasic and elastic domains
-			FETriphasicDomain*      ptdom = dynamic_cast<FETriphasicDomain*>(&mesh.Domain(i));
-			FEBiphasicSoluteDomain* psdom = dynamic_cast<FEBiphasicSoluteDomain*>(&mesh.Domain(i));
-			FEBiphasicDomain* pbdom = dynamic_cast<FEBiphasicDomain*>(&mesh.Domain(i));
-			FEElasticDomain* pedom = dynamic_cast<FEElasticDomain*>(&mesh.Domain(i));
-			if (psdom) psdom->StiffnessMatrix(LS, bsymm);
-			else if (ptdom) ptdom->StiffnessMatrix(LS, bsymm);
-			else if (pbdom) pbdom->StiffnessMatrix(LS, bsymm);
-            else if (pedom) pedom->StiffnessMatrix(LS);
+			if (bsteady) tasks.AddTask([=, &LS]() { pbdom->StiffnessMatrixSS(LS, bsymm); }, cost);
+			else tasks.AddTask([=, &LS]() { pbdom->StiffnessMatrix(LS, bsymm); }, cost);
 		}
+        else if (pedom) tasks.AddTask([=, &LS]() { pedom->StiffnessMatrix(LS); }, cost);
 	}
 
 	// calculate contact stiffness
-	if (fem.SurfacePairConstraints() > 0) 
-	{
-		ContactStiffness(LS);
-	}
+	ContactStiffness(LS, tasks);
 
 	// calculate stiffness matrices for surface loads
 	int nsl = fem.SurfaceLoads();
@@ -573,9 +573,10 @@ bool FEBiphasicSoluteSolver::StiffnessMatrix()
 
 		if (psl->IsActive())
 		{
-			psl->StiffnessMatrix(LS, tp);
+			tasks.AddTask([=, &LS, &tp]() { psl->StiffnessMatrix(LS, tp); }, FETaskCost(*psl));
 		}
 	}
+	tasks.Run();
 
 	// calculate nonlinear constraint stiffness
 	// note that this is the contribution of the 
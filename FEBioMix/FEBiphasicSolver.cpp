@@ -45,6 +45,7 @@ SOFTWARE.*/
 #include <FECore/FENodalLoad.h>
 #include <FECore/FEAnalysis.h>
 #include <FECore/FEBoundaryCondition.h>
+#include <FECore/FETaskList.h>
 
 //-----------------------------------------------------------------------------
 // define the parameter list
@@ -399,31 +400,25 @@ bool FEBiphasicSolver::Residual(vector<double>& R)
 	// get the mesh
 	FEMesh& mesh = fem.GetMesh();
 
+	// The domains, body loads, surface loads and contact interfaces are independent of
+	// each other, so they may be evaluated concurrently. The light ones run at the same
+	// time, which is why they all have to assemble atomically (see FETaskList).
+	FETaskList tasks(TaskAssembly());
+
 	// calculate internal stress force
-	if (fem.GetCurrentStep()->m_nanalysis == FE_STEADY_STATE)
+	bool bsteady = (fem.GetCurrentStep()->m_nanalysis == FE_STEADY_STATE);
+	for (int i=0; i<mesh.Domains(); ++i)
 	{
-		for (int i=0; i<mesh.Domains(); ++i)
+		FEBiphasicDomain* pdom = dynamic_cast<FEBiphasicDomain*>(&mesh.Domain(i));
+		if (pdom)
 		{
-			FEBiphasicDomain* pdom = dynamic_cast<FEBiphasicDomain*>(&mesh.Domain(i));
-			if (pdom) pdom->InternalForcesSS(RHS);
-            else
-            {
-                FEElasticDomain& dom = dynamic_cast<FEElasticDomain&>(mesh.Domain(i));
-                dom.InternalForces(RHS);
-            }
-        }
-	}
-	else
-	{
-		for (int i=0; i<mesh.Domains(); ++i)
+			if (bsteady) tasks.AddTask([=, &RHS]() { pdom->InternalForcesSS(RHS); }, FETaskCost(mesh.Domain(i)));
+			else tasks.AddTask([=, &RHS]() { pdom->InternalForces(RHS); }, FETaskCost(mesh.Domain(i)));
+		}
+		else
 		{
-			FEBiphasicDomain* pdom = dynamic_cast<FEBiphasicDomain*>(&mesh.Domain(i));
-			if (pdom) pdom->InternalForces(RHS);
-            else
-            {
-                FEElasticDomain& dom = dynamic_cast<FEElasticDomain&>(mesh.Domain(i));
-                dom.InternalForces(RHS);
-            }
+			FEElasticDomain& dom = dynamic_cast<FEElasticDomain&>(mesh.Domain(i));
+			tasks.AddTask([&]() { dom.InternalForces(RHS); }, FETaskCost(mesh.Domain(i)));
 		}
 	}
 
@@ -431,18 +426,19 @@ bool FEBiphasicSolver::Residual(vector<double>& R)
 	for (int j = 0; j<fem.BodyLoads(); ++j)
 	{
 		FEBodyLoad* pbl = fem.GetBodyLoad(j);
-		if (pbl->IsActive()) pbl->LoadVector(RHS, tp);
+		if (pbl->IsActive()) tasks.AddTask([=, &RHS, &tp]() { pbl->LoadVector(RHS, tp); }, FETaskCost(*pbl));
     }
     
 	// calculate forces due to surface loads
 	for (int i=0; i<fem.SurfaceLoads(); ++i)
 	{
 		FESurfaceLoad* psl = fem.SurfaceLoad(i);
-		if (psl->IsActive()) psl->LoadVector(RHS, tp);
+		if (psl->IsActive()) tasks.AddTask([=, &RHS, &tp]() { psl->LoadVector(RHS, tp); }, FETaskCost(*psl));
 	}
 
 	// calculate contact forces
-	ContactForces(RHS);
+	ContactForces(RHS, tasks);
+	tasks.Run();
 
 	// calculate nonlinear constraint forces
 	// note that these are the linear constraints
@@ -460,6 +456,9 @@ bool FEBiphasicSolver::Residual(vector<double>& R)
 		}
 	}
 
+	// add the recorded contributions before the reaction forces are read
+	RHS.Reduce();
+
 	// set the nodal reaction forces
 	// TODO: Is this a good place to do this?
 	for (int i=0; i<mesh.Nodes(); ++i)
@@ -495,35 +494,27 @@ bool FEBiphasicSolver::StiffnessMatrix()
 	// setup the linear system of equations
 	FESolidLinearSystem LS(this, &m_rigidSolver, *m_pK, m_Fd, m_ui, (m_msymm == REAL_SYMMETRIC), m_alpha, m_nreq);
 
+	// The domains, body loads, contact interfaces and surface loads are evaluated in a
+	// task list. The light ones run concurrently, so they have to assemble atomically.
+	FETaskList tasks(TaskAssembly());
+
 	// calculate the stiffness matrix for each domain
 	FEAnalysis* pstep = fem.GetCurrentStep();
 	bool bsymm = (m_msymm == REAL_SYMMETRIC);
-	if (pstep->m_nanalysis == FE_STEADY_STATE)
+	bool bsteady = (pstep->m_nanalysis == FE_STEADY_STATE);
+	for (int i=0; i<mesh.Domains(); ++i) 
 	{
-		for (int i=0; i<mesh.Domains(); ++i) 
+        // Biphasic analyses may include biphasic and elastic domains
+		FEBiphasicDomain* pbdom = dynamic_cast<FEBiphasicDomain*>(&mesh.Domain(i));
+		if (pbdom)
 		{
-            // Biphasic analyses may include biphasic and elastic domains
-			FEBiphasicDomain* pbdom = dynamic_cast<FEBiphasicDomain*>(&mesh.Domain(i));
-			if (pbdom) pbdom->StiffnessMatrixSS(LS, bsymm);
-            else
-			{
-				FEElasticDomain* pedom = dynamic_cast<FEElasticDomain*>(&mesh.Domain(i));
-				if (pedom) pedom->StiffnessMatrix(LS);
-			}
+			if (bsteady) tasks.AddTask([=, &LS]() { pbdom->StiffnessMatrixSS(LS, bsymm); }, FETaskCost(mesh.Domain(i)));
+			else tasks.AddTask([=, &LS]() { pbdom->StiffnessMatrix(LS, bsymm); }, FETaskCost(mesh.Domain(i)));
 		}
-	}
-	else
-	{
-		for (int i=0; i<mesh.Domains(); ++i) 
+        else
 		{
-            // Biphasic analyses may include biphasic and elastic domains
-			FEBiphasicDomain* pbdom = dynamic_cast<FEBiphasicDomain*>(&mesh.Domain(i));
-			if (pbdom) pbdom->StiffnessMatrix(LS, bsymm);
-            else 
-			{
-				FEElasticDomain* pedom = dynamic_cast<FEElasticDomain*>(&mesh.Domain(i));
-				if (pedom) pedom->StiffnessMatrix(LS);
-			}
+			FEElasticDomain* pedom = dynamic_cast<FEElasticDomain*>(&mesh.Domain(i));
+			if (pedom) tasks.AddTask([=, &LS]() { pedom->StiffnessMatrix(LS); }, FETaskCost(mesh.Domain(i)));
 		}
 	}
 
@@ -533,19 +524,20 @@ bool FEBiphasicSolver::StiffnessMatrix()
 	for (int j = 0; j<NBL; ++j)
 	{
 		FEBodyLoad* pbl = fem.GetBodyLoad(j);
-		if (pbl->IsActive()) pbl->StiffnessMatrix(LS, tp);
+		if (pbl->IsActive()) tasks.AddTask([=, &LS, &tp]() { pbl->StiffnessMatrix(LS, tp); }, FETaskCost(*pbl));
     }
     
 	// calculate contact stiffness
-	ContactStiffness(LS);
+	ContactStiffness(LS, tasks);
 
 	// calculate stiffness matrices for surface loads
 	int nsl = fem.SurfaceLoads();
 	for (int i=0; i<nsl; ++i)
 	{
 		FESurfaceLoad* psl = fem.SurfaceLoad(i);
-		if (psl->IsActive()) psl->StiffnessMatrix(LS, tp);
+		if (psl->IsActive()) tasks.AddTask([=, &LS, &tp]() { psl->StiffnessMatrix(LS, tp); }, FETaskCost(*psl));
 	}
+	tasks.Run();
 
 	// calculate nonlinear constraint stiffness
 	// note that this is the contribution of the 
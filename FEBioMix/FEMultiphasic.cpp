@@ -44,6 +44,10 @@ BEGIN_FECORE_CLASS(FEMultiphasic, FEMaterial)
 	ADD_PARAMETER(m_rhoTw  , FE_RANGE_GREATER_OR_EQUAL(0.0), "fluid_density");
 	ADD_PARAMETER(m_penalty, FE_RANGE_GREATER_OR_EQUAL(0.0), "penalty"      );
 	ADD_PARAMETER(m_cFr    , "fixed_charge_density");
+	ADD_PARAMETER(m_breactionSplit , "reaction_split");
+	ADD_PARAMETER(m_nreactionSteps , FE_RANGE_GREATER(0), "reaction_substeps");
+	ADD_PARAMETER(m_reactionTol    , FE_RANGE_GREATER(0.0), "reaction_tol");
+	ADD_PARAMETER(m_reactionMaxIter, FE_RANGE_GREATER(0), "reaction_max_iter");
 
 	// define the material properties
 	ADD_PROPERTY(m_pSolid , "solid"              );
@@ -276,6 +280,11 @@ FEMultiphasic::FEMultiphasic(FEModel* pfem) : FEMaterial(pfem)
 	m_Rgas = 0; m_Tabs = 0; m_Fc = 0;
 	m_penalty = 1;
 
+	m_breactionSplit = false;
+	m_nreactionSteps = 4;
+	m_reactionTol = 1e-8;
+	m_reactionMaxIter = 25;
+
 	m_pSolid = 0;
 	m_pPerm = 0;
 	m_pOsmC = 0;
@@ -180,6 +180,12 @@ public: // parameters
 	double              m_rhoTw;    //!< true fluid density
 	double              m_penalty;  //!< penalty for enforcing electroneutrality
 
+	// operator splitting of the chemical reactions
+	bool				m_breactionSplit;	//!< integrate the reactions locally instead of in the global system
+	int					m_nreactionSteps;	//!< number of sub-steps for the local integration
+	double				m_reactionTol;		//!< convergence tolerance of the local integration
+	int					m_reactionMaxIter;	//!< max Newton iterations per sub-step
+
 public:
 	double	m_Rgas;			//!< universal gas constant
 	double	m_Tabs;			//!< absolute temperature
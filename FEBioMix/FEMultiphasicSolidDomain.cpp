@@ -29,6 +29,8 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "FEMultiphasicSolidDomain.h"
 #include "FEMultiphasicMultigeneration.h"
+#include "FEMultiphasicStandard.h"
+#include "FEReactionIntegrator.h"
 #include "FECore/FEModel.h"
 #include "FECore/FEAnalysis.h"
 #include "FECore/log.h"
@@ -44,6 +46,7 @@ SOFTWARE.*/
 FEMultiphasicSolidDomain::FEMultiphasicSolidDomain(FEModel* pfem) : FESolidDomain(pfem), FEMultiphasicDomain(pfem), m_dofU(pfem), m_dofSU(pfem), m_dofR(pfem), m_dof(pfem)
 {
     m_pMat = 0;
+	m_breactionSplit = false;
 	m_dofU.AddVariable(FEBioMech::GetVariableName(FEBioMech::DISPLACEMENT));
 	m_dofSU.AddVariable(FEBioMech::GetVariableName(FEBioMech::SHELL_DISPLACEMENT));
 	m_dofR.AddVariable(FEBioMech::GetVariableName(FEBioMech::RIGID_ROTATION));
@@ -185,6 +188,17 @@ bool FEMultiphasicSolidDomain::Init()
         }
     }
 
+	// The local reaction integration replaces the time integration of the solid-bound
+	// molecules, which the multigeneration material does per generation.
+	m_breactionSplit = false;
+	if (m_pMat->m_breactionSplit && (m_pMat->Reactions() > 0))
+	{
+		if (dynamic_cast<FEMultiphasicStandard*>(m_pMat))
+			m_breactionSplit = true;
+		else
+			feLogWarning("The reaction_split option is not supported by this multiphasic material and will be ignored.");
+	}
+
 	// set the active degrees of freedom list
 	FEDofList dofs(GetFEModel());
 	for (int i=0; i<nsol; ++i)
@@ -481,6 +495,65 @@ void FEMultiphasicSolidDomain::PreSolveUpdate(const FETimeInfo& timeInfo)
             mp.Update(timeInfo);
         }
     }
+
+    // advance the reactions over the new time increment before the transport problem is solved
+    if (SplitReactions()) IntegrateReactions(timeInfo.timeIncrement);
+}
+
+//-----------------------------------------------------------------------------
+bool FEMultiphasicSolidDomain::SplitReactions()
+{
+    if (m_breactionSplit == false) return false;
+
+    // in a steady-state analysis the reactions always remain in the global system
+    FEAnalysis* step = GetFEModel()->GetCurrentStep();
+    return (step && (step->m_nanalysis != FE_STEADY_STATE));
+}
+
+//-----------------------------------------------------------------------------
+//! Integrate the chemical reactions at each integration point over the time increment.
+//! The resulting change in the solute concentrations is added to the referential
+//! concentrations of the previous time step, so that the transport problem starts
+//! from the reacted state. The solid-bound molecule densities are updated directly.
+void FEMultiphasicSolidDomain::IntegrateReactions(double dt)
+{
+    const int NE = (int)m_Elem.size();
+    const int nsol = m_pMat->Solutes();
+    int nfail = 0;
+
+#pragma omp parallel reduction(+:nfail)
+    {
+        FEReactionIntegrator ri(m_pMat);
+
+#pragma omp for schedule(dynamic, 16)
+        for (int i=0; i<NE; ++i)
+        {
+            FESolidElement& el = m_Elem[i];
+            if (el.isActive() == false) continue;
+
+            int nint = el.GaussPoints();
+            for (int n=0; n<nint; ++n)
+            {
+                FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+                FEElasticMaterialPoint& pe = *mp.ExtractData<FEElasticMaterialPoint>();
+                FESolutesMaterialPoint& ps = *(mp.ExtractData<FESolutesMaterialPoint>());
+
+                double phiwhat = 0;
+                if (ri.Integrate(mp, dt, phiwhat) == false) { nfail++; phiwhat = 0; }
+                ps.m_phiwhatr = phiwhat;
+
+                double phiw = m_pMat->Porosity(mp);
+                for (int j=0; j<nsol; ++j)
+                    ps.m_crp[j] = pe.m_J*phiw*ps.m_ca[j];
+
+                ps.m_sbmrp = ps.m_sbmr;
+                for (int j=0; j<ps.m_nsbm; ++j) ps.m_sbmrhat[j] = ps.m_sbmrhatp[j] = 0;
+            }
+        }
+    }
+
+    if (nfail > 0)
+        feLogWarning("Local integration of chemical reactions failed at %d integration points.\nThe reactions were not applied at these points.", nfail);
 }
 
 //-----------------------------------------------------------------------------
@@ -540,7 +613,8 @@ void FEMultiphasicSolidDomain::ElementInternalForce(FESolidElement& el, vector<d
     const int nsol = m_pMat->Solutes();
     int ndpn = 4+nsol;
     
-    const int nreact = m_pMat->Reactions();
+    // reactions that are integrated locally do not contribute to the global system
+    const int nreact = (SplitReactions() ? 0 : m_pMat->Reactions());
     
     double dt = GetFEModel()->GetTime().timeIncrement;
     
@@ -603,6 +677,7 @@ void FEMultiphasicSolidDomain::ElementInternalForce(FESolidElement& el, vector<d
             for (isol=0; isol<nsol; ++isol)
                 chat[isol] += phiw*zhat*pri->m_v[isol];
         }
+        if (nreact != m_pMat->Reactions()) phiwhat += spt.m_phiwhatr;
         
         for (i=0; i<neln; ++i)
         {
@@ -863,7 +938,8 @@ bool FEMultiphasicSolidDomain::ElementMultiphasicStiffness(FESolidElement& el, m
     int ndpn = 4+nsol;
     
     const int nsbm   = m_pMat->SBMs();
-    const int nreact = m_pMat->Reactions();
+    // reactions that are integrated locally do not contribute to the global system
+    const int nreact = (SplitReactions() ? 0 : m_pMat->Reactions());
     
     // zero stiffness matrix
     ke.zero();
@@ -1607,6 +1683,7 @@ void FEMultiphasicSolidDomain::UpdateElementStress(int iel, double dt)
     // get the multiphasic material
     FEMultiphasic* pmb = m_pMat;
     const int nsol = (int)pmb->Solutes();
+    const bool bsplit = SplitReactions();
     vector< vector<double> > ct(nsol, vector<double>(FEElement::MAX_NODES));
     vector<int> sid(nsol);
     for (j=0; j<nsol; ++j) sid[j] = pmb->GetSolute(j)->GetSoluteDOF();
@@ -1666,7 +1743,8 @@ void FEMultiphasicSolidDomain::UpdateElementStress(int iel, double dt)
         FESolutesMaterialPoint& spt = *(mp.ExtractData<FESolutesMaterialPoint>());
         
         // update SBM referential densities
-        pmb->UpdateSolidBoundMolecules(mp);
+        // (with split reactions, these were already updated at the start of the time step)
+        if (bsplit == false) pmb->UpdateSolidBoundMolecules(mp);
         
         // evaluate referential solid volume fraction
         ppt.m_phi0 = pmb->SolidReferentialVolumeFraction(mp);
@@ -79,6 +79,12 @@ public:
     // update element state data
     void UpdateElementStress(int iel, double dt);
 
+    //! returns true if the chemical reactions are integrated locally instead of in the global system
+    bool SplitReactions();
+
+    //! integrate the chemical reactions locally at all integration points (operator splitting)
+    void IntegrateReactions(double dt);
+
 	// get total dof list
 	const FEDofList& GetDOFList() const override;
     
@@ -115,4 +121,5 @@ protected:
 	FEDofList	m_dofSU;
 	FEDofList	m_dofR;
 	FEDofList	m_dof;
+	bool		m_breactionSplit;	//!< the reactions are split off from the transport problem
 };
@@ -49,6 +49,7 @@ SOFTWARE.*/
 #include <FECore/FEAnalysis.h>
 #include <FECore/FENodalLoad.h>
 #include <FECore/FEBoundaryCondition.h>
+#include <FECore/FETaskList.h>
 
 //-----------------------------------------------------------------------------
 // define the parameter list
@@ -483,7 +484,13 @@ bool FEMultiphasicSolver::Residual(vector<double>& R)
 	// get the mesh
 	FEMesh& mesh = fem.GetMesh();
 
+	// The domains, surface loads, body loads and contact interfaces are independent of
+	// each other, so they are collected in a task list. The light ones run at the same
+	// time, so all of them have to assemble atomically (see FETaskList).
+	FETaskList tasks(TaskAssembly());
+
 	// internal stress work
+	bool bsteady = (fem.GetCurrentStep()->m_nanalysis == FE_STEADY_STATE);
 	for (i=0; i<mesh.Domains(); ++i)
 	{
         FEDomain& dom = mesh.Domain(i);
@@ -492,32 +499,25 @@ bool FEMultiphasicSolver::Residual(vector<double>& R)
         FEBiphasicSoluteDomain* pbs = dynamic_cast<FEBiphasicSoluteDomain*>(&dom);
         FETriphasicDomain*      ptd = dynamic_cast<FETriphasicDomain*     >(&dom);
         FEMultiphasicDomain*    pmd = dynamic_cast<FEMultiphasicDomain*   >(&dom);
+        double cost = FETaskCost(dom);
         if (pbd) {
-            if (fem.GetCurrentStep()->m_nanalysis == FE_STEADY_STATE)
-                pbd->InternalForcesSS(RHS);
-            else
-                pbd->InternalForces(RHS);
+            if (bsteady) tasks.AddTask([=, &RHS]() { pbd->InternalForcesSS(RHS); }, cost);
+            else tasks.AddTask([=, &RHS]() { pbd->InternalForces(RHS); }, cost);
         }
         else if (pbs) {
-            if (fem.GetCurrentStep()->m_nanalysis == FE_STEADY_STATE)
-                pbs->InternalForcesSS(RHS);
-            else
-                pbs->InternalForces(RHS);
+            if (bsteady) tasks.AddTask([=, &RHS]() { pbs->InternalForcesSS(RHS); }, cost);
+            else tasks.AddTask([=, &RHS]() { pbs->InternalForces(RHS); }, cost);
         }
         else if (ptd) {
-            if (fem.GetCurrentStep()->m_nanalysis == FE_STEADY_STATE)
-                ptd->InternalForcesSS(RHS);
-            else
-                ptd->InternalForces(RHS);
+            if (bsteady) tasks.AddTask([=, &RHS]() { ptd->InternalForcesSS(RHS); }, cost);
+            else tasks.AddTask([=, &RHS]() { ptd->InternalForces(RHS); }, cost);
         }
         else if (pmd) {
-            if (fem.GetCurrentStep()->m_nanalysis == FE_STEADY_STATE)
-                pmd->InternalForcesSS(RHS);
-            else
-                pmd->InternalForces(RHS);
+            if (bsteady) tasks.AddTask([=, &RHS]() { pmd->InternalForcesSS(RHS); }, cost);
+            else tasks.AddTask([=, &RHS]() { pmd->InternalForces(RHS); }, cost);
         }
         else if (ped)
-            ped->InternalForces(RHS);
+            tasks.AddTask([=, &RHS]() { ped->InternalForces(RHS); }, cost);
     }
     
 	// calculate forces due to surface loads
@@ -525,7 +525,7 @@ bool FEMultiphasicSolver::Residual(vector<double>& R)
 	for (i=0; i<nsl; ++i)
 	{
 		FESurfaceLoad* psl = fem.SurfaceLoad(i);
-		if (psl->IsActive()) psl->LoadVector(RHS, tp);
+		if (psl->IsActive()) tasks.AddTask([=, &RHS, &tp]() { psl->LoadVector(RHS, tp); }, FETaskCost(*psl));
 	}
 
 	// calculate body forces
@@ -536,11 +536,12 @@ bool FEMultiphasicSolver::Residual(vector<double>& R)
 	for (int i = 0; i < nbl; ++i)
 	{
 		FEBodyLoad* pbl = fem.GetBodyLoad(i);
-		if (pbl->IsActive()) pbl->LoadVector(RHS, tp);
+		if (pbl->IsActive()) tasks.AddTask([=, &RHS, &tp]() { pbl->LoadVector(RHS, tp); }, FETaskCost(*pbl));
 	}
 
 	// calculate contact forces
-	ContactForces(RHS);
+	ContactForces(RHS, tasks);
+	tasks.Run();
 
 	// calculate linear constraint forces
 	// note that these are the linear constraints
@@ -558,6 +559,9 @@ bool FEMultiphasicSolver::Residual(vector<double>& R)
 		}
 	}
 
+	// add the recorded contributions before the reaction forces are read
+	RHS.Reduce();
+
 	// set the nodal reaction forces
 	// TODO: Is this a good place to do this?
 	for (i=0; i<mesh.Nodes(); ++i)
@@ -592,48 +596,44 @@ bool FEMultiphasicSolver::StiffnessMatrix()
 
 	FESolidLinearSystem LS(this, &m_rigidSolver, *m_pK, m_Fd, m_ui, (m_msymm == REAL_SYMMETRIC), m_alpha, m_nreq);
 
+	// The domains, contact interfaces, surface loads and body loads are evaluated in a
+	// task list. The light ones run concurrently, so they have to assemble atomically.
+	FETaskList tasks(TaskAssembly());
+
 	// calculate the stiffness matrix for each domain
 	FEAnalysis* pstep = fem.GetCurrentStep();
 	bool bsymm = (m_msymm == REAL_SYMMETRIC);
-	if (pstep->m_nanalysis == FE_STEADY_STATE)
+	bool bsteady = (pstep->m_nanalysis == FE_STEADY_STATE);
+	for (int i=0; i<mesh.Domains(); ++i) 
 	{
-		for (int i=0; i<mesh.Domains(); ++i) 
+		FEDomain& dom = mesh.Domain(i);
+		FEElasticDomain*        pde = dynamic_cast<FEElasticDomain*  >(&dom);
+		FEBiphasicDomain*       pbd = dynamic_cast<FEBiphasicDomain* >(&dom);
+		FEBiphasicSoluteDomain* pbs = dynamic_cast<FEBiphasicSoluteDomain*>(&dom);
+		FETriphasicDomain*      ptd = dynamic_cast<FETriphasicDomain*     >(&dom);
+		FEMultiphasicDomain*    pmd = dynamic_cast<FEMultiphasicDomain*   >(&dom);
+		double cost = FETaskCost(dom);
+
+		if (bsteady)
 		{
-			FEDomain& dom = mesh.Domain(i);
-			FEElasticDomain*        pde = dynamic_cast<FEElasticDomain*  >(&dom);
-			FEBiphasicDomain*       pbd = dynamic_cast<FEBiphasicDomain* >(&dom);
-			FEBiphasicSoluteDomain* pbs = dynamic_cast<FEBiphasicSoluteDomain*>(&dom);
-			FETriphasicDomain*      ptd = dynamic_cast<FETriphasicDomain*     >(&dom);
-			FEMultiphasicDomain*    pmd = dynamic_cast<FEMultiphasicDomain*   >(&dom);
-
-			if      (pbd) pbd->StiffnessMatrixSS(LS, bsymm);
-			else if (pbs) pbs->StiffnessMatrixSS(LS, bsymm);
-			else if (ptd) ptd->StiffnessMatrixSS(LS, bsymm);
-			else if (pmd) pmd->StiffnessMatrixSS(LS, bsymm);
-            else if (pde) pde->StiffnessMatrix(LS);
+			if      (pbd) tasks.AddTask([=, &LS]() { pbd->StiffnessMatrixSS(LS, bsymm); }, cost);
+			else if (pbs) tasks.AddTask([=, &LS]() { pbs->StiffnessMatrixSS(LS, bsymm); }, cost);
+			else if (ptd) tasks.AddTask([=, &LS]() { ptd->StiffnessMatrixSS(LS, bsymm); }, cost);
+			else if (pmd) tasks.AddTask([=, &LS]() { pmd->StiffnessMatrixSS(LS, bsymm); }, cost);
+			else if (pde) tasks.AddTask([=, &LS]() { pde->StiffnessMatrix(LS); }, cost);
 		}
-	}
-	else
-	{
-		for (int i = 0; i<mesh.Domains(); ++i)
+		else
 		{
-			FEDomain& dom = mesh.Domain(i);
-			FEElasticDomain*        pde = dynamic_cast<FEElasticDomain*  >(&dom);
-			FEBiphasicDomain*       pbd = dynamic_cast<FEBiphasicDomain* >(&dom);
-			FEBiphasicSoluteDomain* pbs = dynamic_cast<FEBiphasicSoluteDomain*>(&dom);
-			FETriphasicDomain*      ptd = dynamic_cast<FETriphasicDomain*     >(&dom);
-			FEMultiphasicDomain*    pmd = dynamic_cast<FEMultiphasicDomain*   >(&dom);
-
-			if      (pbd) pbd->StiffnessMatrix(LS, bsymm);
-			else if (pbs) pbs->StiffnessMatrix(LS, bsymm);
-			else if (ptd) ptd->StiffnessMatrix(LS, bsymm);
-			else if (pmd) pmd->StiffnessMatrix(LS, bsymm);
-            else if (pde) pde->StiffnessMatrix(LS);
+			if      (pbd) tasks.AddTask([=, &LS]() { pbd->StiffnessMatrix(LS, bsymm); }, cost);
+			else if (pbs) tasks.AddTask([=, &LS]() { pbs->StiffnessMatrix(LS, bsymm); }, cost);
+			else if (ptd) tasks.AddTask([=, &LS]() { ptd->StiffnessMatrix(LS, bsymm); }, cost);
+			else if (pmd) tasks.AddTask([=, &LS]() { pmd->StiffnessMatrix(LS, bsymm); }, cost);
+			else if (pde) tasks.AddTask([=, &LS]() { pde->StiffnessMatrix(LS); }, cost);
 		}
 	}
 
 	// calculate contact stiffness
-	ContactStiffness(LS);
+	ContactStiffness(LS, tasks);
 
 	// calculate stiffness matrices for surface loads
 	int nsl = fem.SurfaceLoads();
@@ -643,7 +643,7 @@ bool FEMultiphasicSolver::StiffnessMatrix()
 
 		if (psl->IsActive())
 		{
-			psl->StiffnessMatrix(LS, tp);
+			tasks.AddTask([=, &LS, &tp]() { psl->StiffnessMatrix(LS, tp); }, FETaskCost(*psl));
 		}
 	}
 
@@ -655,8 +655,9 @@ bool FEMultiphasicSolver::StiffnessMatrix()
 	for (int i = 0; i < nbl; ++i)
 	{
 		FEBodyLoad* pbl = fem.GetBodyLoad(i);
-		if (pbl->IsActive()) pbl->StiffnessMatrix(LS, tp);
+		if (pbl->IsActive()) tasks.AddTask([=, &LS, &tp]() { pbl->StiffnessMatrix(LS, tp); }, FETaskCost(*pbl));
 	}
+	tasks.Run();
 
 	// calculate nonlinear constraint stiffness
 	// note that this is the contribution of the 
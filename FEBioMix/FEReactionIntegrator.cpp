@@ -0,0 +1,219 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FEReactionIntegrator.h"
+#include "FEMultiphasic.h"
+#include "FEChemicalReaction.h"
+#include <FECore/FEMaterialPoint.h>
+#include <FECore/sys.h>
+#include <math.h>
+#include <float.h>
+
+//-----------------------------------------------------------------------------
+FEReactionIntegrator::FEReactionIntegrator(FEMultiphasic* pmat) : m_pMat(pmat)
+{
+	m_nsol = pmat->Solutes();
+	m_nsbm = pmat->SBMs();
+	m_nreact = pmat->Reactions();
+	m_n = m_nsol + m_nsbm;
+	m_J = 1.0;
+	m_phi0 = 0.0;
+
+	m_y.resize(m_n);
+	m_yn.resize(m_n);
+	m_ys.resize(m_n);
+	m_dy.resize(m_n);
+	m_f.resize(m_n);
+	m_fp.resize(m_n);
+	m_zeta.resize(m_nreact);
+	m_zsum.resize(m_nreact);
+	m_K.resize(m_n, m_n);
+	m_indx.resize(m_n);
+
+	// the bounds and molar masses of the solid-bound molecules
+	m_rhomin.resize(m_nsbm);
+	m_rhomax.resize(m_nsbm);
+	m_M.resize(m_nsbm);
+	for (int i = 0; i < m_nsbm; ++i)
+	{
+		FESolidBoundMolecule* sbm = pmat->GetSBM(i);
+		m_rhomin[i] = sbm->m_rhomin;
+		m_rhomax[i] = sbm->m_rhomax;
+		m_M[i] = pmat->SBMMolarMass(i);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEReactionIntegrator::Rates(FEMaterialPoint& mp, const double* y, double* f)
+{
+	FESolutesMaterialPoint& spt = *(mp.ExtractData<FESolutesMaterialPoint>());
+
+	// The reactions evaluate their supplies from the material point data, so we
+	// copy the trial state to the material point. Some reactions use the effective
+	// concentrations, which are obtained with the (fixed) partition coefficients.
+	for (int i = 0; i < m_nsol; ++i)
+	{
+		spt.m_ca[i] = y[i];
+		double k = spt.m_k[i];
+		spt.m_c[i] = (k > 0.0 ? y[i] / k : y[i]);
+	}
+	for (int i = 0; i < m_nsbm; ++i) spt.m_sbmr[i] = y[m_nsol + i];
+
+	for (int i = 0; i < m_n; ++i) f[i] = 0.0;
+	for (int k = 0; k < m_nreact; ++k)
+	{
+		FEChemicalReaction* pri = m_pMat->GetReaction(k);
+		double zhat = pri->ReactionSupply(mp);
+		m_zeta[k] = zhat;
+
+		const int* v = &pri->m_v[0];
+		for (int i = 0; i < m_nsol; ++i) f[i] += v[i] * zhat;
+
+		// convert from molar supply to referential mass supply
+		for (int i = 0; i < m_nsbm; ++i) f[m_nsol + i] += (m_J - m_phi0)*m_M[i] * v[m_nsol + i] * zhat;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEReactionIntegrator::Clamp(double* y)
+{
+	for (int i = 0; i < m_nsol; ++i) if (y[i] < 0.0) y[i] = 0.0;
+	for (int i = 0; i < m_nsbm; ++i)
+	{
+		double& r = y[m_nsol + i];
+		if (r < m_rhomin[i]) r = m_rhomin[i];
+		if ((m_rhomax[i] > 0) && (r > m_rhomax[i])) r = m_rhomax[i];
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool FEReactionIntegrator::Step(FEMaterialPoint& mp, const double* y0, double h)
+{
+	const int n = m_n;
+	const double tol = m_pMat->m_reactionTol;
+	const int maxIter = m_pMat->m_reactionMaxIter;
+	const double sqeps = sqrt(DBL_EPSILON);
+
+	double* y = &m_y[0];
+	double* f = &m_f[0];
+	double* fp = &m_fp[0];
+	double* dy = &m_dy[0];
+	for (int i = 0; i < n; ++i) y[i] = y0[i];
+
+	for (int iter = 0; iter < maxIter; ++iter)
+	{
+		// residual of the backward Euler step
+		Rates(mp, y, f);
+		for (int i = 0; i < n; ++i) dy[i] = -(y[i] - y0[i] - h*f[i]);
+
+		// Jacobian (finite differences)
+		for (int j = 0; j < n; ++j)
+		{
+			double yj = y[j];
+			double d = sqeps*(fabs(yj) > 1.0 ? fabs(yj) : 1.0);
+			y[j] = yj + d;
+			Rates(mp, y, fp);
+			y[j] = yj;
+			for (int i = 0; i < n; ++i) m_K[i][j] = (i == j ? 1.0 : 0.0) - h*(fp[i] - f[i]) / d;
+		}
+
+		// Newton update
+		m_K.lufactor(m_indx);
+		m_K.lusolve(m_dy, m_indx);
+		for (int i = 0; i < n; ++i) y[i] += dy[i];
+		Clamp(y);
+
+		// check convergence
+		bool bconv = true;
+		for (int i = 0; i < n; ++i)
+		{
+			if (ISNAN(y[i])) return false;
+			if (fabs(dy[i]) > tol*(fabs(y[i]) + tol)) { bconv = false; break; }
+		}
+		if (bconv)
+		{
+			// evaluate the molar supplies at the end of the step
+			Rates(mp, y, f);
+			return true;
+		}
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+bool FEReactionIntegrator::Integrate(FEMaterialPoint& mp, double dt, double& phiwhat)
+{
+	phiwhat = 0.0;
+	if ((m_nreact == 0) || (dt <= 0.0)) return true;
+
+	FEElasticMaterialPoint& ept = *(mp.ExtractData<FEElasticMaterialPoint>());
+	FEBiphasicMaterialPoint& bpt = *(mp.ExtractData<FEBiphasicMaterialPoint>());
+	FESolutesMaterialPoint& spt = *(mp.ExtractData<FESolutesMaterialPoint>());
+	m_J = ept.m_J;
+	m_phi0 = bpt.m_phi0;
+	double phiw = m_pMat->Porosity(mp);
+
+	// initial state
+	for (int i = 0; i < m_nsol; ++i) m_yn[i] = spt.m_ca[i];
+	for (int i = 0; i < m_nsbm; ++i) m_yn[m_nsol + i] = spt.m_sbmr[i];
+	m_ys = m_yn;
+	for (int k = 0; k < m_nreact; ++k) m_zsum[k] = 0.0;
+
+	// integrate over the sub-steps. If a step fails, the step size is halved.
+	const int nsteps = (m_pMat->m_nreactionSteps > 0 ? m_pMat->m_nreactionSteps : 1);
+	const int MAX_CUTS = 10;
+	double h = dt / nsteps;
+	double t = 0.0;
+	int ncuts = 0;
+	while (t < dt*(1.0 - 1e-12))
+	{
+		if (t + h > dt) h = dt - t;
+		if (Step(mp, &m_ys[0], h))
+		{
+			m_ys = m_y;
+			for (int k = 0; k < m_nreact; ++k) m_zsum[k] += h*m_zeta[k];
+			t += h;
+		}
+		else if (++ncuts <= MAX_CUTS) h *= 0.5;
+		else
+		{
+			// restore the initial state
+			Rates(mp, &m_yn[0], &m_f[0]);
+			return false;
+		}
+	}
+
+	// store the final state
+	Rates(mp, &m_ys[0], &m_f[0]);
+
+	// time-averaged solvent supply
+	for (int k = 0; k < m_nreact; ++k)
+		phiwhat += phiw*m_pMat->GetReaction(k)->m_Vbar*m_zsum[k] / dt;
+
+	return true;
+}
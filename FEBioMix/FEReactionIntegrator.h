@@ -0,0 +1,87 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include <FECore/matrix.h>
+#include "febiomix_api.h"
+
+class FEMultiphasic;
+class FEMaterialPoint;
+
+//-----------------------------------------------------------------------------
+//! Local time integration of the chemical reactions of a multiphasic mixture.
+//! This is used when the reactions are split off from the transport problem
+//! (see FEMultiphasic::m_breactionSplit). At each integration point, the actual
+//! solute concentrations and the referential densities of the solid-bound
+//! molecules are advanced over the time increment by solving the reaction ODEs
+//!
+//!   dca/dt   = sum_k v_k zeta_k
+//!   dsbmr/dt = (J - phi0) M sum_k v_k zeta_k
+//!
+//! with the backward Euler method on a number of sub-steps. The deformation (J, phi0)
+//! is kept fixed during the integration. The Jacobian of the reaction rates is
+//! evaluated with finite differences, so any reaction type can be used.
+//! An integrator allocates all its work arrays up front and can then be reused
+//! for any number of integration points (one integrator per thread).
+class FEBIOMIX_API FEReactionIntegrator
+{
+public:
+	FEReactionIntegrator(FEMultiphasic* pmat);
+
+	//! Integrate the reactions over the time increment dt. On return, the actual
+	//! concentrations and the solid-bound molecule densities of the material point
+	//! are updated and phiwhat is set to the time-averaged solvent supply of the
+	//! reactions. Returns false (and leaves the material point data unchanged) if
+	//! the integration failed.
+	bool Integrate(FEMaterialPoint& mp, double dt, double& phiwhat);
+
+private:
+	//! evaluate the rates at state y (also stores the molar supplies in m_zeta)
+	void Rates(FEMaterialPoint& mp, const double* y, double* f);
+
+	//! do one backward Euler step of size h starting from y0 (result is stored in m_y)
+	bool Step(FEMaterialPoint& mp, const double* y0, double h);
+
+	//! enforce the bounds on the state
+	void Clamp(double* y);
+
+private:
+	FEMultiphasic*	m_pMat;
+	int		m_nsol;		//!< number of solutes
+	int		m_nsbm;		//!< number of solid-bound molecules
+	int		m_nreact;	//!< number of reactions
+	int		m_n;		//!< size of the state vector (m_nsol + m_nsbm)
+
+	// state of the material point that is kept fixed
+	double	m_J, m_phi0;
+
+	// work arrays
+	std::vector<double>	m_y, m_yn, m_ys, m_dy, m_f, m_fp, m_zeta, m_zsum;
+	std::vector<double>	m_rhomin, m_rhomax, m_M;
+	matrix				m_K;
+	std::vector<int>	m_indx;
+};
@@ -52,6 +52,7 @@ void FESolutesMaterialPoint::Init()
 	m_psi = m_cF = 0;
 	m_Ie = vec3d(0,0,0);
 	m_rhor = 0;
+	m_phiwhatr = 0;
     m_c.clear();
     m_gradc.clear();
     m_j.clear();
@@ -93,7 +94,7 @@ void FESolutesMaterialPoint::Serialize(DumpStream& ar)
 	ar & m_nsol & m_psi & m_cF & m_Ie & m_nsbm;
 	ar & m_c & m_gradc & m_j & m_ca & m_crp & m_k & m_dkdJ;
 	ar & m_dkdc;
-	ar & m_sbmr & m_sbmrp & m_sbmrhat & m_sbmrhatp;
+	ar & m_sbmr & m_sbmrp & m_sbmrhat & m_sbmrhatp & m_phiwhatr;
 	ar & m_cri;
 	ar & m_crd;
 	ar & m_strain & m_pe & m_pi;
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include <cwctype>
 #include "FEDataSource.h"
+#include "FEDirectSensitivity.h"
 #include <FECore/FEModel.h>
 #include <FECore/log.h>
 #include <FECore/NodeDataRecord.h>
@@ -57,6 +58,50 @@ void FEDataSource::Reset()
 	
 }
 
+bool FEDataSource::InitSensitivity(FEDirectSensitivity* ds)
+{
+	return false;
+}
+
+bool FEDataSource::EvaluateSensitivity(double x, std::vector<double>& dy)
+{
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Differentiates the value at x of a curve with data points pt that have the derivatives dpt
+// (the first row is the derivative of the abscissa, the second of the ordinate). This is done
+// by interpolating curves with perturbed data points, so that the result is consistent with
+// how the curve itself is interpolated.
+static bool curveSensitivity(FEPointFunction& rf, const std::vector<vec2d>& pt, const std::vector<matrix>& dpt, FEDirectSensitivity* ds, double x, std::vector<double>& dy)
+{
+	if ((ds == nullptr) || (ds->IsValid() == false)) return false;
+
+	int nvar = 0;
+	for (const matrix& m : dpt) if (m.columns() > nvar) nvar = m.columns();
+	if (nvar == 0) return false;
+
+	FEPointFunction fp(rf.GetFEModel()), fm(rf.GetFEModel());
+	fp.CopyFrom(rf); fm.CopyFrom(rf);
+	dy.assign(nvar, 0.0);
+	for (int j = 0; j < nvar; ++j)
+	{
+		double h = ds->StepSize(j);
+		fp.Clear(); fm.Clear();
+		for (size_t k = 0; k < pt.size(); ++k)
+		{
+			const matrix& dk = dpt[k];
+			double dx = (dk.rows() > 0 ? h*dk(0, j) : 0.0);
+			double dv = (dk.rows() > 0 ? h*dk(1, j) : 0.0);
+			fp.Add(pt[k].x() + dx, pt[k].y() + dv);
+			fm.Add(pt[k].x() - dx, pt[k].y() - dv);
+		}
+		dy[j] = (fp.value(x) - fm.value(x)) / (2.0*h);
+	}
+
+	return true;
+}
+
 //=================================================================================================
 bool FEDataParameter::update(FEModel* pmdl, unsigned int nwhen, void* pd)
 {
@@ -78,11 +123,21 @@ void FEDataParameter::update()
 
 	// add the data pair to the loadcurve
 	m_rf.Add(x, y);
+
+	// record the derivatives of the data pair
+	if (m_ds)
+	{
+		matrix dv;
+		m_ds->Derivatives([this](vector<double>& v) { v.resize(2); v[0] = m_fx(); v[1] = m_fy(); }, dv);
+		m_pt.push_back(vec2d(x, y));
+		m_dpt.push_back(dv);
+	}
 }
 
 FEDataParameter::FEDataParameter(FEModel* fem) : FEDataSource(fem), m_rf(fem)
 {
 	m_ord = "fem.time";
+	m_ds = nullptr;
 }
 
 void FEDataParameter::SetParameterName(const std::string& name)
@@ -354,6 +409,8 @@ void FEDataParameter::Reset()
 {
 	// reset the reaction force load curve
 	m_rf.Clear();
+	m_pt.clear();
+	m_dpt.clear();
 	FEDataSource::Reset();
 }
 
@@ -362,6 +419,17 @@ double FEDataParameter::Evaluate(double x)
 	return m_rf.value(x);
 }
 
+bool FEDataParameter::InitSensitivity(FEDirectSensitivity* ds)
+{
+	m_ds = ds;
+	return true;
+}
+
+bool FEDataParameter::EvaluateSensitivity(double x, std::vector<double>& dy)
+{
+	return curveSensitivity(m_rf, m_pt, m_dpt, m_ds, x, dy);
+}
+
 //=================================================================================================
 FEDataFilterPositive::FEDataFilterPositive(FEModel* fem) : FEDataSource(fem)
 {
@@ -397,12 +465,28 @@ double FEDataFilterPositive::Evaluate(double t)
 	return (v >= 0.0 ? v : -v);
 }
 
+bool FEDataFilterPositive::InitSensitivity(FEDirectSensitivity* ds)
+{
+	return (m_src ? m_src->InitSensitivity(ds) : false);
+}
+
+bool FEDataFilterPositive::EvaluateSensitivity(double t, std::vector<double>& dy)
+{
+	if (m_src->EvaluateSensitivity(t, dy) == false) return false;
+	if (m_src->Evaluate(t) < 0.0)
+	{
+		for (size_t i = 0; i < dy.size(); ++i) dy[i] = -dy[i];
+	}
+	return true;
+}
+
 
 //=================================================================================================
 FEDataFilterSum::FEDataFilterSum(FEModel* fem) : FEDataSource(fem), m_rf(fem)
 {
 	m_data = nullptr;
 	m_nodeSet = nullptr;
+	m_ds = nullptr;
 }
 
 FEDataFilterSum::~FEDataFilterSum()
@@ -435,6 +519,9 @@ void FEDataFilterSum::Reset()
 {
 	m_rf.Clear();
 	m_rf.Add(0, 0);
+
+	m_pt.assign(1, vec2d(0, 0));
+	m_dpt.assign(1, matrix());
 }
 
 // evaluate data source at x
@@ -443,6 +530,17 @@ double FEDataFilterSum::Evaluate(double x)
 	return m_rf.value(x);
 }
 
+bool FEDataFilterSum::InitSensitivity(FEDirectSensitivity* ds)
+{
+	m_ds = ds;
+	return true;
+}
+
+bool FEDataFilterSum::EvaluateSensitivity(double x, std::vector<double>& dy)
+{
+	return curveSensitivity(m_rf, m_pt, m_dpt, m_ds, x, dy);
+}
+
 bool FEDataFilterSum::update(FEModel* pmdl, unsigned int nwhen, void* pd)
 {
 	// get the optimizaton data
@@ -457,7 +555,25 @@ void FEDataFilterSum::update()
 	// get the current time value
 	double time = m_fem.GetTime().currentTime;
 
-	FEMesh* mesh = m_nodeSet->GetMesh();
+	// evaluate the current reaction force value
+	double x = time;
+	double y = sum();
+
+	// add the data pair to the loadcurve
+	m_rf.Add(x, y);
+
+	// record the derivatives of the data pair
+	if (m_ds)
+	{
+		matrix dv;
+		m_ds->Derivatives([this](vector<double>& v) { v.resize(2); v[0] = m_fem.GetTime().currentTime; v[1] = sum(); }, dv);
+		m_pt.push_back(vec2d(x, y));
+		m_dpt.push_back(dv);
+	}
+}
+
+double FEDataFilterSum::sum()
+{
 	FENodeSet& ns = *m_nodeSet;
 	double sum = 0.0;
 	for (int i = 0; i < m_nodeSet->Size(); ++i)
@@ -465,11 +581,5 @@ void FEDataFilterSum::update()
 		double vi = m_data->value(ns[i]);
 		sum += vi;
 	}
-
-	// evaluate the current reaction force value
-	double x = time;
-	double y = sum;
-
-	// add the data pair to the loadcurve
-	m_rf.Add(x, y);
+	return sum;
 }
@@ -30,6 +30,9 @@ SOFTWARE.*/
 #include <FECore/FEPointFunction.h>
 #include <functional>
 #include <FECore/NodeDataRecord.h>
+#include <FECore/matrix.h>
+
+class FEDirectSensitivity;
 
 //-------------------------------------------------------------------------------------------------
 // The FEDataSource class is used by the FEObjectiveFunction to query model data and evaluate it
@@ -50,6 +53,13 @@ public:
 	// Evaluate source at x
 	virtual double Evaluate(double x) = 0;
 
+	// Prepare the evaluation of the derivatives with respect to the input parameters.
+	// Returns false if the data source does not support this.
+	virtual bool InitSensitivity(FEDirectSensitivity* ds);
+
+	// Evaluate the derivatives of the source at x with respect to the input parameters
+	virtual bool EvaluateSensitivity(double x, std::vector<double>& dy);
+
 protected:
 	FEModel&			m_fem;	//!< reference to model
 };
@@ -81,6 +91,10 @@ public:
 	// evaluate the current value
 	double value() { return m_fy(); }
 
+	bool InitSensitivity(FEDirectSensitivity* ds) override;
+
+	bool EvaluateSensitivity(double x, std::vector<double>& dy) override;
+
 private:
 	static bool update(FEModel* pmdl, unsigned int nwhen, void* pd);
 	void update();
@@ -91,6 +105,10 @@ private:
 	std::function<double()>	m_fx;				//!< pointer to ordinate value
 	std::function<double()>	m_fy;				//!< pointer to variable data
 	FEPointFunction		m_rf;	//!< reaction force data
+
+	FEDirectSensitivity*	m_ds;	//!< evaluates the derivatives of the data points
+	std::vector<vec2d>		m_pt;	//!< data points in the order they were recorded
+	std::vector<matrix>		m_dpt;	//!< derivatives of the data points
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -115,6 +133,10 @@ public:
 	// evaluate data source at x
 	double Evaluate(double x) override;
 
+	bool InitSensitivity(FEDirectSensitivity* ds) override;
+
+	bool EvaluateSensitivity(double x, std::vector<double>& dy) override;
+
 private:
 	FEDataSource*	m_src;
 };
@@ -137,13 +159,23 @@ public:
 	// evaluate data source at x
 	double Evaluate(double x) override;
 
+	bool InitSensitivity(FEDirectSensitivity* ds) override;
+
+	bool EvaluateSensitivity(double x, std::vector<double>& dy) override;
 
 private:
 	static bool update(FEModel* pmdl, unsigned int nwhen, void* pd);
 	void update();
 
+	// sum of the data over the node set
+	double sum();
+
 private:
 	FENodeLogData*	m_data;
 	FENodeSet*		m_nodeSet;
 	FEPointFunction		m_rf;
+
+	FEDirectSensitivity*	m_ds;
+	std::vector<vec2d>		m_pt;
+	std::vector<matrix>		m_dpt;
 };
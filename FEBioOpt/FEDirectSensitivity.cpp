@@ -0,0 +1,297 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEDirectSensitivity.h"
+#include "FEOptimizeData.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEAnalysis.h>
+#include <FECore/FENewtonSolver.h>
+#include <FECore/LinearSolver.h>
+#include <FECore/log.h>
+
+//-----------------------------------------------------------------------------
+FEDirectSensitivity::FEDirectSensitivity(FEOptimizeData* opt) : m_opt(opt)
+{
+	m_fdiff = 0.001;
+	m_bvalid = false;
+	m_dmp = new DumpMemStream(*opt->GetFEModel());
+	m_step = nullptr;
+	m_time = 0.0;
+}
+
+//-----------------------------------------------------------------------------
+FEDirectSensitivity::~FEDirectSensitivity()
+{
+	delete m_dmp;
+}
+
+//-----------------------------------------------------------------------------
+bool FEDirectSensitivity::Init()
+{
+	FEModel* fem = m_opt->GetFEModel();
+
+	// The derivatives of the state are only evaluated at the current time,
+	// so the state may not depend on the parameters through the history.
+	for (int i = 0; i < fem->Steps(); ++i)
+	{
+		FEAnalysis* step = fem->GetStep(i);
+		FESolver* solver = step->GetFESolver();
+		if (dynamic_cast<FENewtonSolver*>(solver) == nullptr)
+		{
+			feLogWarningEx(fem, "Direct sensitivities require a Newton solver (step %d).", i + 1);
+			return false;
+		}
+
+		bool bok = (step->m_nanalysis == FE_STEADY_STATE) ||
+			((step->m_nanalysis == FE_STATIC) && (strcmp(solver->GetTypeStr(), "solid") == 0));
+		if (bok == false)
+		{
+			feLogWarningEx(fem, "Direct sensitivities are only available for static and steady-state analyses (step %d).", i + 1);
+			return false;
+		}
+	}
+
+	fem->AddCallback(update, CB_STEP_SOLVED, (void*)this);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+double FEDirectSensitivity::StepSize(int i)
+{
+	FEInputParameter& var = *m_opt->GetInputParameter(i);
+	return m_fdiff*(fabs(var.ScaleFactor()) + fabs(var.GetValue()));
+}
+
+//-----------------------------------------------------------------------------
+void FEDirectSensitivity::Reset()
+{
+	m_bvalid = true;
+	m_step = nullptr;
+	m_time = 0.0;
+	m_du.clear();
+	m_dfinal.assign(m_final.size(), matrix());
+}
+
+//-----------------------------------------------------------------------------
+int FEDirectSensitivity::AddFinalProbe(Probe f)
+{
+	m_final.push_back(f);
+	m_dfinal.push_back(matrix());
+	return (int)m_final.size() - 1;
+}
+
+//-----------------------------------------------------------------------------
+bool FEDirectSensitivity::FinalDerivatives(int n, matrix& dv)
+{
+	if ((m_bvalid == false) || (n < 0) || (n >= (int)m_final.size())) return false;
+	if (m_dfinal[n].rows() == 0) return false;
+	dv = m_dfinal[n];
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEDirectSensitivity::update(FEModel* pfem, unsigned int nwhen, void* pd)
+{
+	FEDirectSensitivity* ds = (FEDirectSensitivity*)pd;
+	if (ds->m_bvalid == false) return true;
+
+	// the final probes are overwritten by each step, so that the last one remains
+	for (size_t i = 0; i < ds->m_final.size(); ++i)
+	{
+		if (ds->Derivatives(ds->m_final[i], ds->m_dfinal[i]) == false) break;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+FENewtonSolver* FEDirectSensitivity::GetSolver()
+{
+	FEAnalysis* step = m_opt->GetFEModel()->GetCurrentStep();
+	if (step == nullptr) return nullptr;
+	return dynamic_cast<FENewtonSolver*>(step->GetFESolver());
+}
+
+//-----------------------------------------------------------------------------
+void FEDirectSensitivity::SaveState()
+{
+	m_dmp->clear();
+	m_opt->GetFEModel()->Serialize(*m_dmp);
+}
+
+//-----------------------------------------------------------------------------
+void FEDirectSensitivity::RestoreState()
+{
+	m_dmp->Open(false, true);
+	m_opt->GetFEModel()->Serialize(*m_dmp);
+}
+
+//-----------------------------------------------------------------------------
+void FEDirectSensitivity::RefreshState(FENewtonSolver* solver)
+{
+	vector<double> R(solver->m_neq);
+	solver->Residual(R);
+}
+
+//-----------------------------------------------------------------------------
+bool FEDirectSensitivity::UpdateSolution(FENewtonSolver* solver)
+{
+	FEModel* fem = m_opt->GetFEModel();
+	FEAnalysis* step = fem->GetCurrentStep();
+	double time = fem->GetCurrentTime();
+	if ((step == m_step) && (time == m_time) && (m_du.empty() == false)) return true;
+	m_step = nullptr;
+
+	int neq = solver->m_neq;
+	int nvar = m_opt->InputParameters();
+
+	SaveState();
+
+	// the tangent stiffness at the converged state
+	if (solver->FactorStiffness() == false) return false;
+
+	// residual derivatives at the converged state
+	// (The solver update re-evaluates the boundary conditions, in case they depend on the parameters.)
+	vector<double> dR(neq*nvar), R1(neq), R2(neq), ui(neq);
+	for (int j = 0; j < nvar; ++j)
+	{
+		FEInputParameter& var = *m_opt->GetInputParameter(j);
+		double a = var.GetValue();
+		double h = StepSize(j);
+
+		var.SetValue(a + h);
+		zero(ui); solver->Update(ui);
+		solver->Residual(R1);
+		RestoreState();
+
+		var.SetValue(a - h);
+		zero(ui); solver->Update(ui);
+		solver->Residual(R2);
+		RestoreState();
+
+		var.SetValue(a);
+
+		double* dRj = &dR[j*neq];
+		for (int i = 0; i < neq; ++i) dRj[i] = (R1[i] - R2[i]) / (2.0*h);
+	}
+
+	// solve for all parameters at once
+	m_du.resize(neq*nvar);
+	if (solver->GetLinearSolver()->BackSolveMulti(&m_du[0], &dR[0], nvar, neq) == false)
+	{
+		m_du.clear();
+		return false;
+	}
+
+	m_step = step;
+	m_time = time;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEDirectSensitivity::Derivatives(Probe f, matrix& dv)
+{
+	FEModel* fem = m_opt->GetFEModel();
+	int nvar = m_opt->InputParameters();
+
+	vector<double> v1, v2;
+	f(v1);
+	int nv = (int)v1.size();
+	dv.resize(nv, nvar);
+	dv.zero();
+
+	if (m_bvalid == false) return false;
+
+	// outside the converged states (i.e. at the initial state) the model does not depend on the parameters
+	unsigned int nevent = fem->CurrentEvent();
+	if ((nevent != CB_MAJOR_ITERS) && (nevent != CB_STEP_SOLVED)) return true;
+
+	FENewtonSolver* solver = GetSolver();
+	if (solver == nullptr) { m_bvalid = false; return false; }
+
+	vector<double> a0(nvar);
+	for (int j = 0; j < nvar; ++j) a0[j] = m_opt->GetInputParameter(j)->GetValue();
+
+	try
+	{
+		if (UpdateSolution(solver) == false)
+		{
+			RestoreState();
+			RefreshState(solver);
+			m_bvalid = false;
+			return false;
+		}
+
+		// evaluate the quantities at the perturbed states
+		int neq = solver->m_neq;
+		vector<double> ui(neq), R(neq);
+		for (int j = 0; j < nvar; ++j)
+		{
+			FEInputParameter& var = *m_opt->GetInputParameter(j);
+			double a = var.GetValue();
+			double h = StepSize(j);
+			const double* duj = &m_du[j*neq];
+
+			for (int i = 0; i < neq; ++i) ui[i] = h*duj[i];
+			var.SetValue(a + h);
+			solver->Update(ui);
+			solver->Residual(R);
+			f(v1);
+			RestoreState();
+
+			for (int i = 0; i < neq; ++i) ui[i] = -h*duj[i];
+			var.SetValue(a - h);
+			solver->Update(ui);
+			solver->Residual(R);
+			f(v2);
+			RestoreState();
+
+			var.SetValue(a);
+
+			if (((int)v1.size() != nv) || ((int)v2.size() != nv)) { m_bvalid = false; break; }
+			for (int i = 0; i < nv; ++i) dv(i, j) = (v1[i] - v2[i]) / (2.0*h);
+		}
+
+		// Restoring the state does not restore the solver's force vectors (e.g. the reaction forces)
+		RefreshState(solver);
+	}
+	catch (...)
+	{
+		// e.g. a perturbed state that inverted an element
+		for (int j = 0; j < nvar; ++j) m_opt->GetInputParameter(j)->SetValue(a0[j]);
+		RestoreState();
+		RefreshState(solver);
+		m_bvalid = false;
+		return false;
+	}
+
+	return m_bvalid;
+}
@@ -0,0 +1,121 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/matrix.h>
+#include <FECore/DumpMemStream.h>
+#include <vector>
+#include <functional>
+
+class FEOptimizeData;
+class FENewtonSolver;
+class FEAnalysis;
+
+//-----------------------------------------------------------------------------
+//! Evaluates the derivatives of model quantities with respect to the input
+//! parameters of an optimization with the direct differentiation method.
+//! At a converged state R(u, a) = 0, so the solution sensitivities follow from
+//!
+//!   K du/da_j = dR/da_j
+//!
+//! where K is the tangent stiffness at the converged state. The right-hand sides
+//! are obtained from central differences of the residual at the fixed converged
+//! state, and all parameters are solved with a single factorization. A quantity
+//! v(u, a) is then differentiated by evaluating it at u +/- h du/da_j, a_j +/- h.
+//! This costs a few residual evaluations per state instead of a full forward
+//! solve per parameter.
+//! The derivatives are exact for static hyperelastic and steady-state analyses.
+//! For path-dependent materials the sensitivity of the history variables is
+//! not included.
+class FEDirectSensitivity
+{
+public:
+	//! Evaluates quantities at the current model state
+	typedef std::function<void(std::vector<double>& v)> Probe;
+
+public:
+	FEDirectSensitivity(FEOptimizeData* opt);
+	~FEDirectSensitivity();
+
+	//! check that the model's analyses are supported and register the callbacks
+	bool Init();
+
+	//! set the relative step size of the parameter perturbations
+	void SetStepSize(double h) { m_fdiff = h; }
+
+	//! perturbation of input parameter i
+	double StepSize(int i);
+
+	//! This must be called before each forward solve
+	void Reset();
+
+	//! skip the evaluation of the derivatives until the next reset
+	void Disable() { m_bvalid = false; }
+
+	//! returns false if the derivatives could not be evaluated during the last solve
+	bool IsValid() const { return m_bvalid; }
+
+	//! Calculate the derivatives dv(i,j) = dv_i/da_j of the quantities evaluated
+	//! by f at the current state. This must be called from a model callback.
+	bool Derivatives(Probe f, matrix& dv);
+
+	//! Add quantities that are differentiated at the end of each step. Returns
+	//! an id that can be passed to FinalDerivatives.
+	int AddFinalProbe(Probe f);
+
+	//! derivatives of the quantities of a final probe at the end of the last solve
+	bool FinalDerivatives(int n, matrix& dv);
+
+private:
+	static bool update(FEModel* pfem, unsigned int nwhen, void* pd);
+
+	//! calculate the solution sensitivities at the current state
+	bool UpdateSolution(FENewtonSolver* solver);
+
+	//! returns the solver of the current step, or null if the step cannot be differentiated
+	FENewtonSolver* GetSolver();
+
+	void SaveState();
+	void RestoreState();
+
+	//! re-evaluate the solver data that is not part of the saved state
+	void RefreshState(FENewtonSolver* solver);
+
+private:
+	FEOptimizeData*		m_opt;
+	double				m_fdiff;	//!< relative step size
+	bool				m_bvalid;	//!< derivatives of the last solve are valid
+	DumpMemStream*		m_dmp;		//!< converged state
+
+	FEAnalysis*			m_step;		//!< step and time of the state for which m_du was evaluated
+	double				m_time;
+	std::vector<double>	m_du;		//!< solution sensitivities (one column of neq values per parameter)
+
+	std::vector<Probe>	m_final;	//!< final probes
+	std::vector<matrix>	m_dfinal;	//!< derivatives of final probes
+};
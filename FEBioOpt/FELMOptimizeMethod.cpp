@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "FELMOptimizeMethod.h"
 #include "FEOptimizeData.h"
 #include "FEOptimizeInput.h"
+#include "FEDirectSensitivity.h"
 #include "FECore/FEAnalysis.h"
 #include "FECore/log.h"
 
@@ -39,6 +40,7 @@ BEGIN_FECORE_CLASS(FELMOptimizeMethod, FEOptimizeMethod)
 	ADD_PARAMETER(m_fdiff , "f_diff_scale");
 	ADD_PARAMETER(m_nmax  , "max_iter"    );
 	ADD_PARAMETER(m_bcov  , "print_cov"   );
+	ADD_PARAMETER(m_bdirect, "direct_sensitivity");
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
@@ -75,7 +77,16 @@ FELMOptimizeMethod::FELMOptimizeMethod()
 	m_fdiff  = 0.001;
 	m_nmax   = 100;
 	m_bcov   = 0;
+	m_bdirect = false;
 	m_loglevel = LogLevel::LOG_NEVER;
+	m_ds = nullptr;
+	m_bwarn = false;
+}
+
+//-----------------------------------------------------------------------------
+FELMOptimizeMethod::~FELMOptimizeMethod()
+{
+	delete m_ds;
 }
 
 //-----------------------------------------------------------------------------
@@ -125,6 +136,19 @@ bool FELMOptimizeMethod::Solve(FEOptimizeData *pOpt, vector<double>& amin, vecto
 
 	FEModel* fem = pOpt->GetFEModel();
 
+	// prepare the direct differentiation of the objective
+	if (m_bdirect && (m_ds == nullptr))
+	{
+		m_ds = new FEDirectSensitivity(pOpt);
+		m_ds->SetStepSize(m_fdiff);
+		if ((m_ds->Init() == false) || (obj.InitSensitivity(m_ds) == false))
+		{
+			feLogWarningEx(fem, "Direct sensitivities are not available for this problem. Finite differences will be used instead.");
+			m_ds->Disable();
+			m_bdirect = false;
+		}
+	}
+
 	try
 	{
 		// do the first call with lamda to intialize the minimization
@@ -197,11 +221,27 @@ void FELMOptimizeMethod::ObjFun(vector<double>& x, vector<double>& a, vector<dou
 	}
 	
 	// evaluate at a
+	if (m_bdirect) m_ds->Reset();
 	if (opt.FESolve(a) == false) throw FEErrorTermination();
 	
 	opt.GetObjective().Evaluate(y);
 	m_yopt = y;
 
+	// use the derivatives from the direct differentiation if they could be evaluated
+	if (m_bdirect)
+	{
+		if (m_ds->IsValid() && opt.GetObjective().EvaluateSensitivity(dyda)) return;
+
+		if (m_bwarn == false)
+		{
+			feLogWarningEx(opt.GetFEModel(), "Direct sensitivities could not be evaluated. Finite differences will be used instead.");
+			m_bwarn = true;
+		}
+
+		// don't waste time on the derivatives in the forward difference solves
+		m_ds->Disable();
+	}
+
 	// now calculate the derivatives using forward differences
 	int ndata = (int)x.size();
 	vector<double> a1(a);
@@ -32,12 +32,15 @@ SOFTWARE.*/
 #include <vector>
 using namespace std;
 
+class FEDirectSensitivity;
+
 //----------------------------------------------------------------------------
 //! Optimization method using Levenberg-Marquardt method
 class FELMOptimizeMethod : public FEOptimizeMethod
 {
 public:
 	FELMOptimizeMethod();
+	~FELMOptimizeMethod();
 	bool Solve(FEOptimizeData* pOpt, vector<double>& amin, vector<double>& ymin, double* minObj) override;
 
 protected:
@@ -53,9 +56,13 @@ public:
 	double			m_fdiff;	// forward difference step size
 	int				m_nmax;		// maximum number of iterations
 	bool			m_bcov;		// flag to print covariant matrix
+	bool			m_bdirect;	// use direct differentiation for the derivatives
 
 protected:
 	vector<double>	m_yopt;	// optimal y-values
 
+	FEDirectSensitivity*	m_ds;		// evaluates the derivatives with direct differentiation
+	bool					m_bwarn;	// the fall back to finite differences was reported
+
 	DECLARE_FECORE_CLASS();
 };
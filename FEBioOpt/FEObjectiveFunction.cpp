@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEObjectiveFunction.h"
+#include "FEDirectSensitivity.h"
 #include <FECore/FEModel.h>
 #include <FECore/log.h>
 
@@ -36,6 +37,8 @@ SOFTWARE.*/
 FEObjectiveFunction::FEObjectiveFunction(FEModel* fem) : m_fem(fem)
 {
 	m_verbose = false;
+	m_ds = nullptr;
+	m_probe = -1;
 }
 
 FEObjectiveFunction::~FEObjectiveFunction()
@@ -55,6 +58,22 @@ void FEObjectiveFunction::Reset()
 {
 }
 
+bool FEObjectiveFunction::InitSensitivity(FEDirectSensitivity* ds)
+{
+	m_ds = ds;
+	m_probe = ds->AddFinalProbe([this](vector<double>& f) {
+		f.resize(Measurements());
+		EvaluateFunctions(f);
+	});
+	return true;
+}
+
+bool FEObjectiveFunction::EvaluateSensitivity(matrix& dfda)
+{
+	if (m_ds == nullptr) return false;
+	return m_ds->FinalDerivatives(m_probe, dfda);
+}
+
 double FEObjectiveFunction::Evaluate()
 {
 	vector<double> dummy(Measurements());
@@ -70,6 +89,14 @@ double FEObjectiveFunction::Evaluate(vector<double>& y)
 	// evaluate the functions
 	EvaluateFunctions(y);
 
+	return ObjectiveValue(y);
+}
+
+double FEObjectiveFunction::ObjectiveValue(const vector<double>& y)
+{
+	int ndata = Measurements();
+	assert((int)y.size() == ndata);
+
 	// get the measurement vector
 	vector<double> y0(ndata);
 	GetMeasurements(y0);
@@ -173,6 +200,29 @@ void FEDataFitObjective::EvaluateFunctions(vector<double>& f)
 	}
 }
 
+//----------------------------------------------------------------------------
+bool FEDataFitObjective::InitSensitivity(FEDirectSensitivity* ds)
+{
+	return m_src->InitSensitivity(ds);
+}
+
+//----------------------------------------------------------------------------
+// The data source recorded the derivatives of its data during the solve, so
+// they only need to be interpolated at the measurement points.
+bool FEDataFitObjective::EvaluateSensitivity(matrix& dfda)
+{
+	int ndata = m_lc.Points();
+	vector<double> dy;
+	for (int i = 0; i<ndata; ++i)
+	{
+		double xi = m_lc.LoadPoint(i).time;
+		if (m_src->EvaluateSensitivity(xi, dy) == false) return false;
+		if (i == 0) dfda.resize(ndata, (int)dy.size());
+		for (int j = 0; j<(int)dy.size(); ++j) dfda(i, j) = dy[j];
+	}
+	return true;
+}
+
 //=============================================================================
 FEMinimizeObjective::FEMinimizeObjective(FEModel* fem) : FEObjectiveFunction(fem)
 {
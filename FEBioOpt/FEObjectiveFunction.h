@@ -33,10 +33,12 @@ SOFTWARE.*/
 #include "FEDataSource.h"
 #include <FECore/ElementDataRecord.h>
 #include <FECore/NodeDataRecord.h>
+#include <FECore/matrix.h>
 using namespace std;
 
 class FEModel;
 class FEElement;
+class FEDirectSensitivity;
 
 //=============================================================================
 //! This class evaluates the objective function, which is defined as the sum
@@ -70,6 +72,18 @@ public:
 	// evaluate objective function
 	double Evaluate();
 
+	// calculate the objective function value from function values that were
+	// already evaluated (e.g. by another process)
+	double ObjectiveValue(const vector<double>& f);
+
+	// Prepare the evaluation of the function derivatives with respect to the input
+	// parameters. By default, the functions are assumed to depend on the final state
+	// of the model only. Returns false if the derivatives are not available.
+	virtual bool InitSensitivity(FEDirectSensitivity* ds);
+
+	// evaluate the derivatives dfda(i,j) = df_i/da_j of the functions of the last solve
+	virtual bool EvaluateSensitivity(matrix& dfda);
+
 	// print output to screen or not
 	void SetVerbose(bool b) { m_verbose = b; }
 
@@ -90,6 +104,9 @@ public: // These functions need to be implemented by derived classes
 private:
 	FEModel*	m_fem;
 	bool	m_verbose;		//!< print data flag
+
+	FEDirectSensitivity*	m_ds;		//!< evaluates the function derivatives
+	int						m_probe;	//!< id of the final-state probe
 };
 
 //=============================================================================
@@ -116,6 +133,11 @@ public:
 	// set the data measurements
 	void SetMeasurements(const vector<pair<double, double> >& data);
 
+	// the derivatives are evaluated by the data source
+	bool InitSensitivity(FEDirectSensitivity* ds) override;
+
+	bool EvaluateSensitivity(matrix& dfda) override;
+
 public:
 	// return number of measurements
 	int Measurements();
@@ -123,6 +123,9 @@ bool FEOptimizeData::Init()
 	// allocate default optimization solver if none specified in input file
 	if (m_pSolver == 0) m_pSolver = new FELMOptimizeMethod;
 
+	// give the optimization method a chance to prepare
+	if (m_pSolver->Init() == false) return false;
+
 	// allocate default solver if none specified in input file
 	if (m_pTask == 0) m_pTask = fecore_new<FECoreTask>("solve", m_fem);
 
@@ -206,6 +209,18 @@ bool FEOptimizeData::RunTask()
 	return m_pTask->Run();
 }
 
+//-----------------------------------------------------------------------------
+void FEOptimizeData::LogIteration()
+{
+	feLog("\n----- Iteration: %d -----\n", m_niter);
+	for (int i = 0; i<InputParameters(); ++i)
+	{
+		FEInputParameter& var = *GetInputParameter(i);
+		string name = var.GetName();
+		feLog("%-15s = %lg\n", name.c_str(), var.GetValue());
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! solve the FE problem with a new set of parameters
 bool FEOptimizeData::FESolve(const vector<double>& a)
@@ -227,13 +242,7 @@ bool FEOptimizeData::FESolve(const vector<double>& a)
 	}
 
 	// report the new values
-	feLog("\n----- Iteration: %d -----\n", m_niter);
-	for (int i = 0; i<nvar; ++i)
-	{
-		FEInputParameter& var = *GetInputParameter(i);
-		string name = var.GetName();
-		feLog("%-15s = %lg\n", name.c_str(), var.GetValue());
-	}
+	LogIteration();
 
 	// reset the FEM data
 	FEModel& fem = *GetFEModel();
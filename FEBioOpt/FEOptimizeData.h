@@ -144,6 +144,9 @@ public:
 	//! solve the FE problem with a new set of parameters
 	bool FESolve(const vector<double>& a);
 
+	//! report the current parameter values
+	void LogIteration();
+
 public:
 	// return the number of input parameters
 	int InputParameters() { return (int)m_Var.size(); }
@@ -54,6 +54,9 @@ class FEOptimizeMethod : public FEParamContainer
 public:
 	FEOptimizeMethod() { m_print_level = PRINT_ITERATIONS; }
 
+	// This is called before the FE model is initialized.
+	virtual bool Init() { return true; }
+
 	// Implement this function for solve an optimization problem
 	// should return the optimal values for the input parameters in a, the optimal
 	// values of the measurement vector in ymin and
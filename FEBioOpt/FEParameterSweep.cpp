@@ -28,6 +28,11 @@ SOFTWARE.*/
 #include <FEBioXML/XMLReader.h>
 #include <FECore/FEModel.h>
 #include <FECore/FEAnalysis.h>
+#include <FECore/DumpMemStream.h>
+#include <FECore/FETimeStepController.h>
+#include <FECore/FESurfacePairConstraint.h>
+#include <FECore/FENLConstraint.h>
+#include <FECore/DataStore.h>
 #include <FECore/log.h>
 
 FESweepParam::FESweepParam()
@@ -62,6 +67,8 @@ void FESweepParam::SetValue(double v)
 FEParameterSweep::FEParameterSweep(FEModel* fem) : FECoreTask(fem)
 {
 	m_niter = 0;
+	m_rec = nullptr;
+	m_recEvents = 0;
 }
 
 //! initialization
@@ -70,6 +77,9 @@ bool FEParameterSweep::Init(const char* szfile)
 	// read the control file
 	if (Input(szfile) == false) return false;
 
+	// this has to be done before the model does any work
+	m_pool.Prepare();
+
 	// initialize the model
 	if (GetFEModel()->Init() == false) return false;
 
@@ -163,6 +173,20 @@ bool FEParameterSweep::Input(const char* szfile)
 			// looks good, so throw it on the pile
 			m_params.push_back(p);
 		}
+		else if (tag == "workers")
+		{
+			int n = 1;
+			tag.value(n);
+			if (n < 1) throw XMLReader::InvalidValue(tag);
+			m_pool.SetWorkers(n);
+		}
+		else if (tag == "worker_threads")
+		{
+			int n = 0;
+			tag.value(n);
+			if (n < 0) throw XMLReader::InvalidValue(tag);
+			m_pool.SetWorkerThreads(n);
+		}
 		else throw XMLReader::InvalidTag(tag);
 		++tag;
 	} while (!tag.isend());
@@ -184,12 +208,12 @@ bool FEParameterSweep::Run()
 		a[i] = pi.m_min;
 	}
 
-	// run the parameter sweep
+	// collect the grid points
+	vector< vector<double> > grid;
 	bool bdone = false;
 	do
 	{
-		// solve the problem with the new input parameters
-		if (FESolve(a) == false) return false;
+		grid.push_back(a);
 
 		// update indices
 		for (size_t i = 0; i<ma; ++i)
@@ -203,32 +227,224 @@ bool FEParameterSweep::Run()
 	}
 	while (!bdone);
 
+	// let the workers do the work
+	if (m_pool.IsParallel()) return RunWorkers(grid);
+
+	// run the parameter sweep
+	for (size_t i = 0; i<grid.size(); ++i)
+	{
+		// solve the problem with the new input parameters
+		if (FESolve(grid[i]) == false) return false;
+	}
+
 	return true;
 }
 
+// items of a recorded run
+enum { SWEEP_END, SWEEP_OUTPUT_EVENT };
+
+// Serializes the (shallow) model state that the output files need. The solver is
+// left out, since some of its data only exists while a step is active.
+static void SerializeOutputState(FEModel& fem, FEAnalysis& step, DumpStream& ar)
+{
+	fem.GetTime().Serialize(ar);
+	fem.SerializeGeometry(ar);
+	for (int i = 0; i < fem.SurfacePairConstraints(); ++i) fem.SurfacePairConstraint(i)->Serialize(ar);
+	for (int i = 0; i < fem.NonlinearConstraints(); ++i) fem.NonlinearConstraint(i)->Serialize(ar);
+
+	ar & step.m_ntime & step.m_ntimesteps;
+	ar & step.m_ntotiter & step.m_ntotrhs & step.m_ntotref;
+	if (step.m_timeController) ar & step.m_timeController->m_nmust;
+}
+
+// Records the model state at every event that can write output, so that the
+// calling process can write the output of a run that was solved in a worker.
+bool FEParameterSweep::RecordEvent(FEModel* pfem, unsigned int nwhen, void* pd)
+{
+	FEParameterSweep* sweep = (FEParameterSweep*)pd;
+	DumpMemStream* ar = sweep->m_rec;
+	if ((ar == nullptr) || ((nwhen & sweep->m_recEvents) == 0)) return true;
+
+	FEModel& fem = *pfem;
+	int nstep = fem.GetCurrentStepIndex();
+	int ncounter = fem.UpdateCounter();
+
+	// Each state gets its own stream, since objects can be reallocated during a run.
+	DumpMemStream state(fem);
+	state.Open(true, true);
+	SerializeOutputState(fem, *fem.GetStep(nstep), state);
+
+	int nsize = (int)state.size();
+	(*ar) << (int)SWEEP_OUTPUT_EVENT << (int)nwhen << nstep << ncounter << nsize;
+	if (nsize > 0) ar->write(state.data(), 1, nsize);
+	return true;
+}
+
+// Each worker solves its grid points on its own copy of the model. It records the log
+// messages and the model state at each output event of a run, and sends these back.
+// The calling process then replays the runs in grid order, so the log and output files
+// are the same as when the grid points are solved one after another in this process.
+bool FEParameterSweep::RunWorkers(const vector< vector<double> >& grid)
+{
+	FEModel& fem = *GetFEModel();
+
+	// The workers should not write to the output files, so we turn off their output.
+	// We keep the current output levels so we can restore them after loading a state.
+	int nsteps = fem.Steps();
+	vector<int> plotLevel(nsteps), outputLevel(nsteps);
+	m_recEvents = CB_MAJOR_ITERS | CB_AUGMENT | CB_STEP_SOLVED | CB_SOLVED;
+	for (int i = 0; i < nsteps; ++i)
+	{
+		plotLevel[i] = fem.GetStep(i)->GetPlotLevel();
+		outputLevel[i] = fem.GetStep(i)->GetOutputLevel();
+
+		// only record the minor iterations when they are needed
+		if ((plotLevel[i] == FE_PLOT_MINOR_ITRS) || (outputLevel[i] == FE_OUTPUT_MINOR_ITRS)) m_recEvents |= CB_MINOR_ITERS;
+	}
+
+	// The state is recorded before the model writes the output, so that any
+	// messages that are logged while handling the event follow it in the record.
+	fem.AddCallback(RecordEvent, m_recEvents, this, CallbackHandler::CB_ADD_FRONT);
+
+	FEWorkerPool::WorkFunction work = [&](int job, vector<char>& buf) {
+		for (int i = 0; i < nsteps; ++i)
+		{
+			fem.GetStep(i)->SetPlotLevel(FE_PLOT_NEVER);
+			fem.GetStep(i)->SetOutputLevel(FE_OUTPUT_NEVER);
+		}
+
+		// record the output events of this run
+		DumpMemStream ar(fem);
+		ar.Open(true, true);
+		m_rec = &ar;
+
+		bool ok = SolveModel(grid[job]);
+
+		m_rec = nullptr;
+		ar << (int)SWEEP_END;
+
+		// A failed run still returns the output it recorded.
+		buf.assign(ar.data(), ar.data() + ar.size());
+		return ok;
+	};
+
+	FEWorkerPool::ResultFunction done = [&](int job, bool ok, const vector<char>& buf) {
+		LogIteration(grid[job]);
+
+		// The log is blocked while the run is replayed, just like it is blocked
+		// while a grid point is solved in this process (see SolveModel).
+		fem.BlockLog();
+		ResetModel(grid[job]);
+
+		// replay the run
+		DumpMemStream ar(fem);
+		if (buf.empty() == false) ar.write(&buf[0], 1, buf.size());
+		ar.Open(false, true);
+		int lastCounter = -1;
+		int item = SWEEP_END;
+		bool bvalid = true;
+		if (buf.empty() == false) ar >> item;
+		while (item != SWEEP_END)
+		{
+			if (item != SWEEP_OUTPUT_EVENT) { bvalid = false; break; }
+
+			int nwhen, nstep, ncounter, nsize;
+			ar >> nwhen >> nstep >> ncounter >> nsize;
+			if ((nstep < 0) || (nstep >= nsteps) || (nsize < 0)) { bvalid = false; break; }
+
+			// load the state
+			DumpMemStream state(fem);
+			if (nsize > 0)
+			{
+				vector<char> data(nsize);
+				ar.read(&data[0], 1, nsize);
+				state.write(&data[0], 1, nsize);
+			}
+			state.Open(false, true);
+
+			FEAnalysis* step = fem.GetStep(nstep);
+			fem.SetCurrentStepIndex(nstep);
+			fem.SetCurrentStep(step);
+			SerializeOutputState(fem, *step, state);
+			for (int i = 0; i < nsteps; ++i)
+			{
+				fem.GetStep(i)->SetPlotLevel(plotLevel[i]);
+				fem.GetStep(i)->SetOutputLevel(outputLevel[i]);
+			}
+
+			// a new state needs a new update counter, otherwise the plot file skips it
+			if (ncounter != lastCounter) fem.IncrementUpdateCounter();
+			lastCounter = ncounter;
+
+			// write the output
+			if ((nwhen == CB_SOLVED) && (outputLevel[nstep] == FE_OUTPUT_FINAL))
+			{
+				fem.GetDataStore().Write();
+				step->SetOutputLevel(FE_OUTPUT_NEVER);
+			}
+			fem.DoCallback(nwhen);
+
+			ar >> item;
+		}
+
+		fem.UnBlockLog();
+
+		if (bvalid == false)
+		{
+			feLogError("Invalid result data for grid point %d.", job + 1);
+			return false;
+		}
+		return ok;
+	};
+
+	feLog("\nRunning %d grid points on %d workers (%d threads each).\n", (int)grid.size(), m_pool.Workers(), m_pool.WorkerThreads());
+
+	return m_pool.Run((int)grid.size(), work, done);
+}
+
 bool FEParameterSweep::FESolve(const vector<double>& a)
+{
+	LogIteration(a);
+	return SolveModel(a);
+}
+
+void FEParameterSweep::LogIteration(const vector<double>& a)
 {
 	++m_niter;
 	feLog("\n----- Iteration: %d -----\n", m_niter);
 
-	// set the input parameters
 	size_t nvar = m_params.size();
 	assert(nvar == a.size());
 	for (int i = 0; i<nvar; ++i)
 	{
-		FESweepParam& var = m_params[i];
-		var.SetValue(a[i]);
-
-		string name = var.m_paramName;
+		string name = m_params[i].m_paramName;
 		feLog("%-15s = %lg\n", name.c_str(), a[i]);
 	}
+}
 
-	// reset the FEM data
-	FEModel& fem = *GetFEModel();
-	fem.BlockLog();
+// Sets the parameters of a grid point and resets the model. The load controllers are
+// evaluated at the start time, so that the load parameters do not depend on the grid
+// point that was solved before (which is different in the workers).
+void FEParameterSweep::ResetModel(const vector<double>& a)
+{
+	// set the input parameters
+	size_t nvar = m_params.size();
+	assert(nvar == a.size());
+	for (int i = 0; i<nvar; ++i) m_params[i].SetValue(a[i]);
 
 	// reset model
+	FEModel& fem = *GetFEModel();
 	fem.Reset();
+	fem.EvaluateLoadControllers(0.0);
+	fem.EvaluateLoadParameters();
+}
+
+bool FEParameterSweep::SolveModel(const vector<double>& a)
+{
+	FEModel& fem = *GetFEModel();
+	fem.BlockLog();
+
+	ResetModel(a);
 
 	// solve the FE problem
 	bool bret = fem.Solve();
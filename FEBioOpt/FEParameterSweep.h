@@ -26,6 +26,9 @@ SOFTWARE.*/
 
 #pragma once
 #include <FECore/FECoreTask.h>
+#include "FEWorkerPool.h"
+
+class DumpMemStream;
 
 // This class represents a parameter that will be swept
 class FESweepParam
@@ -61,7 +64,17 @@ private:
 	bool InitParams();
 	bool FESolve(const vector<double>& a);
 
+	void LogIteration(const vector<double>& a);
+	void ResetModel(const vector<double>& a);
+	bool SolveModel(const vector<double>& a);
+
+	bool RunWorkers(const vector< vector<double> >& grid);
+	static bool RecordEvent(FEModel* fem, unsigned int nwhen, void* pd);
+
 private:
 	vector<FESweepParam>	m_params;
 	int						m_niter;
+	FEWorkerPool			m_pool;		//!< runs the grid points in worker processes
+	DumpMemStream*			m_rec;		//!< records the current run in a worker
+	unsigned int			m_recEvents;	//!< output events that are recorded
 };
@@ -29,16 +29,40 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "FEScanOptimizeMethod.h"
 #include "FEOptimizeData.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEAnalysis.h>
 #include "FECore/log.h"
+#include <string.h>
 
 BEGIN_FECORE_CLASS(FEScanOptimizeMethod, FEOptimizeMethod)
-
+	ADD_PARAMETER(m_workers, "workers"       );
+	ADD_PARAMETER(m_threads, "worker_threads");
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
 // FEScanOptimizeMethod
 //-----------------------------------------------------------------------------
 
+FEScanOptimizeMethod::FEScanOptimizeMethod()
+{
+	m_workers = 1;
+	m_threads = 0;
+}
+
+//-----------------------------------------------------------------------------
+bool FEScanOptimizeMethod::Init()
+{
+	if (m_workers < 1) return false;
+	m_pool.SetWorkers(m_workers);
+	m_pool.SetWorkerThreads(m_threads);
+
+	// this has to be done before the model does any work
+	m_pool.Prepare();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
 bool FEScanOptimizeMethod::Solve(FEOptimizeData* pOpt, vector<double>& amin, vector<double>& ymin, double* minObj)
 {
 	if (pOpt == 0) return false;
@@ -54,25 +78,12 @@ bool FEScanOptimizeMethod::Solve(FEOptimizeData* pOpt, vector<double>& amin, vec
 		a[i] = var->MinValue();
 	}
 
-	// loop until done
-	vector<double> y(ma, 0.0);
+	// collect the grid points
+	vector< vector<double> > grid;
 	bool bdone = false;
-	double fmin = 0.0;
 	do
 	{
-		// solve the problem with the new input parameters
-		if (opt.FESolve(a) == false) return false;
-
-		// calculate objective function
-		double fobj = obj.Evaluate(y);
-
-		// update minimum
-		if ((fmin == 0.0) || (fobj < fmin))
-		{
-			fmin = fobj;
-			amin = a;
-			ymin = y;
-		}
+		grid.push_back(a);
 
 		// update indices
 		for (int i=0; i<ma; ++i)
@@ -86,8 +97,92 @@ bool FEScanOptimizeMethod::Solve(FEOptimizeData* pOpt, vector<double>& amin, vec
 	}
 	while (!bdone);
 
+	double fmin = 0.0;
+	if (m_pool.IsParallel())
+	{
+		if (SolveWorkers(opt, grid, amin, ymin, fmin) == false) return false;
+	}
+	else
+	{
+		vector<double> y(ma, 0.0);
+		for (size_t n = 0; n < grid.size(); ++n)
+		{
+			// solve the problem with the new input parameters
+			if (opt.FESolve(grid[n]) == false) return false;
+
+			// calculate objective function
+			double fobj = obj.Evaluate(y);
+
+			// update minimum
+			if ((fmin == 0.0) || (fobj < fmin))
+			{
+				fmin = fobj;
+				amin = grid[n];
+				ymin = y;
+			}
+		}
+	}
+
 	// store the optimum data
 	if (minObj) *minObj = fmin;
 
 	return true;
 }
+
+//-----------------------------------------------------------------------------
+// The grid points are solved by the worker processes, which send back the
+// function values. The objective values and the minimum are then evaluated here
+// in grid order, so the result is the same as for the serial scan.
+bool FEScanOptimizeMethod::SolveWorkers(FEOptimizeData& opt, const vector< vector<double> >& grid, vector<double>& amin, vector<double>& ymin, double& fmin)
+{
+	FEModel* fem = opt.GetFEModel();
+	FEObjectiveFunction& obj = opt.GetObjective();
+
+	FEWorkerPool::WorkFunction work = [&](int job, vector<char>& buf) {
+		// the workers should not write any output
+		fem->BlockLog();
+		for (int i = 0; i < fem->Steps(); ++i) fem->GetStep(i)->SetOutputLevel(FE_OUTPUT_NEVER);
+
+		bool ok = opt.FESolve(grid[job]);
+		fem->BlockLog();
+		if (ok == false) return false;
+
+		vector<double> y;
+		obj.Evaluate(y);
+
+		// send back the function values
+		if (y.empty() == false)
+		{
+			buf.resize(y.size()*sizeof(double));
+			memcpy(&buf[0], &y[0], buf.size());
+		}
+		return true;
+	};
+
+	FEWorkerPool::ResultFunction done = [&](int job, bool ok, const vector<char>& buf) {
+		// report the iteration
+		const vector<double>& a = grid[job];
+		opt.m_niter++;
+		for (int i = 0; i < opt.InputParameters(); ++i) opt.GetInputParameter(i)->SetValue(a[i]);
+		opt.LogIteration();
+		if (ok == false) return false;
+
+		// calculate objective function
+		vector<double> y(buf.size() / sizeof(double));
+		if (y.empty() == false) memcpy(&y[0], &buf[0], buf.size());
+		double fobj = obj.ObjectiveValue(y);
+
+		// update minimum
+		if ((fmin == 0.0) || (fobj < fmin))
+		{
+			fmin = fobj;
+			amin = a;
+			ymin = y;
+		}
+		return true;
+	};
+
+	feLogEx(fem, "\nRunning %d grid points on %d workers (%d threads each).\n", (int)grid.size(), m_pool.Workers(), m_pool.WorkerThreads());
+
+	return m_pool.Run((int)grid.size(), work, done);
+}
@@ -28,17 +28,32 @@ SOFTWARE.*/
 
 #pragma once
 #include "FEOptimizeMethod.h"
+#include "FEWorkerPool.h"
 
 //----------------------------------------------------------------------------
 //! Basic method that scans the parameter space for a minimum.
 class FEScanOptimizeMethod : public FEOptimizeMethod
 {
 public:
+	FEScanOptimizeMethod();
+
+	bool Init() override;
+
 	// this implements the solution algorithm.
 	// returns the optimal parameter values in amin
 	// returns the optimal measurement vector in ymin
 	// returns the optimal objective function value in minObj
 	bool Solve(FEOptimizeData* pOpt, vector<double>& amin, vector<double>& ymin, double* minObj) override;
 
+private:
+	bool SolveWorkers(FEOptimizeData& opt, const vector< vector<double> >& grid, vector<double>& amin, vector<double>& ymin, double& fmin);
+
+public:
+	int		m_workers;		//!< number of worker processes
+	int		m_threads;		//!< OpenMP threads per worker (0 = share the available threads)
+
+private:
+	FEWorkerPool	m_pool;
+
 	DECLARE_FECORE_CLASS();
 };
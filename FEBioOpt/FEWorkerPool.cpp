@@ -0,0 +1,316 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEWorkerPool.h"
+#include <FECore/sys.h>
+#include <string.h>
+#include <stdio.h>
+#include <map>
+
+#ifndef WIN32
+#include <unistd.h>
+#include <poll.h>
+#include <signal.h>
+#include <errno.h>
+#include <sys/wait.h>
+#endif
+
+//-----------------------------------------------------------------------------
+FEWorkerPool::FEWorkerPool()
+{
+	m_workers = 1;
+	m_threads = 0;
+	m_maxThreads = 1;
+	m_prepared = false;
+}
+
+//-----------------------------------------------------------------------------
+void FEWorkerPool::SetWorkers(int workers)
+{
+	m_workers = (workers < 1 ? 1 : workers);
+}
+
+//-----------------------------------------------------------------------------
+void FEWorkerPool::SetWorkerThreads(int threads)
+{
+	m_threads = (threads < 0 ? 0 : threads);
+}
+
+//-----------------------------------------------------------------------------
+bool FEWorkerPool::IsParallel() const
+{
+#ifdef WIN32
+	return false;
+#else
+	return (m_workers > 1);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+int FEWorkerPool::WorkerThreads() const
+{
+	if (m_threads > 0) return m_threads;
+	int threads = m_maxThreads / m_workers;
+	return (threads < 1 ? 1 : threads);
+}
+
+//-----------------------------------------------------------------------------
+void FEWorkerPool::Prepare()
+{
+	if (m_prepared) return;
+	m_prepared = true;
+	m_maxThreads = omp_get_max_threads();
+#ifndef WIN32
+	if (IsParallel()) omp_set_num_threads(1);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+bool FEWorkerPool::Run(int jobs, WorkFunction work, ResultFunction done)
+{
+	if (jobs <= 0) return true;
+	if ((IsParallel() == false) || (jobs == 1)) return RunSerial(jobs, work, done);
+	return RunParallel(jobs, work, done);
+}
+
+//-----------------------------------------------------------------------------
+bool FEWorkerPool::RunSerial(int jobs, WorkFunction& work, ResultFunction& done)
+{
+	std::vector<char> buf;
+	for (int i = 0; i < jobs; ++i)
+	{
+		buf.clear();
+		bool ok = work(i, buf);
+		if (done(i, ok, buf) == false) return false;
+	}
+	return true;
+}
+
+#ifdef WIN32
+//-----------------------------------------------------------------------------
+bool FEWorkerPool::RunParallel(int jobs, WorkFunction& work, ResultFunction& done)
+{
+	return RunSerial(jobs, work, done);
+}
+#else
+//-----------------------------------------------------------------------------
+// header that precedes each result in the pipe
+struct JOB_HEADER
+{
+	int		job;
+	int		ok;
+	size_t	size;
+};
+
+//-----------------------------------------------------------------------------
+static bool write_all(int fd, const char* pd, size_t n)
+{
+	while (n > 0)
+	{
+		ssize_t m = write(fd, pd, n);
+		if (m < 0)
+		{
+			if (errno == EINTR) continue;
+			return false;
+		}
+		pd += m;
+		n -= (size_t)m;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEWorkerPool::RunParallel(int jobs, WorkFunction& work, ResultFunction& done)
+{
+	int workers = (m_workers < jobs ? m_workers : jobs);
+	int threads = WorkerThreads();
+
+	// don't let the workers inherit unwritten output (e.g. of the log file)
+	fflush(nullptr);
+
+	std::vector<pid_t> pid(workers, -1);
+	std::vector<int> fd(workers, -1);
+	for (int n = 0; n < workers; ++n)
+	{
+		int p[2];
+		pid_t id = -1;
+		if (pipe(p) == 0)
+		{
+			id = fork();
+			if (id < 0) { close(p[0]); close(p[1]); }
+		}
+		if (id < 0)
+		{
+			// we could not start this worker, so stop the ones we have
+			for (int i = 0; i < n; ++i) { kill(pid[i], SIGTERM); close(fd[i]); waitpid(pid[i], nullptr, 0); }
+			return false;
+		}
+
+		if (id == 0)
+		{
+			// we're the worker, so run our share of the jobs and send back the results
+			close(p[0]);
+			for (int i = 0; i < n; ++i) close(fd[i]);
+			omp_set_num_threads(threads);
+
+			std::vector<char> buf;
+			for (int i = n; i < jobs; i += workers)
+			{
+				buf.clear();
+				bool ok = false;
+				try {
+					ok = work(i, buf);
+				}
+				catch (...)
+				{
+					ok = false;
+				}
+
+				JOB_HEADER h = { i, (ok ? 1 : 0), buf.size() };
+				if (write_all(p[1], (const char*)&h, sizeof(h)) == false) _exit(1);
+				if (buf.empty() == false)
+				{
+					if (write_all(p[1], &buf[0], buf.size()) == false) _exit(1);
+				}
+			}
+			close(p[1]);
+
+			// Don't return to the caller or run any exit handlers
+			_exit(0);
+		}
+
+		close(p[1]);
+		pid[n] = id;
+		fd[n] = p[0];
+	}
+
+	// collect the results
+	struct RESULT
+	{
+		bool				ok;
+		std::vector<char>	data;
+	};
+	std::map<int, RESULT> results;
+	std::vector< std::vector<char> > stream(workers);
+	std::vector<char> tmp(1 << 16);
+	int next = 0;
+	int open = workers;
+	bool bret = true;
+	while (next < jobs)
+	{
+		// pass on the results that are ready, in job order
+		std::map<int, RESULT>::iterator it;
+		while ((it = results.find(next)) != results.end())
+		{
+			bool ok = done(next, it->second.ok, it->second.data);
+			results.erase(it);
+			++next;
+			if (ok == false) { bret = false; break; }
+		}
+		if ((bret == false) || (next >= jobs)) break;
+
+		// If all workers are gone, the remaining results will never arrive.
+		if (open == 0)
+		{
+			std::vector<char> none;
+			for (; next < jobs; ++next)
+			{
+				if (done(next, false, none) == false) { bret = false; break; }
+			}
+			break;
+		}
+
+		// wait for data
+		std::vector<pollfd> pfd;
+		std::vector<int> wid;
+		for (int n = 0; n < workers; ++n)
+		{
+			if (fd[n] >= 0)
+			{
+				pollfd p = { fd[n], POLLIN, 0 };
+				pfd.push_back(p);
+				wid.push_back(n);
+			}
+		}
+		if (poll(&pfd[0], (nfds_t)pfd.size(), -1) < 0)
+		{
+			if (errno == EINTR) continue;
+			bret = false;
+			break;
+		}
+
+		for (size_t k = 0; k < pfd.size(); ++k)
+		{
+			if (pfd[k].revents == 0) continue;
+			int n = wid[k];
+			ssize_t m = read(fd[n], &tmp[0], tmp.size());
+			if ((m < 0) && (errno == EINTR)) continue;
+			if (m <= 0)
+			{
+				// the worker is done (or died)
+				close(fd[n]);
+				fd[n] = -1;
+				open--;
+				continue;
+			}
+
+			std::vector<char>& s = stream[n];
+			s.insert(s.end(), tmp.begin(), tmp.begin() + m);
+
+			// extract all complete results
+			size_t pos = 0;
+			while (s.size() - pos >= sizeof(JOB_HEADER))
+			{
+				JOB_HEADER h;
+				memcpy(&h, &s[pos], sizeof(h));
+				if (s.size() - pos - sizeof(h) < h.size) break;
+				RESULT& r = results[h.job];
+				r.ok = (h.ok != 0);
+				r.data.assign(s.begin() + pos + sizeof(h), s.begin() + pos + sizeof(h) + h.size);
+				pos += sizeof(h) + h.size;
+			}
+			if (pos > 0) s.erase(s.begin(), s.begin() + pos);
+		}
+	}
+
+	// clean up
+	for (int n = 0; n < workers; ++n)
+	{
+		if (fd[n] >= 0)
+		{
+			// we stopped early, so the worker can stop too
+			kill(pid[n], SIGTERM);
+			close(fd[n]);
+		}
+		waitpid(pid[n], nullptr, 0);
+	}
+
+	return bret;
+}
+#endif
@@ -0,0 +1,86 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <vector>
+#include <functional>
+
+//-----------------------------------------------------------------------------
+//! Runs a list of independent jobs (e.g. the grid points of a parameter sweep)
+//! on a pool of worker processes. The workers are forked from the calling
+//! process once the model is initialized, so each worker starts with its own
+//! copy of the model. Jobs are assigned round-robin and the results are handed
+//! back to the calling process in job order, so that the output does not depend
+//! on the number of workers. On Windows, or with less than two workers, the
+//! jobs are simply run one after another in the calling process.
+class FEWorkerPool
+{
+public:
+	//! Runs a job in a worker. The result data is returned in the buffer.
+	typedef std::function<bool(int job, std::vector<char>& result)> WorkFunction;
+
+	//! Processes the result of a job in the calling process. Returning
+	//! false stops the pool.
+	typedef std::function<bool(int job, bool ok, const std::vector<char>& result)> ResultFunction;
+
+public:
+	FEWorkerPool();
+
+	//! set the number of workers
+	void SetWorkers(int workers);
+
+	//! set the OpenMP threads per worker (0 = share the available threads)
+	void SetWorkerThreads(int threads);
+
+	//! number of workers
+	int Workers() const { return m_workers; }
+
+	//! number of OpenMP threads each worker will use
+	int WorkerThreads() const;
+
+	//! returns true if jobs will actually run in separate processes
+	bool IsParallel() const;
+
+	//! This must be called before the model is initialized. The OpenMP runtime
+	//! cannot be used in a process that is forked from a multi-threaded process,
+	//! so the calling process stays single-threaded from here on.
+	void Prepare();
+
+	//! Run the jobs. The result function is called for jobs 0, 1, ..., jobs-1 in order.
+	bool Run(int jobs, WorkFunction work, ResultFunction done);
+
+private:
+	bool RunSerial(int jobs, WorkFunction& work, ResultFunction& done);
+	bool RunParallel(int jobs, WorkFunction& work, ResultFunction& done);
+
+private:
+	int		m_workers;		//!< number of worker processes
+	int		m_threads;		//!< OpenMP threads per worker
+	int		m_maxThreads;	//!< OpenMP threads of the calling process before Prepare was called
+	bool	m_prepared;
+};
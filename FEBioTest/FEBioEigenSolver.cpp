@@ -29,8 +29,17 @@ SOFTWARE.*/
 #include <FECore/FEAnalysis.h>
 #include <FECore/EigenSolver.h>
 #include <FECore/SparseMatrix.h>
+#include <FECore/CompactMatrix.h>
+#include <FECore/FEGlobalMatrix.h>
+#include <FECore/LinearSolver.h>
+#include <FECore/log.h>
 #include <FEBioMech/FESolidSolver2.h>
+#include <FEBioMech/FESolidLinearSystem.h>
+#include <FEBioMech/FEElasticDomain.h>
+#include <FEBioMech/FESolidMaterial.h>
 #include <FEBioPlot/FEBioPlotFile.h>
+#include <NumCore/LOBPCGEigenSolver.h>
+#include <NumCore/CompactSymmMatrix.h>
 
 FEBioEigenSolver::FEBioEigenSolver(FEModel* fem) : FECoreTask(fem)
 {
@@ -45,6 +54,64 @@ bool FEBioEigenSolver::Init(const char* szfile)
 	return fem->Init();
 }
 
+#ifndef MKL_ISS
+// Assembles the stiffness matrix (or the mass matrix) in a new matrix, so that it does
+// not touch the stiffness matrix and linear solver of the solver.
+static FEGlobalMatrix* AssembleMatrix(FEModel* fem, FESolidSolver2* solver, bool bmass)
+{
+	FEGlobalMatrix* G = new FEGlobalMatrix(new CompactSymmMatrix());
+	if (G->Create(fem, solver->m_neq, true) == false) { delete G; return nullptr; }
+	G->Zero();
+
+	bool bret = true;
+	if (bmass)
+	{
+		// consistent mass matrix of the deformable domains and the rigid bodies
+		vector<double> F(solver->m_neq, 0.0), u(solver->m_neq, 0.0);
+		FESolidLinearSystem LS(solver, solver->GetRigidSolver(), *G, F, u, true, 1.0, solver->m_nreq);
+		FEMesh& mesh = fem->GetMesh();
+		for (int i = 0; i < mesh.Domains(); ++i)
+		{
+			FEDomain& dom = mesh.Domain(i);
+			FESolidMaterial* mat = dynamic_cast<FESolidMaterial*>(dom.GetMaterial());
+			FEElasticDomain* edom = dynamic_cast<FEElasticDomain*>(&dom);
+			if (dom.IsActive() && edom && mat && (mat->IsRigid() == false)) edom->MassMatrix(LS, 1.0);
+		}
+
+		// with these values, the rigid body "mass matrix" is the mass and moment of inertia
+		FETimeInfo tp = fem->GetTime();
+		tp.timeIncrement = 1.0;
+		tp.alpham = 1.0;
+		tp.beta = 1.0;
+		tp.gamma = 1.0;
+		solver->GetRigidSolver()->RigidMassMatrix(LS, tp);
+
+		// The prescribed dofs are in the linear system with a one on the diagonal of K.
+		// They get no mass, so that they don't show up as (spurious) eigenvalues of one.
+		SparseMatrix& M = *G->GetSparseMatrixPtr();
+		for (int i = 0; i < mesh.Nodes(); ++i)
+		{
+			FENode& node = mesh.Node(i);
+			for (int j = 0; j < (int)node.m_ID.size(); ++j)
+			{
+				int J = -node.m_ID[j] - 2;
+				if ((J >= 0) && (J < solver->m_nreq)) M.set(J, J, 0.0);
+			}
+		}
+	}
+	else
+	{
+		FEGlobalMatrix* K0 = solver->m_pK;
+		solver->m_pK = G;
+		bret = solver->StiffnessMatrix();
+		solver->m_pK = K0;
+	}
+
+	if (bret == false) { delete G; return nullptr; }
+	return G;
+}
+#endif
+
 bool FEBioEigenSolver::Run()
 {
 	FEModel* fem = GetFEModel();
@@ -62,23 +129,69 @@ bool FEBioEigenSolver::Run()
 	if (solver->ReformStiffness() == false) return false;
 
 	// get the stiffness matrix
+	LinearSolver* ls = solver->GetLinearSolver();
 	SparseMatrix* K = solver->GetStiffnessMatrix()->GetSparseMatrixPtr(); assert(K);
 
 	// create the eigen solver
+#ifdef MKL_ISS
 	EigenSolver* eigenSolver = fecore_new<EigenSolver>("feast", fem);
 	if (eigenSolver == nullptr) return false;
 	eigenSolver->GetParameter("m0")->value<int>() = K->Rows();
 	eigenSolver->GetParameter("emin")->value<double>() = 0.0;
 	eigenSolver->GetParameter("emax")->value<double>() = 1.0;
+	SparseMatrix* M = nullptr;
+#else
+	// Without MKL, the lowest eigenvalues of K.x = lambda.M.x are found with the native solver.
+	// A direct linear solver has already factored K, so it is used as is, which gives an exact
+	// shift-invert around zero. Since it may have factored K in place, K is assembled again in a
+	// separate matrix. An iterative linear solver (or its preconditioner) can be reused as well.
+	// Otherwise, algebraic multigrid is used, which requires a compact matrix format.
+	LOBPCGEigenSolver* eigenSolver = fecore_new<LOBPCGEigenSolver>("lobpcg", fem);
+	if (eigenSolver == nullptr) return false;
+	LinearSolver* pc = nullptr;
+	FEGlobalMatrix* Kc = nullptr;
+	if (ls && ls->IsIterative())
+	{
+		// one application of the configured preconditioner is much cheaper than a full Krylov solve
+		IterativeLinearSolver* its = dynamic_cast<IterativeLinearSolver*>(ls);
+		LinearSolver* lpc = (its ? its->GetLeftPreconditioner() : nullptr);
+		eigenSolver->SetPreconditioner(lpc ? lpc : ls);
+	}
+	else if (ls)
+	{
+		Kc = AssembleMatrix(fem, solver, false);
+		if (Kc == nullptr) return false;
+		K = Kc->GetSparseMatrixPtr();
+		eigenSolver->SetPreconditioner(ls, true);
+	}
+	else if (dynamic_cast<CompactMatrix*>(K))
+	{
+		pc = fecore_new<LinearSolver>("native_amg", fem);
+		eigenSolver->SetPreconditioner(pc);
+	}
+	else feLogWarning("No suitable preconditioner for the eigen solver. Convergence may be slow.");
+
+	// the mass matrix
+	FEGlobalMatrix* Mc = AssembleMatrix(fem, solver, true);
+	if (Mc == nullptr) { delete Kc; delete pc; return false; }
+	SparseMatrix* M = Mc->GetSparseMatrixPtr();
+#endif
 
 	// initialize eigen solver
-	if (eigenSolver->Init() == false) return false;
+	bool b = eigenSolver->Init();
 
 	// get eigen values and eigen vectors
 	vector<double> eigenValues;
 	matrix eigenVectors;
-	bool b = eigenSolver->EigenSolve(K, nullptr, eigenValues, eigenVectors);
+	if (b) b = eigenSolver->EigenSolve(K, M, eigenValues, eigenVectors);
+#ifndef MKL_ISS
+	delete Mc;
+	delete Kc;
+	delete pc;
+#endif
 	if (b == false) return false;
+	feLog("\nEigenvalues:\n");
+	for (int i = 0; i < eigenValues.size(); ++i) feLog("\t%3d: %lg\n", i + 1, eigenValues[i]);
 
 	FEMesh& mesh = fem->GetMesh();
 
@@ -40,6 +40,10 @@ void FEBioCodeSection::Parse(XMLTag& tag)
 		{
 			const char* szname = tag.AttributeValue("name");
 			FECallBack* pcb = fecore_new<FECallBack>(szname, GetFEModel());
+			if (pcb == nullptr) throw XMLReader::InvalidAttributeValue(tag, "name", szname);
+
+			// read the (optional) callback parameters
+			if (tag.isleaf() == false) ReadParameterList(tag, pcb);
 
 			// TODO: The constructor of FECallBack already registered the callback class, so
 			// we don't need to do anything else here. Of course, the question is who
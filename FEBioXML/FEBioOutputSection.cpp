@@ -178,6 +178,15 @@ void FEBioOutputSection::ParseLogfile(XMLTag &tag)
 			else if (strcmp(szcomment, "off") == 0) bcomment = false;
 		}
 
+		// binary output (only supported for node and element data)
+		bool bbinary = false;
+		const char* szbinary = tag.AttributeValue("binary", true);
+		if (szbinary != 0)
+		{
+			if (strcmp(szbinary, "on") == 0) bbinary = true;
+			else if (strcmp(szbinary, "off") == 0) bbinary = false;
+		}
+
 
 		if (tag == "node_data")
 		{
@@ -191,6 +200,7 @@ void FEBioOutputSection::ParseLogfile(XMLTag &tag)
 			if (szdelim  != 0) prec->SetDelim(szdelim);
 			if (szformat != 0) prec->SetFormat(szformat);
 			prec->SetComments(bcomment);
+			prec->SetBinary(bbinary);
 
 			const char* sztmp = "set";
 			if (GetFileReader()->GetFileVersion() >= 0x0205) sztmp = "node_set";
@@ -246,6 +256,7 @@ void FEBioOutputSection::ParseLogfile(XMLTag &tag)
 			if (szdelim  != 0) prec->SetDelim(szdelim);
 			if (szformat != 0) prec->SetFormat(szformat);
 			prec->SetComments(bcomment);
+			prec->SetBinary(bbinary);
 
 			const char* sztmp = "elset";
 			if (GetFileReader()->GetFileVersion() >= 0x0205) sztmp = "elem_set";
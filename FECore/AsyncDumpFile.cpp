@@ -0,0 +1,152 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "AsyncDumpFile.h"
+#include "DumpFile.h"
+#include "FEModel.h"
+#include <stdio.h>
+#ifdef HAVE_ZLIB
+#include "zlib.h"
+#endif
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+//-----------------------------------------------------------------------------
+AsyncDumpFile::AsyncDumpFile(FEModel& fem) : m_fem(fem), m_ar(fem)
+{
+	m_bok = true;
+}
+
+//-----------------------------------------------------------------------------
+AsyncDumpFile::~AsyncDumpFile()
+{
+	Wait();
+}
+
+//-----------------------------------------------------------------------------
+void AsyncDumpFile::Write(const char* szfile)
+{
+	// we can only reuse the memory stream when the last write is done
+	Wait();
+
+	// serialize the model
+	m_ar.clear();
+	m_ar.Open(true, false);
+	m_fem.Serialize(m_ar);
+
+	// write the archive in the background
+	m_file = szfile;
+	m_thread = std::thread([this]() { m_bok = WriteArchive(); });
+}
+
+//-----------------------------------------------------------------------------
+bool AsyncDumpFile::Wait()
+{
+	if (m_thread.joinable()) m_thread.join();
+	bool bok = m_bok;
+	m_bok = true;
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+bool AsyncDumpFile::WriteArchive()
+{
+	std::string tmpFile = m_file + ".tmp";
+	FILE* fp = fopen(tmpFile.c_str(), "wb");
+	if (fp == 0) return false;
+
+	const char* pd = m_ar.data();
+	size_t nsize = m_ar.size();
+	bool bok = true;
+
+#ifdef HAVE_ZLIB
+	// write the header
+	unsigned long long nbytes = nsize;
+	bok = (fwrite(DUMP_COMPRESSED_TAG, 1, 4, fp) == 4) && (fwrite(&nbytes, sizeof(nbytes), 1, fp) == 1);
+
+	// compress the data in blocks
+	// (We favor speed, since the archive is written while the model is running.)
+	z_stream strm;
+	strm.zalloc = Z_NULL;
+	strm.zfree = Z_NULL;
+	strm.opaque = Z_NULL;
+	if (bok && (deflateInit(&strm, Z_BEST_SPEED) == Z_OK))
+	{
+		const size_t CHUNK = 1 << 20;
+		std::vector<unsigned char> out(CHUNK);
+		size_t pos = 0;
+		int flush = Z_NO_FLUSH;
+		do
+		{
+			size_t nblock = (nsize - pos < CHUNK ? nsize - pos : CHUNK);
+			strm.avail_in = (uInt) nblock;
+			strm.next_in = (Bytef*) (pd + pos);
+			pos += nblock;
+			flush = (pos >= nsize ? Z_FINISH : Z_NO_FLUSH);
+			do
+			{
+				strm.avail_out = (uInt) CHUNK;
+				strm.next_out = &out[0];
+				deflate(&strm, flush);
+				size_t have = CHUNK - strm.avail_out;
+				if (fwrite(&out[0], 1, have, fp) != have) bok = false;
+			}
+			while (strm.avail_out == 0);
+		}
+		while (bok && (flush != Z_FINISH));
+		deflateEnd(&strm);
+	}
+	else bok = false;
+#else
+	// without zlib the archive is written uncompressed
+	if (nsize > 0) bok = (fwrite(pd, 1, nsize, fp) == nsize);
+#endif
+
+	// make sure the data is on disk before the archive is replaced
+	if (fflush(fp) != 0) bok = false;
+#ifndef WIN32
+	if (bok && (fsync(fileno(fp)) != 0)) bok = false;
+#endif
+	fclose(fp);
+
+	if (bok)
+	{
+#ifdef WIN32
+		bok = (MoveFileExA(tmpFile.c_str(), m_file.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0);
+#else
+		bok = (rename(tmpFile.c_str(), m_file.c_str()) == 0);
+#endif
+	}
+	if (bok == false) remove(tmpFile.c_str());
+
+	return bok;
+}
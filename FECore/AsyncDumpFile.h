@@ -0,0 +1,68 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "DumpMemStream.h"
+#include <string>
+#include <thread>
+
+//-----------------------------------------------------------------------------
+//! Writes cold restart archives in the background.
+//! The model is serialized into a memory stream on the calling thread. A 
+//! worker thread then compresses the data (when zlib is available) and writes
+//! it to a temporary file, which replaces the archive only when it is
+//! complete. This way an interrupted write never corrupts the previous 
+//! restart point. The archives can be read with DumpFile.
+class FECORE_API AsyncDumpFile
+{
+public:
+	AsyncDumpFile(FEModel& fem);
+	~AsyncDumpFile();
+
+	//! Serialize the model and start writing the archive. 
+	//! A pending write is completed first.
+	void Write(const char* szfile);
+
+	//! Wait until the pending write is done.
+	//! Returns false if the last write failed.
+	bool Wait();
+
+	//! the name of the archive that was written last
+	const std::string& FileName() const { return m_file; }
+
+private:
+	//! compress and write the memory stream (runs on the worker thread)
+	bool WriteArchive();
+
+private:
+	FEModel&		m_fem;
+	DumpMemStream	m_ar;		//!< serialized model data
+	std::thread		m_thread;	//!< worker thread
+	std::string		m_file;		//!< archive name
+	bool			m_bok;		//!< result of last write
+};
@@ -51,6 +51,8 @@ DataRecord::DataRecord(FEModel* pfem, const char* szfile, int ntype) : m_type(nt
 	strcpy(m_szdelim, " ");
 	
 	m_bcomm = true;
+	m_bbinary = false;
+	m_bheader = false;
 
 	m_fp = 0;
 	m_szfile[0] = 0;
@@ -91,6 +93,21 @@ void DataRecord::SetFormat(const char* sz)
 	strcpy(m_szfmt, sz);
 }
 
+//-----------------------------------------------------------------------------
+void DataRecord::SetBinary(bool b)
+{
+	if (b == m_bbinary) return;
+	m_bbinary = b;
+	m_bheader = false;
+
+	// reopen the file in the correct mode
+	if (m_fp)
+	{
+		m_fp = freopen(m_szfile, (b ? "wb" : "wt"), m_fp);
+		if (m_fp == 0) feLogErrorEx(m_pfem, "FAILED REOPENING DATA FILE %s\n\n", m_szfile);
+	}
+}
+
 //-----------------------------------------------------------------------------
 bool DataRecord::Initialize()
 {
@@ -99,24 +116,35 @@ bool DataRecord::Initialize()
 }
 
 //-----------------------------------------------------------------------------
-std::string DataRecord::printToString(int i)
+// Formats one line of the default text output: the item number followed by its
+// nd data values v[0], v[stride], ... This is shared by the text records and
+// BinaryToText so that both produce the same text.
+static std::string formatItem(int item, const double* v, int nd, int stride, const char* szdelim)
 {
 	std::stringstream ss;
 	ss.precision(12);
 
-	ss << m_item[i] << m_szdelim;
-	int nd = Size();
+	ss << item << szdelim;
 	for (int j = 0; j<nd; ++j)
 	{
-		double val = Evaluate(m_item[i], j);
-		ss << val;
-		if (j != nd - 1) ss << m_szdelim;
+		ss << v[j*stride];
+		if (j != nd - 1) ss << szdelim;
 		else ss << "\n";
 	}
 
 	return ss.str();
 }
 
+//-----------------------------------------------------------------------------
+std::string DataRecord::printToString(int i)
+{
+	int nd = Size();
+	std::vector<double> val(nd);
+	for (int j = 0; j<nd; ++j) val[j] = Evaluate(m_item[i], j);
+
+	return formatItem(m_item[i], (nd > 0 ? &val[0] : nullptr), nd, 1, m_szdelim);
+}
+
 //-----------------------------------------------------------------------------
 std::string DataRecord::printToFormatString(int i)
 {
@@ -200,8 +228,18 @@ bool DataRecord::Write()
 	feLogEx(m_pfem, "Time = %.9lg\n", ftime);
 	feLogEx(m_pfem, "Data = %s\n", m_szname);
 
-	// write some comments
+	// binary data is only written to files
 	FILE* fp = m_fp;
+	if (fp && m_bbinary)
+	{
+		feLogEx(m_pfem, "File = %s\n", m_szfile);
+		return WriteBinary(nstep, ftime);
+	}
+
+	// the binary file could not be opened or written, so we stopped recording
+	if (m_bbinary && (m_szfile[0] != 0)) return false;
+
+	// write some comments
 	if (fp && m_bcomm)
 	{
 		// we save the data in a seperate file
@@ -241,6 +279,131 @@ bool DataRecord::Write()
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+void DataRecord::EvaluateItems(std::vector<double>& data)
+{
+	int N = (int)m_item.size();
+	int nd = Size();
+	for (int j = 0; j < nd; ++j)
+		for (int i = 0; i < N; ++i) data[j*N + i] = Evaluate(m_item[i], j);
+}
+
+//-----------------------------------------------------------------------------
+// The binary file starts with a header that stores the layout of the data:
+//   tag, version, nr of items, nr of data values, name, delimiter, comment flag, item list
+// Each call appends a frame with the step number, the time, and the data values,
+// which are stored per data column (see EvaluateItems).
+bool DataRecord::WriteBinary(int nstep, double ftime)
+{
+	FILE* fp = m_fp;
+	int N = (int)m_item.size();
+	int nd = Size();
+
+	bool bok = true;
+	if (m_bheader == false)
+	{
+		int version = FE_DATA_BINARY_VERSION;
+		int lname = (int)strlen(m_szname);
+		int ldelim = (int)strlen(m_szdelim);
+		int bcomm = (m_bcomm ? 1 : 0);
+		bok = bok && (fwrite(FE_DATA_BINARY_TAG, 1, 4, fp) == 4);
+		bok = bok && (fwrite(&version, sizeof(int), 1, fp) == 1);
+		bok = bok && (fwrite(&N, sizeof(int), 1, fp) == 1);
+		bok = bok && (fwrite(&nd, sizeof(int), 1, fp) == 1);
+		bok = bok && (fwrite(&lname, sizeof(int), 1, fp) == 1);
+		bok = bok && ((int)fwrite(m_szname, 1, lname, fp) == lname);
+		bok = bok && (fwrite(&ldelim, sizeof(int), 1, fp) == 1);
+		bok = bok && ((int)fwrite(m_szdelim, 1, ldelim, fp) == ldelim);
+		bok = bok && (fwrite(&bcomm, sizeof(int), 1, fp) == 1);
+		if (bok && (N > 0)) bok = ((int)fwrite(&m_item[0], sizeof(int), N, fp) == N);
+		m_bheader = true;
+	}
+
+	if (bok)
+	{
+		// evaluate the data
+		m_buf.resize((size_t)N*nd);
+		EvaluateItems(m_buf);
+
+		// append the frame
+		bok = bok && (fwrite(&nstep, sizeof(int), 1, fp) == 1);
+		bok = bok && (fwrite(&ftime, sizeof(double), 1, fp) == 1);
+		size_t nsize = m_buf.size();
+		if (bok && (nsize > 0)) bok = (fwrite(&m_buf[0], sizeof(double), nsize, fp) == nsize);
+		bok = bok && (fflush(fp) == 0);
+	}
+
+	// stop recording, since the file is incomplete from here on
+	if (bok == false)
+	{
+		feLogErrorEx(m_pfem, "FAILED WRITING DATA FILE %s\n\n", m_szfile);
+		fclose(m_fp);
+		m_fp = 0;
+	}
+
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+bool DataRecord::BinaryToText(const char* szbin, const char* sztxt)
+{
+	FILE* fin = fopen(szbin, "rb");
+	if (fin == 0) return false;
+
+	// read the header
+	char tag[4] = { 0 };
+	int version = 0, N = 0, nd = 0, lname = 0, ldelim = 0, bcomm = 0;
+	char szname[MAX_STRING] = { 0 }, szdelim[MAX_DELIM] = { 0 };
+	bool bok = (fread(tag, 1, 4, fin) == 4) && (strncmp(tag, FE_DATA_BINARY_TAG, 4) == 0);
+	bok = bok && (fread(&version, sizeof(int), 1, fin) == 1) && (version == FE_DATA_BINARY_VERSION);
+	bok = bok && (fread(&N, sizeof(int), 1, fin) == 1) && (N >= 0);
+	bok = bok && (fread(&nd, sizeof(int), 1, fin) == 1) && (nd >= 0);
+	bok = bok && (fread(&lname, sizeof(int), 1, fin) == 1) && (lname >= 0) && (lname < MAX_STRING);
+	bok = bok && ((int)fread(szname, 1, lname, fin) == lname);
+	bok = bok && (fread(&ldelim, sizeof(int), 1, fin) == 1) && (ldelim >= 0) && (ldelim < MAX_DELIM);
+	bok = bok && ((int)fread(szdelim, 1, ldelim, fin) == ldelim);
+	bok = bok && (fread(&bcomm, sizeof(int), 1, fin) == 1);
+	std::vector<int> item(N);
+	if (bok && (N > 0)) bok = ((int)fread(&item[0], sizeof(int), N, fin) == N);
+	if (bok == false) { fclose(fin); return false; }
+
+	FILE* fout = (sztxt ? fopen(sztxt, "wt") : stdout);
+	if (fout == 0) { fclose(fin); return false; }
+
+	// convert the frames
+	std::vector<double> data((size_t)N*nd);
+	int nstep;
+	double ftime;
+	while (fread(&nstep, sizeof(int), 1, fin) == 1)
+	{
+		if ((fread(&ftime, sizeof(double), 1, fin) != 1) ||
+			(!data.empty() && (fread(&data[0], sizeof(double), data.size(), fin) != data.size())))
+		{
+			// incomplete frame (e.g. the run was interrupted)
+			bok = false;
+			break;
+		}
+
+		if (bcomm)
+		{
+			fprintf(fout, "*Step  = %d\n", nstep);
+			fprintf(fout, "*Time  = %.9lg\n", ftime);
+			fprintf(fout, "*Data  = %s\n", szname);
+		}
+
+		for (int i = 0; i < N; ++i)
+		{
+			std::string out = formatItem(item[i], (nd > 0 ? &data[i] : nullptr), nd, N, szdelim);
+			fprintf(fout, "%s", out.c_str());
+		}
+	}
+
+	fclose(fin);
+	if (sztxt) fclose(fout);
+
+	return bok;
+}
+
 //-----------------------------------------------------------------------------
 
 void DataRecord::SetItemList(const std::vector<int>& items)
@@ -262,6 +425,7 @@ void DataRecord::Serialize(DumpStream &ar)
 	ar & m_bcomm;
 	ar & m_item;
 	ar & m_szdata;
+	ar & m_bbinary;
 
 	// when we're loading we need to reinitialize the file
 	if (ar.IsLoading())
@@ -273,7 +437,14 @@ void DataRecord::Serialize(DumpStream &ar)
 		if (m_szfile[0] != 0)
 		{
 			// reopen data file for appending
-			m_fp = fopen(m_szfile, "a+");
+			m_fp = fopen(m_szfile, (m_bbinary ? "ab" : "a+"));
+
+			// a binary file only needs a header when it is empty
+			if (m_fp && m_bbinary)
+			{
+				fseek(m_fp, 0, SEEK_END);
+				m_bheader = (ftell(m_fp) > 0);
+			}
 		}
 	}
 }
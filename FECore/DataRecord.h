@@ -49,6 +49,11 @@ enum FEDataRecordType {
 	FE_DATA_DOMAIN
 };
 
+//-----------------------------------------------------------------------------
+// Binary data files start with this tag
+#define FE_DATA_BINARY_TAG	"FEBD"
+#define FE_DATA_BINARY_VERSION	1
+
 //-----------------------------------------------------------------------------
 // Exception thrown when parsing fails
 class FECORE_API UnknownDataField : public std::runtime_error
@@ -75,6 +80,11 @@ public:
 	void SetDelim(const char* sz);
 	void SetFormat(const char* sz);
 	void SetComments(bool b) { m_bcomm = b; }
+	void SetBinary(bool b);
+
+	//! convert a binary data file to the text format (written to stdout if sztxt is null).
+	//! The lines are formatted like those of a text record without a format string.
+	static bool BinaryToText(const char* szbin, const char* sztxt);
 
 public:
 	virtual bool Initialize();
@@ -84,10 +94,17 @@ public:
 	virtual void SetData(const char* sz) = 0;
 	virtual int Size() const = 0;
 
+protected:
+	//! Evaluate all data values of all items. The values are stored per data 
+	//! column, i.e. data[j*items + i] is the j-th value of the i-th item.
+	virtual void EvaluateItems(std::vector<double>& data);
+
 private:
 	std::string printToString(int i);
 	std::string printToFormatString(int i);
 
+	bool WriteBinary(int nstep, double ftime);
+
 public:
 	int					m_nid;		//!< ID of data record
 	std::vector<int>	m_item;		//!< item list
@@ -99,6 +116,9 @@ protected:
 	char	m_szdelim[MAX_DELIM];	//!< data delimitor
 	char	m_szdata[MAX_STRING];	//!< data expression
 	char	m_szfmt[MAX_STRING];	//!< max format string
+	bool	m_bbinary;				//!< write data in binary format
+	bool	m_bheader;				//!< binary file header was written
+	std::vector<double>	m_buf;		//!< data buffer for binary output
 
 protected:
 	char	m_szfile[MAX_STRING];	//!< file name of data record
@@ -28,10 +28,15 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "DumpFile.h"
+#ifdef HAVE_ZLIB
+#include "zlib.h"
+#endif
 
 DumpFile::DumpFile(FEModel& fem) : DumpStream(fem)
 {
 	m_fp = 0;
+	m_bmem = false;
+	m_pos = 0;
 }
 
 DumpFile::~DumpFile()
@@ -44,11 +49,80 @@ bool DumpFile::Open(const char* szfile)
 	m_fp = fopen(szfile, "rb");
 	if (m_fp == 0) return false;
 
+	// see if this is a compressed archive
+	char tag[4] = { 0 };
+	if ((fread(tag, 1, 4, m_fp) == 4) && (strncmp(tag, DUMP_COMPRESSED_TAG, 4) == 0))
+	{
+		if (Decompress() == false)
+		{
+			Close();
+			return false;
+		}
+	}
+	else rewind(m_fp);
+
 	DumpStream::Open(false, false);
 
 	return true;
 }
 
+bool DumpFile::Decompress()
+{
+#ifdef HAVE_ZLIB
+	unsigned long long nsize = 0;
+	if (fread(&nsize, sizeof(nsize), 1, m_fp) != 1) return false;
+	// (one extra byte so that a corrupt stream cannot fill the buffer exactly)
+	m_buf.resize((size_t) nsize + 1);
+
+	z_stream strm;
+	strm.zalloc = Z_NULL;
+	strm.zfree = Z_NULL;
+	strm.opaque = Z_NULL;
+	strm.avail_in = 0;
+	strm.next_in = Z_NULL;
+	if (inflateInit(&strm) != Z_OK) return false;
+
+	const size_t CHUNK = 1 << 20;
+	std::vector<unsigned char> in(CHUNK);
+	size_t nout = 0;
+	int ret = Z_OK;
+	while (ret != Z_STREAM_END)
+	{
+		strm.avail_in = (uInt) fread(&in[0], 1, CHUNK, m_fp);
+		if (strm.avail_in == 0) break;
+		strm.next_in = &in[0];
+		do
+		{
+			size_t nleft = m_buf.size() - nout;
+			if (nleft == 0) break;
+			uInt nblock = (uInt) (nleft < CHUNK ? nleft : CHUNK);
+			strm.avail_out = nblock;
+			strm.next_out = (Bytef*) (m_buf.data() + nout);
+			ret = inflate(&strm, Z_NO_FLUSH);
+			if ((ret != Z_OK) && (ret != Z_STREAM_END) && (ret != Z_BUF_ERROR))
+			{
+				inflateEnd(&strm);
+				return false;
+			}
+			nout += nblock - strm.avail_out;
+		}
+		while ((strm.avail_in > 0) && (ret != Z_STREAM_END));
+		if (nout >= m_buf.size()) break;
+	}
+	inflateEnd(&strm);
+
+	if ((ret != Z_STREAM_END) || (nout != nsize)) return false;
+	m_buf.resize((size_t) nsize);
+
+	m_bmem = true;
+	m_pos = 0;
+	return true;
+#else
+	// compressed archives cannot be read without zlib
+	return false;
+#endif
+}
+
 bool DumpFile::Create(const char* szfile)
 {
 	m_fp = fopen(szfile, "wb");
@@ -73,6 +147,9 @@ void DumpFile::Close()
 {
 	if (m_fp) fclose(m_fp); 
 	m_fp = 0;
+	m_bmem = false;
+	m_buf.clear();
+	m_pos = 0;
 }
 
 //! write buffer to archive
@@ -87,11 +164,21 @@ size_t DumpFile::write(const void* pd, size_t size, size_t count)
 size_t DumpFile::read(void* pd, size_t size, size_t count)
 {
 	assert(IsLoading());
+	if (m_bmem)
+	{
+		if (size == 0) return 0;
+		size_t nleft = (m_buf.size() - m_pos) / size;
+		size_t elemsRead = (count < nleft ? count : nleft);
+		memcpy(pd, m_buf.data() + m_pos, size * elemsRead);
+		m_pos += size * elemsRead;
+		return size * elemsRead;
+	}
 	int elemsRead = fread(pd, size, count, m_fp);
 	return size * elemsRead;
 }
 
 bool DumpFile::EndOfStream() const
 {
+	if (m_bmem) return (m_pos >= m_buf.size());
 	return (feof(m_fp) != 0);
 }
@@ -29,14 +29,22 @@ SOFTWARE.*/
 #pragma once
 
 #include <stdio.h>
+#include <vector>
 #include "DumpStream.h"
 
+//-----------------------------------------------------------------------------
+//! Compressed archives start with this tag, followed by the size of the
+//! uncompressed data (as a 64-bit integer) and the zlib stream.
+#define DUMP_COMPRESSED_TAG	"FEBZ"
+
 //-----------------------------------------------------------------------------
 //! Class for serializing data to a binary archive.
 
 //! This class is used to read data from or write
 //! data to a binary file. The class defines several operators to 
 //! simplify in- and output.
+//! Compressed archives (see AsyncDumpFile) are recognized when opened for
+//! reading. They are decompressed into memory and read from there.
 //! \sa FEM::Serialize()
 
 class FECORE_API DumpFile : public DumpStream
@@ -70,6 +78,14 @@ public:
 	//! Flush the archive
 	void Flush() { fflush(m_fp); }
 
+protected:
+	//! read the rest of a compressed archive into the memory buffer
+	bool Decompress();
+
 protected:
 	FILE*		m_fp;		//!< The actual file pointer
+
+	bool				m_bmem;		//!< read from the (decompressed) memory buffer
+	std::vector<char>	m_buf;		//!< decompressed archive data
+	size_t				m_pos;		//!< read position in memory buffer
 };
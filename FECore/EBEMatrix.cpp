@@ -0,0 +1,455 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "EBEMatrix.h"
+#include "FENewtonSolver.h"
+#include "FEModel.h"
+#include "FEDomain.h"
+#include "FEMesh.h"
+#include "log.h"
+#include <math.h>
+
+//-----------------------------------------------------------------------------
+EBEMatrix::EBEMatrix(FENewtonSolver* pns, bool bsymm, bool bcache) : m_pns(pns)
+{
+	m_nrow = m_ncol = 0;
+	m_nsize = 0;
+	m_bsymm = bsymm;
+	m_bcache = bcache;
+	m_mode = REFORM;
+	m_x = nullptr;
+	m_y = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+//! Create the matrix. Only the size of the profile is used.
+void EBEMatrix::Create(SparseMatrixProfile& MP)
+{
+	int neq = MP.Rows();
+	m_nrow = m_ncol = neq;
+	m_nsize = 0;
+
+	BuildBlocks(neq);
+
+	m_bset.assign(neq, 0);
+	m_vset.assign(neq, 0.0);
+}
+
+//-----------------------------------------------------------------------------
+// The diagonal blocks collect the equations of each node. Element dofs and any
+// other equations (e.g. rigid body dofs) form 1x1 blocks.
+void EBEMatrix::BuildBlocks(int neq)
+{
+	m_eqBlock.assign(neq, -1);
+	m_eqIndex.assign(neq, 0);
+	m_bsize.clear();
+	m_beqOffset.clear();
+	m_beq.clear();
+	m_beq.reserve(neq);
+
+	FEMesh& mesh = m_pns->GetFEModel()->GetMesh();
+	for (int i = 0; i < mesh.Nodes(); ++i)
+	{
+		FENode& node = mesh.Node(i);
+		int nb = (int)m_bsize.size();
+		int n = 0;
+		for (int j = 0; j < (int)node.m_ID.size(); ++j)
+		{
+			int id = node.m_ID[j];
+			if ((id >= 0) && (id < neq) && (m_eqBlock[id] == -1))
+			{
+				if (n == 0) m_beqOffset.push_back((int)m_beq.size());
+				m_eqBlock[id] = nb;
+				m_eqIndex[id] = n++;
+				m_beq.push_back(id);
+			}
+		}
+		if (n > 0) m_bsize.push_back(n);
+	}
+
+	// all remaining equations get their own block
+	for (int i = 0; i < neq; ++i)
+	{
+		if (m_eqBlock[i] == -1)
+		{
+			m_eqBlock[i] = (int)m_bsize.size();
+			m_eqIndex[i] = 0;
+			m_beqOffset.push_back((int)m_beq.size());
+			m_beq.push_back(i);
+			m_bsize.push_back(1);
+		}
+	}
+
+	// allocate the block values
+	int NB = (int)m_bsize.size();
+	m_bvalOffset.resize(NB);
+	size_t nval = 0;
+	for (int i = 0; i < NB; ++i)
+	{
+		m_bvalOffset[i] = nval;
+		nval += (size_t)m_bsize[i] * m_bsize[i];
+	}
+	m_bval.assign(nval, 0.0);
+}
+
+//-----------------------------------------------------------------------------
+void EBEMatrix::Zero()
+{
+	m_mode = REFORM;
+	std::fill(m_bval.begin(), m_bval.end(), 0.0);
+	std::fill(m_bset.begin(), m_bset.end(), 0);
+	m_elem.clear();
+	m_lm.clear();
+	m_ke.clear();
+	m_entry.clear();
+	m_nsize = 0;
+}
+
+//-----------------------------------------------------------------------------
+void EBEMatrix::Clear()
+{
+	vector<double>().swap(m_bval);
+	vector<ELEMENT>().swap(m_elem);
+	vector<int>().swap(m_lm);
+	vector<double>().swap(m_ke);
+	vector<ENTRY>().swap(m_entry);
+	m_nsize = 0;
+}
+
+//-----------------------------------------------------------------------------
+void EBEMatrix::AddToBlock(int I, int J, double v)
+{
+	int nb = m_eqBlock[I];
+	if (m_eqBlock[J] != nb) return;
+	int n = m_bsize[nb];
+	double& bij = m_bval[m_bvalOffset[nb] + (size_t)m_eqIndex[I] * n + m_eqIndex[J]];
+#pragma omp atomic
+	bij += v;
+}
+
+//-----------------------------------------------------------------------------
+// Process a single matrix entry. For symmetric matrices, only the upper triangular
+// part is used, as is done by the symmetric sparse matrix formats.
+void EBEMatrix::AddEntry(int I, int J, double v)
+{
+	if (m_bsymm && (I > J)) return;
+
+	if (m_mode == REFORM)
+	{
+		AddToBlock(I, J, v);
+		if (m_bsymm && (I != J)) AddToBlock(J, I, v);
+	}
+	else
+	{
+		double yi = v * m_x[J];
+#pragma omp atomic
+		m_y[I] += yi;
+
+		if (m_bsymm && (I != J))
+		{
+			double yj = v * m_x[I];
+#pragma omp atomic
+			m_y[J] += yj;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void EBEMatrix::Assemble(const matrix& ke, const std::vector<int>& lm)
+{
+	Assemble(ke, lm, lm);
+}
+
+//-----------------------------------------------------------------------------
+void EBEMatrix::Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj)
+{
+	// NOTE: the index arrays can be larger than the element matrix
+	const int nr = ke.rows();
+	const int nc = ke.columns();
+	for (int i = 0; i < nr; ++i)
+	{
+		int I = lmi[i];
+		if (I < 0) continue;
+		for (int j = 0; j < nc; ++j)
+		{
+			int J = lmj[j];
+			if (J >= 0) AddEntry(I, J, ke[i][j]);
+		}
+	}
+
+	// store a copy of the element matrix
+	if (m_bcache && (m_mode == REFORM))
+	{
+#pragma omp critical(EBEMatrix_cache)
+		{
+			ELEMENT el;
+			el.nr = nr;
+			el.nc = nc;
+			el.lm = m_lm.size();
+			el.ke = m_ke.size();
+			m_lm.insert(m_lm.end(), lmi.begin(), lmi.begin() + nr);
+			m_lm.insert(m_lm.end(), lmj.begin(), lmj.begin() + nc);
+			for (int i = 0; i < nr; ++i)
+				m_ke.insert(m_ke.end(), ke[i], ke[i] + nc);
+			m_elem.push_back(el);
+			m_nsize += nr*nc;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void EBEMatrix::add(int i, int j, double v)
+{
+	if ((i < 0) || (j < 0)) return;
+	AddEntry(i, j, v);
+
+	if (m_bcache && (m_mode == REFORM))
+	{
+		ENTRY e = { i, j, v };
+#pragma omp critical(EBEMatrix_cache)
+		m_entry.push_back(e);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Diagonal entries are only set for equations that don't receive any other contributions
+// (e.g. prescribed or masked equations), so the entire row of the product is overridden.
+void EBEMatrix::set(int i, int j, double v)
+{
+	if (i != j) { add(i, j, v); return; }
+	if (m_mode != REFORM) return;
+
+	m_bset[i] = 1;
+	m_vset[i] = v;
+
+	int nb = m_eqBlock[i];
+	m_bval[m_bvalOffset[nb] + (size_t)m_eqIndex[i] * m_bsize[nb] + m_eqIndex[i]] = v;
+}
+
+//-----------------------------------------------------------------------------
+double EBEMatrix::get(int i, int j)
+{
+	int nb = m_eqBlock[i];
+	if (m_eqBlock[j] != nb) return 0.0;
+	return m_bval[m_bvalOffset[nb] + (size_t)m_eqIndex[i] * m_bsize[nb] + m_eqIndex[j]];
+}
+
+//-----------------------------------------------------------------------------
+double EBEMatrix::diag(int i)
+{
+	return get(i, i);
+}
+
+//-----------------------------------------------------------------------------
+bool EBEMatrix::mult_vector(double* x, double* r)
+{
+	const int neq = m_nrow;
+	for (int i = 0; i < neq; ++i) r[i] = 0.0;
+
+	m_x = x;
+	m_y = r;
+	m_mode = MULTIPLY;
+
+	bool bret = true;
+	if (m_bcache)
+	{
+		// apply the cached element matrices
+		const int NE = (int)m_elem.size();
+#pragma omp parallel for schedule(dynamic, 64)
+		for (int n = 0; n < NE; ++n)
+		{
+			const ELEMENT& el = m_elem[n];
+			const int* lmi = &m_lm[el.lm];
+			const int* lmj = lmi + el.nr;
+			const double* ke = &m_ke[el.ke];
+			for (int i = 0; i < el.nr; ++i)
+			{
+				int I = lmi[i];
+				if (I < 0) continue;
+				for (int j = 0; j < el.nc; ++j)
+				{
+					int J = lmj[j];
+					if (J >= 0) AddEntry(I, J, ke[i*el.nc + j]);
+				}
+			}
+		}
+
+		for (size_t n = 0; n < m_entry.size(); ++n)
+		{
+			const ENTRY& e = m_entry[n];
+			AddEntry(e.i, e.j, e.v);
+		}
+	}
+	else
+	{
+		// Evaluate the stiffness matrix again, which calls Assemble for all element matrices.
+		// The stiffness evaluation also updates the prescribed dof contributions, which
+		// must not change here.
+		vector<double> Fd = m_pns->m_Fd;
+		bret = m_pns->StiffnessMatrix();
+		m_pns->m_Fd = Fd;
+	}
+
+	m_mode = REFORM;
+	m_x = nullptr;
+	m_y = nullptr;
+
+	// set the rows of the equations whose diagonal was set
+	for (int i = 0; i < neq; ++i)
+	{
+		if (m_bset[i]) r[i] = m_vset[i] * x[i];
+	}
+
+	return bret;
+}
+
+//=============================================================================
+EBEBlockJacobi::EBEBlockJacobi(FEModel* fem) : Preconditioner(fem), m_A(nullptr)
+{
+	m_bdiag = false;
+}
+
+//-----------------------------------------------------------------------------
+// Invert a dense n x n matrix (stored row-wise) with Gauss-Jordan elimination.
+// Returns false if the matrix is singular.
+static bool invert_block(int n, double* a, double* ai)
+{
+	for (int i = 0; i < n*n; ++i) ai[i] = 0.0;
+	for (int i = 0; i < n; ++i) ai[i*n + i] = 1.0;
+
+	for (int k = 0; k < n; ++k)
+	{
+		// find the pivot
+		int p = k;
+		double amax = fabs(a[k*n + k]);
+		for (int i = k + 1; i < n; ++i)
+		{
+			if (fabs(a[i*n + k]) > amax) { amax = fabs(a[i*n + k]); p = i; }
+		}
+		if (amax == 0.0) return false;
+
+		if (p != k)
+		{
+			for (int j = 0; j < n; ++j)
+			{
+				double t = a[k*n + j]; a[k*n + j] = a[p*n + j]; a[p*n + j] = t;
+				t = ai[k*n + j]; ai[k*n + j] = ai[p*n + j]; ai[p*n + j] = t;
+			}
+		}
+
+		double f = 1.0 / a[k*n + k];
+		for (int j = 0; j < n; ++j) { a[k*n + j] *= f; ai[k*n + j] *= f; }
+
+		for (int i = 0; i < n; ++i)
+		{
+			if (i == k) continue;
+			double g = a[i*n + k];
+			if (g == 0.0) continue;
+			for (int j = 0; j < n; ++j)
+			{
+				a[i*n + j] -= g*a[k*n + j];
+				ai[i*n + j] -= g*ai[k*n + j];
+			}
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool EBEBlockJacobi::Factor()
+{
+	m_A = dynamic_cast<EBEMatrix*>(GetSparseMatrix());
+	if (m_A == nullptr) return false;
+
+	const int NB = m_A->Blocks();
+	m_offset.resize(NB + 1);
+	m_offset[0] = 0;
+	for (int n = 0; n < NB; ++n) m_offset[n + 1] = m_offset[n] + (size_t)m_A->BlockSize(n)*m_A->BlockSize(n);
+	m_Binv.assign(m_offset[NB], 0.0);
+
+	int nsingular = 0;
+#pragma omp parallel reduction(+:nsingular)
+	{
+		vector<double> a;
+
+#pragma omp for schedule(dynamic, 256)
+		for (int n = 0; n < NB; ++n)
+		{
+			const int bs = m_A->BlockSize(n);
+			const double* b = m_A->BlockValues(n);
+			double* bi = &m_Binv[m_offset[n]];
+
+			bool bok = false;
+			if ((m_bdiag == false) && (bs > 1))
+			{
+				a.assign(b, b + bs*bs);
+				bok = invert_block(bs, &a[0], bi);
+				if (bok == false) nsingular++;
+			}
+
+			// use the diagonal when the block is singular
+			if (bok == false)
+			{
+				for (int i = 0; i < bs*bs; ++i) bi[i] = 0.0;
+				for (int i = 0; i < bs; ++i)
+				{
+					double dii = b[i*bs + i];
+					bi[i*bs + i] = (dii != 0.0 ? 1.0 / dii : 1.0);
+				}
+			}
+		}
+	}
+
+	if (nsingular > 0) feLogWarning("%d singular diagonal blocks were replaced by their diagonal.", nsingular);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool EBEBlockJacobi::BackSolve(double* x, double* y)
+{
+	if (m_A == nullptr) return false;
+
+	const int NB = m_A->Blocks();
+#pragma omp parallel for schedule(dynamic, 256)
+	for (int n = 0; n < NB; ++n)
+	{
+		const int bs = m_A->BlockSize(n);
+		const int* eq = m_A->BlockEquations(n);
+		const double* bi = &m_Binv[m_offset[n]];
+		for (int i = 0; i < bs; ++i)
+		{
+			double s = 0.0;
+			for (int j = 0; j < bs; ++j) s += bi[i*bs + j] * y[eq[j]];
+			x[eq[i]] = s;
+		}
+	}
+
+	return true;
+}
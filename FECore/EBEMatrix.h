@@ -0,0 +1,178 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "SparseMatrix.h"
+#include "Preconditioner.h"
+
+class FENewtonSolver;
+
+//-----------------------------------------------------------------------------
+// This class represents the global stiffness matrix as a matrix-free operator.
+// The matrix is never assembled. Instead, the product with a vector is calculated
+// element by element, either by evaluating the element stiffness matrices again
+// for each product, or from element matrices that were cached when the stiffness
+// matrix was reformed. Only the diagonal blocks of the nodal degrees of freedom are
+// assembled, which are used by the block-Jacobi preconditioner.
+class FECORE_API EBEMatrix : public SparseMatrix
+{
+	enum AssemblyMode {
+		REFORM,			// the stiffness matrix is being (re)formed
+		MULTIPLY		// the element matrices are multiplied with m_x
+	};
+
+public:
+	EBEMatrix(FENewtonSolver* pns, bool bsymm, bool bcache);
+
+	//! the matrix-vector product
+	bool mult_vector(double* x, double* r) override;
+
+	//! no sparsity pattern needs to be created
+	bool IsMatrixFree() const override { return true; }
+
+public:
+	//! set all matrix elements to zero
+	void Zero() override;
+
+	//! Create the matrix. Only the size of the profile is used.
+	void Create(SparseMatrixProfile& MP) override;
+
+	//! assemble a matrix into the sparse matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lm) override;
+
+	//! assemble a matrix into the sparse matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj) override;
+
+	//! check if an entry was allocated
+	bool check(int i, int j) override { return true; }
+
+	//! set entry to value (only diagonal entries can be set, off-diagonal entries are added)
+	void set(int i, int j, double v) override;
+
+	//! add value to entry
+	void add(int i, int j, double v) override;
+
+	//! retrieve value (only entries of the diagonal blocks are available)
+	double get(int i, int j) override;
+
+	//! get the diagonal value
+	double diag(int i) override;
+
+	//! release memory for storing data
+	void Clear() override;
+
+public:
+	//! number of diagonal blocks
+	int Blocks() const { return (int)m_bsize.size(); }
+
+	//! size of a diagonal block
+	int BlockSize(int n) const { return m_bsize[n]; }
+
+	//! equations of a diagonal block
+	const int* BlockEquations(int n) const { return &m_beq[m_beqOffset[n]]; }
+
+	//! values of a diagonal block (stored row-wise)
+	double* BlockValues(int n) { return &m_bval[m_bvalOffset[n]]; }
+
+	//! the number of cached element matrices
+	int CachedElements() const { return (int)m_elem.size(); }
+
+private:
+	void BuildBlocks(int neq);
+	void AddEntry(int I, int J, double v);
+	void AddToBlock(int I, int J, double v);
+
+private:
+	// An element matrix that was cached during reformation
+	struct ELEMENT
+	{
+		int		nr, nc;		// nr of rows and columns
+		size_t	lm;			// offset into m_lm (row indices, followed by column indices)
+		size_t	ke;			// offset into m_ke
+	};
+
+	// An entry that was added with add()
+	struct ENTRY
+	{
+		int		i, j;
+		double	v;
+	};
+
+private:
+	FENewtonSolver*	m_pns;
+	bool			m_bsymm;	// symmetric matrix (only the upper triangular part is used)
+	bool			m_bcache;	// cache the element matrices
+	AssemblyMode	m_mode;
+
+	// the diagonal blocks
+	vector<int>		m_eqBlock;		// block index of each equation
+	vector<int>		m_eqIndex;		// local index of each equation in its block
+	vector<int>		m_bsize;		// block sizes
+	vector<int>		m_beqOffset;	// offset of block equations
+	vector<size_t>	m_bvalOffset;	// offset of block values
+	vector<int>		m_beq;			// equations of all blocks
+	vector<double>	m_bval;			// values of all blocks
+
+	// diagonal entries that were set
+	vector<char>	m_bset;
+	vector<double>	m_vset;
+
+	// cached element matrices and entries
+	vector<ELEMENT>	m_elem;
+	vector<int>		m_lm;
+	vector<double>	m_ke;
+	vector<ENTRY>	m_entry;
+
+	// vectors of the current product
+	const double*	m_x;
+	double*			m_y;
+};
+
+//-----------------------------------------------------------------------------
+// Block-Jacobi preconditioner for the EBEMatrix, based on the diagonal blocks
+// of the nodal degrees of freedom.
+class FECORE_API EBEBlockJacobi : public Preconditioner
+{
+public:
+	EBEBlockJacobi(FEModel* fem);
+
+	// only use the diagonal instead of the diagonal blocks
+	void SetDiagonalOnly(bool b) { m_bdiag = b; }
+
+	// invert the diagonal blocks
+	bool Factor() override;
+
+	// apply to vector P x = y
+	bool BackSolve(double* x, double* y) override;
+
+private:
+	bool			m_bdiag;
+	EBEMatrix*		m_A;
+	vector<size_t>	m_offset;	// offsets of the blocks in m_Binv
+	vector<double>	m_Binv;		// the inverted diagonal blocks
+};
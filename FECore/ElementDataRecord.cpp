@@ -88,6 +88,22 @@ double ElementDataRecord::Evaluate(int item, int ndata)
 	else return 0.0;
 }
 
+//-----------------------------------------------------------------------------
+// The elements are evaluated in parallel.
+void ElementDataRecord::EvaluateItems(std::vector<double>& data)
+{
+	// the lookup table must be built before the threads use it
+	if (m_ELT.empty()) BuildELT();
+
+	const int N = (int)m_item.size();
+	const int nd = Size();
+	#pragma omp parallel for
+	for (int i = 0; i < N; ++i)
+	{
+		for (int j = 0; j < nd; ++j) data[j*N + i] = Evaluate(m_item[i], j);
+	}
+}
+
 //-----------------------------------------------------------------------------
 void ElementDataRecord::BuildELT()
 {
@@ -64,6 +64,7 @@ public:
 
 protected:
 	void BuildELT();
+	void EvaluateItems(std::vector<double>& data) override;
 
 protected:
 	vector<ELEMREF>	m_ELT;
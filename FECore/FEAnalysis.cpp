@@ -500,6 +500,21 @@ bool FEAnalysis::Solve()
 	return bconv;
 }
 
+//-----------------------------------------------------------------------------
+void FEAnalysis::AdvanceTime(double dt)
+{
+	FEModel& fem = *GetFEModel();
+	FETimeInfo& tp = fem.GetTime();
+
+	// don't go past the end of the step
+	double t = tp.currentTime + dt;
+	if (t > m_tend) t = m_tend;
+	tp.currentTime = t;
+
+	// the time controller has to adjust the next time step for the new time
+	if (m_timeController) m_timeController->TimeAdvanced();
+}
+
 //-----------------------------------------------------------------------------
 // This function calls the FE Solver for solving this analysis and also handles
 // all the exceptions. 
@@ -530,6 +545,7 @@ int FEAnalysis::SolveTimeStep()
 				{
 					fem.GetTime().augmentation = niter;
 					feLog("\n=== Applying mesh adaptors: iteration %d\n", niter + 1);
+					bool incremental = true;
 					for (int i = 0; i < fem.MeshAdaptors(); ++i)
 					{
 						FEMeshAdaptor* meshAdaptor = fem.MeshAdaptor(i);
@@ -541,6 +557,8 @@ int FEAnalysis::SolveTimeStep()
 							// It will return true if the mesh was modified. 
 							bool meshModified = meshAdaptor->Apply(niter);
 
+							if (meshModified && (meshAdaptor->IsIncrementalUpdate() == false)) incremental = false;
+
 							bconv = ((meshModified == false) && bconv);
 							feLog("\n");
 						}
@@ -549,12 +567,21 @@ int FEAnalysis::SolveTimeStep()
 
 					if (bconv == false)
 					{
-						// we need to clear the FE solver and then reinitialize it again
+						// If all adaptors only deactivated parts of the mesh, the solver can
+						// try to keep its equations and matrix structure and just mask out
+						// the inactive equations. Otherwise, we need to clear the FE solver
+						// and then reinitialize it again.
 						FESolver* solver = GetFESolver();
-						solver->Clean();
+						if ((incremental == false) || (solver->MaskInactiveEquations() == false))
+						{
+							// the incremental update skipped the model reactivation
+							if (incremental) fem.Reactivate();
 
-						// reinitialize it
-						InitSolver();
+							solver->Clean();
+
+							// reinitialize it
+							InitSolver();
+						}
 
 						// inform listeners that the mesh was remeshed
 						fem.DoCallback(CB_REMESH);
@@ -67,6 +67,11 @@ public:
 	//! Solve the analysis step
 	virtual bool Solve();
 
+	//! Advance the time without solving. This is meant for components that extrapolate 
+	//! the model state over a time interval (e.g. cycle jumping in fatigue analyses).
+	//! It should only be called in between time steps, i.e. from a CB_UPDATE_TIME callback.
+	void AdvanceTime(double dt);
+
 	//! wrap it up
 	virtual void Deactivate();
 
@@ -48,6 +48,7 @@ SOFTWARE.*/
 #include "BFGSSolver.h"
 #include "FEBroydenStrategy.h"
 #include "JFNKStrategy.h"
+#include "MFNKStrategy.h"
 #include "FENodeSet.h"
 #include "FEFacetSet.h"
 #include "FEElementSet.h"
@@ -148,6 +149,7 @@ REGISTER_FECORE_CLASS(FEPIDController , "PID");
 REGISTER_FECORE_CLASS(BFGSSolver       , "BFGS");
 REGISTER_FECORE_CLASS(FEBroydenStrategy, "Broyden");
 REGISTER_FECORE_CLASS(JFNKStrategy     , "JFNK");
+REGISTER_FECORE_CLASS(MFNKStrategy     , "MFNK");
 
 // preconditioners
 REGISTER_FECORE_CLASS(DiagonalPreconditioner, "diagonal");
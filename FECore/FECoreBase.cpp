@@ -33,6 +33,8 @@ SOFTWARE.*/
 #include "FEModelParam.h"
 #include "log.h"
 #include <sstream>
+#include <string.h>
+#include <ctype.h>
 
 //-----------------------------------------------------------------------------
 //! The constructor takes one argument, namely the SUPER_CLASS_ID which
@@ -119,18 +121,36 @@ FEModel* FECoreBase::GetFEModel() const { return m_fem; }
 void FECoreBase::SetFEModel(FEModel* fem) { m_fem = fem; }
 
 //-----------------------------------------------------------------------------
-void setParamValue(FEParam& pi, const std::string& val)
+// Sets a parameter from a string. Returns false if the string is not a valid value,
+// e.g. when it is not one of the options of an enum parameter.
+static bool setParamValue(FEParam& pi, const std::string& val)
 {
-	if (val.empty()) return;
 	const char* sz = val.c_str();
+	while (isspace((unsigned char)*sz)) ++sz;
+	if (*sz == 0) return true;
 	switch (pi.type())
 	{
-	case FE_PARAM_INT: pi.value<int>() = atoi(sz); break;
+	case FE_PARAM_INT:
+	{
+		// enum parameters can be set by name as well
+		const char* szenum = pi.enums();
+		if (szenum && (szenum[0] != '@') && (isdigit((unsigned char)sz[0]) == 0) && (sz[0] != '-'))
+		{
+			for (int n = 0; *szenum; ++n, szenum += strlen(szenum) + 1)
+			{
+				if (strcmp(szenum, sz) == 0) { pi.value<int>() = n; return true; }
+			}
+			return false;
+		}
+		else pi.value<int>() = atoi(sz);
+	}
+	break;
 	case FE_PARAM_BOOL: pi.value<bool>() = (atoi(sz) == 0 ? false : true); break;
 	case FE_PARAM_DOUBLE: pi.value<double>() = atof(sz); break;
 	default:
 		assert(false);
 	}
+	return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -160,7 +180,12 @@ bool FECoreBase::SetParameters(const ClassDescriptor::ClassVariable& cv)
 			if (vi == nullptr) return false;
 
 			// set the value
-			setParamValue(*pi, vi->m_val);
+			if (setParamValue(*pi, vi->m_val) == false)
+			{
+				FEModel* fem = GetFEModel();
+				if (fem) feLogErrorEx(fem, "Invalid value \"%s\" for parameter %s of %s.", vi->m_val.c_str(), vari->m_name.c_str(), GetTypeStr());
+				return false;
+			}
 		}
 		else
 		{
@@ -180,7 +205,7 @@ bool FECoreBase::SetParameters(const ClassDescriptor::ClassVariable& cv)
 			prop->SetProperty(pc);
 
 			// set the property's parameters
-			pc->SetParameters(*ci);
+			if (pc->SetParameters(*ci) == false) return false;
 		}
 	}
 
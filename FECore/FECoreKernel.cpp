@@ -327,7 +327,7 @@ void* FECoreKernel::Create(int superClassID, FEModel* pfem, const ClassDescripto
 	const ClassDescriptor::ClassVariable* root = cd.Root();
 	FECoreBase* pc = (FECoreBase*)Create(superClassID, root->m_type.c_str(), pfem);
 	if (pc == nullptr) return nullptr;
-	pc->SetParameters(cd);
+	if (pc->SetParameters(cd) == false) { delete pc; return nullptr; }
 	return pc;
 }
 
@@ -54,7 +54,6 @@ void FEElemElemList::Init()
 
 	// count nr of neighbors
 	int NN = 0, n = 0, nf;
-	m_ref[0] = 0;
 	for (int i=0; i<m.Domains(); ++i)
 	{
 		FEDomain& dom = m.Domain(i);
@@ -62,7 +61,7 @@ void FEElemElemList::Init()
 		{
 			FEElement& el = dom.ElementRef(j);
 			nf = el.Faces();
-			if (n != 0) m_ref[n] = m_ref[n-1] + nf;
+			m_ref[n] = NN;
 			NN += nf;
 		}
 	}
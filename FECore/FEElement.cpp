@@ -52,6 +52,14 @@ FEElementState& FEElementState::operator = (const FEElementState& s)
 	return (*this);
 }
 
+//-----------------------------------------------------------------------------
+void FEElement::SwapMaterialPointData(FEElement& el)
+{
+	m_State.Swap(el.m_State);
+	for (int i = 0; i < m_State.Size(); ++i) if (m_State[i]) m_State[i]->m_elem = this;
+	for (int i = 0; i < el.m_State.Size(); ++i) if (el.m_State[i]) el.m_State[i]->m_elem = &el;
+}
+
 //-----------------------------------------------------------------------------
 //! clear material point data
 void FEElement::ClearData()
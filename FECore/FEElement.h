@@ -59,6 +59,12 @@ public:
 	//! create 
 	void Create(int n) { m_data.assign(n, static_cast<FEMaterialPoint*>(0) ); }
 
+	//! exchange the state data with another state (no data is copied)
+	void Swap(FEElementState& s) { m_data.swap(s.m_data); }
+
+	//! number of material points
+	int Size() const { return (int)m_data.size(); }
+
 	//! operator for easy access to element data
 	FEMaterialPoint*& operator [] (int n) { return m_data[n]; }
 
@@ -163,6 +169,10 @@ public:
 		m_State[n] = pmp; 
 	}
 
+	//! exchange the material point data with another element
+	//! This moves the material points without copying them.
+	void SwapMaterialPointData(FEElement& el);
+
 	//! serialize
 	//! NOTE: state data is not serialized by the element. This has to be done by the domains.
 	virtual void Serialize(DumpStream& ar);
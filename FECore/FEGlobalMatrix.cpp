@@ -182,6 +182,15 @@ bool FEGlobalMatrix::Create(FEModel* pfem, int neq, bool breset)
 	// reconstructing it every time we come here saves us a lot of time. The 
 	// static profile is stored in the variable m_MPs.
 
+	// matrix-free operators only need to know the number of equations
+	// (no columns are allocated for the profile, so only the number of rows is set)
+	if (m_pA->IsMatrixFree())
+	{
+		SparseMatrixProfile MP(neq, 0);
+		m_pA->Create(MP);
+		return true;
+	}
+
 	// begin building the profile
 	build_begin(neq);
 	{
@@ -30,37 +30,177 @@ SOFTWARE.*/
 #include "FEGlobalVector.h"
 #include "vec3d.h"
 #include "FEModel.h"
+#include "FEAnalysis.h"
+#include "FESolver.h"
+#include "sys.h"
+#include <algorithm>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+//-----------------------------------------------------------------------------
+FEAssemblyBuffer::FEAssemblyBuffer()
+{
+	m_owner = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// The number of bins only determines how the reduction is distributed over the
+// threads. It does not affect the result.
+void FEAssemblyBuffer::Prepare()
+{
+	int nt = omp_get_max_threads();
+	if ((int)m_log.size() < nt) m_log.resize(nt);
+
+	size_t nbins = 4 * m_log.size();
+	if (m_tmp.size() != nbins)
+	{
+		m_tmp.resize(nbins);
+		for (Log& log : m_log) { log.m_bin.clear(); log.m_bin.resize(nbins); }
+	}
+}
+
+//-----------------------------------------------------------------------------
+FEAssemblyBuffer::Log& FEAssemblyBuffer::ThreadLog()
+{
+	int n = omp_get_thread_num();
+	assert(n < (int)m_log.size());
+	return m_log[n];
+}
+
+//-----------------------------------------------------------------------------
+// Orders the entries by target first and then by the bit pattern of the value. 
+// The latter is a total order (also for NaNs), so the sorted sequence of a target's
+// contributions only depends on their values.
+static bool entry_less(const FEAssemblyBuffer::Entry& a, const FEAssemblyBuffer::Entry& b)
+{
+	if (a.p != b.p) return (a.p < b.p);
+	int64_t ia, ib;
+	memcpy(&ia, &a.v, sizeof(double));
+	memcpy(&ib, &b.v, sizeof(double));
+	return (ia < ib);
+}
+
+//-----------------------------------------------------------------------------
+// A target only appears in one bin, so the bins can be reduced in parallel.
+void FEAssemblyBuffer::Reduce()
+{
+	const int nbins = (int)m_tmp.size();
+#pragma omp parallel for schedule(dynamic)
+	for (int b = 0; b < nbins; ++b)
+	{
+		// merge the thread logs of this bin
+		vector<Entry>& all = m_tmp[b];
+		for (Log& log : m_log)
+		{
+			vector<Entry>& bin = log.m_bin[b];
+			all.insert(all.end(), bin.begin(), bin.end());
+			bin.clear();
+		}
+		if (all.empty()) continue;
+
+		// add the contributions of each target in sorted order
+		std::sort(all.begin(), all.end(), entry_less);
+		const size_t N = all.size();
+		for (size_t i = 0; i < N;)
+		{
+			double* p = all[i].p;
+			double s = *p;
+			for (; (i < N) && (all[i].p == p); ++i) s += all[i].v;
+			*p = s;
+		}
+		all.clear();
+	}
+}
 
 //-----------------------------------------------------------------------------
 FEGlobalVector::FEGlobalVector(FEModel& fem, vector<double>& R, vector<double>& Fr) : m_fem(fem), m_R(R), m_Fr(Fr)
 {
+	m_mode = FE_ASSEMBLE_ATOMIC;
+	m_buf = nullptr;
+	m_ownBuf = false;
+
+	// use the assembly mode of the active solver
+	FEAnalysis* step = fem.GetCurrentStep();
+	FESolver* solver = (step ? step->GetFESolver() : nullptr);
+	if (solver) SetAssemblyMode(solver->m_assemblyMode);
 }
 
 //-----------------------------------------------------------------------------
 FEGlobalVector::~FEGlobalVector()
 {
+	Reduce();
+	Detach();
+}
 
+//-----------------------------------------------------------------------------
+void FEGlobalVector::SetAssemblyMode(int mode)
+{
+	Reduce();
+	Detach();
+	m_mode = mode;
+	if (m_mode == FE_ASSEMBLE_REDUCE) Attach();
+}
+
+//-----------------------------------------------------------------------------
+// Use the solver's assembly buffer. If another global vector is using it already,
+// this vector allocates its own.
+void FEGlobalVector::Attach()
+{
+	FEAnalysis* step = m_fem.GetCurrentStep();
+	FESolver* solver = (step ? step->GetFESolver() : nullptr);
+	if (solver && (solver->GetAssemblyBuffer().m_owner == nullptr))
+	{
+		m_buf = &solver->GetAssemblyBuffer();
+		m_ownBuf = false;
+	}
+	else
+	{
+		m_buf = new FEAssemblyBuffer;
+		m_ownBuf = true;
+	}
+	m_buf->m_owner = this;
+	m_buf->Prepare();
+}
+
+//-----------------------------------------------------------------------------
+void FEGlobalVector::Detach()
+{
+	if (m_buf == nullptr) return;
+	m_buf->m_owner = nullptr;
+	if (m_ownBuf) delete m_buf;
+	m_buf = nullptr;
+	m_ownBuf = false;
+}
+
+//-----------------------------------------------------------------------------
+// NOTE: Contributions made outside parallel regions are recorded as well. Otherwise
+// the summation order would depend on whether a loop actually ran in parallel. 
+FEAssemblyBuffer::Log* FEGlobalVector::ThreadLog()
+{
+	return (m_buf ? &m_buf->ThreadLog() : nullptr);
+}
+
+//-----------------------------------------------------------------------------
+void FEGlobalVector::Reduce()
+{
+	if (m_buf) m_buf->Reduce();
 }
 
 //-----------------------------------------------------------------------------
 void FEGlobalVector::Assemble(vector<int>& en, vector<int>& elm, vector<double>& fe, bool bdom)
 {
 	vector<double>& R = m_R;
+	FEAssemblyBuffer::Log* log = ThreadLog();
 
 	// assemble the element residual into the global residual
 	int ndof = (int)fe.size();
 	for (int i=0; i<ndof; ++i)
 	{
 		int I = elm[i];
-		if ( I >= 0) {
-#pragma omp atomic
-			R[I] += fe[i];
-		}
+		if ( I >= 0) AddTo(log, R[I], fe[i]);
 // TODO: Find another way to store reaction forces
-		else if (-I-2 >= 0) {
-#pragma omp atomic
-			m_Fr[-I-2] -= fe[i];
-		}
+		else if (-I-2 >= 0) AddTo(log, m_Fr[-I-2], -fe[i]);
 	}
 }
 
@@ -69,14 +209,12 @@ void FEGlobalVector::Assemble(vector<int>& en, vector<int>& elm, vector<double>&
 void FEGlobalVector::Assemble(vector<int>& lm, vector<double>& fe)
 {
 	vector<double>& R = m_R;
+	FEAssemblyBuffer::Log* log = ThreadLog();
 	const int n = (int) lm.size();
 	for (int i=0; i<n; ++i)
 	{
 		int nid = lm[i];
-		if (nid >= 0) {
-#pragma omp atomic
-			R[nid] += fe[i];
-		}
+		if (nid >= 0) AddTo(log, R[nid], fe[i]);
 	}
 }
 
@@ -89,8 +227,5 @@ void FEGlobalVector::Assemble(int nodeId, int dof, double f)
 	int n = node.m_ID[dof];
 
 	// assemble into global vector
-	if (n >= 0) {
-#pragma omp atomic
-		m_R[n] += f;
-	}
+	if (n >= 0) Add(n, f);
 }
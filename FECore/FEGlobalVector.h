@@ -33,9 +33,75 @@ using namespace std;
 
 class FEModel;
 
+//-----------------------------------------------------------------------------
+//! Assembly modes for global vectors
+enum FEAssemblyMode
+{
+	FE_ASSEMBLE_ATOMIC,		//!< assemble directly into the global vector using atomic updates
+	FE_ASSEMBLE_REDUCE		//!< record contributions per thread and add them in a canonical order
+};
+
+//-----------------------------------------------------------------------------
+//! Buffer for the FE_ASSEMBLE_REDUCE assembly mode. Each thread records the 
+//! contributions it makes as (target, value) pairs, binned by blocks of consecutive
+//! targets. When the buffer is reduced, each bin is processed by one thread: its 
+//! contributions are sorted by target and value, so that every target receives its 
+//! contributions in the same order, regardless of how many threads produced them and 
+//! how the work was scheduled. The solver owns this buffer so that the memory is
+//! reused between residual evaluations.
+class FECORE_API FEAssemblyBuffer
+{
+public:
+	struct Entry
+	{
+		double*	p;	//!< target
+		double	v;	//!< contribution
+	};
+
+	//! contributions recorded by one thread
+	class Log
+	{
+	public:
+		void Add(double* p, double v) { m_bin[Bin(p)].push_back({ p, v }); }
+
+	private:
+		// bins are assigned round-robin to blocks of 256 consecutive doubles
+		size_t Bin(const double* p) const { return ((size_t)p >> 11) % m_bin.size(); }
+
+	private:
+		vector< vector<Entry> >	m_bin;
+
+		friend class FEAssemblyBuffer;
+	};
+
+public:
+	FEAssemblyBuffer();
+
+	//! make sure there is a log for every thread (call outside parallel regions)
+	void Prepare();
+
+	//! the calling thread's log
+	Log& ThreadLog();
+
+	//! add all recorded contributions to their targets
+	void Reduce();
+
+public:
+	void*	m_owner;	//!< global vector that currently uses this buffer
+
+private:
+	vector<Log>				m_log;	//!< contributions per thread
+	vector< vector<Entry> >	m_tmp;	//!< merged contributions per bin (only used in Reduce)
+};
+
 //-----------------------------------------------------------------------------
 //! This class represents a global system array. It provides functions to assemble
 //! local (element) vectors into this array
+//! In the FE_ASSEMBLE_REDUCE mode, all contributions are recorded in an 
+//! FEAssemblyBuffer (see above). These are added to the global 
+//! vector when Reduce is called, which happens at the latest when this object is 
+//! destroyed. This avoids atomic updates and makes the result independent of the 
+//! number of threads.
 class FECORE_API FEGlobalVector
 {
 public:
@@ -45,6 +111,16 @@ public:
 	//! destructor
 	virtual ~FEGlobalVector();
 
+	//! set the assembly mode (see FEAssemblyMode)
+	void SetAssemblyMode(int mode);
+
+	//! get the assembly mode
+	int AssemblyMode() const { return m_mode; }
+
+	//! add the recorded contributions to the global vector.
+	//! This must be called before the global vector is read directly.
+	void Reduce();
+
 	//! Assemble the element vector into this global vector
 	virtual void Assemble(vector<int>& en, vector<int>& elm, vector<double>& fe, bool bdom = false);
 
@@ -53,6 +129,9 @@ public:
 
 	//! assemble a nodel value
 	virtual void Assemble(int node, int dof, double f);
+
+	//! add a value to an equation (thread-safe)
+	void Add(int n, double v) { AddTo(ThreadLog(), m_R[n], v); }
     
 	//! access operator
 	double& operator [] (int i) { return m_R[i]; }
@@ -65,8 +144,32 @@ public:
 
 	operator vector<double>& () { return m_R; }
 
+protected:
+	//! The log the calling thread records its contributions in, or null
+	//! if contributions should be added directly.
+	FEAssemblyBuffer::Log* ThreadLog();
+
+	//! add a value to a target (either recorded in the log or added atomically)
+	static void AddTo(FEAssemblyBuffer::Log* log, double& d, double v)
+	{
+		if (log) log->Add(&d, v);
+		else
+		{
+#pragma omp atomic
+			d += v;
+		}
+	}
+
+private:
+	void Attach();
+	void Detach();
+
 protected:
 	FEModel&			m_fem;	//!< model
 	vector<double>&		m_R;	//!< residual
 	vector<double>&		m_Fr;	//!< nodal reaction forces \todo I want to remove this
+
+	int					m_mode;		//!< assembly mode
+	FEAssemblyBuffer*	m_buf;		//!< assembly buffer (FE_ASSEMBLE_REDUCE mode only)
+	bool				m_ownBuf;	//!< the buffer was allocated by this vector
 };
@@ -0,0 +1,528 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEGraphPartitioner.h"
+#include "FENodeNodeList.h"
+#include "FEElemElemList.h"
+#include "FEMesh.h"
+#include <set>
+#include <deque>
+#include <algorithm>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// extract the subgraph of g that is induced by the vertices in sel
+static void ExtractSubgraph(const FEGraphPartitioner::Graph& g, const vector<int>& sel, FEGraphPartitioner::Graph& s)
+{
+	vector<int> lid(g.n, -1);
+	for (int i = 0; i < (int)sel.size(); ++i) lid[sel[i]] = i;
+
+	s.n = (int)sel.size();
+	s.xadj.assign(s.n + 1, 0);
+	s.vw.resize(s.n);
+	s.adj.clear();
+	s.adjw.clear();
+	for (int i = 0; i < s.n; ++i)
+	{
+		int v = sel[i];
+		s.vw[i] = g.vw[v];
+		for (int j = g.xadj[v]; j < g.xadj[v + 1]; ++j)
+		{
+			int u = lid[g.adj[j]];
+			if (u >= 0)
+			{
+				s.adj.push_back(u);
+				s.adjw.push_back(g.adjw[j]);
+			}
+		}
+		s.xadj[i + 1] = (int)s.adj.size();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// returns by how much the part weights exceed the allowed maximum
+static int Overweight(const int w[2], const int maxw[2])
+{
+	return max(w[0] - maxw[0], 0) + max(w[1] - maxw[1], 0);
+}
+
+//-----------------------------------------------------------------------------
+FEGraphPartitioner::FEGraphPartitioner()
+{
+	m_coarsenTo = 100;
+	m_ntries = 4;
+	m_fmPasses = 8;
+	m_imbalance = 0.03;
+	m_leafSize = 64;
+	m_seed = 1;
+}
+
+//-----------------------------------------------------------------------------
+// simple linear congruential generator, so that the partitions are reproducible
+unsigned int FEGraphPartitioner::Random()
+{
+	m_seed = m_seed * 1103515245u + 12345u;
+	return (m_seed >> 8);
+}
+
+//-----------------------------------------------------------------------------
+void FEGraphPartitioner::SetGraph(FENodeNodeList& NNL)
+{
+	int N = NNL.Size();
+	m_G.n = N;
+	m_G.xadj.assign(N + 1, 0);
+	for (int i = 0; i < N; ++i) m_G.xadj[i + 1] = m_G.xadj[i] + NNL.Valence(i);
+
+	m_G.adj.resize(m_G.xadj[N]);
+	for (int i = 0; i < N; ++i)
+	{
+		int* pn = NNL.NodeList(i);
+		for (int j = 0; j < NNL.Valence(i); ++j) m_G.adj[m_G.xadj[i] + j] = pn[j];
+	}
+	m_G.adjw.assign(m_G.adj.size(), 1);
+	m_G.vw.assign(N, 1);
+}
+
+//-----------------------------------------------------------------------------
+void FEGraphPartitioner::SetGraph(FEMesh& mesh, FEElemElemList& EEL)
+{
+	int NE = mesh.Elements();
+	m_G.n = NE;
+	m_G.xadj.assign(NE + 1, 0);
+	m_G.adj.clear();
+	for (int i = 0; i < NE; ++i)
+	{
+		int nf = mesh.Element(i)->Faces();
+		for (int j = 0; j < nf; ++j)
+		{
+			int nj = EEL.NeighborIndex(i, j);
+			if (nj >= 0) m_G.adj.push_back(nj);
+		}
+		m_G.xadj[i + 1] = (int)m_G.adj.size();
+	}
+	m_G.adjw.assign(m_G.adj.size(), 1);
+	m_G.vw.assign(NE, 1);
+}
+
+//-----------------------------------------------------------------------------
+int FEGraphPartitioner::EdgeCut(const vector<int>& part) const
+{
+	int cut = 0;
+	for (int v = 0; v < m_G.n; ++v)
+		for (int j = m_G.xadj[v]; j < m_G.xadj[v + 1]; ++j)
+			if (part[v] != part[m_G.adj[j]]) cut += m_G.adjw[j];
+	return cut / 2;
+}
+
+//-----------------------------------------------------------------------------
+bool FEGraphPartitioner::Partition(int nparts, vector<int>& part)
+{
+	if ((nparts < 1) || (nparts > m_G.n)) return false;
+	part.assign(m_G.n, 0);
+	if (nparts == 1) return true;
+
+	vector<int> vid(m_G.n);
+	for (int i = 0; i < m_G.n; ++i) vid[i] = i;
+	RecursiveBisection(m_G, vid, nparts, 0, part);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FEGraphPartitioner::RecursiveBisection(const Graph& g, const vector<int>& vid, int nparts, int part0, vector<int>& part)
+{
+	if ((nparts == 1) || (g.n == 0))
+	{
+		for (int i = 0; i < g.n; ++i) part[vid[i]] = part0;
+		return;
+	}
+
+	int n0 = nparts / 2;
+	vector<int> p;
+	Bisect(g, (double)n0 / (double)nparts, p);
+
+	for (int s = 0; s < 2; ++s)
+	{
+		vector<int> sel, sid;
+		for (int i = 0; i < g.n; ++i) if (p[i] == s) { sel.push_back(i); sid.push_back(vid[i]); }
+
+		Graph sg;
+		ExtractSubgraph(g, sel, sg);
+		if (s == 0) RecursiveBisection(sg, sid, n0, part0, part);
+		else RecursiveBisection(sg, sid, nparts - n0, part0 + n0, part);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEGraphPartitioner::NestedDissection(vector<int>& P)
+{
+	P.clear();
+	P.reserve(m_G.n);
+
+	vector<int> vid(m_G.n);
+	for (int i = 0; i < m_G.n; ++i) vid[i] = i;
+	Dissect(m_G, vid, P);
+}
+
+//-----------------------------------------------------------------------------
+// Orders the two halves of a bisection first, followed by the separator, 
+// so that the separator equations are eliminated last.
+void FEGraphPartitioner::Dissect(const Graph& g, const vector<int>& vid, vector<int>& P)
+{
+	if (g.n <= m_leafSize)
+	{
+		for (int i = 0; i < g.n; ++i) P.push_back(vid[i]);
+		return;
+	}
+
+	vector<int> part;
+	Bisect(g, 0.5, part);
+
+	// Turn the edge separator into a vertex separator by moving the 
+	// boundary vertices of the side with the smallest boundary to the separator.
+	vector<char> bnd(g.n, 0);
+	int nb[2] = { 0, 0 };
+	for (int v = 0; v < g.n; ++v)
+	{
+		for (int j = g.xadj[v]; j < g.xadj[v + 1]; ++j)
+			if (part[g.adj[j]] != part[v]) { bnd[v] = 1; nb[part[v]]++; break; }
+	}
+	int s = (nb[0] <= nb[1] ? 0 : 1);
+	for (int v = 0; v < g.n; ++v) if (bnd[v] && (part[v] == s)) part[v] = 2;
+
+	vector<int> sel[3], sid[3];
+	for (int v = 0; v < g.n; ++v) { sel[part[v]].push_back(v); sid[part[v]].push_back(vid[v]); }
+
+	// make sure we made progress
+	if (sel[0].empty() || sel[1].empty())
+	{
+		for (int i = 0; i < g.n; ++i) P.push_back(vid[i]);
+		return;
+	}
+
+	for (int k = 0; k < 2; ++k)
+	{
+		Graph sg;
+		ExtractSubgraph(g, sel[k], sg);
+		Dissect(sg, sid[k], P);
+	}
+	P.insert(P.end(), sid[2].begin(), sid[2].end());
+}
+
+//-----------------------------------------------------------------------------
+// Bisects the graph so that part 0 gets (about) a fraction f0 of the weight.
+void FEGraphPartitioner::Bisect(const Graph& g, double f0, vector<int>& part)
+{
+	part.assign(g.n, 0);
+	if (g.n < 2) return;
+
+	// target weights
+	int W = 0;
+	for (int i = 0; i < g.n; ++i) W += g.vw[i];
+	int tw0 = (int)(f0*W + 0.5);
+	int tw1 = W - tw0;
+	int maxw[2];
+	maxw[0] = tw0 + max(1, (int)(m_imbalance*tw0));
+	maxw[1] = tw1 + max(1, (int)(m_imbalance*tw1));
+
+	// coarsening phase
+	deque<Graph> coarse;
+	deque< vector<int> > cmap;
+	const Graph* pg = &g;
+	while (pg->n > m_coarsenTo)
+	{
+		coarse.push_back(Graph());
+		cmap.push_back(vector<int>());
+		Coarsen(*pg, coarse.back(), cmap.back());
+
+		// stop when the matching no longer reduces the graph
+		if (coarse.back().n > 0.95*pg->n)
+		{
+			coarse.pop_back();
+			cmap.pop_back();
+			break;
+		}
+		pg = &coarse.back();
+	}
+
+	// initial bisection of the coarsest graph
+	const Graph& gc = *pg;
+	vector<int> p, pbest;
+	int bestCut = 0, bestOver = 0;
+	for (int i = 0; i < m_ntries; ++i)
+	{
+		int seed = (int)(Random() % gc.n);
+		GrowBisection(gc, seed, tw0, maxw[0], p);
+		int cut = Refine(gc, maxw, p);
+
+		int w[2] = { 0, 0 };
+		for (int v = 0; v < gc.n; ++v) w[p[v]] += gc.vw[v];
+		int over = Overweight(w, maxw);
+		if (pbest.empty() || (over < bestOver) || ((over == bestOver) && (cut < bestCut)))
+		{
+			pbest = p;
+			bestCut = cut;
+			bestOver = over;
+		}
+	}
+
+	// uncoarsening phase
+	for (int l = (int)cmap.size() - 1; l >= 0; --l)
+	{
+		const Graph& fine = (l == 0 ? g : coarse[l - 1]);
+		const vector<int>& map = cmap[l];
+		p.resize(fine.n);
+		for (int v = 0; v < fine.n; ++v) p[v] = pbest[map[v]];
+		pbest.swap(p);
+		Refine(fine, maxw, pbest);
+	}
+
+	part.swap(pbest);
+}
+
+//-----------------------------------------------------------------------------
+// Coarsens the graph by heavy-edge matching. On return cmap maps the vertices
+// of g to the vertices of the coarse graph c.
+void FEGraphPartitioner::Coarsen(const Graph& g, Graph& c, vector<int>& cmap)
+{
+	int n = g.n;
+
+	// visit the vertices in random order
+	vector<int> perm(n);
+	for (int i = 0; i < n; ++i) perm[i] = i;
+	for (int i = n - 1; i > 0; --i) swap(perm[i], perm[Random() % (i + 1)]);
+
+	// match each vertex with the unmatched neighbor with the heaviest edge
+	vector<int> match(n, -1);
+	vector<int> cu, cv;
+	cmap.assign(n, -1);
+	for (int k = 0; k < n; ++k)
+	{
+		int u = perm[k];
+		if (match[u] != -1) continue;
+
+		int v = u, wmax = -1;
+		for (int j = g.xadj[u]; j < g.xadj[u + 1]; ++j)
+		{
+			int w = g.adj[j];
+			if ((w != u) && (match[w] == -1) && (g.adjw[j] > wmax)) { wmax = g.adjw[j]; v = w; }
+		}
+		match[u] = v;
+		match[v] = u;
+		cmap[u] = cmap[v] = (int)cu.size();
+		cu.push_back(u);
+		cv.push_back(v);
+	}
+
+	// build the coarse graph, merging the parallel edges
+	int cn = (int)cu.size();
+	c.n = cn;
+	c.vw.assign(cn, 0);
+	c.xadj.assign(cn + 1, 0);
+	c.adj.clear();
+	c.adjw.clear();
+	vector<int> pos(cn, -1);
+	for (int ci = 0; ci < cn; ++ci)
+	{
+		int start = (int)c.adj.size();
+		for (int k = 0; k < 2; ++k)
+		{
+			int u = (k == 0 ? cu[ci] : cv[ci]);
+			if ((k == 1) && (u == cu[ci])) break;
+
+			c.vw[ci] += g.vw[u];
+			for (int j = g.xadj[u]; j < g.xadj[u + 1]; ++j)
+			{
+				int cj = cmap[g.adj[j]];
+				if (cj == ci) continue;
+				if (pos[cj] >= start) c.adjw[pos[cj]] += g.adjw[j];
+				else
+				{
+					pos[cj] = (int)c.adj.size();
+					c.adj.push_back(cj);
+					c.adjw.push_back(g.adjw[j]);
+				}
+			}
+		}
+		c.xadj[ci + 1] = (int)c.adj.size();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Greedy graph growing: starting from the seed, part 0 is grown by adding the
+// vertex that increases the cut the least, until it reaches its target weight.
+int FEGraphPartitioner::GrowBisection(const Graph& g, int seed, int tw0, int maxw0, vector<int>& part)
+{
+	int n = g.n;
+	part.assign(n, 1);
+
+	// gain of moving a vertex from part 1 to part 0
+	vector<int> gain(n);
+	for (int v = 0; v < n; ++v)
+	{
+		gain[v] = 0;
+		for (int j = g.xadj[v]; j < g.xadj[v + 1]; ++j) gain[v] -= g.adjw[j];
+	}
+
+	set< pair<int, int> > front;
+	vector<char> inFront(n, 0);
+	int w0 = 0, next = 0, cut = 0;
+	while (w0 < tw0)
+	{
+		int v = -1;
+		if (!front.empty())
+		{
+			v = front.begin()->second;
+			front.erase(front.begin());
+			inFront[v] = 0;
+		}
+		else if (part[seed] == 1) v = seed;
+		else
+		{
+			// the graph is not connected, so pick any vertex
+			while ((next < n) && (part[next] == 0)) ++next;
+			if (next == n) break;
+			v = next;
+		}
+
+		// don't overshoot by too much
+		if ((w0 > 0) && (w0 + g.vw[v] > maxw0)) break;
+
+		part[v] = 0;
+		w0 += g.vw[v];
+		cut -= gain[v];
+		for (int j = g.xadj[v]; j < g.xadj[v + 1]; ++j)
+		{
+			int u = g.adj[j];
+			if (part[u] == 0) continue;
+			if (inFront[u]) front.erase(make_pair(-gain[u], u));
+			gain[u] += 2 * g.adjw[j];
+			front.insert(make_pair(-gain[u], u));
+			inFront[u] = 1;
+		}
+	}
+
+	return cut;
+}
+
+//-----------------------------------------------------------------------------
+// Fiduccia-Mattheyses refinement of a bisection. Vertices are moved one at 
+// a time (each vertex at most once per pass) in order of decreasing gain, 
+// even if this temporarily increases the cut. At the end of the pass, the
+// moves after the best partition that was seen are undone. 
+// Returns the cut of the refined partition.
+int FEGraphPartitioner::Refine(const Graph& g, const int maxw[2], vector<int>& part)
+{
+	int n = g.n;
+	vector<int> gain(n);
+	vector<char> locked(n);
+	vector<int> moves;
+	int cut = 0;
+	for (int pass = 0; pass < m_fmPasses; ++pass)
+	{
+		// calculate the gains, weights, and cut
+		int w[2] = { 0, 0 };
+		cut = 0;
+		for (int v = 0; v < n; ++v)
+		{
+			w[part[v]] += g.vw[v];
+			int ed = 0, id = 0;
+			for (int j = g.xadj[v]; j < g.xadj[v + 1]; ++j)
+			{
+				if (part[g.adj[j]] == part[v]) id += g.adjw[j]; else ed += g.adjw[j];
+			}
+			gain[v] = ed - id;
+			cut += ed;
+		}
+		cut /= 2;
+
+		set< pair<int, int> > Q[2];
+		for (int v = 0; v < n; ++v) Q[part[v]].insert(make_pair(-gain[v], v));
+		locked.assign(n, 0);
+		moves.clear();
+
+		int bestCut = cut;
+		int bestOver = Overweight(w, maxw);
+		int bestMove = 0;
+		const int limit = 100;
+		int sinceBest = 0;
+		while (sinceBest < limit)
+		{
+			// find the best move that respects the balance
+			int s = -1;
+			for (int k = 0; k < 2; ++k)
+			{
+				if (Q[k].empty()) continue;
+				int v = Q[k].begin()->second;
+				bool ok = (w[1 - k] + g.vw[v] <= maxw[1 - k]) || (w[k] > maxw[k]);
+				if (ok && ((s == -1) || (gain[v] > gain[Q[s].begin()->second]))) s = k;
+			}
+			if (s == -1) break;
+
+			// move the vertex
+			int v = Q[s].begin()->second;
+			Q[s].erase(Q[s].begin());
+			locked[v] = 1;
+			part[v] = 1 - s;
+			w[s] -= g.vw[v];
+			w[1 - s] += g.vw[v];
+			cut -= gain[v];
+			gain[v] = -gain[v];
+			moves.push_back(v);
+
+			// update the neighbors
+			for (int j = g.xadj[v]; j < g.xadj[v + 1]; ++j)
+			{
+				int u = g.adj[j];
+				if (locked[u]) continue;
+				Q[part[u]].erase(make_pair(-gain[u], u));
+				gain[u] += (part[u] == part[v] ? -2 : 2)*g.adjw[j];
+				Q[part[u]].insert(make_pair(-gain[u], u));
+			}
+
+			int over = Overweight(w, maxw);
+			if ((over < bestOver) || ((over == bestOver) && (cut < bestCut)))
+			{
+				bestCut = cut;
+				bestOver = over;
+				bestMove = (int)moves.size();
+				sinceBest = 0;
+			}
+			else sinceBest++;
+		}
+
+		// undo the moves after the best partition
+		for (int k = (int)moves.size() - 1; k >= bestMove; --k) part[moves[k]] = 1 - part[moves[k]];
+		cut = bestCut;
+
+		if (bestMove == 0) break;
+	}
+
+	return cut;
+}
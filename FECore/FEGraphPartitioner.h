@@ -0,0 +1,106 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "fecore_api.h"
+#include <vector>
+
+class FEMesh;
+class FENodeNodeList;
+class FEElemElemList;
+
+//-----------------------------------------------------------------------------
+//! Multilevel graph partitioner.
+
+//! The graph is coarsened by heavy-edge matching until it is small, 
+//! bisected by greedy graph growing, and then projected back to the original
+//! graph, refining the bisection with Fiduccia-Mattheyses (FM) passes on each
+//! level. k-way partitions are obtained by recursive bisection.
+//! The graph can be the node graph of a mesh (FENodeNodeList) or the dual 
+//! graph of its elements (FEElemElemList). The latter is useful for domain 
+//! decomposition and for distributing the elements over threads. 
+//! The partitioner also calculates nested dissection (fill-reducing) orderings.
+class FECORE_API FEGraphPartitioner
+{
+public:
+	// graph in compressed row format
+	struct Graph
+	{
+		int					n;		// number of vertices
+		std::vector<int>	xadj;	// start of adjacency list of each vertex (size n+1)
+		std::vector<int>	adj;	// adjacent vertices
+		std::vector<int>	adjw;	// edge weights
+		std::vector<int>	vw;		// vertex weights
+
+		Graph() : n(0) {}
+	};
+
+public:
+	FEGraphPartitioner();
+
+	//! set the graph from the node-node list
+	void SetGraph(FENodeNodeList& NNL);
+
+	//! set the (dual) graph of the elements of the mesh. 
+	//! Elements are indexed in the order of FEMesh::Element(i)
+	void SetGraph(FEMesh& mesh, FEElemElemList& EEL);
+
+	//! get the graph
+	const Graph& GetGraph() const { return m_G; }
+
+	//! partition the graph into nparts parts of (roughly) equal weight
+	//! On return part[i] is the part that vertex i is assigned to.
+	bool Partition(int nparts, std::vector<int>& part);
+
+	//! calculate a nested dissection ordering of the graph
+	//! On return P[i] is the vertex that is ordered at position i.
+	void NestedDissection(std::vector<int>& P);
+
+	//! calculate the number of cut edges of a partition
+	int EdgeCut(const std::vector<int>& part) const;
+
+public:
+	int		m_coarsenTo;	//!< stop coarsening when the graph has fewer vertices
+	int		m_ntries;		//!< number of initial bisections that are tried
+	int		m_fmPasses;		//!< max number of FM passes on each level
+	double	m_imbalance;	//!< allowed relative imbalance of the bisection
+	int		m_leafSize;		//!< nested dissection stops on subgraphs smaller than this
+
+private:
+	void Bisect(const Graph& g, double f0, std::vector<int>& part);
+	void Coarsen(const Graph& g, Graph& c, std::vector<int>& cmap);
+	int GrowBisection(const Graph& g, int seed, int tw0, int maxw0, std::vector<int>& part);
+	int Refine(const Graph& g, const int maxw[2], std::vector<int>& part);
+	void RecursiveBisection(const Graph& g, const std::vector<int>& vid, int nparts, int part0, std::vector<int>& part);
+	void Dissect(const Graph& g, const std::vector<int>& vid, std::vector<int>& P);
+	unsigned int Random();
+
+private:
+	Graph			m_G;
+	unsigned int	m_seed;
+};
@@ -33,6 +33,7 @@ SOFTWARE.*/
 #include "FEAnalysis.h"
 #include "DumpStream.h"
 #include "FEDomain.h"
+#include "FEGlobalVector.h"
 
 //-----------------------------------------------------------------------------
 FELinearConstraintManager::FELinearConstraintManager(FEModel* fem) : m_fem(fem)
@@ -348,7 +349,7 @@ bool FELinearConstraintManager::Activate()
 }
 
 //-----------------------------------------------------------------------------
-void FELinearConstraintManager::AssembleResidual(vector<double>& R, vector<int>& en, vector<int>& elm, vector<double>& fe)
+void FELinearConstraintManager::AssembleResidual(FEGlobalVector& R, vector<int>& en, vector<int>& elm, vector<double>& fe)
 {
 	FEMesh& mesh = m_fem->GetMesh();
 
@@ -379,8 +380,7 @@ void FELinearConstraintManager::AssembleResidual(vector<double>& R, vector<int>&
 					if (I >= 0)
 					{
 						double A = (*is)->val;
-#pragma omp atomic
-						R[I] += A*fe[i];
+						R.Add(I, A*fe[i]);
 					}
 				}
 			}
@@ -27,12 +27,18 @@ SOFTWARE.*/
 #include "FEMeshAdaptor.h"
 #include "FESolidDomain.h"
 #include <FECore/FEElementList.h>
+#include "FEModel.h"
+#include "FESurfaceLoad.h"
+#include "FESurfacePairConstraint.h"
+#include "FELinearConstraintManager.h"
+#include <algorithm>
 
 REGISTER_SUPER_CLASS(FEMeshAdaptor, FEMESHADAPTOR_ID);
 
 FEMeshAdaptor::FEMeshAdaptor(FEModel* fem) : FEModelComponent(fem)
 {
 	m_elemSet = nullptr;
+	m_bincremental = false;
 }
 
 void FEMeshAdaptor::SetElementSet(FEElementSet* elemSet)
@@ -49,6 +55,43 @@ void FEMeshAdaptor::UpdateModel()
 {
 	FEModel& fem = *GetFEModel();
 	fem.Reactivate();
+	m_bincremental = false;
+}
+
+void FEMeshAdaptor::UpdateModelIncremental(const std::vector<FESurface*>& modifiedSurfaces)
+{
+	FEModel& fem = *GetFEModel();
+	auto isModified = [&](FESurface* s) {
+		return (std::find(modifiedSurfaces.begin(), modifiedSurfaces.end(), s) != modifiedSurfaces.end());
+	};
+
+	// contact interfaces may need to rebuild their equations
+	for (int i = 0; i < fem.SurfacePairConstraints(); ++i)
+	{
+		FESurfacePairConstraint& ci = *fem.SurfacePairConstraint(i);
+		if (isModified(ci.GetPrimarySurface()) || isModified(ci.GetSecondarySurface()))
+		{
+			UpdateModel();
+			return;
+		}
+	}
+
+	// update the surface loads on the modified surfaces
+	for (int i = 0; i < fem.SurfaceLoads(); ++i)
+	{
+		FESurfaceLoad& sl = *fem.SurfaceLoad(i);
+		FESurface& surf = sl.GetSurface();
+		if (isModified(&surf))
+		{
+			sl.SetSurface(&surf);
+			if (sl.IsActive()) sl.Activate();
+		}
+	}
+
+	// linear constraints may have been removed
+	fem.GetLinearConstraintManager().Activate();
+
+	m_bincremental = true;
 }
 
 // helper function for projecting integration point data to nodes
@@ -34,6 +34,7 @@ class FEElement;
 class FEMaterialPoint;
 class FEElementSet;
 class FEMeshAdaptorCriterion;
+class FESurface;
 
 //-----------------------------------------------------------------------------
 // Base class for all mesh adaptors
@@ -52,12 +53,22 @@ public:
 	// iteration is the iteration number of the mesh adaptation loop
 	virtual bool Apply(int iteration) = 0;
 
+	// Returns true if the last modification only deactivated elements and nodes
+	// (see UpdateModelIncremental). In that case the solver can keep its equations.
+	bool IsIncrementalUpdate() const { return m_bincremental; }
+
 protected:
 	// call this after the model was updated
 	void UpdateModel();
 
+	// Call this instead of UpdateModel when elements (and orphaned nodes) were only deactivated.
+	// Only the surface loads on the modified surfaces are updated. If a contact interface uses
+	// one of these surfaces, this falls back to UpdateModel.
+	void UpdateModelIncremental(const std::vector<FESurface*>& modifiedSurfaces);
+
 private:
 	FEElementSet*	m_elemSet;
+	bool			m_bincremental;
 };
 
 // helper function for projecting integration point data to nodes
@@ -59,6 +59,8 @@ SOFTWARE.*/
 #include "Timer.h"
 #include "DumpMemStream.h"
 #include "FEPlotDataStore.h"
+#include "FESpaceFillingCurve.h"
+#include "FESolver.h"
 #include <stdarg.h>
 using namespace std;
 
@@ -493,6 +495,54 @@ bool FEModel::Init()
 		if (step.Init() == false) return false;
 	}
 
+	// reorder the solid elements for memory locality
+	// NOTE: This must be done before the mesh is initialized since surfaces
+	//       and domain data store references to the elements.
+	FESolver* solver = m_imp->m_Step[0]->GetFESolver();
+	if (solver && (solver->m_sfcOrder != FESpaceFillingCurve::NONE))
+	{
+		// collect the surfaces that are not owned by the mesh, including those of
+		// the step-local model components
+		vector<FESurface*> surf;
+		for (int i = 0; i < SurfacePairConstraints(); ++i)
+		{
+			FESurfacePairConstraint* pc = SurfacePairConstraint(i);
+			surf.push_back(pc->GetPrimarySurface());
+			surf.push_back(pc->GetSecondarySurface());
+		}
+		for (int i = 0; i < ModelLoads(); ++i)
+		{
+			FESurfaceLoad* psl = dynamic_cast<FESurfaceLoad*>(ModelLoad(i));
+			if (psl) surf.push_back(&psl->GetSurface());
+		}
+		for (int i = 0; i < NonlinearConstraints(); ++i)
+		{
+			FESurfaceConstraint* psc = dynamic_cast<FESurfaceConstraint*>(NonlinearConstraint(i));
+			if (psc) surf.push_back(psc->GetSurface());
+		}
+		for (int i = 0; i < Steps(); ++i)
+		{
+			FEAnalysis* step = GetStep(i);
+			for (int j = 0; j < step->ModelComponents(); ++j)
+			{
+				FEModelComponent* pmc = step->GetModelComponent(j);
+				FESurfacePairConstraint* pc = dynamic_cast<FESurfacePairConstraint*>(pmc);
+				if (pc)
+				{
+					surf.push_back(pc->GetPrimarySurface());
+					surf.push_back(pc->GetSecondarySurface());
+				}
+				FESurfaceLoad* psl = dynamic_cast<FESurfaceLoad*>(pmc);
+				if (psl) surf.push_back(&psl->GetSurface());
+				FESurfaceConstraint* psc = dynamic_cast<FESurfaceConstraint*>(pmc);
+				if (psc) surf.push_back(psc->GetSurface());
+			}
+		}
+
+		FESpaceFillingCurve sfc(solver->m_sfcOrder);
+		sfc.ReorderElements(GetMesh(), surf);
+	}
+
 	// create and initialize the rigid body data
 	// NOTE: Do this first, since some BC's look at the nodes' rigid id.
 	if (InitRigidSystem() == false) return false;
@@ -60,7 +60,7 @@ BEGIN_FECORE_CLASS(FENewtonSolver, FESolver)
 	ADD_PARAMETER(m_Rmax, FE_RANGE_GREATER_OR_EQUAL(0.0), "max_residual");
 
 	// obsolete parameters (Should be set via the qn_method)
-	ADD_PARAMETER(m_qndefault           , "qnmethod", 0, "BFGS\0BROYDEN\0JFNK\0");
+	ADD_PARAMETER(m_qndefault           , "qnmethod", 0, "BFGS\0BROYDEN\0JFNK\0MFNK\0");
 	ADD_PARAMETER(m_maxups              , FE_RANGE_GREATER_OR_EQUAL(0.0), "max_ups" );
 	ADD_PARAMETER(m_max_buf_size        , FE_RANGE_GREATER_OR_EQUAL(0), "qn_max_buffer_size");
 	ADD_PARAMETER(m_cycle_buffer        , "qn_cycle_buffer");
@@ -202,6 +202,9 @@ bool FENewtonSolver::ReformStiffness()
 		// calculate the global stiffness matrix
 	    bret = StiffnessMatrix();
 
+		// masked equations don't get any contributions, so set their diagonal to one
+		for (int eq : m_maskedEq) m_pK->GetSparseMatrixPtr()->set(eq, eq, 1.0);
+
 		// check for zero diagonals
 		if (m_bzero_diagonal)
 		{
@@ -246,6 +249,38 @@ bool FENewtonSolver::ReformStiffness()
     return bret;
 }
 
+//-----------------------------------------------------------------------------
+//! Evaluates and factors the stiffness matrix at the current state. This is
+//! meant for evaluating the tangent of a converged solution, so the reformation
+//! counters are not touched. Since the factorization no longer matches the
+//! quasi-Newton updates, a reformation is forced at the start of the next solve.
+bool FENewtonSolver::FactorStiffness()
+{
+	if ((m_pK == nullptr) || (m_plinsolve == nullptr)) return false;
+
+	if (m_breshape)
+	{
+		if (!CreateStiffness(false)) return false;
+	}
+
+	{
+		TRACK_TIME(TimerID::Timer_Stiffness);
+		m_pK->Zero();
+		zero(m_Fd);
+		if (StiffnessMatrix() == false) return false;
+		for (int eq : m_maskedEq) m_pK->GetSparseMatrixPtr()->set(eq, eq, 1.0);
+	}
+
+	{
+		TRACK_TIME(TimerID::Timer_LinSolve);
+		if (m_plinsolve->Factor() == false) return false;
+	}
+
+	QNForceReform(true);
+
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 //! get the RHS
 std::vector<double> FENewtonSolver::GetLoadVector()
@@ -409,6 +444,7 @@ bool FENewtonSolver::Init()
 		case QN_BFGS   : SetSolutionStrategy(fecore_new<FENewtonStrategy>("BFGS"   , GetFEModel())); break;
 		case QN_BROYDEN: SetSolutionStrategy(fecore_new<FENewtonStrategy>("Broyden", GetFEModel())); break;
 		case QN_JFNK   : SetSolutionStrategy(fecore_new<FENewtonStrategy>("JFNK"   , GetFEModel())); break;
+		case QN_MFNK   : SetSolutionStrategy(fecore_new<FENewtonStrategy>("MFNK"   , GetFEModel())); break;
 		default:
 			feLogError("Invalid quasi-Newton option (%d)", m_qndefault);
 			return false;
@@ -444,6 +480,41 @@ bool FENewtonSolver::Init()
 	// set the create stiffness matrix flag
 	m_breshape = true;
 
+	// the equations were (re)numbered, so nothing is masked
+	m_maskedEq.clear();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! The equations of nodal dofs that became inactive are taken out of the linear
+//! system by setting the dof's equation number to -1. Since these dofs no longer
+//! receive any contributions, the corresponding rows and columns of the stiffness
+//! matrix are zero. ReformStiffness places a one on their diagonal, so the
+//! existing matrix profile and symbolic factorization remain valid.
+bool FENewtonSolver::MaskInactiveEquations()
+{
+	FEMesh& mesh = GetFEModel()->GetMesh();
+	int nmasked = 0;
+	for (int i = 0; i < mesh.Nodes(); ++i)
+	{
+		FENode& node = mesh.Node(i);
+		bool bexclude = node.HasFlags(FENode::EXCLUDE);
+		for (int j = 0; j < (int)node.m_ID.size(); ++j)
+		{
+			int id = node.m_ID[j];
+			if ((id != -1) && (bexclude || (node.is_active(j) == false)))
+			{
+				int eq = (id >= 0 ? id : -id - 2);
+				m_maskedEq.push_back(eq);
+				node.m_ID[j] = -1;
+				nmasked++;
+			}
+		}
+	}
+
+	feLog("	Masked equations .......................... : %d\n", nmasked);
+
 	return true;
 }
 
@@ -472,6 +543,7 @@ void FENewtonSolver::Serialize(DumpStream& ar)
 		ar << m_maxref;
 		ar << m_qndefault;
 		ar << m_qnstrategy;
+		ar << m_maskedEq;
 	}
 	else
 	{
@@ -479,6 +551,7 @@ void FENewtonSolver::Serialize(DumpStream& ar)
 		ar >> m_maxref;
 		ar >> m_qndefault;
 		ar >> m_qnstrategy;
+		ar >> m_maskedEq;
 
 		// realloc data
 		if (m_neq > 0 && m_qnstrategy)
@@ -43,7 +43,8 @@ enum QN_STRATEGY
 {
 	QN_BFGS,
 	QN_BROYDEN,
-	QN_JFNK
+	QN_JFNK,
+	QN_MFNK
 };
 
 //-----------------------------------------------------------------------------
@@ -107,6 +108,9 @@ public: // overloaded from FESolver
 	//! Clean up
 	void Clean() override;
 
+	//! mask the equations of inactive dofs
+	bool MaskInactiveEquations() override;
+
 	//! serialization
 	void Serialize(DumpStream& ar) override;
 
@@ -143,6 +147,10 @@ public:
 	//! reform the stiffness matrix
     bool ReformStiffness();
 
+	//! evaluate and factor the stiffness matrix at the current state without
+	//! counting it as a reformation (e.g. for post-processing a converged solution)
+	bool FactorStiffness();
+
     //! recalculates the shape of the stiffness matrix
     bool CreateStiffness(bool breset);
 
@@ -241,6 +249,7 @@ public:
 	LinearSolver*		m_plinsolve;	//!< the linear solver
 	FEGlobalMatrix*		m_pK;			//!< global stiffness matrix
     bool				m_breshape;		//!< Matrix reshape flag
+	vector<int>			m_maskedEq;		//!< equations of dofs that were deactivated (see MaskInactiveEquations)
 	bool				m_persistMatrix;//!< Don't delete stiffness matrix until necessary (if true, K is deleted at end of time step)
 
 	// data used by Quasin
@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "FEMaterial.h"
 #include "tools.h"
 #include "log.h"
+#include "DumpMemStream.h"
 
 //-----------------------------------------------------------------------------
 FESolidDomain::FESolidDomain(FEModel* pfem) : FEDomain(FE_DOMAIN_SOLID, pfem), m_dofU(pfem), m_dofSU(pfem)
@@ -97,6 +98,57 @@ void FESolidDomain::CopyFrom(FEMeshPartition* pd)
 	ForEachElement([=](FEElement& el) { el.SetMeshPartition(this); });
 }
 
+//-----------------------------------------------------------------------------
+void FESolidDomain::PermuteElements(const std::vector<int>& P)
+{
+	int NE = Elements();
+	assert((int)P.size() == NE);
+
+	// Detach the material points first so that the element copies below
+	// don't duplicate them. The points are then moved to their new element.
+	vector<FESolidElement> state(NE);
+	for (int i = 0; i < NE; ++i) state[i].SwapMaterialPointData(m_Elem[i]);
+
+	vector<FESolidElement> elem(NE);
+	for (int i = 0; i < NE; ++i)
+	{
+		FESolidElement& el = elem[i];
+		el = m_Elem[P[i]];
+		el.SwapMaterialPointData(state[P[i]]);
+		el.SetLocalID(i);
+		el.SetMeshPartition(this);
+	}
+	m_Elem.swap(elem);
+
+	// The material points were allocated in the original element order. Reallocate
+	// them in the new order so that they are also traversed sequentially in memory.
+	// Not all material points implement Copy, so the data is transferred through
+	// serialization instead.
+	FEMaterial* pmat = GetMaterial();
+	if (pmat == nullptr) return;
+
+	DumpMemStream ar(*GetFEModel());
+	for (int i = 0; i < NE; ++i)
+	{
+		FESolidElement& el = m_Elem[i];
+		for (int j = 0; j < el.GaussPoints(); ++j)
+		{
+			FEMaterialPoint* mp0 = el.GetMaterialPoint(j);
+			if (mp0 == nullptr) continue;
+
+			ar.Open(true, false);
+			mp0->Serialize(ar);
+
+			FEMaterialPoint* mp = pmat->CreateMaterialPointData();
+			ar.Open(false, false);
+			mp->Serialize(ar);
+
+			el.SetMaterialPointData(mp, j);
+			delete mp0;
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! initialize element data
 bool FESolidDomain::Init()
@@ -2521,6 +2573,24 @@ int FESolidDomain::GetElementDofs(FESolidElement& el)
 	return (int)GetDOFList().Size()*el.Nodes();
 }
 
+//-----------------------------------------------------------------------------
+void FESolidDomain::UnpackLM(const FESolidElement& el, const FEDofList& dofList, vector<int>& lm)
+{
+	FEMesh& mesh = *GetMesh();
+	int dofPerNode = dofList.Size();
+	int neln = el.Nodes();
+	lm.assign(dofPerNode*neln, -1);
+	for (int j = 0; j < neln; ++j)
+	{
+		FENode& node = mesh.Node(el.m_node[j]);
+		vector<int>& ID = node.m_ID;
+		for (int k = 0; k < dofPerNode; ++k)
+		{
+			lm[dofPerNode*j + k] = ID[dofList[k]];
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 // Evaluate an integral over the domain and assemble into global load vector
 void FESolidDomain::LoadVector(
@@ -2529,8 +2599,6 @@ void FESolidDomain::LoadVector(
 	FEVolumeVectorIntegrand f	// the actual integrand function
 )
 {
-	FEMesh& mesh = *GetMesh();
-
 	// degrees of freedom per node
 	int dofPerNode = dofList.Size();
 	std::vector<double> val(dofPerNode, 0.0);
@@ -2579,16 +2647,8 @@ void FESolidDomain::LoadVector(
 			}
 
 			// get the element's LM vector
-			vector<int> lm(ndof, -1);
-			for (int j = 0; j < neln; ++j)
-			{
-				FENode& node = mesh.Node(el.m_node[j]);
-				vector<int>& ID = node.m_ID;
-				for (int k = 0; k < dofPerNode; ++k)
-				{
-					lm[dofPerNode*j + k] = ID[dofList[k]];
-				}
-			}
+			vector<int> lm;
+			UnpackLM(el, dofList, lm);
 
 			// Assemble into global vector
 			R.Assemble(el.m_node, lm, fe);
@@ -2604,7 +2664,6 @@ void FESolidDomain::LoadStiffness(FELinearSystem& LS, const FEDofList& dofList_a
 	int dofPerNode_a = dofList_a.Size();
 	int dofPerNode_b = dofList_b.Size();
 
-	FEMesh& mesh = *GetMesh();
 	vec3d rt[FEElement::MAX_NODES];
 
 	matrix kab(dofPerNode_a, dofPerNode_b);
@@ -2651,21 +2710,8 @@ void FESolidDomain::LoadStiffness(FELinearSystem& LS, const FEDofList& dofList_a
 		}
 
 		// get the element's LM vector
-		std::vector<int>& lma = ke.RowIndices();
-		std::vector<int>& lmb = ke.ColumnsIndices();
-		lma.assign(ndof_a, -1);
-		lmb.assign(ndof_b, -1);
-		for (int j = 0; j < neln; ++j)
-		{
-			FENode& node = mesh.Node(el.m_node[j]);
-			std::vector<int>& ID = node.m_ID;
-
-			for (int k = 0; k < dofPerNode_a; ++k)
-				lma[dofPerNode_a*j + k] = ID[dofList_a[k]];
-
-			for (int k = 0; k < dofPerNode_b; ++k)
-				lmb[dofPerNode_b*j + k] = ID[dofList_b[k]];
-		}
+		UnpackLM(el, dofList_a, ke.RowIndices());
+		UnpackLM(el, dofList_b, ke.ColumnsIndices());
 
 		// assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
@@ -31,6 +31,8 @@ SOFTWARE.*/
 #include "FEModel.h"
 #include "FEDofList.h"
 #include "FELinearSystem.h"
+#include "FEGlobalVector.h"
+#include "fixed_matrix.h"
 
 //-----------------------------------------------------------------------------
 // This typedef defines a surface integrand. 
@@ -42,6 +44,13 @@ typedef std::function<void(FEMaterialPoint& mp, int node_a, std::vector<double>&
 
 typedef std::function<void(FEMaterialPoint& mp, int node_a, int node_b, matrix& val)> FEVolumeMatrixIntegrand;
 
+// The templated versions of FESolidDomain::LoadVector and LoadStiffness take the
+// integrand as a template argument so that it can be inlined. The number of
+// degrees of freedom per node is fixed at compile time and the integrands have
+// the following signatures:
+//   void(FEMaterialPoint& mp, int node_a, double* val)
+//   void(FEMaterialPoint& mp, int node_a, int node_b, fixed_matrix<NA, NB>& val)
+
 //-----------------------------------------------------------------------------
 //! abstract base class for 3D volumetric elements
 class FECORE_API FESolidDomain : public FEDomain
@@ -65,6 +74,11 @@ public:
     //! copy data from another domain (overridden from FEDomain)
     void CopyFrom(FEMeshPartition* pd) override;
 
+	//! reorder the elements so that element i becomes element P[i]
+	//! The material points are reallocated in the new element order.
+	//! NOTE: this must be called before the domain is initialized.
+	void PermuteElements(const std::vector<int>& P);
+
     //! element access
 	FESolidElement& Element(int n);
     FEElement& ElementRef(int n) override { return m_Elem[n]; }
@@ -265,6 +279,8 @@ public:
 	//! return the degrees of freedom of an element for this domain
 	virtual int GetElementDofs(FESolidElement& el);
 
+	using FEDomain::UnpackLM;
+
 public:
 	// Evaluate an integral over the domain and assemble into global load vector
 	virtual void LoadVector(
@@ -281,6 +297,16 @@ public:
 		FEVolumeMatrixIntegrand f	// the matrix function to evaluate
 	);
 
+	// Evaluate a load vector with an inlined integrand (see comments above)
+	template <int NDOF, class F> void LoadVector(FEGlobalVector& R, const FEDofList& dofList, F f);
+
+	// Evaluate the stiffness of a load with an inlined integrand (see comments above)
+	template <int NA, int NB, class F> void LoadStiffness(FELinearSystem& LS, const FEDofList& dofList_a, const FEDofList& dofList_b, F f);
+
+protected:
+	//! get the equation numbers of the element for the given dofs
+	void UnpackLM(const FESolidElement& el, const FEDofList& dofList, vector<int>& lm);
+
 protected:
     vector<FESolidElement>	m_Elem;		//!< array of elements
 	FE_Element_Spec			m_elemSpec;	//!< the element spec
@@ -288,3 +314,91 @@ protected:
 	FEDofList	m_dofU;
 	FEDofList	m_dofSU;
 };
+
+//-----------------------------------------------------------------------------
+template <int NDOF, class F> void FESolidDomain::LoadVector(FEGlobalVector& R, const FEDofList& dofList, F f)
+{
+	assert(dofList.Size() == NDOF);
+
+	vector<double> fe;
+	vector<int> lm;
+	double val[NDOF];
+
+	int NE = Elements();
+	for (int i = 0; i<NE; ++i)
+	{
+		// only consider active elements
+		FESolidElement& el = Element(i);
+		if (el.isActive() == false) continue;
+
+		int neln = el.Nodes();
+		fe.assign(NDOF * neln, 0.0);
+
+		// loop over integration points
+		double* w = el.GaussWeights();
+		int nint = el.GaussPoints();
+		for (int n = 0; n<nint; ++n)
+		{
+			FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+			mp.m_Jt = detJt(el, n);
+			mp.m_shape = el.H(n);
+
+			for (int j = 0; j<neln; ++j)
+			{
+				f(mp, j, val);
+				for (int k = 0; k<NDOF; ++k) fe[NDOF*j + k] += val[k] * w[n];
+			}
+		}
+
+		// assemble into global vector
+		UnpackLM(el, dofList, lm);
+		R.Assemble(el.m_node, lm, fe);
+	}
+}
+
+//-----------------------------------------------------------------------------
+template <int NA, int NB, class F> void FESolidDomain::LoadStiffness(FELinearSystem& LS, const FEDofList& dofList_a, const FEDofList& dofList_b, F f)
+{
+	assert((dofList_a.Size() == NA) && (dofList_b.Size() == NB));
+
+	FEElementMatrix ke;
+	fixed_matrix<NA, NB> kab;
+
+	int NE = Elements();
+	for (int m = 0; m<NE; ++m)
+	{
+		FESolidElement& el = Element(m);
+		int neln = el.Nodes();
+
+		ke.SetNodes(el.m_node);
+		ke.resize(NA * neln, NB * neln);
+		ke.zero();
+
+		// repeat over integration points
+		double* w = el.GaussWeights();
+		int nint = el.GaussPoints();
+		for (int n = 0; n<nint; ++n)
+		{
+			FEMaterialPoint& pt = *el.GetMaterialPoint(n);
+			pt.m_shape = el.H(n);
+
+			for (int i = 0; i<neln; ++i)
+				for (int j = 0; j<neln; ++j)
+				{
+					kab.zero();
+					f(pt, i, j, kab);
+
+					for (int k = 0; k<NA; ++k)
+					{
+						double* kek = ke[NA*i + k] + NB*j;
+						for (int l = 0; l<NB; ++l) kek[l] += kab(k, l) * w[n];
+					}
+				}
+		}
+
+		// assemble element matrix in global stiffness matrix
+		UnpackLM(el, dofList_a, ke.RowIndices());
+		UnpackLM(el, dofList_b, ke.ColumnsIndices());
+		LS.Assemble(ke);
+	}
+}
@@ -30,13 +30,18 @@ SOFTWARE.*/
 #include "FESolver.h"
 #include "FEModel.h"
 #include "FENodeReorder.h"
+#include "FESpaceFillingCurve.h"
+#include "FEGraphPartitioner.h"
+#include "FENodeNodeList.h"
 #include "DumpStream.h"
 #include "FEDomain.h"
 #include "FESurfacePairConstraint.h"
 #include "FENLConstraint.h"
 #include "FELinearConstraintManager.h"
 #include "FENodalLoad.h"
+#include "FEGlobalVector.h"
 #include "LinearSolver.h"
+#include "log.h"
 
 REGISTER_SUPER_CLASS(FESolver, FESOLVER_ID);
 
@@ -45,6 +50,10 @@ BEGIN_FECORE_CLASS(FESolver, FECoreBase)
 	ADD_PARAMETER(m_eq_scheme, "equation_scheme");
 	ADD_PARAMETER(m_eq_order , "equation_order" );
 	ADD_PARAMETER(m_bwopt    , "optimize_bw");
+	ADD_PARAMETER(m_sfcOrder , "sfc_reorder", 0, "none\0hilbert\0morton\0");
+	ADD_PARAMETER(m_ndOrder  , "nested_dissection");
+	ADD_PARAMETER(m_assemblyMode, "assembly_mode", 0, "atomic\0deterministic\0");
+	ADD_PARAMETER(m_btaskAssembly, "task_assembly");
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
@@ -61,14 +70,34 @@ FESolver::FESolver(FEModel* fem) : FECoreBase(fem)
 	m_neq = 0;
 
 	m_bwopt = 0;
+	m_sfcOrder = FESpaceFillingCurve::NONE;
+	m_ndOrder = false;
 
 	m_eq_scheme = EQUATION_SCHEME::STAGGERED;
 	m_eq_order = EQUATION_ORDER::NORMAL_ORDER;
+
+	m_assemblyMode = FE_ASSEMBLE_ATOMIC;
+	m_btaskAssembly = false;
+	m_breduceAssembly = false;
+	m_assemblyBuffer = nullptr;
 }
 
 //-----------------------------------------------------------------------------
 FESolver::~FESolver()
 {
+	delete m_assemblyBuffer;
+}
+
+//-----------------------------------------------------------------------------
+bool FESolver::Init()
+{
+	if ((m_assemblyMode == FE_ASSEMBLE_REDUCE) && (m_breduceAssembly == false))
+	{
+		feLogError("The deterministic assembly mode is not supported by the %s solver.", GetTypeStr());
+		return false;
+	}
+
+	return FECoreBase::Init();
 }
 
 //-----------------------------------------------------------------------------
@@ -148,6 +177,22 @@ Matrix_Type FESolver::MatrixType() const
 	return mtype;
 }
 
+//-----------------------------------------------------------------------------
+// The thread-private buffers of the deterministic assembly mode are indexed by
+// the thread number, which is not unique inside concurrently running tasks.
+// The tasks are therefore only run concurrently with the atomic assembly.
+bool FESolver::TaskAssembly() const
+{
+	return m_btaskAssembly && (m_assemblyMode == FE_ASSEMBLE_ATOMIC);
+}
+
+//-----------------------------------------------------------------------------
+FEAssemblyBuffer& FESolver::GetAssemblyBuffer()
+{
+	if (m_assemblyBuffer == nullptr) m_assemblyBuffer = new FEAssemblyBuffer;
+	return *m_assemblyBuffer;
+}
+
 //-----------------------------------------------------------------------------
 // extract the (square) norm of a solution vector
 double FESolver::ExtractSolutionNorm(const vector<double>& v, const FEDofList& dofs) const
@@ -311,6 +356,38 @@ bool FESolver::InitStep(double time)
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+//! Calculates the permutation P of the nodes, such that the equations are assigned
+//! to node P[0] first, then to node P[1], etc.
+void FESolver::NodeOrdering(vector<int>& P)
+{
+	FEMesh& mesh = GetFEModel()->GetMesh();
+	int NN = mesh.Nodes();
+	P.resize(NN);
+
+	// see if we need to optimize the bandwidth
+	if (m_bwopt)
+	{
+		FENodeReorder mod;
+		mod.Apply(mesh, P);
+	}
+	else if (m_ndOrder)
+	{
+		// fill-reducing ordering
+		FENodeNodeList NNL;
+		NNL.Create(mesh);
+		FEGraphPartitioner gp;
+		gp.SetGraph(NNL);
+		gp.NestedDissection(P);
+	}
+	else if (m_sfcOrder != FESpaceFillingCurve::NONE)
+	{
+		FESpaceFillingCurve sfc(m_sfcOrder);
+		sfc.Apply(mesh, P);
+	}
+	else for (int i = 0; i < NN; ++i) P[i] = i;
+}
+
 //-----------------------------------------------------------------------------
 //!	This function initializes the equation system.
 //! It is assumed that all free dofs up until now have been given an ID >= 0
@@ -337,15 +414,8 @@ bool FESolver::InitEquations()
 
 	// reorder the node numbers
 	int NN = mesh.Nodes();
-	vector<int> P(NN);
-    
-    // see if we need to optimize the bandwidth
-	if (m_bwopt)
-	{
-		FENodeReorder mod;
-		mod.Apply(mesh, P);
-	}
-	else for (int i = 0; i < NN; ++i) P[i] = i;
+	vector<int> P;
+	NodeOrdering(P);
 
 	for (int i = 0; i < mesh.Nodes(); ++i)
 	{
@@ -526,6 +596,12 @@ bool FESolver::InitEquations()
     return true;
 }
 
+//-----------------------------------------------------------------------------
+bool FESolver::MaskInactiveEquations()
+{
+	return false;
+}
+
 //-----------------------------------------------------------------------------
 bool FESolver::InitEquations2()
 {
@@ -537,16 +613,8 @@ bool FESolver::InitEquations2()
 	m_part.clear();
 
 	// reorder the node numbers
-	int NN = mesh.Nodes();
-	vector<int> P(NN);
-
-	// see if we need to optimize the bandwidth
-	if (m_bwopt)
-	{
-		FENodeReorder mod;
-		mod.Apply(mesh, P);
-	}
-	else for (int i = 0; i < NN; ++i) P[i] = i;
+	vector<int> P;
+	NodeOrdering(P);
 
 	// reset all equation numbers
 	// first, on all nodes
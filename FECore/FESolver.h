@@ -84,6 +84,7 @@ class FEModel;
 class FEGlobalMatrix;
 class LinearSolver;
 class FEGlobalVector;
+class FEAssemblyBuffer;
 
 //-----------------------------------------------------------------------------
 //! This is the base class for all FE solvers.
@@ -103,6 +104,9 @@ public:
 	virtual ~FESolver();
 
 public:
+	//! initialization
+	bool Init() override;
+
 	//! Data serialization
 	void Serialize(DumpStream& ar) override;
 
@@ -122,9 +126,18 @@ public:
 	// TODO: work in progress
 	virtual bool InitEquations2();
 
+	//! calculate the order in which the nodes are assigned equation numbers
+	void NodeOrdering(vector<int>& P);
+
 	//! add equations
 	void AddEquations(int neq, int partition = 0);
 
+	//! Called after degrees of freedom were deactivated without otherwise changing the
+	//! mesh (e.g. by element erosion). A solver that supports this keeps its equation
+	//! numbering, matrix profile and symbolic factorization and masks the equations of
+	//! the inactive dofs instead. If this returns false, the solver must be reinitialized.
+	virtual bool MaskInactiveEquations();
+
 	//! initialize the step (This is called before SolveStep)
 	virtual bool InitStep(double time);
 
@@ -165,6 +178,13 @@ public:
 	//! get matrix type
 	Matrix_Type MatrixType() const;
 
+	//! returns true if independent contributions to the residual and stiffness
+	//! matrix (domains, loads, contact) may be evaluated concurrently (see FETaskList)
+	bool TaskAssembly() const;
+
+	//! buffer used by global vectors in the deterministic assembly mode
+	FEAssemblyBuffer& GetAssemblyBuffer();
+
 	//! build the matrix profile
 	virtual void BuildMatrixProfile(FEGlobalMatrix& G, bool breset);
 
@@ -183,9 +203,13 @@ public:
 
 public: //TODO Move these parameters elsewhere
 	int					m_bwopt;	    //!< bandwidth optimization flag
+	int					m_sfcOrder;		//!< space-filling curve reordering (see FESpaceFillingCurve::CurveType)
+	bool				m_ndOrder;		//!< nested dissection (fill-reducing) equation ordering
 	int					m_msymm;		//!< matrix symmetry flag for linear solver allocation
 	int					m_eq_scheme;	//!< equation number scheme (used in InitEquations)
 	int					m_eq_order;		//!< normal or reverse ordering
+	int					m_assemblyMode;	//!< residual assembly mode (see FEAssemblyMode)
+	bool				m_btaskAssembly;	//!< evaluate independent contributions concurrently
 	int					m_neq;			//!< number of equations
 	std::vector<int>	m_part;			//!< partitions of linear system
 	std::vector<int>	m_dofMap;		//!< array stores for each equation the corresponding dof index
@@ -204,5 +228,13 @@ protected:
 	// list of solution variables
 	vector<FESolutionVariable>	m_Var;
 
+	//! Set by solvers that reduce the residual (see FEGlobalVector::Reduce) before they
+	//! read it, or the reaction forces, directly. Other solvers reject the deterministic
+	//! assembly mode.
+	bool	m_breduceAssembly;
+
+private:
+	FEAssemblyBuffer*	m_assemblyBuffer;	//!< kept between residual evaluations (allocated on first use)
+
 	DECLARE_FECORE_CLASS();
 };
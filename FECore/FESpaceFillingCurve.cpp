@@ -0,0 +1,222 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FESpaceFillingCurve.h"
+#include "FEMesh.h"
+#include "FESolidDomain.h"
+#include "FESurface.h"
+#include <algorithm>
+#include <stdint.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// number of bits per coordinate axis
+static const int SFC_BITS = 21;
+
+//-----------------------------------------------------------------------------
+// spread the lower 21 bits of x so that there are two zero bits between each bit
+static uint64_t spread_bits(uint64_t x)
+{
+	x &= 0x1fffff;
+	x = (x | (x << 32)) & 0x001f00000000ffffULL;
+	x = (x | (x << 16)) & 0x001f0000ff0000ffULL;
+	x = (x | (x <<  8)) & 0x100f00f00f00f00fULL;
+	x = (x | (x <<  4)) & 0x10c30c30c30c30c3ULL;
+	x = (x | (x <<  2)) & 0x1249249249249249ULL;
+	return x;
+}
+
+//-----------------------------------------------------------------------------
+// Morton (Z-order) key: the bits of the coordinates are interleaved, with the 
+// first coordinate providing the most significant bit
+static uint64_t morton_key(const uint32_t X[3])
+{
+	return (spread_bits(X[0]) << 2) | (spread_bits(X[1]) << 1) | spread_bits(X[2]);
+}
+
+//-----------------------------------------------------------------------------
+// Hilbert key. The coordinates are first converted to the "transposed" Hilbert
+// index, using the algorithm of J. Skilling, "Programming the Hilbert curve", 
+// AIP Conf. Proc. 707 (2004). Interleaving the transposed form gives the index.
+static uint64_t hilbert_key(const uint32_t X0[3])
+{
+	uint32_t X[3] = { X0[0], X0[1], X0[2] };
+	const uint32_t M = 1u << (SFC_BITS - 1);
+
+	// inverse undo
+	for (uint32_t Q = M; Q > 1; Q >>= 1)
+	{
+		uint32_t P = Q - 1;
+		for (int i = 0; i < 3; ++i)
+		{
+			if (X[i] & Q) X[0] ^= P;
+			else
+			{
+				uint32_t t = (X[0] ^ X[i]) & P;
+				X[0] ^= t;
+				X[i] ^= t;
+			}
+		}
+	}
+
+	// Gray encode
+	for (int i = 1; i < 3; ++i) X[i] ^= X[i - 1];
+	uint32_t t = 0;
+	for (uint32_t Q = M; Q > 1; Q >>= 1) if (X[2] & Q) t ^= Q - 1;
+	for (int i = 0; i < 3; ++i) X[i] ^= t;
+
+	return morton_key(X);
+}
+
+//-----------------------------------------------------------------------------
+FESpaceFillingCurve::FESpaceFillingCurve(int curve) : m_curve(curve)
+{
+
+}
+
+//-----------------------------------------------------------------------------
+void FESpaceFillingCurve::Apply(const vector<vec3d>& r, vector<int>& P)
+{
+	int N = (int)r.size();
+	P.resize(N);
+	for (int i = 0; i < N; ++i) P[i] = i;
+	if ((N < 2) || (m_curve == NONE)) return;
+
+	// find the bounding box
+	vec3d r0 = r[0], r1 = r[0];
+	for (int i = 1; i < N; ++i)
+	{
+		const vec3d& ri = r[i];
+		if (ri.x < r0.x) r0.x = ri.x; if (ri.x > r1.x) r1.x = ri.x;
+		if (ri.y < r0.y) r0.y = ri.y; if (ri.y > r1.y) r1.y = ri.y;
+		if (ri.z < r0.z) r0.z = ri.z; if (ri.z > r1.z) r1.z = ri.z;
+	}
+
+	// use the same scale on all axes so that the curve is not distorted
+	double L = r1.x - r0.x;
+	if (r1.y - r0.y > L) L = r1.y - r0.y;
+	if (r1.z - r0.z > L) L = r1.z - r0.z;
+	if (L <= 0.0) return;
+	const double s = (double)((1u << SFC_BITS) - 1) / L;
+
+	// calculate the keys
+	vector< pair<uint64_t, int> > key(N);
+	for (int i = 0; i < N; ++i)
+	{
+		const vec3d& ri = r[i];
+		uint32_t X[3];
+		X[0] = (uint32_t)((ri.x - r0.x)*s);
+		X[1] = (uint32_t)((ri.y - r0.y)*s);
+		X[2] = (uint32_t)((ri.z - r0.z)*s);
+		key[i].first = (m_curve == MORTON ? morton_key(X) : hilbert_key(X));
+		key[i].second = i;
+	}
+
+	// sort along the curve (ties are resolved by the original index)
+	sort(key.begin(), key.end());
+	for (int i = 0; i < N; ++i) P[i] = key[i].second;
+}
+
+//-----------------------------------------------------------------------------
+void FESpaceFillingCurve::Apply(FEMesh& mesh, vector<int>& P)
+{
+	int NN = mesh.Nodes();
+	vector<vec3d> r(NN);
+	for (int i = 0; i < NN; ++i) r[i] = mesh.Node(i).m_r0;
+	Apply(r, P);
+}
+
+//-----------------------------------------------------------------------------
+void FESpaceFillingCurve::ReorderElements(FEMesh& mesh, const vector<FESurface*>& surfaces)
+{
+	if (m_curve == NONE) return;
+
+	// collect all the surfaces (without duplicates)
+	vector<FESurface*> surf;
+	for (int i = 0; i < mesh.Surfaces(); ++i) surf.push_back(&mesh.Surface(i));
+	for (FESurface* ps : surfaces)
+	{
+		if (ps && (find(surf.begin(), surf.end(), ps) == surf.end())) surf.push_back(ps);
+	}
+
+	// The surfaces may already reference the domain elements, so we store
+	// the IDs of these elements and restore the pointers afterwards.
+	vector< vector<int> > surfElem(surf.size());
+	for (size_t n = 0; n < surf.size(); ++n)
+	{
+		FESurface& s = *surf[n];
+		vector<int>& id = surfElem[n];
+		id.resize(2 * s.Elements());
+		for (int i = 0; i < s.Elements(); ++i)
+		{
+			FESurfaceElement& el = s.Element(i);
+			id[2 * i    ] = (el.m_elem[0] ? el.m_elem[0]->GetID() : -1);
+			id[2 * i + 1] = (el.m_elem[1] ? el.m_elem[1]->GetID() : -1);
+		}
+	}
+
+	// reorder the solid domains
+	vector<vec3d> rc;
+	vector<int> P;
+	for (int n = 0; n < mesh.Domains(); ++n)
+	{
+		FESolidDomain* dom = dynamic_cast<FESolidDomain*>(&mesh.Domain(n));
+		if ((dom == nullptr) || (dom->Elements() < 2)) continue;
+
+		int NE = dom->Elements();
+		rc.resize(NE);
+		for (int i = 0; i < NE; ++i)
+		{
+			FESolidElement& el = dom->Element(i);
+			int neln = el.Nodes();
+			vec3d c(0, 0, 0);
+			for (int j = 0; j < neln; ++j) c += mesh.Node(el.m_node[j]).m_r0;
+			rc[i] = c / (double)neln;
+		}
+
+		Apply(rc, P);
+		dom->PermuteElements(P);
+	}
+
+	// the element lookup table holds pointers to the elements
+	mesh.RebuildLUT();
+
+	// restore the surface elements' pointers
+	for (size_t n = 0; n < surf.size(); ++n)
+	{
+		FESurface& s = *surf[n];
+		const vector<int>& id = surfElem[n];
+		for (int i = 0; i < s.Elements(); ++i)
+		{
+			FESurfaceElement& el = s.Element(i);
+			el.m_elem[0] = (id[2 * i    ] >= 0 ? mesh.FindElementFromID(id[2 * i    ]) : nullptr);
+			el.m_elem[1] = (id[2 * i + 1] >= 0 ? mesh.FindElementFromID(id[2 * i + 1]) : nullptr);
+		}
+	}
+}
@@ -0,0 +1,71 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "fecore_api.h"
+#include "vec3d.h"
+#include <vector>
+
+class FEMesh;
+class FESurface;
+
+//-----------------------------------------------------------------------------
+//! This class calculates orderings of the nodes and elements of a mesh along
+//! a space-filling curve. Entities that are close in space end up close in
+//! the ordering, which improves the memory locality of the element loops and
+//! of the assembly (as opposed to FENodeReorder, which minimizes bandwidth).
+//! The coordinates are quantized on a 2^21 grid per axis so that the curve 
+//! index fits in 64 bits.
+class FECORE_API FESpaceFillingCurve
+{
+public:
+	enum CurveType {
+		NONE,
+		HILBERT,
+		MORTON
+	};
+
+public:
+	FESpaceFillingCurve(int curve = HILBERT);
+
+	//! calculates the permutation that sorts the points along the curve
+	//! (i.e. P[i] is the index of the i-th point along the curve)
+	void Apply(const std::vector<vec3d>& r, std::vector<int>& P);
+
+	//! calculates the permutation of the mesh nodes
+	void Apply(FEMesh& mesh, std::vector<int>& P);
+
+	//! reorders the elements of the solid domains along the curve of the 
+	//! element centroids. This must be called before the mesh is initialized.
+	//! The element references of the mesh' surfaces and of the additional 
+	//! surfaces that are passed in (e.g. contact surfaces) are updated.
+	void ReorderElements(FEMesh& mesh, const std::vector<FESurface*>& surfaces = std::vector<FESurface*>());
+
+private:
+	int	m_curve;
+};
@@ -2257,7 +2257,7 @@ void FESurface::LoadVector(FEGlobalVector& R, const FEDofList& dofList, bool bre
 
 			double* H = el.H(order, n);
 			double* Hr = el.Gr(order, n);
-			double* Hs = el.Gr(order, n);
+			double* Hs = el.Gs(order, n);
 
 			// put it all together
 			for (int j = 0; j<neln; ++j)
@@ -34,6 +34,9 @@ SOFTWARE.*/
 #include "FENodeSet.h"
 #include "FEDofList.h"
 #include "FESurfaceElement.h"
+#include "FEGlobalVector.h"
+#include "FELinearSystem.h"
+#include "fixed_matrix.h"
 
 //-----------------------------------------------------------------------------
 class FEMesh;
@@ -70,6 +73,13 @@ typedef std::function<void(FESurfaceMaterialPoint& mp, const FESurfaceDofShape&
 
 typedef std::function<void(FESurfaceMaterialPoint& mp, const FESurfaceDofShape& node_a, const FESurfaceDofShape& node_b, matrix& val)> FESurfaceMatrixIntegrand;
 
+// The templated versions of FESurface::LoadVector and LoadStiffness take the
+// integrand as a template argument so that it can be inlined. The number of
+// degrees of freedom per node is fixed at compile time and the integrands have
+// the following signatures:
+//   void(FESurfaceMaterialPoint& mp, const FESurfaceDofShape& node_a, double* val)
+//   void(FESurfaceMaterialPoint& mp, const FESurfaceDofShape& node_a, const FESurfaceDofShape& node_b, fixed_matrix<NA, NB>& val)
+
 //-----------------------------------------------------------------------------
 //! Surface mesh
 
@@ -284,6 +294,12 @@ public:
 		FESurfaceMatrixIntegrand f	// the matrix function to evaluate
 	);
 
+	//! Evaluate a load vector with an inlined integrand (see comments above)
+	template <int NDOF, class F> void LoadVector(FEGlobalVector& R, const FEDofList& dofList, bool breference, F f);
+
+	//! Evaluate the stiffness matrix of a load with an inlined integrand (see comments above)
+	template <int NA, int NB, class F> void LoadStiffness(FELinearSystem& LS, const FEDofList& dofList_a, const FEDofList& dofList_b, F f);
+
 public:
 	void CreateMaterialPointData();
     
@@ -294,3 +310,150 @@ protected:
     double                      m_alpha;    //!< intermediate time fraction
 	bool						m_bshellb;	//!< true if this surface is the bottom of a shell domain
 };
+
+//-----------------------------------------------------------------------------
+template <int NDOF, class F> void FESurface::LoadVector(FEGlobalVector& R, const FEDofList& dofList, bool breference, F f)
+{
+	assert(dofList.Size() == NDOF);
+	int order = (NDOF == 1 ? dofList.InterpolationOrder(0) : -1);
+
+	vector<double> fe;
+	vector<int> lm;
+	vec3d re[FEElement::MAX_NODES];
+	double G[NDOF];
+	FESurfaceDofShape dof_a;
+
+	int NE = Elements();
+	for (int i = 0; i < NE; ++i)
+	{
+		FESurfaceElement& el = Element(i);
+
+		// init the element vector
+		int neln = el.ShapeFunctions(order);
+		fe.assign(NDOF * neln, 0.0);
+
+		// get the nodal coordinates
+		if (breference)
+			GetReferenceNodalCoordinates(el, re);
+		else
+			GetNodalCoordinates(el, re);
+
+		// calculate element vector
+		double* w = el.GaussWeights();
+		int nint = el.GaussPoints();
+		for (int n = 0; n < nint; ++n)
+		{
+			FESurfaceMaterialPoint& pt = static_cast<FESurfaceMaterialPoint&>(*el.GetMaterialPoint(n));
+
+			// kinematics at integration points
+			pt.dxr = el.eval_deriv1(re, n);
+			pt.dxs = el.eval_deriv2(re, n);
+			pt.m_shape = el.H(n);
+
+			double* H = el.H(order, n);
+			double* Hr = el.Gr(order, n);
+			double* Hs = el.Gs(order, n);
+
+			for (int j = 0; j < neln; ++j)
+			{
+				dof_a.index = j;
+				dof_a.shape = H[j];
+				dof_a.shape_deriv_r = Hr[j];
+				dof_a.shape_deriv_s = Hs[j];
+
+				f(pt, dof_a, G);
+				for (int k = 0; k < NDOF; ++k) fe[NDOF * j + k] += G[k] * w[n];
+			}
+		}
+
+		// assemble into global vector
+		UnpackLM(el, dofList, lm);
+		R.Assemble(el.m_node, lm, fe);
+	}
+}
+
+//-----------------------------------------------------------------------------
+template <int NA, int NB, class F> void FESurface::LoadStiffness(FELinearSystem& LS, const FEDofList& dofList_a, const FEDofList& dofList_b, F f)
+{
+	assert((dofList_a.Size() == NA) && (dofList_b.Size() == NB));
+	int order_a = (NA == 1 ? dofList_a.InterpolationOrder(0) : -1);
+	int order_b = (NB == 1 ? dofList_b.InterpolationOrder(0) : -1);
+
+	FEElementMatrix ke;
+	fixed_matrix<NA, NB> kab;
+	vec3d rt[FEElement::MAX_NODES];
+	FESurfaceDofShape dof_a, dof_b;
+
+	int NE = Elements();
+	for (int m = 0; m < NE; ++m)
+	{
+		FESurfaceElement& el = Element(m);
+
+		int neln = el.Nodes();
+		int nn_a = el.ShapeFunctions(order_a);
+		int nn_b = el.ShapeFunctions(order_b);
+
+		ke.SetNodes(el.m_node);
+		ke.resize(NA * nn_a, NB * nn_b);
+		ke.zero();
+
+		// nodal coordinates
+		GetNodalCoordinates(el, rt);
+
+		// repeat over integration points
+		double* w = el.GaussWeights();
+		int nint = el.GaussPoints();
+		for (int n = 0; n < nint; ++n)
+		{
+			FESurfaceMaterialPoint& pt = static_cast<FESurfaceMaterialPoint&>(*el.GetMaterialPoint(n));
+
+			// tangents at integration point
+			double* Gr = el.Gr(n);
+			double* Gs = el.Gs(n);
+			pt.dxr = vec3d(0, 0, 0);
+			pt.dxs = vec3d(0, 0, 0);
+			for (int i = 0; i < neln; ++i)
+			{
+				pt.dxr += rt[i] * Gr[i];
+				pt.dxs += rt[i] * Gs[i];
+			}
+
+			double* Ha = el.H(order_a, n);
+			double* Gra = el.Gr(order_a, n);
+			double* Gsa = el.Gs(order_a, n);
+			double* Hb = el.H(order_b, n);
+			double* Grb = el.Gr(order_b, n);
+			double* Gsb = el.Gs(order_b, n);
+
+			for (int i = 0; i < nn_a; ++i)
+			{
+				dof_a.index = i;
+				dof_a.shape = Ha[i];
+				dof_a.shape_deriv_r = Gra[i];
+				dof_a.shape_deriv_s = Gsa[i];
+
+				for (int j = 0; j < nn_b; ++j)
+				{
+					dof_b.index = j;
+					dof_b.shape = Hb[j];
+					dof_b.shape_deriv_r = Grb[j];
+					dof_b.shape_deriv_s = Gsb[j];
+
+					kab.zero();
+					f(pt, dof_a, dof_b, kab);
+
+					for (int k = 0; k < NA; ++k)
+					{
+						double* kek = ke[NA*i + k] + NB*j;
+						for (int l = 0; l < NB; ++l) kek[l] += kab(k, l) * w[n];
+					}
+				}
+			}
+		}
+
+		// assemble element matrix in global stiffness matrix
+		UnpackLM(el, dofList_a, ke.RowIndices());
+		UnpackLM(el, dofList_b, ke.ColumnsIndices());
+		LS.Assemble(ke);
+	}
+}
@@ -0,0 +1,148 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FETaskList.h"
+#include "FEDomain.h"
+#include "FEBodyLoad.h"
+#include "FESurfaceLoad.h"
+#include "FESurfacePairConstraint.h"
+#include "FESurface.h"
+#include "sys.h"
+#include <algorithm>
+#include <exception>
+
+//-----------------------------------------------------------------------------
+FETaskList::FETaskList(bool bparallel) : m_bparallel(bparallel)
+{
+}
+
+//-----------------------------------------------------------------------------
+void FETaskList::AddTask(std::function<void()> f, double cost)
+{
+	Task t;
+	t.f = f;
+	t.cost = (cost > 0.0 ? cost : 0.0);
+	m_task.push_back(t);
+}
+
+//-----------------------------------------------------------------------------
+void FETaskList::Run()
+{
+	// we swap the tasks out first, so that the list is cleared even if a task throws
+	std::vector<Task> tasks;
+	tasks.swap(m_task);
+	const int N = (int)tasks.size();
+	if (N == 0) return;
+
+	const int nt = omp_get_max_threads();
+	if ((m_bparallel == false) || (nt == 1) || (N == 1) || omp_in_parallel())
+	{
+		for (int i = 0; i < N; ++i) tasks[i].f();
+		return;
+	}
+
+	// A task that takes at least a thread's share of the total work cannot be
+	// balanced against the others, so we run it by itself.
+	double total = 0.0;
+	for (int i = 0; i < N; ++i) total += tasks[i].cost;
+	const double heavy = total / nt;
+
+	std::vector<int> light;
+	for (int i = 0; i < N; ++i)
+	{
+		if ((tasks[i].cost >= heavy) && (tasks[i].cost > 0.0)) tasks[i].f();
+		else light.push_back(i);
+	}
+
+	if (light.size() == 1) { tasks[light[0]].f(); return; }
+	if (light.empty()) return;
+
+	// The remaining tasks are dispatched largest first, which keeps the
+	// imbalance at the end small.
+	std::stable_sort(light.begin(), light.end(), [&](int a, int b) {
+		return tasks[a].cost > tasks[b].cost;
+	});
+
+	// exceptions cannot leave a parallel region, so we catch them here
+	std::exception_ptr err = nullptr;
+	const int NL = (int)light.size();
+	#pragma omp parallel shared(tasks, light, err)
+	{
+		#pragma omp single
+		{
+			for (int n = 0; n < NL; ++n)
+			{
+				int i = light[n];
+				#pragma omp task firstprivate(i) shared(tasks, err)
+				{
+					try {
+						tasks[i].f();
+					}
+					catch (...)
+					{
+						#pragma omp critical (FETaskList_error)
+						if (err == nullptr) err = std::current_exception();
+					}
+				}
+			}
+		}
+	}
+
+	if (err) std::rethrow_exception(err);
+}
+
+//-----------------------------------------------------------------------------
+double FETaskCost(FEDomain& dom)
+{
+	return (double)dom.Elements();
+}
+
+//-----------------------------------------------------------------------------
+double FETaskCost(FEBodyLoad& load)
+{
+	double cost = 0.0;
+	for (int i = 0; i < load.Domains(); ++i) cost += load.Domain(i)->Elements();
+	return cost;
+}
+
+//-----------------------------------------------------------------------------
+double FETaskCost(FESurfaceLoad& load)
+{
+	return (double)load.GetSurface().Elements();
+}
+
+//-----------------------------------------------------------------------------
+double FETaskCost(FESurfacePairConstraint& pc)
+{
+	FESurface* ps = pc.GetPrimarySurface();
+	FESurface* ss = pc.GetSecondarySurface();
+	double cost = 0.0;
+	if (ps) cost += ps->Elements();
+	if (ss) cost += ss->Elements();
+	return cost;
+}
@@ -0,0 +1,84 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include <vector>
+#include <functional>
+#include "fecore_api.h"
+
+class FEDomain;
+class FEBodyLoad;
+class FESurfaceLoad;
+class FESurfacePairConstraint;
+
+//-----------------------------------------------------------------------------
+//! A list of independent work items (e.g. the contributions of domains, loads
+//! and contact interfaces to the global residual or stiffness matrix).
+//! Each task is given an estimate of its cost (e.g. its number of elements).
+//! When the list is run in parallel, tasks that are expensive enough to keep all
+//! threads busy by themselves are run one after another so that they can use
+//! their own (element-level) parallel loops. The remaining tasks are executed
+//! concurrently as OpenMP tasks, starting with the most expensive ones. Inside
+//! such a task, nested parallel loops run on a single thread.
+//! Tasks must assemble through thread-safe interfaces (FEGlobalVector and
+//! FELinearSystem are). When the list is not run in parallel, the tasks are
+//! executed in the order they were added.
+class FECORE_API FETaskList
+{
+	struct Task
+	{
+		std::function<void()>	f;		//!< the work to do
+		double					cost;	//!< estimated cost
+	};
+
+public:
+	FETaskList(bool bparallel = false);
+
+	//! enable or disable concurrent execution
+	void SetParallel(bool b) { m_bparallel = b; }
+
+	//! add a task
+	void AddTask(std::function<void()> f, double cost = 1.0);
+
+	//! number of tasks
+	int Tasks() const { return (int)m_task.size(); }
+
+	//! execute all tasks and clear the list.
+	//! If a task throws, the first exception is rethrown after all tasks are done.
+	void Run();
+
+private:
+	std::vector<Task>	m_task;
+	bool				m_bparallel;
+};
+
+//-----------------------------------------------------------------------------
+//! Cost estimates of model components for scheduling (number of elements)
+FECORE_API double FETaskCost(FEDomain& dom);
+FECORE_API double FETaskCost(FEBodyLoad& load);
+FECORE_API double FETaskCost(FESurfaceLoad& load);
+FECORE_API double FETaskCost(FESurfacePairConstraint& pc);
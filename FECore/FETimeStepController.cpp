@@ -259,6 +259,35 @@ void FETimeStepController::AutoTimeStep(int niter)
 	m_step->m_dt = dtn;
 }
 
+//-----------------------------------------------------------------------------
+//! The next time step starts from a different time than the one it was calculated for,
+//! so the must-points and the end of the step have to be checked again.
+void FETimeStepController::TimeAdvanced()
+{
+	FEModel* fem = m_step->GetFEModel();
+	double t = fem->GetCurrentTime();
+
+	// start from the time step size before the must-point adjustment
+	double dtn = m_dtp;
+	if (dtn < m_dtmin) dtn = m_dtmin;
+
+	// find the next must-point after the new time
+	m_nmust = -1;
+	if (m_must_points.empty() == false)
+	{
+		const double eps = m_step->m_tend*1e-12;
+		const int points = (int)m_must_points.size();
+		m_next_must = 0;
+		while ((m_next_must < points) && (m_must_points[m_next_must] <= t + eps)) m_next_must++;
+		dtn = CheckMustPoints(t, dtn);
+	}
+
+	// make sure we are not exceeding the final time
+	if (t + dtn > m_step->m_tend) dtn = m_step->m_tend - t;
+
+	m_step->m_dt = dtn;
+}
+
 //-----------------------------------------------------------------------------
 //! This function makes sure that no must points are passed. It returns an
 //! updated value (less than dt) if t + dt would pass a must point. Otherwise
@@ -64,6 +64,9 @@ public:
 	//! Adjust for must points
 	double CheckMustPoints(double t, double dt);
 
+	//! The time was advanced without solving (see FEAnalysis::AdvanceTime)
+	void TimeAdvanced();
+
 private:
 	FEAnalysis*	m_step;
 
@@ -28,7 +28,9 @@ SOFTWARE.*/
 
 #pragma once
 #include "matrix.h"
+#include "FESolidDomain.h"
 #include <functional>
+#include <utility>
 
 //-----------------------------------------------------------------------------
 // The purpose of this file is to explore mechanisms for evaluating the integrals 
@@ -62,3 +64,132 @@ FECORE_API void AssembleSolidDomain(FESolidDomain& dom, FELinearSystem& ls, std:
 FECORE_API void AssembleSolidDomain(FESolidDomain& dom, FEGlobalVector& R, std::function<void(FESolidElement& el, vector<double>& fe)> elementIntegrand);
 
 FECORE_API void IntegrateSolidDomain(FESolidDomain& dom, FELinearSystem& ls, std::function<void(FEMaterialPoint& mp, matrix& ke)> elementIntegrand);
+
+//-----------------------------------------------------------------------------
+// Templated versions of the integrators above. These take the integrand as a
+// template argument so that the calls can be inlined, and they reuse the element
+// buffers across elements. The return types restrict these overloads to callables
+// with the matching signature.
+
+//-----------------------------------------------------------------------------
+template <class F> auto IntegrateBDB(FESolidDomain& dom, FESolidElement& el, F D, matrix& ke)
+	-> decltype(mat3ds(D(std::declval<const FEMaterialPoint&>())), void())
+{
+	vec3d G[FEElement::MAX_NODES];
+
+	const double *gw = el.GaussWeights();
+	int ne = el.Nodes();
+	int ni = el.GaussPoints();
+	for (int n = 0; n<ni; ++n)
+	{
+		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+
+		// calculate jacobian and D at this point
+		double detJt = dom.ShapeGradient(el, n, G);
+		mat3ds Dn = D(mp);
+
+		// form the matrix
+		for (int i = 0; i<ne; ++i)
+		{
+			vec3d DGi = Dn*G[i];
+			for (int j = 0; j<ne; ++j)
+			{
+				ke[i][j] += (DGi * G[j])*(detJt*gw[n]);
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+template <class F> auto AssembleSolidDomain(FESolidDomain& dom, FELinearSystem& ls, F elementIntegrand)
+	-> decltype(elementIntegrand(std::declval<FESolidElement&>(), std::declval<matrix&>()), void())
+{
+	int NE = dom.Elements();
+#pragma omp parallel shared(NE)
+	{
+		FEElementMatrix ke;
+		vector<int> lm;
+
+#pragma omp for
+		for (int i = 0; i<NE; ++i)
+		{
+			FESolidElement& el = dom.Element(i);
+			int ndofs = dom.GetElementDofs(el);
+
+			// build the element stiffness matrix
+			ke.resize(ndofs, ndofs);
+			ke.zero();
+			elementIntegrand(el, ke);
+
+			// assemble into global matrix
+			dom.UnpackLM(el, lm);
+			ke.SetNodes(el.m_node);
+			ke.SetIndices(lm);
+			ls.Assemble(ke);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+template <class F> auto AssembleSolidDomain(FESolidDomain& dom, FEGlobalVector& R, F elementIntegrand)
+	-> decltype(elementIntegrand(std::declval<FESolidElement&>(), std::declval<vector<double>&>()), void())
+{
+	vector<double> fe;
+	vector<int> lm;
+
+	int NE = dom.Elements();
+	for (int i = 0; i < NE; ++i)
+	{
+		FESolidElement& el = dom.Element(i);
+		int ndofs = dom.GetElementDofs(el);
+
+		// get element contribution
+		fe.assign(ndofs, 0.0);
+		elementIntegrand(el, fe);
+
+		// assemble into RHS
+		dom.UnpackLM(el, lm);
+		R.Assemble(lm, fe);
+	}
+}
+
+//-----------------------------------------------------------------------------
+template <class F> auto IntegrateSolidDomain(FESolidDomain& dom, FELinearSystem& ls, F elementIntegrand)
+	-> decltype(elementIntegrand(std::declval<FEMaterialPoint&>(), std::declval<matrix&>()), void())
+{
+	int NE = dom.Elements();
+#pragma omp parallel shared(NE)
+	{
+		FEElementMatrix ke;
+		matrix kn;
+		vector<int> lm;
+
+#pragma omp for
+		for (int i = 0; i<NE; ++i)
+		{
+			FESolidElement& el = dom.Element(i);
+			int ndofs = dom.GetElementDofs(el);
+
+			// build the element stiffness matrix
+			ke.resize(ndofs, ndofs);
+			ke.zero();
+			kn.resize(ndofs, ndofs);
+
+			// loop over all integration points
+			int nint = el.GaussPoints();
+			double* w = el.GaussWeights();
+			for (int n = 0; n < nint; ++n)
+			{
+				FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+				elementIntegrand(mp, kn);
+				ke.adds(kn, w[n]);
+			}
+
+			// assemble into global matrix
+			dom.UnpackLM(el, lm);
+			ke.SetNodes(el.m_node);
+			ke.SetIndices(lm);
+			ls.Assemble(ke);
+		}
+	}
+}
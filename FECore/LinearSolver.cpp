@@ -110,6 +110,17 @@ void LinearSolver::Destroy()
 
 }
 
+//-----------------------------------------------------------------------------
+bool LinearSolver::BackSolveMulti(double* x, double* y, int nrhs, int ldy)
+{
+	for (int k = 0; k < nrhs; ++k)
+	{
+		size_t offset = (size_t)k*ldy;
+		if (BackSolve(x + offset, y + offset) == false) return false;
+	}
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 //! helper function for when this solver is used as a preconditioner
 bool LinearSolver::mult_vector(double* x, double* y)
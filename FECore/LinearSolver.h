@@ -83,6 +83,11 @@ public:
 	//! do a backsolve, i.e. solve for a right-hand side vector y (must be overridden)
 	virtual bool BackSolve(double* x, double* y) = 0;
 
+	//! do a backsolve for nrhs right-hand sides at once. The right-hand sides and
+	//! the solutions are stored one after another, i.e. the k-th vector starts at y + k*ldy.
+	//! The default implementation solves for one right-hand side at a time.
+	virtual bool BackSolveMulti(double* x, double* y, int nrhs, int ldy);
+
 	//! Do any cleanup
 	virtual void Destroy();
 
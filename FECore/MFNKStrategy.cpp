@@ -0,0 +1,113 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "MFNKStrategy.h"
+#include "FENewtonSolver.h"
+#include "EBEMatrix.h"
+#include "FEException.h"
+#include "LinearSolver.h"
+#include "log.h"
+
+BEGIN_FECORE_CLASS(MFNKStrategy, FENewtonStrategy)
+	ADD_PARAMETER(m_bcache, "cache_elements");
+	ADD_PARAMETER(m_bdiag , "diagonal_pc");
+END_FECORE_CLASS();
+
+MFNKStrategy::MFNKStrategy(FEModel* fem) : FENewtonStrategy(fem)
+{
+	m_bcache = false;
+	m_bdiag = false;
+
+	m_plinsolve = nullptr;
+	m_A = nullptr;
+	m_PC = nullptr;
+}
+
+MFNKStrategy::~MFNKStrategy()
+{
+	delete m_PC;
+}
+
+//! New initialization method
+bool MFNKStrategy::Init()
+{
+	if (m_pns == nullptr) return false;
+	m_plinsolve = m_pns->GetLinearSolver();
+	return true;
+}
+
+SparseMatrix* MFNKStrategy::CreateSparseMatrix(Matrix_Type mtype)
+{
+	// The matrix-free operator can only be used with iterative solvers
+	IterativeLinearSolver* ls = dynamic_cast<IterativeLinearSolver*>(m_pns->m_plinsolve);
+	if (ls == nullptr)
+	{
+		feLogError("The MFNK strategy requires an iterative linear solver.");
+		return nullptr;
+	}
+
+	// Preconditioners of the linear solver need an assembled matrix, so they can't be used.
+	if (ls->GetRightPreconditioner())
+	{
+		feLogError("The MFNK strategy cannot be used with a right preconditioner.");
+		return nullptr;
+	}
+	if (ls->GetLeftPreconditioner() && (ls->GetLeftPreconditioner() != m_PC))
+	{
+		feLogWarning("The preconditioner of the linear solver is replaced by a block-Jacobi preconditioner.");
+	}
+
+	// the matrix is owned by the FEGlobalMatrix
+	m_A = new EBEMatrix(m_pns, (mtype == REAL_SYMMETRIC), m_bcache);
+	ls->SetSparseMatrix(m_A);
+
+	if (m_PC == nullptr) m_PC = new EBEBlockJacobi(GetFEModel());
+	m_PC->SetDiagonalOnly(m_bdiag);
+	m_PC->SetSparseMatrix(m_A);
+	ls->SetLeftPreconditioner(m_PC);
+
+	return m_A;
+}
+
+//! perform a quasi-Newton udpate
+bool MFNKStrategy::Update(double s, vector<double>& ui, vector<double>& R0, vector<double>& R1)
+{
+	// Nothing to do here. When the element matrices are not cached, the tangent is always
+	// evaluated at the current state and only the preconditioner is reused.
+	return true;
+}
+
+//! solve the equations
+void MFNKStrategy::SolveEquations(vector<double>& x, vector<double>& b)
+{
+	if (m_plinsolve->BackSolve(x, b) == false)
+	{
+		throw LinearSolverFailed();
+	}
+}
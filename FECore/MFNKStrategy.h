@@ -0,0 +1,69 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "FENewtonStrategy.h"
+#include "SparseMatrix.h"
+
+class EBEMatrix;
+class EBEBlockJacobi;
+
+//-----------------------------------------------------------------------------
+// Implements a matrix-free Newton-Krylov strategy. The global stiffness matrix is
+// not assembled. Instead, the iterative linear solver multiplies with the tangent
+// element by element (see EBEMatrix) and is preconditioned with a block-Jacobi 
+// preconditioner that is assembled from the nodal diagonal blocks.
+class MFNKStrategy : public FENewtonStrategy
+{
+public:
+	MFNKStrategy(FEModel* fem);
+	~MFNKStrategy();
+
+	//! New initialization method
+	bool Init() override;
+
+	//! initialize the linear system
+	SparseMatrix* CreateSparseMatrix(Matrix_Type mtype) override;
+
+	//! perform a quasi-Newton udpate (does nothing)
+	bool Update(double s, vector<double>& ui, vector<double>& R0, vector<double>& R1) override;
+
+	//! solve the equations
+	void SolveEquations(vector<double>& x, vector<double>& b) override;
+
+private:
+	bool	m_bcache;		//!< cache the element matrices instead of evaluating them for each product
+	bool	m_bdiag;		//!< use only the diagonal for the preconditioner
+
+public:
+	LinearSolver*	m_plinsolve;		//!< pointer to linear solver
+	EBEMatrix*		m_A;
+	EBEBlockJacobi*	m_PC;
+
+	DECLARE_FECORE_CLASS();
+};
@@ -87,6 +87,19 @@ double NodeDataRecord::Evaluate(int item, int ndata)
 	return m_Data[ndata]->value(nnode);
 }
 
+//-----------------------------------------------------------------------------
+// The nodes are evaluated in parallel.
+void NodeDataRecord::EvaluateItems(std::vector<double>& data)
+{
+	const int N = (int)m_item.size();
+	const int nd = Size();
+	#pragma omp parallel for
+	for (int i = 0; i < N; ++i)
+	{
+		for (int j = 0; j < nd; ++j) data[j*N + i] = Evaluate(m_item[i], j);
+	}
+}
+
 //-----------------------------------------------------------------------------
 void NodeDataRecord::SelectAllItems()
 {
@@ -58,6 +58,9 @@ public:
 	void SetNodeSet(FENodeSet* pns);
 	int Size() const;
 
+protected:
+	void EvaluateItems(std::vector<double>& data) override;
+
 private:
 	vector<FENodeLogData*>	m_Data;
 };
@@ -95,6 +95,9 @@ public: // functions to be overwritten in derived classes
 	//! scale matrix
 	virtual void scale(const vector<double>& L, const vector<double>& R);
 
+	//! Matrix-free operators don't store any entries and don't need a sparsity pattern.
+	virtual bool IsMatrixFree() const { return false; }
+
 public:
 	//! multiply with vector
 	bool mult_vector(double* x, double* r) override { assert(false); return false; }
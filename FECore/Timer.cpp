@@ -31,6 +31,9 @@ SOFTWARE.*/
 #include <stdio.h>
 #include <time.h>
 #include <string>
+#ifndef WIN32
+#include <chrono>
+#endif
 
 //-----------------------------------------------------------------------------
 // Define the data types used for measuring times.
@@ -38,7 +41,7 @@ SOFTWARE.*/
 #ifdef WIN32
 #define TIMER_TYPE clock_t
 #else
-#define TIMER_TYPE	time_t
+#define TIMER_TYPE	std::chrono::steady_clock::time_point
 #endif
 
 //-----------------------------------------------------------------------------
@@ -52,8 +55,10 @@ double sys_diff_time(TIMER_TYPE& t1, TIMER_TYPE& t0);
 void sys_get_time(TIMER_TYPE& t) { t = clock(); }
 double sys_diff_time(TIMER_TYPE& t1, TIMER_TYPE& t0) { return (double) (t1 - t0) / CLOCKS_PER_SEC; }
 #else
-void sys_get_time(TIMER_TYPE& t) { time(&t); }
-double sys_diff_time(TIMER_TYPE& t1, TIMER_TYPE& t0) { return difftime(t1, t0); }
+// NOTE: time() only has a resolution of one second, which is too coarse for timing
+//       individual solver phases, so we use a monotonic clock instead.
+void sys_get_time(TIMER_TYPE& t) { t = std::chrono::steady_clock::now(); }
+double sys_diff_time(TIMER_TYPE& t1, TIMER_TYPE& t0) { return std::chrono::duration<double>(t1 - t0).count(); }
 #endif
 
 //-----------------------------------------------------------------------------
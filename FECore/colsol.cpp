@@ -29,6 +29,9 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "math.h"
 #include "fecore_api.h"
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////
 // LINEAR SOLVER : colsol
@@ -50,10 +53,10 @@ SOFTWARE.*/
 // section 8.2, page 696 and following
 //
 
-FECORE_API void colsol_factor(int N, double* values, int* pointers)
+template <typename T> static void colsol_factor_t(int N, T* values, int* pointers)
 {
 	int i, j, r, mi, mj, mm;
-	double krj;
+	T krj;
 	int pi, pj;
 
 	// -A- factorize the matrix 
@@ -77,7 +80,7 @@ FECORE_API void colsol_factor(int N, double* values, int* pointers)
 
 			pi = pointers[i]+i;
 
-			double& kij = values[pj - i];
+			T& kij = values[pj - i];
 
 			// the next line is replaced by the piece of code between arrows
 			// where the r loop is unrolled to give this algorithm a 
@@ -111,7 +114,7 @@ FECORE_API void colsol_factor(int N, double* values, int* pointers)
 		for (i=mj; i<j; ++i) values[pj - i] /= values[ pointers[i] ];
 
 		// calculate d[j][j] value
-		double& kjj = values[ pointers[j] ];
+		T& kjj = values[ pointers[j] ];
 		for (r=mj; r<j; ++r) 
 		{
 			krj = values[pj - r];
@@ -122,7 +125,7 @@ FECORE_API void colsol_factor(int N, double* values, int* pointers)
 
 ///////////////////////////////////////////////////////////////////////////////
 
-FECORE_API void colsol_solve(int N, double* values, int* pointers, double* R)
+template <typename T> static void colsol_solve_t(int N, const T* values, int* pointers, double* R)
 {
 	int i, mi, r;
 
@@ -170,6 +173,93 @@ FECORE_API void colsol_solve(int N, double* values, int* pointers, double* R)
 	}
 }
 
+//-----------------------------------------------------------------------------
+// Back substitution for multiple right hand sides. The nrhs vectors are stored 
+// interleaved, i.e. R[i*nrhs + k] is the i-th component of the k-th vector, so 
+// that each entry of the factorization is loaded once and applied to all vectors.
+template <typename T> static void colsol_solve_block_t(int N, const T* values, int* pointers, double* R, int nrhs)
+{
+	// calculate V = L^(-T)*R vector
+	for (int i=1; i<N; ++i)
+	{
+		int mi = i+1 - pointers[i+1] + pointers[i];
+		double* Ri = R + (size_t)i*nrhs;
+		for (int r=mi; r<i; ++r)
+		{
+			const double a = values[ pointers[i] + i - r];
+			const double* Rr = R + (size_t)r*nrhs;
+			for (int k=0; k<nrhs; ++k) Ri[k] -= a*Rr[k];
+		}
+	}
+
+	// calculate Vbar = D^(-1)*V
+	for (int i=0; i<N; ++i)
+	{
+		const double d = 1.0 / values[ pointers[i] ];
+		double* Ri = R + (size_t)i*nrhs;
+		for (int k=0; k<nrhs; ++k) Ri[k] *= d;
+	}
+
+	// calculate the solution
+	for (int i=N-1; i>0; --i)
+	{
+		int mi = i+1 - pointers[i+1] + pointers[i];
+		const int pi = pointers[i] + i;
+		const double* Ri = R + (size_t)i*nrhs;
+		for (int r=mi; r<i; ++r)
+		{
+			const double a = values[ pi - r ];
+			double* Rr = R + (size_t)r*nrhs;
+			for (int k=0; k<nrhs; ++k) Rr[k] -= a*Ri[k];
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+FECORE_API void colsol_factor(int N, double* values, int* pointers)
+{
+	colsol_factor_t(N, values, pointers);
+}
+
+FECORE_API void colsol_solve(int N, double* values, int* pointers, double* R)
+{
+	colsol_solve_t(N, values, pointers, R);
+}
+
+FECORE_API void colsol_solve(int N, double* values, int* pointers, double* R, int nrhs)
+{
+	colsol_solve_block_t(N, values, pointers, R, nrhs);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Single precision versions of colsol. The factorization is done in single 
+// precision, but the back substitution accumulates in double precision.
+
+FECORE_API void colsol_factor(int N, float* values, int* pointers)
+{
+#if defined(__SSE__) || defined(_M_X64)
+	// Small entries quickly become denormal in single precision, which slows down the
+	// factorization dramatically. Since they don't matter for the factorization, we 
+	// flush them to zero.
+	unsigned int csr = _mm_getcsr();
+	_mm_setcsr(csr | 0x8040);	// FTZ | DAZ
+	colsol_factor_t(N, values, pointers);
+	_mm_setcsr(csr);
+#else
+	colsol_factor_t(N, values, pointers);
+#endif
+}
+
+FECORE_API void colsol_solve(int N, float* values, int* pointers, double* R)
+{
+	colsol_solve_t(N, values, pointers, R);
+}
+
+FECORE_API void colsol_solve(int N, float* values, int* pointers, double* R, int nrhs)
+{
+	colsol_solve_block_t(N, values, pointers, R, nrhs);
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 // This LU solver is grabbed from Numerical Recipes in C.
@@ -0,0 +1,237 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <assert.h>
+#include <math.h>
+#include "matrix.h"
+
+//-----------------------------------------------------------------------------
+//! Small dense matrix whose dimensions are known at compile time.
+//! Unlike the general purpose matrix class, the data is stored inline so
+//! that temporaries in element kernels live on the stack and no heap
+//! allocations are needed. Products with a transposed operand are offered
+//! as separate functions so that the transpose never has to be formed.
+template <int R, int C> class fixed_matrix
+{
+public:
+	enum { ROWS = R, COLS = C };
+
+public:
+	//! constructor (does not initialize the data)
+	fixed_matrix() {}
+
+	//! construct from a general matrix
+	explicit fixed_matrix(const matrix& m)
+	{
+		assert((m.rows() == R) && (m.columns() == C));
+		for (int i = 0; i<R; ++i)
+			for (int j = 0; j<C; ++j) d[i][j] = m(i, j);
+	}
+
+	//! matrix dimensions
+	int rows() const { return R; }
+	int columns() const { return C; }
+
+	//! access operators
+	double& operator () (int i, int j) { return d[i][j]; }
+	const double& operator () (int i, int j) const { return d[i][j]; }
+
+	double* operator [] (int i) { return d[i]; }
+	const double* operator [] (int i) const { return d[i]; }
+
+	//! set all entries to zero
+	void zero()
+	{
+		for (int i = 0; i<R; ++i)
+			for (int j = 0; j<C; ++j) d[i][j] = 0.0;
+	}
+
+	//! copy the entries into a general matrix (which is resized if needed)
+	void copy_to(matrix& m) const
+	{
+		if ((m.rows() != R) || (m.columns() != C)) m.resize(R, C);
+		for (int i = 0; i<R; ++i)
+			for (int j = 0; j<C; ++j) m(i, j) = d[i][j];
+	}
+
+	//! add the entries to a general matrix of the same size
+	void add_to(matrix& m) const
+	{
+		assert((m.rows() == R) && (m.columns() == C));
+		for (int i = 0; i<R; ++i)
+			for (int j = 0; j<C; ++j) m(i, j) += d[i][j];
+	}
+
+	//! set a 3x3 block starting at row i and column j
+	void set(int i, int j, const mat3d& a)
+	{
+		assert((i + 3 <= R) && (j + 3 <= C));
+		for (int k = 0; k<3; ++k)
+			for (int l = 0; l<3; ++l) d[i + k][j + l] = a(k, l);
+	}
+
+	//! add a 3x3 block starting at row i and column j
+	void add(int i, int j, const mat3d& a)
+	{
+		assert((i + 3 <= R) && (j + 3 <= C));
+		for (int k = 0; k<3; ++k)
+			for (int l = 0; l<3; ++l) d[i + k][j + l] += a(k, l);
+	}
+
+public:
+	//! matrix transpose
+	fixed_matrix<C, R> transpose() const
+	{
+		fixed_matrix<C, R> t;
+		for (int i = 0; i<R; ++i)
+			for (int j = 0; j<C; ++j) t(j, i) = d[i][j];
+		return t;
+	}
+
+	//! calculate A*B
+	template <int K> fixed_matrix<R, K> operator * (const fixed_matrix<C, K>& b) const
+	{
+		fixed_matrix<R, K> m;
+		for (int i = 0; i<R; ++i)
+			for (int j = 0; j<K; ++j)
+			{
+				double s = 0.0;
+				for (int k = 0; k<C; ++k) s += d[i][k] * b(k, j);
+				m(i, j) = s;
+			}
+		return m;
+	}
+
+	//! calculate A*B^T without forming the transpose of B
+	template <int K> fixed_matrix<R, K> mult_transpose(const fixed_matrix<K, C>& b) const
+	{
+		fixed_matrix<R, K> m;
+		for (int i = 0; i<R; ++i)
+			for (int j = 0; j<K; ++j)
+			{
+				double s = 0.0;
+				for (int k = 0; k<C; ++k) s += d[i][k] * b(j, k);
+				m(i, j) = s;
+			}
+		return m;
+	}
+
+	//! calculate A^T*B without forming the transpose of A
+	template <int K> fixed_matrix<C, K> transpose_mult(const fixed_matrix<R, K>& b) const
+	{
+		fixed_matrix<C, K> m; m.zero();
+		for (int k = 0; k<R; ++k)
+			for (int i = 0; i<C; ++i)
+			{
+				const double aki = d[k][i];
+				for (int j = 0; j<K; ++j) m(i, j) += aki * b(k, j);
+			}
+		return m;
+	}
+
+	//! arithmetic operators
+	fixed_matrix operator + (const fixed_matrix& b) const { fixed_matrix m(*this); m += b; return m; }
+	fixed_matrix operator - (const fixed_matrix& b) const { fixed_matrix m(*this); m -= b; return m; }
+	fixed_matrix operator * (double a) const { fixed_matrix m(*this); m *= a; return m; }
+
+	fixed_matrix& operator += (const fixed_matrix& b)
+	{
+		for (int i = 0; i<R; ++i)
+			for (int j = 0; j<C; ++j) d[i][j] += b.d[i][j];
+		return *this;
+	}
+
+	fixed_matrix& operator -= (const fixed_matrix& b)
+	{
+		for (int i = 0; i<R; ++i)
+			for (int j = 0; j<C; ++j) d[i][j] -= b.d[i][j];
+		return *this;
+	}
+
+	fixed_matrix& operator *= (double a)
+	{
+		for (int i = 0; i<R; ++i)
+			for (int j = 0; j<C; ++j) d[i][j] *= a;
+		return *this;
+	}
+
+	//! matrix inverse (only for square matrices)
+	//! This uses Gauss-Jordan elimination with partial pivoting.
+	fixed_matrix inverse() const
+	{
+		static_assert(R == C, "fixed_matrix::inverse requires a square matrix");
+		fixed_matrix a(*this);
+		fixed_matrix ai; ai.zero();
+		for (int i = 0; i<R; ++i) ai.d[i][i] = 1.0;
+
+		for (int k = 0; k<R; ++k)
+		{
+			// find the pivot row
+			int p = k;
+			double amax = fabs(a.d[k][k]);
+			for (int i = k + 1; i<R; ++i)
+			{
+				double ai_k = fabs(a.d[i][k]);
+				if (ai_k > amax) { amax = ai_k; p = i; }
+			}
+			assert(amax != 0.0);
+
+			// swap rows
+			if (p != k)
+			{
+				for (int j = 0; j<C; ++j)
+				{
+					double t = a.d[k][j]; a.d[k][j] = a.d[p][j]; a.d[p][j] = t;
+					t = ai.d[k][j]; ai.d[k][j] = ai.d[p][j]; ai.d[p][j] = t;
+				}
+			}
+
+			// normalize the pivot row
+			double f = 1.0 / a.d[k][k];
+			for (int j = 0; j<C; ++j) { a.d[k][j] *= f; ai.d[k][j] *= f; }
+
+			// eliminate the other rows
+			for (int i = 0; i<R; ++i)
+			{
+				if (i == k) continue;
+				double g = a.d[i][k];
+				if (g == 0.0) continue;
+				for (int j = 0; j<C; ++j)
+				{
+					a.d[i][j] -= g*a.d[k][j];
+					ai.d[i][j] -= g*ai.d[k][j];
+				}
+			}
+		}
+		return ai;
+	}
+
+private:
+	double	d[R][C];
+};
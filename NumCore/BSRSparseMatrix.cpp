@@ -0,0 +1,366 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "BSRSparseMatrix.h"
+#include <FECore/MatrixProfile.h>
+#include <FECore/matrix.h>
+#include <algorithm>
+#include <assert.h>
+
+//-----------------------------------------------------------------------------
+BSRSparseMatrix::BSRSparseMatrix(bool bsymmetric) : m_bsymm(bsymmetric)
+{
+	m_nbr = m_nbc = 0;
+}
+
+//-----------------------------------------------------------------------------
+void BSRSparseMatrix::Create(SparseMatrixProfile& mp)
+{
+	int nr = mp.Rows();
+	int nc = mp.Columns();
+	assert((m_bsymm == false) || (nr == nc));
+
+	int nbr = (nr + BS - 1) / BS;
+	int nbc = (nc + BS - 1) / BS;
+
+	// collect the block columns of each block row
+	std::vector< std::vector<int> > blockRows(nbr);
+	for (int j = 0; j<nc; ++j)
+	{
+		int bj = j / BS;
+		SparseMatrixProfile::ColumnProfile& a = mp.Column(j);
+		int n = a.size();
+		for (int k = 0; k<n; ++k)
+		{
+			int b0 = a[k].start / BS;
+			int b1 = a[k].end / BS;
+			for (int bi = b0; bi <= b1; ++bi)
+			{
+				// columns are processed in increasing order, so checking the last
+				// entry removes most of the duplicates
+				std::vector<int>& row = blockRows[bi];
+				if (row.empty() || (row.back() != bj)) row.push_back(bj);
+
+				// make sure the structure of symmetric matrices is symmetric
+				if (m_bsymm && (bi != bj)) blockRows[bj].push_back(bi);
+			}
+		}
+	}
+
+	// the diagonal blocks are always needed for square matrices
+	if (nr == nc)
+	{
+		for (int i = 0; i<nbr; ++i) blockRows[i].push_back(i);
+	}
+
+	// build the compressed structure
+	m_ptr.assign(nbr + 1, 0);
+	for (int i = 0; i<nbr; ++i)
+	{
+		std::vector<int>& row = blockRows[i];
+		std::sort(row.begin(), row.end());
+		row.erase(std::unique(row.begin(), row.end()), row.end());
+		m_ptr[i + 1] = m_ptr[i] + (int)row.size();
+	}
+
+	int nblocks = m_ptr[nbr];
+	m_col.resize(nblocks);
+	for (int i = 0; i<nbr; ++i)
+	{
+		std::vector<int>& row = blockRows[i];
+		std::copy(row.begin(), row.end(), m_col.begin() + m_ptr[i]);
+		std::vector<int>().swap(row);
+	}
+
+	m_nrow = nr;
+	m_ncol = nc;
+	m_nbr = nbr;
+	m_nbc = nbc;
+	m_nsize = nblocks*BS*BS;
+
+	// find the diagonal blocks
+	m_diag.assign(nbr, -1);
+	for (int i = 0; i<nbr; ++i) m_diag[i] = FindBlock(i, i);
+
+	// allocate values
+	m_val.assign((size_t)nblocks*BS*BS, 0.0);
+}
+
+//-----------------------------------------------------------------------------
+void BSRSparseMatrix::Zero()
+{
+	std::fill(m_val.begin(), m_val.end(), 0.0);
+}
+
+//-----------------------------------------------------------------------------
+void BSRSparseMatrix::Clear()
+{
+	std::vector<int>().swap(m_ptr);
+	std::vector<int>().swap(m_col);
+	std::vector<int>().swap(m_diag);
+	std::vector<double>().swap(m_val);
+	std::vector<double>().swap(m_xpad);
+	m_nbr = m_nbc = 0;
+	SparseMatrix::Clear();
+}
+
+//-----------------------------------------------------------------------------
+int BSRSparseMatrix::FindBlock(int bi, int bj) const
+{
+	if ((bi < 0) || (bi >= m_nbr) || m_col.empty()) return -1;
+	const int* col = m_col.data();
+	const int* p0 = col + m_ptr[bi];
+	const int* p1 = col + m_ptr[bi + 1];
+	const int* p = std::lower_bound(p0, p1, bj);
+	if ((p == p1) || (*p != bj)) return -1;
+	return (int)(p - col);
+}
+
+//-----------------------------------------------------------------------------
+// Element matrices store the dofs of a node consecutively, so neighboring columns
+// usually fall in the same block. The last block found is therefore cached.
+void BSRSparseMatrix::Assemble(const matrix& ke, const std::vector<int>& lm)
+{
+	const int N = ke.rows();
+	double* pv = m_val.data();
+	for (int i = 0; i<N; ++i)
+	{
+		int I = lm[i];
+		if (I < 0) continue;
+
+		int bi = I / BS;
+		int ri = I % BS;
+		const double* ki = ke[i];
+
+		int bjlast = -1, kb = -1;
+		for (int j = 0; j<N; ++j)
+		{
+			int J = lm[j];
+			if (J < 0) continue;
+
+			int bj = J / BS;
+			if (bj != bjlast) { kb = FindBlock(bi, bj); bjlast = bj; }
+			assert(kb >= 0);
+
+			double* a = pv + (size_t)kb*BS*BS + ri*BS + (J % BS);
+#pragma omp atomic
+			(*a) += ki[j];
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void BSRSparseMatrix::Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj)
+{
+	const int N = ke.rows();
+	const int M = ke.columns();
+	for (int i = 0; i<N; ++i)
+	{
+		int I = lmi[i];
+		if (I < 0) continue;
+		for (int j = 0; j<M; ++j)
+		{
+			int J = lmj[j];
+			if (J < 0) continue;
+
+			// symmetric matrices only take the lower-triangular part (as CompactSymmMatrix)
+			if (m_bsymm)
+			{
+				if (I >= J)
+				{
+					addEntry(I, J, ke[i][j]);
+					if (I != J) addEntry(J, I, ke[i][j]);
+				}
+			}
+			else addEntry(I, J, ke[i][j]);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void BSRSparseMatrix::addEntry(int i, int j, double v)
+{
+	int kb = FindBlock(i / BS, j / BS);
+	assert(kb >= 0);
+	if (kb < 0) return;
+	double* a = m_val.data() + (size_t)kb*BS*BS + (i % BS)*BS + (j % BS);
+#pragma omp atomic
+	(*a) += v;
+}
+
+//-----------------------------------------------------------------------------
+void BSRSparseMatrix::setEntry(int i, int j, double v)
+{
+	int kb = FindBlock(i / BS, j / BS);
+	assert(kb >= 0);
+	if (kb < 0) return;
+	m_val[(size_t)kb*BS*BS + (i % BS)*BS + (j % BS)] = v;
+}
+
+//-----------------------------------------------------------------------------
+bool BSRSparseMatrix::check(int i, int j)
+{
+	return (FindBlock(i / BS, j / BS) >= 0);
+}
+
+//-----------------------------------------------------------------------------
+// For symmetric matrices, FEBio only adds the upper triangular entries (see CompactSymmMatrix::add),
+// so these are mirrored into the lower triangular part.
+void BSRSparseMatrix::add(int i, int j, double v)
+{
+	assert((i >= 0) && (i < m_nrow));
+	assert((j >= 0) && (j < m_ncol));
+	if (m_bsymm)
+	{
+		if (i <= j)
+		{
+			addEntry(i, j, v);
+			if (i != j) addEntry(j, i, v);
+		}
+	}
+	else addEntry(i, j, v);
+}
+
+//-----------------------------------------------------------------------------
+void BSRSparseMatrix::set(int i, int j, double v)
+{
+	assert((i >= 0) && (i < m_nrow));
+	assert((j >= 0) && (j < m_ncol));
+#pragma omp critical
+	{
+		if (m_bsymm)
+		{
+			if (j <= i)
+			{
+				setEntry(i, j, v);
+				if (i != j) setEntry(j, i, v);
+			}
+		}
+		else setEntry(i, j, v);
+	}
+}
+
+//-----------------------------------------------------------------------------
+double BSRSparseMatrix::get(int i, int j)
+{
+	int kb = FindBlock(i / BS, j / BS);
+	if (kb < 0) return 0.0;
+	return m_val[(size_t)kb*BS*BS + (i % BS)*BS + (j % BS)];
+}
+
+//-----------------------------------------------------------------------------
+double BSRSparseMatrix::diag(int i)
+{
+	int kb = m_diag[i / BS];
+	int r = i % BS;
+	return m_val[(size_t)kb*BS*BS + r*BS + r];
+}
+
+//-----------------------------------------------------------------------------
+// The product is computed one block row at a time so that there are no write
+// conflicts between threads. The 3x3 blocks are unrolled completely which lets
+// the compiler vectorize the inner loop.
+bool BSRSparseMatrix::mult_vector(double* x, double* r)
+{
+	const int nbr = m_nbr;
+	const int N = m_nrow;
+	const int M = m_ncol;
+
+	// When the number of columns is not a multiple of three, the last block column
+	// would read past the end of x, so use a zero-padded copy.
+	const double* px = x;
+	if (M % BS)
+	{
+		m_xpad.resize((size_t)m_nbc*BS);
+		for (int i = 0; i<M; ++i) m_xpad[i] = x[i];
+		for (int i = M; i<m_nbc*BS; ++i) m_xpad[i] = 0.0;
+		px = &m_xpad[0];
+	}
+
+	const int* ptr = m_ptr.data();
+	const int* col = m_col.data();
+	const double* val = m_val.data();
+
+#pragma omp parallel for schedule(guided)
+	for (int ib = 0; ib<nbr; ++ib)
+	{
+		double r0 = 0.0, r1 = 0.0, r2 = 0.0;
+		for (int k = ptr[ib]; k<ptr[ib + 1]; ++k)
+		{
+			const double* a = val + (size_t)k*9;
+			const double* xb = px + col[k]*BS;
+			const double x0 = xb[0], x1 = xb[1], x2 = xb[2];
+			r0 += a[0]*x0 + a[1]*x1 + a[2]*x2;
+			r1 += a[3]*x0 + a[4]*x1 + a[5]*x2;
+			r2 += a[6]*x0 + a[7]*x1 + a[8]*x2;
+		}
+
+		int i0 = ib*BS;
+		if (i0 + 2 < N)
+		{
+			r[i0] = r0; r[i0 + 1] = r1; r[i0 + 2] = r2;
+		}
+		else
+		{
+			r[i0] = r0;
+			if (i0 + 1 < N) r[i0 + 1] = r1;
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void BSRSparseMatrix::scale(const std::vector<double>& L, const std::vector<double>& R)
+{
+	assert((int)L.size() == m_nrow);
+	assert((int)R.size() == m_ncol);
+	const int N = m_nrow;
+	const int M = m_ncol;
+
+#pragma omp parallel for
+	for (int ib = 0; ib<m_nbr; ++ib)
+	{
+		for (int k = m_ptr[ib]; k<m_ptr[ib + 1]; ++k)
+		{
+			double* a = m_val.data() + (size_t)k*BS*BS;
+			int j0 = m_col[k]*BS;
+			for (int r = 0; r<BS; ++r)
+			{
+				int i = ib*BS + r;
+				double li = (i < N ? L[i] : 0.0);
+				for (int c = 0; c<BS; ++c)
+				{
+					int j = j0 + c;
+					double rj = (j < M ? R[j] : 0.0);
+					a[r*BS + c] *= li*rj;
+				}
+			}
+		}
+	}
+}
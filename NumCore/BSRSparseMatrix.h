@@ -0,0 +1,137 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include <FECore/SparseMatrix.h>
+#include <vector>
+
+//=============================================================================
+//! This class stores a sparse matrix in block compressed row storage (BSR) format
+//! with dense 3x3 blocks.
+
+//! Solid mechanics problems produce stiffness matrices that consist of 3x3 nodal
+//! blocks. Storing one column index per block instead of one per entry reduces the
+//! index storage about nine-fold and allows the matrix-vector product to operate
+//! on small dense blocks. The equations are grouped in consecutive triplets
+//! (block row i contains equations 3i, 3i+1, 3i+2) so the format can be used for any
+//! equation numbering. If the number of equations is not a multiple of three, the
+//! last block is padded with zeroes.
+//! Both triangles are always stored, also for symmetric matrices. For symmetric
+//! matrices the add and set functions follow the conventions of CompactSymmMatrix
+//! and update both the (i,j) and (j,i) entries.
+class BSRSparseMatrix : public SparseMatrix
+{
+public:
+	enum { BS = 3 };	//!< block size
+
+public:
+	//! constructor
+	BSRSparseMatrix(bool bsymmetric = false);
+
+	//! Create the matrix structure from the SparseMatrixProfile.
+	void Create(SparseMatrixProfile& mp) override;
+
+	//! set all matrix elements to zero
+	void Zero() override;
+
+	//! release the matrix data
+	void Clear() override;
+
+	//! Assemble an element matrix into the global matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lm) override;
+
+	//! assemble a matrix into the sparse matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj) override;
+
+	//! see if a matrix element is defined
+	bool check(int i, int j) override;
+
+	//! set matrix item
+	void set(int i, int j, double v) override;
+
+	//! add a matrix item
+	void add(int i, int j, double v) override;
+
+	//! get a matrix item
+	double get(int i, int j) override;
+
+	//! return the diagonal component
+	double diag(int i) override;
+
+	//! multiply with vector
+	bool mult_vector(double* x, double* r) override;
+
+	//! do row (L) and column (R) scaling
+	void scale(const std::vector<double>& L, const std::vector<double>& R) override;
+
+	//! is the matrix symmetric or not
+	bool isSymmetric() const { return m_bsymm; }
+
+public:
+	//! number of block rows
+	int BlockRows() const { return m_nbr; }
+
+	//! number of block columns
+	int BlockColumns() const { return m_nbc; }
+
+	//! number of blocks
+	int Blocks() const { return (int)m_col.size(); }
+
+	//! block row pointers (size BlockRows()+1)
+	const int* BlockPointers() const { return (m_ptr.empty() ? nullptr : &m_ptr[0]); }
+
+	//! block column indices
+	const int* BlockIndices() const { return (m_col.empty() ? nullptr : &m_col[0]); }
+
+	//! block values (each block is stored row-major)
+	double* BlockValues() { return (m_val.empty() ? nullptr : &m_val[0]); }
+
+	//! index of the diagonal block of block row i (or -1 if not present)
+	int DiagonalBlock(int i) const { return m_diag[i]; }
+
+	//! find the index of block (bi, bj) or return -1 if it is not defined
+	int FindBlock(int bi, int bj) const;
+
+private:
+	//! add a value without taking the symmetry flag into account
+	void addEntry(int i, int j, double v);
+
+	//! set a value without taking the symmetry flag into account
+	void setEntry(int i, int j, double v);
+
+private:
+	bool	m_bsymm;	//!< symmetry flag
+	int		m_nbr;		//!< number of block rows
+	int		m_nbc;		//!< number of block columns
+
+	std::vector<int>	m_ptr;	//!< block row pointers
+	std::vector<int>	m_col;	//!< block column indices
+	std::vector<int>	m_diag;	//!< index of the diagonal blocks
+	std::vector<double>	m_val;	//!< block values
+
+	std::vector<double>	m_xpad;	//!< padded copy of the input vector (used when the size is not a multiple of three)
+};
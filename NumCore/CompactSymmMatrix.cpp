@@ -28,6 +28,8 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "CompactSymmMatrix.h"
+#include <FECore/sys.h>
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -37,58 +39,156 @@ CompactSymmMatrix::CompactSymmMatrix(int offset) : CompactMatrix(offset)
 }
 
 //-----------------------------------------------------------------------------
+void CompactSymmMatrix::Clear()
+{
+	m_part.clear();
+	CompactMatrix::Clear();
+}
+
+//-----------------------------------------------------------------------------
+// Multiply column j of the lower-triangular storage with x. The lower entries
+// are scattered into r, while the diagonal and the (transposed) upper entries
+// are gathered into r[j]. The result vector r starts at row r0.
+static inline void symm_mult_column(const double* pv, const int* pi, int n, int j, int offset, const double* x, double* r, int r0 = 0)
+{
+	const double xj = x[j];
+	const int ro = offset + r0;
+
+	// add off-diagonal elements
+	for (int i = 1; i<n - 7; i += 8)
+	{
+		// add lower triangular element
+		r[pi[i    ] - ro] += pv[i    ] * xj;
+		r[pi[i + 1] - ro] += pv[i + 1] * xj;
+		r[pi[i + 2] - ro] += pv[i + 2] * xj;
+		r[pi[i + 3] - ro] += pv[i + 3] * xj;
+		r[pi[i + 4] - ro] += pv[i + 4] * xj;
+		r[pi[i + 5] - ro] += pv[i + 5] * xj;
+		r[pi[i + 6] - ro] += pv[i + 6] * xj;
+		r[pi[i + 7] - ro] += pv[i + 7] * xj;
+	}
+	for (int i = 0; i<(n - 1) % 8; ++i)
+		r[pi[n - 1 - i] - ro] += pv[n - 1 - i] * xj;
+
+	// add diagonal element
+	double rj = pv[0] * xj;
+
+	// add upper-triangular elements
+	for (int i = 1; i<n - 7; i += 8)
+	{
+		// add upper triangular element
+		rj += pv[i    ] * x[pi[i    ] - offset];
+		rj += pv[i + 1] * x[pi[i + 1] - offset];
+		rj += pv[i + 2] * x[pi[i + 2] - offset];
+		rj += pv[i + 3] * x[pi[i + 3] - offset];
+		rj += pv[i + 4] * x[pi[i + 4] - offset];
+		rj += pv[i + 5] * x[pi[i + 5] - offset];
+		rj += pv[i + 6] * x[pi[i + 6] - offset];
+		rj += pv[i + 7] * x[pi[i + 7] - offset];
+	}
+	for (int i = 0; i<(n - 1) % 8; ++i)
+		rj += pv[n - 1 - i] * x[pi[n - 1 - i] - offset];
+
+	r[j - r0] += rj;
+}
+
+//-----------------------------------------------------------------------------
+// Splits the columns into blocks with about the same number of nonzeroes, and
+// determines the last row that each block scatters into.
+void CompactSymmMatrix::PartitionColumns(int nt)
+{
+	int N = Columns();
+	int nnz = m_ppointers[N] - m_ppointers[0];
+
+	m_part.resize(nt + 1);
+	m_last.resize(nt);
+	m_off.resize(nt + 1);
+	m_part[0] = 0;
+	m_off[0] = 0;
+	for (int t = 0; t < nt; ++t)
+	{
+		int c0 = m_part[t];
+		int c1 = N;
+		if (t < nt - 1)
+		{
+			int target = m_ppointers[0] + (int)(((long long)nnz*(t + 1)) / nt);
+			c1 = (int)(std::lower_bound(m_ppointers + c0, m_ppointers + N, target) - m_ppointers);
+		}
+		m_part[t + 1] = c1;
+
+		int last = c1 - 1;
+		for (int k = m_ppointers[c0] - m_offset; k < m_ppointers[c1] - m_offset; ++k)
+		{
+			int i = m_pindices[k] - m_offset;
+			if (i > last) last = i;
+		}
+		m_last[t] = last;
+		m_off[t + 1] = m_off[t] + (size_t)(last - c0 + 1);
+	}
+	m_tmp.resize(m_off[nt]);
+}
+
+//-----------------------------------------------------------------------------
+// Since only the lower triangular part is stored, each column scatters into
+// rows below the diagonal. To run this in parallel without atomics, every thread
+// multiplies a block of columns into its own buffer. This buffer only covers the 
+// rows of the block and the rows below it that the block scatters into, which for
+// a banded matrix is not much more than the block itself. Each thread then sums 
+// the buffers that overlap its own rows, in a fixed order, so the result does 
+// not depend on the scheduling.
 bool CompactSymmMatrix::mult_vector(double* x, double* r)
 {
 	// get row count
 	int N = Rows();
 	int M = Columns();
 
-	// zero result vector
-	for (int j = 0; j<N; ++j) r[j] = 0.0;
-
-	// loop over all columns
-	for (int j = 0; j<M; ++j)
+	// for small matrices (or when we are already in a parallel region) the serial loop is faster
+	int nt = omp_get_max_threads();
+	if ((nt == 1) || (N < MIN_PARALLEL_ROWS) || omp_in_parallel())
 	{
-		double* pv = m_pd + m_ppointers[j] - m_offset;
-		int* pi = m_pindices + m_ppointers[j] - m_offset;
-		int n = m_ppointers[j + 1] - m_ppointers[j];
+		// zero result vector
+		for (int j = 0; j<N; ++j) r[j] = 0.0;
 
-		// add off-diagonal elements
-		for (int i = 1; i<n - 7; i += 8)
+		// loop over all columns
+		for (int j = 0; j<M; ++j)
 		{
-			// add lower triangular element
-			r[pi[i    ] - m_offset] += pv[i    ] * x[j];
-			r[pi[i + 1] - m_offset] += pv[i + 1] * x[j];
-			r[pi[i + 2] - m_offset] += pv[i + 2] * x[j];
-			r[pi[i + 3] - m_offset] += pv[i + 3] * x[j];
-			r[pi[i + 4] - m_offset] += pv[i + 4] * x[j];
-			r[pi[i + 5] - m_offset] += pv[i + 5] * x[j];
-			r[pi[i + 6] - m_offset] += pv[i + 6] * x[j];
-			r[pi[i + 7] - m_offset] += pv[i + 7] * x[j];
+			int n0 = m_ppointers[j] - m_offset;
+			int n = m_ppointers[j + 1] - m_ppointers[j];
+			symm_mult_column(m_pd + n0, m_pindices + n0, n, j, m_offset, x, r);
 		}
-		for (int i = 0; i<(n - 1) % 8; ++i)
-			r[pi[n - 1 - i] - m_offset] += pv[n - 1 - i] * x[j];
+		return true;
+	}
 
-		// add diagonal element
-		double rj = pv[0] * x[j];
+	// the partition only needs to be updated when the structure (see Clear) or the thread count changes
+	if ((int)m_part.size() != nt + 1) PartitionColumns(nt);
 
-		// add upper-triangular elements
-		for (int i = 1; i<n - 7; i += 8)
+#pragma omp parallel num_threads(nt)
+	{
+		int t = omp_get_thread_num();
+		int c0 = m_part[t];
+		int c1 = m_part[t + 1];
+
+		// multiply this thread's columns
+		double* rt = m_tmp.data() + m_off[t];
+		for (size_t i = 0; i < m_off[t + 1] - m_off[t]; ++i) rt[i] = 0.0;
+		for (int j = c0; j < c1; ++j)
 		{
-			// add upper triangular element
-			rj += pv[i    ] * x[pi[i    ] - m_offset];
-			rj += pv[i + 1] * x[pi[i + 1] - m_offset];
-			rj += pv[i + 2] * x[pi[i + 2] - m_offset];
-			rj += pv[i + 3] * x[pi[i + 3] - m_offset];
-			rj += pv[i + 4] * x[pi[i + 4] - m_offset];
-			rj += pv[i + 5] * x[pi[i + 5] - m_offset];
-			rj += pv[i + 6] * x[pi[i + 6] - m_offset];
-			rj += pv[i + 7] * x[pi[i + 7] - m_offset];
+			int n0 = m_ppointers[j] - m_offset;
+			int n = m_ppointers[j + 1] - m_ppointers[j];
+			symm_mult_column(m_pd + n0, m_pindices + n0, n, j, m_offset, x, rt, c0);
 		}
-		for (int i = 0; i<(n - 1) % 8; ++i)
-			rj += pv[n - 1 - i] * x[pi[n - 1 - i] - m_offset];
 
-		r[j] += rj;
+#pragma omp barrier
+
+		// sum the buffers that overlap the rows of this thread
+		for (int i = c0; i < c1; ++i) r[i] = 0.0;
+		for (int k = 0; k <= t; ++k)
+		{
+			int i0 = std::max(c0, m_part[k]);
+			int i1 = std::min(c1 - 1, m_last[k]);
+			const double* rk = m_tmp.data() + m_off[k];
+			for (int i = i0; i <= i1; ++i) r[i] += rk[i - m_part[k]];
+		}
 	}
 
 	return true;
@@ -44,6 +44,9 @@ public:
 	//! Create the matrix structure from the SparseMatrixProfile.
 	void Create(SparseMatrixProfile& mp) override;
 
+	//! clear the matrix (this also resets the column partition of mult_vector)
+	void Clear() override;
+
 	//! Assemble an element matrix into the global matrix
 	void Assemble(const matrix& ke, const vector<int>& lm) override;
 
@@ -85,4 +88,19 @@ public:
 
 	//! do row (L) and column (R) scaling
 	void scale(const vector<double>& L, const vector<double>& R) override;
+
+private:
+	//! split the columns into nt blocks of similar size for mult_vector
+	void PartitionColumns(int nt);
+
+private:
+	enum { MIN_PARALLEL_ROWS = 5000 };	//!< matrices smaller than this are multiplied serially
+
+	// The parallel mult_vector assigns a block of columns (and the same rows of the result) to
+	// each thread. A thread accumulates into its own buffer, which covers the rows of its block
+	// and the rows below it that the block scatters into.
+	vector<int>		m_part;		//!< first column of each block (last entry is the number of columns)
+	vector<int>		m_last;		//!< last row that each block contributes to
+	vector<size_t>	m_off;		//!< offset of each block's buffer in m_tmp
+	vector<double>	m_tmp;		//!< buffers of all blocks
 };
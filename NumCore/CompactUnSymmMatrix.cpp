@@ -359,38 +359,34 @@ double CRSSparseMatrix::diag(int i)
 //-----------------------------------------------------------------------------
 bool CRSSparseMatrix::mult_vector(double* x, double* r)
 {
-#ifdef MKL_ISS
-
 	// get the matrix size
 	const int N = Rows();
 
+#ifdef MKL_ISS
 	if (Offset() == 1)
 	{
 		const char transa = 'N';
 		mkl_dcsrgemv(&transa, &N, m_pd, m_ppointers, m_pindices, x, r);
+		return true;
 	}
-	else
+#endif
+
+	// loop over all rows
+#pragma omp parallel for schedule(guided)
+	for (int i = 0; i < N; ++i)
 	{
-		assert(m_offset == 0);
-		// loop over all rows
-	#pragma omp parallel for schedule(guided)
-		for (int i = 0; i < N; ++i)
+		const double* pv = m_pd + (m_ppointers[i] - m_offset);
+		const int* pi = m_pindices + (m_ppointers[i] - m_offset);
+		const int n = m_ppointers[i + 1] - m_ppointers[i];
+		double ri = 0.0;
+		for (int j = 0; j < n; j ++)
 		{
-			const double* pv = m_pd + (m_ppointers[i] - m_offset);
-			const int* pi = m_pindices + (m_ppointers[i] - m_offset);
-			const int n = m_ppointers[i + 1] - m_ppointers[i];
-			r[i] = 0.0;
-			for (int j = 0; j < n; j ++)
-			{
-				r[i] += (*pv++) * x[*pi++ - m_offset];
-			}
+			ri += pv[j] * x[pi[j] - m_offset];
 		}
+		r[i] = ri;
 	}
 
 	return true;
-#else
-	return false;
-#endif
 }
 
 //! calculate the abs row sum 
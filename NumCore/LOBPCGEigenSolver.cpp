@@ -0,0 +1,403 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "LOBPCGEigenSolver.h"
+#include "MatrixTools.h"
+#include <FECore/LinearSolver.h>
+#include <FECore/log.h>
+#include <algorithm>
+
+BEGIN_FECORE_CLASS(LOBPCGEigenSolver, EigenSolver)
+	ADD_PARAMETER(m_nev       , "eigenvalues");
+	ADD_PARAMETER(m_blockSize , "block_size");
+	ADD_PARAMETER(m_maxIter   , "max_iter");
+	ADD_PARAMETER(m_tol       , "tol");
+	ADD_PARAMETER(m_printLevel, "print_level");
+
+	ADD_PROPERTY(m_pc, "pc", FEProperty::Optional);
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+// Eigenvalues and eigenvectors of the dense symmetric n x n matrix a (row-based storage)
+// with the cyclic Jacobi method. On return, d contains the eigenvalues in ascending order
+// and column j of v (row-based storage) the eigenvector of d[j]. The matrix a is destroyed.
+static void jacobi_eigen(int n, vector<double>& a, vector<double>& d, vector<double>& v)
+{
+	v.assign((size_t)n*n, 0.0);
+	for (int i = 0; i < n; ++i) v[i*n + i] = 1.0;
+
+	for (int sweep = 0; sweep < 100; ++sweep)
+	{
+		double off = 0.0, diag = 0.0;
+		for (int i = 0; i < n; ++i)
+		{
+			diag += a[i*n + i] * a[i*n + i];
+			for (int j = i + 1; j < n; ++j) off += a[i*n + j] * a[i*n + j];
+		}
+		if (off <= 1e-30*diag) break;
+
+		for (int p = 0; p < n - 1; ++p)
+			for (int q = p + 1; q < n; ++q)
+			{
+				const double apq = a[p*n + q];
+				if (apq == 0.0) continue;
+
+				// calculate the rotation that eliminates a_pq
+				const double theta = (a[q*n + q] - a[p*n + p]) / (2.0*apq);
+				const double t = (theta >= 0.0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta*theta + 1.0));
+				const double c = 1.0 / sqrt(t*t + 1.0);
+				const double s = t*c;
+
+				for (int k = 0; k < n; ++k)
+				{
+					const double akp = a[k*n + p], akq = a[k*n + q];
+					a[k*n + p] = c*akp - s*akq;
+					a[k*n + q] = s*akp + c*akq;
+				}
+				for (int k = 0; k < n; ++k)
+				{
+					const double apk = a[p*n + k], aqk = a[q*n + k];
+					a[p*n + k] = c*apk - s*aqk;
+					a[q*n + k] = s*apk + c*aqk;
+				}
+				for (int k = 0; k < n; ++k)
+				{
+					const double vkp = v[k*n + p], vkq = v[k*n + q];
+					v[k*n + p] = c*vkp - s*vkq;
+					v[k*n + q] = s*vkp + c*vkq;
+				}
+			}
+	}
+
+	// sort the eigenvalues in ascending order
+	vector<int> order(n);
+	for (int i = 0; i < n; ++i) order[i] = i;
+	std::sort(order.begin(), order.end(), [&](int i, int j) { return a[i*n + i] < a[j*n + j]; });
+
+	d.resize(n);
+	vector<double> vs((size_t)n*n);
+	for (int j = 0; j < n; ++j)
+	{
+		d[j] = a[order[j] * n + order[j]];
+		for (int i = 0; i < n; ++i) vs[i*n + j] = v[i*n + order[j]];
+	}
+	v.swap(vs);
+}
+
+//-----------------------------------------------------------------------------
+LOBPCGEigenSolver::LOBPCGEigenSolver(FEModel* fem) : EigenSolver(fem)
+{
+	m_nev = 10;
+	m_blockSize = 0;
+	m_maxIter = 500;
+	m_tol = 1e-6;
+	m_printLevel = 0;
+
+	m_pc = nullptr;
+	m_pcFactored = false;
+}
+
+//-----------------------------------------------------------------------------
+bool LOBPCGEigenSolver::Init()
+{
+	return (m_nev > 0);
+}
+
+//-----------------------------------------------------------------------------
+bool LOBPCGEigenSolver::EigenSolve(SparseMatrix* A, SparseMatrix* B, vector<double>& eigenValues, matrix& eigenVectors)
+{
+	if (A == nullptr) return false;
+	const int n = A->Rows();
+	if ((n == 0) || (A->Columns() != n)) return false;
+	if (B && ((B->Rows() != n) || (B->Columns() != n))) return false;
+
+	// The block contains a few more vectors than requested, which speeds up the
+	// convergence of the highest requested eigenvalues.
+	const int nev = (m_nev < n ? m_nev : n);
+	if (nev <= 0) return false;
+	int m = (m_blockSize > nev ? m_blockSize : nev + (nev < 5 ? nev : 5));
+	if (m > n) m = n;
+
+	// set up the preconditioner
+	vector<double> dinv;
+	if (m_pc)
+	{
+		// (unless it is already set up for A)
+		if (m_pcFactored == false)
+		{
+			m_pc->SetFEModel(GetFEModel());
+			if ((m_pc->SetSparseMatrix(A) == false) || (m_pc->PreProcess() == false) || (m_pc->Factor() == false))
+			{
+				feLogError("LOBPCG: Failed to set up preconditioner.");
+				return false;
+			}
+		}
+	}
+	else
+	{
+		dinv.assign(n, 1.0);
+		for (int i = 0; i < n; ++i)
+		{
+			double aii = A->diag(i);
+			if (aii != 0.0) dinv[i] = 1.0 / aii;
+		}
+	}
+
+	// The search space is spanned by the current approximations X, the preconditioned
+	// residuals W and the directions P, i.e. S = [X, W, P]. The columns of S are kept
+	// B-orthonormal, and the products A.S and B.S are updated alongside.
+	const size_t N = (size_t)n;
+	const int smax = 3 * m;
+	vector<double> S(smax*N), AS(smax*N), BS(B ? smax*N : 0);
+	vector<double> P(m*N), AP(m*N), BP(B ? m*N : 0);
+	vector<double> T(m*N), AT(m*N), BT(B ? m*N : 0);
+	vector<double> R(m*N);
+	auto s  = [&](int j) { return &S[j*N]; };
+	auto as = [&](int j) { return &AS[j*N]; };
+	auto bs = [&](int j) { return (B ? &BS[j*N] : &S[j*N]); };
+
+	// Orthogonalize column k of S w.r.t. the previous columns (twice, for stability)
+	// and normalize it. Returns false if the vector is (numerically) dependent.
+	auto orthonormalize = [&](int k) {
+		double* sk = s(k);
+		double* ak = as(k);
+		double* bk = (B ? bs(k) : nullptr);
+		double norm0 = sqrt(NumCore::dotProduct(n, sk, bs(k)));
+		if (norm0 == 0.0) return false;
+		for (int pass = 0; pass < 2; ++pass)
+		{
+			for (int i = 0; i < k; ++i)
+			{
+				const double c = NumCore::dotProduct(n, bs(i), sk);
+				NumCore::axpy(n, -c, s(i), sk);
+				NumCore::axpy(n, -c, as(i), ak);
+				if (bk) NumCore::axpy(n, -c, bs(i), bk);
+			}
+		}
+		double norm = sqrt(fabs(NumCore::dotProduct(n, sk, bs(k))));
+		if (norm <= 1e-10*norm0) return false;
+		const double f = 1.0 / norm;
+#pragma omp parallel for schedule(static)
+		for (int i = 0; i < n; ++i)
+		{
+			sk[i] *= f;
+			ak[i] *= f;
+			if (bk) bk[i] *= f;
+		}
+		return true;
+	};
+
+	// evaluate the products of column k of S
+	auto multiply = [&](int k) {
+		A->mult_vector(s(k), as(k));
+		if (B) B->mult_vector(s(k), bs(k));
+	};
+
+	// initial (deterministic) random block
+	unsigned int seed = 12345u;
+	for (int j = 0; j < m; ++j)
+	{
+		double* x = s(j);
+		for (int i = 0; i < n; ++i)
+		{
+			seed = seed*1103515245u + 12345u;
+			x[i] = ((seed >> 8) & 0xFFFF) / 65536.0 - 0.5;
+		}
+		multiply(j);
+		if (orthonormalize(j) == false) return false;
+	}
+
+	vector<double> lam(m, 0.0), res(m, 1.0), G, theta, Y;
+	bool bhasP = false;
+	bool bconv = false;
+	int iter = 0;
+	for (iter = 0; iter <= m_maxIter; ++iter)
+	{
+		int ns = m;
+		if (iter > 0)
+		{
+			// keep X orthonormal despite round-off
+			for (int j = 0; j < m; ++j) if (orthonormalize(j) == false) return false;
+
+			// residuals of the unconverged vectors
+			int nr = 0;
+			for (int j = 0; j < m; ++j)
+			{
+				if (res[j] <= m_tol) continue;
+				const double* ax = as(j);
+				const double* bx = bs(j);
+				const double lj = lam[j];
+				double* rj = &R[nr*N];
+#pragma omp parallel for schedule(static)
+				for (int i = 0; i < n; ++i) rj[i] = ax[i] - lj*bx[i];
+				nr++;
+			}
+
+			// Precondition them all at once. The results are stored in the next columns
+			// of S, and moved down when a previous one is dropped by the orthonormalization.
+			const int ns0 = ns;
+			if (m_pc)
+			{
+				if ((nr > 0) && (m_pc->BackSolveMulti(s(ns0), &R[0], nr, n) == false)) return false;
+			}
+			else
+			{
+				for (int j = 0; j < nr; ++j)
+				{
+					double* w = s(ns0 + j);
+					const double* rj = &R[j*N];
+					for (int i = 0; i < n; ++i) w[i] = dinv[i] * rj[i];
+				}
+			}
+			for (int j = 0; j < nr; ++j)
+			{
+				if (ns != ns0 + j) std::copy(S.begin() + (ns0 + j)*N, S.begin() + (ns0 + j + 1)*N, s(ns));
+				multiply(ns);
+				if (orthonormalize(ns)) ns++;
+			}
+
+			// the search directions of the unconverged vectors
+			if (bhasP)
+			{
+				for (int j = 0; j < m; ++j)
+				{
+					if (res[j] <= m_tol) continue;
+					std::copy(P.begin() + j*N, P.begin() + (j + 1)*N, s(ns));
+					std::copy(AP.begin() + j*N, AP.begin() + (j + 1)*N, as(ns));
+					if (B) std::copy(BP.begin() + j*N, BP.begin() + (j + 1)*N, bs(ns));
+					if (orthonormalize(ns)) ns++;
+				}
+			}
+		}
+
+		// Rayleigh-Ritz procedure on the search space
+		G.assign((size_t)ns*ns, 0.0);
+#pragma omp parallel for schedule(dynamic)
+		for (int i = 0; i < ns; ++i)
+		{
+			for (int j = i; j < ns; ++j)
+			{
+				// (evaluated serially, since this loop is already parallel)
+				const double* si = s(i);
+				const double* aj = as(j);
+				double g = 0.0;
+				for (int k = 0; k < n; ++k) g += si[k] * aj[k];
+				G[i*ns + j] = G[j*ns + i] = g;
+			}
+		}
+		jacobi_eigen(ns, G, theta, Y);
+		for (int j = 0; j < m; ++j) lam[j] = theta[j];
+
+		// new directions P = [W, P].Y_wp and new approximations X = X.Y_x + P
+		for (int j = 0; j < m; ++j)
+		{
+			double* pj = &P[j*N];
+			double* apj = &AP[j*N];
+			double* bpj = (B ? &BP[j*N] : nullptr);
+			double* tj = &T[j*N];
+			double* atj = &AT[j*N];
+			double* btj = (B ? &BT[j*N] : nullptr);
+#pragma omp parallel for schedule(static)
+			for (int k = 0; k < n; ++k)
+			{
+				double p = 0.0, ap = 0.0, bp = 0.0;
+				for (int i = m; i < ns; ++i)
+				{
+					const double y = Y[i*ns + j];
+					p += y*S[i*N + k];
+					ap += y*AS[i*N + k];
+					if (B) bp += y*BS[i*N + k];
+				}
+				double x = p, ax = ap, bx = bp;
+				for (int i = 0; i < m; ++i)
+				{
+					const double y = Y[i*ns + j];
+					x += y*S[i*N + k];
+					ax += y*AS[i*N + k];
+					if (B) bx += y*BS[i*N + k];
+				}
+				pj[k] = p; apj[k] = ap;
+				tj[k] = x; atj[k] = ax;
+				if (B) { bpj[k] = bp; btj[k] = bx; }
+			}
+		}
+		std::copy(T.begin(), T.end(), S.begin());
+		std::copy(AT.begin(), AT.end(), AS.begin());
+		if (B) std::copy(BT.begin(), BT.end(), BS.begin());
+		bhasP = (ns > m);
+
+		// check the residuals
+		int nconv = 0;
+		double rmax = 0.0;
+		for (int j = 0; j < m; ++j)
+		{
+			const double* ax = as(j);
+			const double* bx = bs(j);
+			const double lj = lam[j];
+			double rr = 0.0, aa = 0.0, bb = 0.0;
+#pragma omp parallel for schedule(static) reduction(+:rr,aa,bb)
+			for (int i = 0; i < n; ++i)
+			{
+				double ri = ax[i] - lj*bx[i];
+				rr += ri*ri;
+				aa += ax[i] * ax[i];
+				bb += bx[i] * bx[i];
+			}
+			double d = sqrt(aa) + fabs(lj)*sqrt(bb);
+			res[j] = (d > 0.0 ? sqrt(rr) / d : sqrt(rr));
+			if (j < nev)
+			{
+				if (res[j] <= m_tol) nconv++;
+				if (res[j] > rmax) rmax = res[j];
+			}
+		}
+
+		if (m_printLevel > 1) feLog("LOBPCG %3d: %d converged, max residual = %lg\n", iter, nconv, rmax);
+
+		if (nconv == nev) { bconv = true; break; }
+	}
+
+	if (m_printLevel > 0) feLog("LOBPCG: %d iterations\n", iter);
+	if (bconv == false)
+	{
+		feLogError("LOBPCG: Max number of iterations reached.");
+		return false;
+	}
+
+	// store the results
+	eigenValues.assign(lam.begin(), lam.begin() + nev);
+	eigenVectors.resize(nev, n);
+	for (int j = 0; j < nev; ++j)
+	{
+		const double* x = s(j);
+		for (int i = 0; i < n; ++i) eigenVectors[j][i] = x[i];
+	}
+
+	return true;
+}
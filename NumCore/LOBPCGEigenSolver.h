@@ -0,0 +1,71 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/SparseMatrix.h>
+#include <FECore/matrix.h>
+#include <FECore/EigenSolver.h>
+
+class LinearSolver;
+
+//-----------------------------------------------------------------------------
+//! Locally optimal block preconditioned conjugate gradient (LOBPCG) solver for the
+//! lowest eigenvalues of the generalized eigenvalue problem A.x = lambda.B.x, where A
+//! and B are symmetric and B is positive semi-definite (if B is null, B = I is used).
+//! The preconditioner is an approximation of A^-1 and can be any linear solver that
+//! accepts the matrix A and leaves it intact (e.g. native_amg, native_ic0, native_cg).
+//! With an exact solver, the convergence is that of shift-invert around zero. A linear
+//! solver that already factored A (e.g. a direct solver) can be passed as is. If no
+//! preconditioner is given, the diagonal of A is used. This solver does not depend on MKL.
+class LOBPCGEigenSolver : public EigenSolver
+{
+public:
+	LOBPCGEigenSolver(FEModel* fem);
+
+	bool Init() override;
+
+	//! Calculate the lowest eigenvalues. On return, row i of eigenVectors stores the
+	//! eigenvector (normalized w.r.t. B) of eigenvalue i.
+	bool EigenSolve(SparseMatrix* A, SparseMatrix* B, vector<double>& eigenValues, matrix& eigenVectors) override;
+
+	//! set the preconditioner (which is not owned by this class). If bfactored is true,
+	//! the preconditioner is already set up for A and is not factored again.
+	void SetPreconditioner(LinearSolver* pc, bool bfactored = false) { m_pc = pc; m_pcFactored = bfactored; }
+
+private:
+	int		m_nev;			// number of requested eigenvalues
+	int		m_blockSize;	// block size (0 = use default)
+	int		m_maxIter;		// max nr of iterations
+	double	m_tol;			// relative residual tolerance
+	int		m_printLevel;	// output level
+
+	LinearSolver*	m_pc;	// preconditioner
+	bool	m_pcFactored;	// the preconditioner is already set up
+
+	DECLARE_FECORE_CLASS();
+};
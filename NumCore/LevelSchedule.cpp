@@ -0,0 +1,77 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "LevelSchedule.h"
+#include <FECore/sys.h>
+
+//-----------------------------------------------------------------------------
+LevelSchedule::LevelSchedule()
+{
+	m_bparallel = false;
+}
+
+//-----------------------------------------------------------------------------
+void LevelSchedule::Build(int N, const int* ptr, const int* idx, int offset, bool lower)
+{
+	// calculate the level of each row
+	std::vector<int> level(N, 0);
+	int levels = 0;
+	for (int n = 0; n < N; ++n)
+	{
+		int i = (lower ? n : N - 1 - n);
+		int li = 0;
+		for (int k = ptr[i] - offset; k < ptr[i + 1] - offset; ++k)
+		{
+			int j = idx[k] - offset;
+			if ((lower && (j < i)) || (!lower && (j > i)))
+			{
+				if (level[j] + 1 > li) li = level[j] + 1;
+			}
+		}
+		level[i] = li;
+		if (li + 1 > levels) levels = li + 1;
+	}
+
+	// sort the rows by level (the rows within a level stay in their original order)
+	m_ptr.assign(levels + 1, 0);
+	for (int i = 0; i < N; ++i) m_ptr[level[i] + 1]++;
+	for (int l = 0; l < levels; ++l) m_ptr[l + 1] += m_ptr[l];
+
+	m_rows.resize(N);
+	std::vector<int> pos(m_ptr.begin(), m_ptr.end() - 1);
+	for (int n = 0; n < N; ++n)
+	{
+		int i = (lower ? n : N - 1 - n);
+		m_rows[pos[level[i]]++] = i;
+	}
+
+	// Every level ends with a synchronization point, so the parallel sweep is only
+	// worth it if the levels are (on average) large enough.
+	int nt = omp_get_max_threads();
+	m_bparallel = ((nt > 1) && (levels > 0) && (N / levels >= 16 * nt));
+}
@@ -0,0 +1,103 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! A level schedule groups the rows of a sparse triangular matrix such that all
+//! rows in a level only depend on rows in previous levels. The rows of a level can
+//! then be processed in parallel. This is used by the native incomplete factorization
+//! preconditioners for the factorization and the triangular solves.
+class LevelSchedule
+{
+public:
+	LevelSchedule();
+
+	//! Build the schedule from a row-based sparsity pattern (i.e. row i depends on the
+	//! columns stored in idx[ptr[i]-offset ... ptr[i+1]-offset-1]).
+	//! If lower is true, only the columns j < i are considered and rows are processed in
+	//! ascending order. Otherwise, only the columns j > i are considered.
+	void Build(int N, const int* ptr, const int* idx, int offset, bool lower);
+
+	//! number of levels
+	int Levels() const { return (int)m_ptr.size() - 1; }
+
+	//! first index into Rows() of level l
+	int LevelStart(int l) const { return m_ptr[l]; }
+
+	//! one past the last index into Rows() of level l
+	int LevelEnd(int l) const { return m_ptr[l + 1]; }
+
+	//! the rows sorted by level
+	const int* Rows() const { return (m_rows.empty() ? nullptr : &m_rows[0]); }
+
+	//! returns true if the levels are large enough to make a parallel sweep worthwhile
+	bool IsParallel() const { return m_bparallel; }
+
+	//! Loop over all rows in level order and call f(i) for each row.
+	//! Rows of a level are distributed over the threads.
+	template <class F> void Sweep(F f) const;
+
+private:
+	std::vector<int>	m_ptr;		//!< start of each level in m_rows
+	std::vector<int>	m_rows;		//!< rows sorted by level
+	bool				m_bparallel;
+};
+
+//-----------------------------------------------------------------------------
+template <class F> void LevelSchedule::Sweep(F f) const
+{
+	const int levels = Levels();
+	const int* rows = Rows();
+	if (m_bparallel == false)
+	{
+		for (int n = 0; n < m_ptr[levels]; ++n) f(rows[n]);
+		return;
+	}
+
+#pragma omp parallel
+	{
+		for (int l = 0; l < levels; ++l)
+		{
+			const int n0 = m_ptr[l];
+			const int n1 = m_ptr[l + 1];
+
+			// small levels are not worth distributing
+			if (n1 - n0 < 64)
+			{
+#pragma omp single
+				for (int n = n0; n < n1; ++n) f(rows[n]);
+			}
+			else
+			{
+#pragma omp for schedule(static)
+				for (int n = n0; n < n1; ++n) f(rows[n]);
+			}
+		}
+	}
+}
@@ -194,23 +194,31 @@ double NumCore::inverse_infnorm(CompactMatrix* A)
 	if (solver.PreProcess() == false) return 0.0;
 	if (solver.Factor() == false) return 0.0;
 
+	// the columns of the inverse are calculated in blocks
+	const int NB = 16;
 	int N = A->Rows();
-	vector<double> e(N, 0.0), x(N, 0.0);
+	vector<double> e((size_t)N*NB, 0.0), x((size_t)N*NB, 0.0);
 	vector<double> s(N, 0.0);
-	for (int i = 0; i < N; ++i)
+	for (int i0 = 0; i0 < N; i0 += NB)
 	{
-		// get the i-th column of the inverse matrix
-		e[i] = 1.0;
-		solver.BackSolve(&x[0], &e[0]);
+		int nb = (N - i0 < NB ? N - i0 : NB);
+
+		// get the next columns of the inverse matrix
+		for (int k = 0; k < nb; ++k) e[(size_t)k*N + i0 + k] = 1.0;
+		solver.BackSolveMulti(&x[0], &e[0], nb, N);
 
 		// add to net row sums
-		for (int j = 0; j < N; ++j) s[j] += fabs(x[j]);
+		for (int k = 0; k < nb; ++k)
+		{
+			const double* xk = &x[(size_t)k*N];
+			for (int j = 0; j < N; ++j) s[j] += fabs(xk[j]);
+		}
 
 		// reset e
-		e[i] = 0.0;
+		for (int k = 0; k < nb; ++k) e[(size_t)k*N + i0 + k] = 0.0;
 
-		if (i % 100 == 0)
-			fprintf(stderr, "%.2lg%%\r", 100.0 *i / N);
+		if ((i0 / NB) % 10 == 0)
+			fprintf(stderr, "%.2lg%%\r", 100.0 *i0 / N);
 	}
 
 	// get the max row sum
@@ -250,23 +258,33 @@ double NumCore::estimateConditionNumber(SparseMatrix* K)
 	int N = A->Rows();
 	double normAi = 0.0;
 
-	vector<double> b(N, 0), x(N, 0);
+	vector<double> b(N, 0);
 	int iters = (N < 50 ? N : 50);
-	for (int i = 0; i < iters; ++i)
+
+	// the random vectors are solved for in blocks
+	const int NB = 16;
+	vector<double> B((size_t)N*NB), X((size_t)N*NB);
+	for (int i0 = 0; i0 < iters; i0 += NB)
 	{
-		// create a random vector
-		NumCore::randomVector(b, -1.0, 1.0);
-		for (int j = 0; j < N; ++j) b[j] = (b[j] >= 0.0 ? 1.0 : -1.0);
+		int nb = (iters - i0 < NB ? iters - i0 : NB);
 
-		// calculate solution
-		solver.BackSolve(&x[0], &b[0]);
+		// create the random vectors
+		for (int k = 0; k < nb; ++k)
+		{
+			NumCore::randomVector(b, -1.0, 1.0);
+			for (int j = 0; j < N; ++j) B[(size_t)k*N + j] = (b[j] >= 0.0 ? 1.0 : -1.0);
+		}
 
-		double normb = infNorm(b);
-		double normx = infNorm(x);
-		if (normx > normAi) normAi = normx;
+		// calculate the solutions
+		solver.BackSolveMulti(&X[0], &B[0], nb, N);
 
-//		int pct = (100 * i) / (iters - 1);
-//		fprintf(stderr, "calculating condition number: %d%%\r", pct);
+		for (int k = 0; k < nb; ++k)
+		{
+			const double* xk = &X[(size_t)k*N];
+			double normx = 0.0;
+			for (int j = 0; j < N; ++j) if (fabs(xk[j]) > normx) normx = fabs(xk[j]);
+			if (normx > normAi) normAi = normx;
+		}
 	}
 
 	return normA*normAi;
@@ -295,6 +313,20 @@ double NumCore::infNorm(const std::vector<double>& x)
 	return m;
 }
 
+double NumCore::dotProduct(int n, const double* a, const double* b)
+{
+	double s = 0.0;
+#pragma omp parallel for reduction(+:s) schedule(static)
+	for (int i = 0; i < n; ++i) s += a[i] * b[i];
+	return s;
+}
+
+void NumCore::axpy(int n, double a, const double* x, double* y)
+{
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i) y[i] += a * x[i];
+}
+
 // print compact matrix pattern to svn file
 void NumCore::print_svg(CompactMatrix* m, std::ostream &out, int i0, int j0, int i1, int j1)
 {
@@ -0,0 +1,674 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "NativeAMGPreconditioner.h"
+#include "CompactSymmMatrix.h"
+#include "CompactUnSymmMatrix.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEMesh.h>
+#include <FECore/log.h>
+#include <FECore/sys.h>
+#include <algorithm>
+
+BEGIN_FECORE_CLASS(NativeAMGPreconditioner, Preconditioner)
+	ADD_PARAMETER(m_maxLevels , "max_levels");
+	ADD_PARAMETER(m_coarseSize, "coarse_size");
+	ADD_PARAMETER(m_theta     , "strong_threshold");
+	ADD_PARAMETER(m_nsmooth   , "smooth_steps");
+	ADD_PARAMETER(m_ncycle    , "cycles");
+	ADD_PARAMETER(m_printLevel, "print_level");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+// the coarsest level is solved with a few smoothing sweeps if it is too large for a dense factorization
+#define AMG_MAX_DENSE_SIZE	2000
+
+//-----------------------------------------------------------------------------
+// y = A*x
+template <class CSR> static void spmv(const CSR& A, const double* x, double* y)
+{
+	const int N = A.nr;
+	const int* rp = &A.rp[0];
+	const int* ci = (A.ci.empty() ? nullptr : &A.ci[0]);
+	const double* v = (A.v.empty() ? nullptr : &A.v[0]);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < N; ++i)
+	{
+		double s = 0.0;
+		for (int k = rp[i]; k < rp[i + 1]; ++k) s += v[k] * x[ci[k]];
+		y[i] = s;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// T = A^T
+template <class CSR> static void transpose(const CSR& A, CSR& T)
+{
+	T.nr = A.nc;
+	T.nc = A.nr;
+	T.rp.assign(T.nr + 1, 0);
+	const int NNZ = A.NonZeroes();
+	for (int k = 0; k < NNZ; ++k) T.rp[A.ci[k] + 1]++;
+	for (int i = 0; i < T.nr; ++i) T.rp[i + 1] += T.rp[i];
+
+	T.ci.resize(NNZ);
+	T.v.resize(NNZ);
+	vector<int> pos(T.rp.begin(), T.rp.end() - 1);
+	for (int i = 0; i < A.nr; ++i)
+	{
+		for (int k = A.rp[i]; k < A.rp[i + 1]; ++k)
+		{
+			int n = pos[A.ci[k]]++;
+			T.ci[n] = i;
+			T.v[n] = A.v[k];
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// C = A*B (the rows are evaluated in parallel)
+template <class CSR> static void multiply(const CSR& A, const CSR& B, CSR& C)
+{
+	const int N = A.nr;
+	const int M = B.nc;
+	C.nr = N;
+	C.nc = M;
+	C.rp.assign(N + 1, 0);
+
+	// count the nonzeroes of each row
+#pragma omp parallel
+	{
+		vector<int> mark(M, -1);
+#pragma omp for schedule(static)
+		for (int i = 0; i < N; ++i)
+		{
+			int n = 0;
+			for (int k = A.rp[i]; k < A.rp[i + 1]; ++k)
+			{
+				const int j = A.ci[k];
+				for (int l = B.rp[j]; l < B.rp[j + 1]; ++l)
+				{
+					const int c = B.ci[l];
+					if (mark[c] != i) { mark[c] = i; n++; }
+				}
+			}
+			C.rp[i + 1] = n;
+		}
+	}
+	for (int i = 0; i < N; ++i) C.rp[i + 1] += C.rp[i];
+
+	C.ci.resize(C.rp[N]);
+	C.v.resize(C.rp[N]);
+
+	// evaluate the products
+#pragma omp parallel
+	{
+		// rows are processed in ascending order by each thread, so
+		// any position that lies before the start of the row is stale
+		vector<int> pos(M, -1);
+#pragma omp for schedule(static)
+		for (int i = 0; i < N; ++i)
+		{
+			const int k0 = C.rp[i];
+			int n = k0;
+			for (int k = A.rp[i]; k < A.rp[i + 1]; ++k)
+			{
+				const int j = A.ci[k];
+				const double a = A.v[k];
+				for (int l = B.rp[j]; l < B.rp[j + 1]; ++l)
+				{
+					const int c = B.ci[l];
+					if (pos[c] < k0)
+					{
+						pos[c] = n;
+						C.ci[n] = c;
+						C.v[n] = a*B.v[l];
+						n++;
+					}
+					else C.v[pos[c]] += a*B.v[l];
+				}
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+NativeAMGPreconditioner::NativeAMGPreconditioner(FEModel* fem) : Preconditioner(fem)
+{
+	m_maxLevels = 10;
+	m_coarseSize = 500;
+	m_theta = 0.0;
+	m_nsmooth = 1;
+	m_ncycle = 1;
+	m_printLevel = 0;
+
+	m_K = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* NativeAMGPreconditioner::CreateSparseMatrix(Matrix_Type ntype)
+{
+	// the matrix is copied in Factor, so any format will do
+	if (ntype == REAL_SYMMETRIC) m_K = new CompactSymmMatrix(0);
+	else m_K = new CRSSparseMatrix(0);
+	return m_K;
+}
+
+//-----------------------------------------------------------------------------
+void NativeAMGPreconditioner::Destroy()
+{
+	m_level.clear();
+	vector<double>().swap(m_LU);
+	vector<int>().swap(m_piv);
+}
+
+//-----------------------------------------------------------------------------
+bool NativeAMGPreconditioner::CopyMatrix(CompactMatrix* K, CSR& A)
+{
+	const int N = K->Rows();
+	if (N != K->Columns()) return false;
+
+	const int offset = K->Offset();
+	const int* pp = K->Pointers();
+	const int* pi = K->Indices();
+	const double* pv = K->Values();
+
+	A.nr = A.nc = N;
+	A.rp.assign(N + 1, 0);
+	if (K->isSymmetric())
+	{
+		// only the lower triangular part is stored (column by column), so each
+		// off-diagonal entry (i,j) also needs to be stored as (j,i).
+		for (int j = 0; j < N; ++j)
+		{
+			for (int k = pp[j] - offset; k < pp[j + 1] - offset; ++k)
+			{
+				const int i = pi[k] - offset;
+				A.rp[i + 1]++;
+				if (i != j) A.rp[j + 1]++;
+			}
+		}
+		for (int i = 0; i < N; ++i) A.rp[i + 1] += A.rp[i];
+
+		A.ci.resize(A.rp[N]);
+		A.v.resize(A.rp[N]);
+		vector<int> pos(A.rp.begin(), A.rp.end() - 1);
+		for (int j = 0; j < N; ++j)
+		{
+			for (int k = pp[j] - offset; k < pp[j + 1] - offset; ++k)
+			{
+				const int i = pi[k] - offset;
+				int n = pos[i]++;
+				A.ci[n] = j; A.v[n] = pv[k];
+				if (i != j)
+				{
+					n = pos[j]++;
+					A.ci[n] = i; A.v[n] = pv[k];
+				}
+			}
+		}
+	}
+	else if (K->isRowBased())
+	{
+		const int NNZ = pp[N] - offset;
+		for (int i = 0; i <= N; ++i) A.rp[i] = pp[i] - offset;
+		A.ci.resize(NNZ);
+		A.v.assign(pv, pv + NNZ);
+		for (int k = 0; k < NNZ; ++k) A.ci[k] = pi[k] - offset;
+	}
+	else
+	{
+		// column-based storage is the row-based storage of the transpose
+		CSR T;
+		const int NNZ = pp[N] - offset;
+		T.nr = T.nc = N;
+		T.rp.resize(N + 1);
+		for (int i = 0; i <= N; ++i) T.rp[i] = pp[i] - offset;
+		T.ci.resize(NNZ);
+		T.v.assign(pv, pv + NNZ);
+		for (int k = 0; k < NNZ; ++k) T.ci[k] = pi[k] - offset;
+		transpose(T, A);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// The rows of the matrix are assumed to be the model's (first) equations, so that the
+// degree of freedom of each row can be found from the nodal equation numbers. Rows that
+// do not belong to a nodal degree of freedom (or when there is no model) get function -1.
+void NativeAMGPreconditioner::BuildFunctions(vector<int>& fnc, int N)
+{
+	fnc.assign(N, -1);
+	FEModel* fem = GetFEModel();
+	if (fem == nullptr) return;
+
+	FEMesh& mesh = fem->GetMesh();
+	for (int i = 0; i < mesh.Nodes(); ++i)
+	{
+		FENode& node = mesh.Node(i);
+		for (int l = 0; l < node.dofs(); ++l)
+		{
+			int eq = node.m_ID[l];
+			if (eq < -1) eq = -eq - 2;
+			if ((eq >= 0) && (eq < N)) fnc[eq] = l;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// The prolongator is built from the aggregates of the strongly connected unknowns and is
+// then smoothed with one damped Jacobi step, i.e. P = (I - w D^-1 A) P_tent.
+bool NativeAMGPreconditioner::BuildProlongation(Level& L, vector<int>& fncCoarse)
+{
+	const CSR& A = L.A;
+	const vector<double>& dinv = L.dinv;
+	const vector<int>& fnc = L.fnc;
+	CSR& P = L.P;
+	const int N = A.nr;
+	const double theta2 = m_theta*m_theta;
+	auto strong = [&](int i, int k) {
+		const int j = A.ci[k];
+		if ((j == i) || (fnc[i] != fnc[j]) || (A.v[k] == 0.0)) return false;
+		return (A.v[k] * A.v[k] * fabs(dinv[i] * dinv[j]) >= theta2);
+	};
+
+	// phase 1: unknowns whose strong neighbors are all unaggregated form a new aggregate
+	vector<int> agg(N, -1);
+	int na = 0;
+	for (int i = 0; i < N; ++i)
+	{
+		if (agg[i] >= 0) continue;
+		int ns = 0;
+		bool bfree = true;
+		for (int k = A.rp[i]; k < A.rp[i + 1]; ++k)
+		{
+			if (strong(i, k))
+			{
+				ns++;
+				if (agg[A.ci[k]] >= 0) { bfree = false; break; }
+			}
+		}
+		if (bfree && (ns > 0))
+		{
+			agg[i] = na;
+			for (int k = A.rp[i]; k < A.rp[i + 1]; ++k) if (strong(i, k)) agg[A.ci[k]] = na;
+			na++;
+		}
+	}
+
+	// phase 2: add the remaining unknowns to the aggregate they are most strongly connected to
+	vector<int> agg1(agg);
+	for (int i = 0; i < N; ++i)
+	{
+		if (agg1[i] >= 0) continue;
+		double amax = 0.0;
+		for (int k = A.rp[i]; k < A.rp[i + 1]; ++k)
+		{
+			const int j = A.ci[k];
+			if ((agg1[j] >= 0) && strong(i, k) && (fabs(A.v[k]) > amax))
+			{
+				amax = fabs(A.v[k]);
+				agg[i] = agg1[j];
+			}
+		}
+	}
+
+	// phase 3: whatever is left forms aggregates with its unaggregated strong neighbors
+	for (int i = 0; i < N; ++i)
+	{
+		if (agg[i] >= 0) continue;
+		agg[i] = na;
+		for (int k = A.rp[i]; k < A.rp[i + 1]; ++k)
+		{
+			if ((agg[A.ci[k]] < 0) && strong(i, k)) agg[A.ci[k]] = na;
+		}
+		na++;
+	}
+
+	// see if the coarsening is still effective
+	if ((na == 0) || (na > 0.9*N)) return false;
+
+	// the aggregates inherit the function of their unknowns
+	fncCoarse.assign(na, -1);
+	for (int i = 0; i < N; ++i) fncCoarse[agg[i]] = fnc[i];
+
+	// tentative prolongator (the constant vector on each aggregate, normalized)
+	vector<int> size(na, 0);
+	for (int i = 0; i < N; ++i) size[agg[i]]++;
+	CSR Pt;
+	Pt.nr = N;
+	Pt.nc = na;
+	Pt.rp.resize(N + 1);
+	Pt.ci.resize(N);
+	Pt.v.resize(N);
+	for (int i = 0; i < N; ++i)
+	{
+		Pt.rp[i] = i;
+		Pt.ci[i] = agg[i];
+		Pt.v[i] = 1.0 / sqrt((double)size[agg[i]]);
+	}
+	Pt.rp[N] = N;
+
+	// estimate the spectral radius of D^-1 A with a few power iterations,
+	// which is bounded from above by the Gershgorin estimate
+	double rho = 0.0;
+	for (int i = 0; i < N; ++i)
+	{
+		double s = 0.0;
+		for (int k = A.rp[i]; k < A.rp[i + 1]; ++k) s += fabs(A.v[k]);
+		s *= fabs(dinv[i]);
+		if (s > rho) rho = s;
+	}
+	vector<double> u(N), w(N);
+	for (int i = 0; i < N; ++i) u[i] = 1.0 + (i % 7)*0.1;
+	double lam = 0.0;
+	for (int n = 0; n < 10; ++n)
+	{
+		double un = 0.0;
+		for (int i = 0; i < N; ++i) un += u[i] * u[i];
+		un = sqrt(un);
+		if (un == 0.0) break;
+		for (int i = 0; i < N; ++i) u[i] /= un;
+		spmv(A, &u[0], &w[0]);
+		lam = 0.0;
+		for (int i = 0; i < N; ++i) { w[i] *= dinv[i]; lam += w[i] * w[i]; }
+		lam = sqrt(lam);
+		u.swap(w);
+	}
+	if ((lam > 0.0) && (1.1*lam < rho)) rho = 1.1*lam;
+	if (rho <= 0.0) rho = 1.0;
+	const double omega = 4.0 / (3.0*rho);
+
+	// smoothing operator S = I - w D^-1 A
+	CSR S(A);
+	for (int i = 0; i < N; ++i)
+	{
+		for (int k = S.rp[i]; k < S.rp[i + 1]; ++k)
+		{
+			S.v[k] *= -omega*dinv[i];
+			if (S.ci[k] == i) S.v[k] += 1.0;
+		}
+	}
+
+	multiply(S, Pt, P);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool NativeAMGPreconditioner::FactorCoarse(const CSR& A)
+{
+	const int n = A.nr;
+	m_LU.assign((size_t)n*n, 0.0);
+	m_piv.resize(n);
+	double* a = &m_LU[0];
+	for (int i = 0; i < n; ++i)
+		for (int k = A.rp[i]; k < A.rp[i + 1]; ++k) a[(size_t)i*n + A.ci[k]] += A.v[k];
+
+	// LU factorization with partial pivoting
+	int nzero = 0;
+	for (int k = 0; k < n; ++k)
+	{
+		int p = k;
+		double amax = fabs(a[(size_t)k*n + k]);
+		for (int i = k + 1; i < n; ++i)
+		{
+			double aik = fabs(a[(size_t)i*n + k]);
+			if (aik > amax) { amax = aik; p = i; }
+		}
+		m_piv[k] = p;
+		if (p != k)
+		{
+			for (int j = 0; j < n; ++j) std::swap(a[(size_t)k*n + j], a[(size_t)p*n + j]);
+		}
+
+		double akk = a[(size_t)k*n + k];
+		if (akk == 0.0)
+		{
+			// a singular coarse matrix only affects the quality of the preconditioner
+			a[(size_t)k*n + k] = akk = 1.0;
+			nzero++;
+		}
+
+		const double* ak = a + (size_t)k*n;
+#pragma omp parallel for schedule(static) if (n - k > 256)
+		for (int i = k + 1; i < n; ++i)
+		{
+			double* ai = a + (size_t)i*n;
+			const double l = ai[k] / akk;
+			ai[k] = l;
+			if (l != 0.0)
+			{
+				for (int j = k + 1; j < n; ++j) ai[j] -= l*ak[j];
+			}
+		}
+	}
+
+	if (nzero > 0) feLogWarning("AMG: Coarse level matrix is singular (%d zero pivots).", nzero);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool NativeAMGPreconditioner::Factor()
+{
+	// the matrix may also have been set directly
+	if (m_K == nullptr) m_K = dynamic_cast<CompactMatrix*>(GetSparseMatrix());
+	if (m_K == nullptr) return false;
+
+	m_level.clear();
+	m_LU.clear();
+	m_level.reserve(m_maxLevels > 1 ? m_maxLevels : 1);
+	m_level.push_back(Level());
+	if (CopyMatrix(m_K, m_level[0].A) == false) return false;
+	BuildFunctions(m_level[0].fnc, m_level[0].A.nr);
+
+	for (int l = 0;; ++l)
+	{
+		Level& L = m_level[l];
+		const CSR& A = L.A;
+		const int N = A.nr;
+
+		// inverse of the diagonal
+		L.dinv.assign(N, 1.0);
+		for (int i = 0; i < N; ++i)
+		{
+			for (int k = A.rp[i]; k < A.rp[i + 1]; ++k)
+			{
+				if ((A.ci[k] == i) && (A.v[k] != 0.0)) { L.dinv[i] = 1.0 / A.v[k]; break; }
+			}
+		}
+
+		L.x.assign(N, 0.0);
+		L.b.assign(N, 0.0);
+		L.r.assign(N, 0.0);
+		L.xold.assign(N, 0.0);
+
+		// see if this is the coarsest level
+		if ((N <= m_coarseSize) || (l + 1 >= m_maxLevels)) break;
+		vector<int> fnc;
+		if (BuildProlongation(L, fnc) == false) break;
+		transpose(L.P, L.R);
+
+		// Galerkin coarse level operator A_c = R A P
+		CSR AP;
+		multiply(A, L.P, AP);
+		m_level.push_back(Level());
+		multiply(m_level[l].R, AP, m_level[l + 1].A);
+		m_level[l + 1].fnc.swap(fnc);
+	}
+
+	// factor the coarsest level
+	const CSR& Ac = m_level.back().A;
+	if (Ac.nr <= AMG_MAX_DENSE_SIZE)
+	{
+		if (FactorCoarse(Ac) == false) return false;
+	}
+
+	if (m_printLevel > 0)
+	{
+		double nnz0 = (double)m_level[0].A.NonZeroes(), nnz = 0.0;
+		feLog("AMG: %d levels\n", Levels());
+		for (int l = 0; l < Levels(); ++l)
+		{
+			const CSR& A = m_level[l].A;
+			feLog("\tlevel %d: %d rows, %d nonzeroes\n", l, A.nr, A.NonZeroes());
+			nnz += A.NonZeroes();
+		}
+		feLog("\toperator complexity: %lg\n", (nnz0 > 0.0 ? nnz / nnz0 : 0.0));
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Hybrid symmetric Gauss-Seidel sweep. Each thread does a forward and backward sweep over
+// its own rows using the values of the other threads' rows from before the sweep.
+void NativeAMGPreconditioner::Smooth(int l)
+{
+	Level& L = m_level[l];
+	const CSR& A = L.A;
+	const int N = A.nr;
+	const int* rp = &A.rp[0];
+	const int* ci = &A.ci[0];
+	const double* v = &A.v[0];
+	const double* dinv = &L.dinv[0];
+	const double* b = &L.b[0];
+	double* x = &L.x[0];
+	double* xold = &L.xold[0];
+	for (int i = 0; i < N; ++i) xold[i] = x[i];
+
+#pragma omp parallel if (N > 1000)
+	{
+		const int nt = omp_get_num_threads();
+		const int t = omp_get_thread_num();
+		const int i0 = (int)(((long long)N*t) / nt);
+		const int i1 = (int)(((long long)N*(t + 1)) / nt);
+
+		auto relax = [=](int i) {
+			double s = b[i];
+			for (int k = rp[i]; k < rp[i + 1]; ++k)
+			{
+				const int j = ci[k];
+				if (j == i) continue;
+				s -= v[k] * ((j >= i0) && (j < i1) ? x[j] : xold[j]);
+			}
+			x[i] = s*dinv[i];
+		};
+
+		for (int i = i0; i < i1; ++i) relax(i);
+		for (int i = i1 - 1; i >= i0; --i) relax(i);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void NativeAMGPreconditioner::Cycle(int l)
+{
+	Level& L = m_level[l];
+	const int N = L.A.nr;
+	double* x = &L.x[0];
+	for (int i = 0; i < N; ++i) x[i] = 0.0;
+
+	// solve the coarsest level
+	if (l == Levels() - 1)
+	{
+		if (m_LU.empty())
+		{
+			for (int n = 0; n < 10 * m_nsmooth; ++n) Smooth(l);
+			return;
+		}
+
+		const double* a = &m_LU[0];
+		for (int i = 0; i < N; ++i) x[i] = L.b[i];
+		for (int k = 0; k < N; ++k)
+		{
+			if (m_piv[k] != k) std::swap(x[k], x[m_piv[k]]);
+		}
+		for (int i = 1; i < N; ++i)
+		{
+			double s = x[i];
+			const double* ai = a + (size_t)i*N;
+			for (int j = 0; j < i; ++j) s -= ai[j] * x[j];
+			x[i] = s;
+		}
+		for (int i = N - 1; i >= 0; --i)
+		{
+			double s = x[i];
+			const double* ai = a + (size_t)i*N;
+			for (int j = i + 1; j < N; ++j) s -= ai[j] * x[j];
+			x[i] = s / ai[i];
+		}
+		return;
+	}
+
+	// pre-smoothing
+	for (int n = 0; n < m_nsmooth; ++n) Smooth(l);
+
+	// restrict the residual
+	Level& C = m_level[l + 1];
+	spmv(L.A, x, &L.r[0]);
+	for (int i = 0; i < N; ++i) L.r[i] = L.b[i] - L.r[i];
+	spmv(L.R, &L.r[0], &C.b[0]);
+
+	// coarse level correction
+	Cycle(l + 1);
+	spmv(L.P, &C.x[0], &L.r[0]);
+	for (int i = 0; i < N; ++i) x[i] += L.r[i];
+
+	// post-smoothing
+	for (int n = 0; n < m_nsmooth; ++n) Smooth(l);
+}
+
+//-----------------------------------------------------------------------------
+bool NativeAMGPreconditioner::BackSolve(double* x, double* y)
+{
+	if (m_level.empty()) return false;
+
+	Level& L = m_level[0];
+	const int N = L.A.nr;
+	for (int i = 0; i < N; ++i) L.b[i] = y[i];
+	for (int i = 0; i < N; ++i) x[i] = 0.0;
+
+	int ncycle = (m_ncycle > 0 ? m_ncycle : 1);
+	for (int n = 0; n < ncycle; ++n)
+	{
+		// correct for the residual of the previous cycles
+		if (n > 0)
+		{
+			spmv(L.A, x, &L.r[0]);
+			for (int i = 0; i < N; ++i) L.b[i] = y[i] - L.r[i];
+		}
+
+		Cycle(0);
+		for (int i = 0; i < N; ++i) x[i] += L.x[i];
+	}
+
+	return true;
+}
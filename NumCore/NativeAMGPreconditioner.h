@@ -0,0 +1,121 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/Preconditioner.h>
+
+class CompactMatrix;
+
+//-----------------------------------------------------------------------------
+//! Smoothed aggregation algebraic multigrid preconditioner that does not depend on
+//! MKL or HYPRE. The hierarchy is built in Factor and every call to BackSolve applies
+//! a number of V-cycles (with zero initial guess). The smoother is a hybrid symmetric
+//! Gauss-Seidel sweep (i.e. Gauss-Seidel within each thread's rows and Jacobi across
+//! threads), and the coarsest level is solved with a dense LU factorization.
+//! Unknowns are only aggregated with unknowns of the same degree of freedom (e.g. the
+//! same displacement component), which is looked up from the model's equation numbers.
+//! Any compact matrix format is accepted since the matrix is copied to full row storage.
+class NativeAMGPreconditioner : public Preconditioner
+{
+	// sparse matrix in (zero-based) compressed row storage
+	struct CSR
+	{
+		int	nr, nc;
+		vector<int>		rp;
+		vector<int>		ci;
+		vector<double>	v;
+
+		CSR() { nr = nc = 0; }
+		int NonZeroes() const { return (int)v.size(); }
+	};
+
+	// data for one level of the hierarchy
+	struct Level
+	{
+		CSR		A;		// level matrix
+		CSR		P;		// prolongation to this level from the next (coarser) level
+		CSR		R;		// restriction (transpose of P)
+		vector<double>	dinv;	// inverse of the diagonal of A
+		vector<int>		fnc;	// the function (i.e. degree of freedom) each unknown belongs to
+		vector<double>	x, b, r, xold;	// work vectors
+	};
+
+public:
+	NativeAMGPreconditioner(FEModel* fem);
+
+	// build the multigrid hierarchy
+	bool Factor() override;
+
+	// apply to vector P x = y
+	bool BackSolve(double* x, double* y) override;
+
+	// create sparse matrix
+	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
+
+	// clean up
+	void Destroy() override;
+
+	// nr of levels in the hierarchy
+	int Levels() const { return (int)m_level.size(); }
+
+private:
+	// copy a compact matrix to full row storage
+	bool CopyMatrix(CompactMatrix* K, CSR& A);
+
+	// find the degree of freedom of each equation
+	void BuildFunctions(vector<int>& fnc, int N);
+
+	// build the smoothed prolongation operator for level l
+	bool BuildProlongation(Level& L, vector<int>& fncCoarse);
+
+	// factor the coarsest level
+	bool FactorCoarse(const CSR& A);
+
+	// apply a V-cycle on level l to the rhs stored in the level's b vector
+	void Cycle(int l);
+
+	// apply the smoother on level l
+	void Smooth(int l);
+
+private:
+	int		m_maxLevels;	// max number of levels
+	int		m_coarseSize;	// size of the coarsest level
+	double	m_theta;		// strength of connection threshold
+	int		m_nsmooth;		// nr of smoothing sweeps
+	int		m_ncycle;		// nr of V-cycles per application
+	int		m_printLevel;	// output level
+
+private:
+	CompactMatrix*	m_K;
+
+	vector<Level>	m_level;
+	vector<double>	m_LU;		// dense LU factorization of the coarsest level
+	vector<int>		m_piv;		// pivots of the coarse factorization
+
+	DECLARE_FECORE_CLASS();
+};
@@ -0,0 +1,307 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "NativeBlockSchurPreconditioner.h"
+#include "NativeAMGPreconditioner.h"
+#include "BlockMatrix.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEMesh.h>
+#include <FECore/FESolidDomain.h>
+#include <FECore/log.h>
+
+BEGIN_FECORE_CLASS(NativeBlockSchurPreconditioner, Preconditioner)
+	ADD_PARAMETER(m_method    , "method"  , 0, "diagonal\0lower_triangular\0upper_triangular\0");
+	ADD_PARAMETER(m_schurPC   , "schur_pc", 0, "diagonal\0lumped_mass\0");
+	ADD_PARAMETER(m_printLevel, "print_level");
+
+	ADD_PROPERTY(m_Apc, "A_pc", FEProperty::Optional);
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+NativeBlockSchurPreconditioner::NativeBlockSchurPreconditioner(FEModel* fem) : Preconditioner(fem)
+{
+	m_method = BLOCK_UPPER;
+	m_schurPC = SCHUR_DIAGONAL;
+	m_printLevel = 0;
+
+	m_Apc = nullptr;
+	m_K = nullptr;
+	m_ownApc = false;
+}
+
+//-----------------------------------------------------------------------------
+NativeBlockSchurPreconditioner::~NativeBlockSchurPreconditioner()
+{
+	if (m_ownApc) delete m_Apc;
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* NativeBlockSchurPreconditioner::CreateSparseMatrix(Matrix_Type ntype)
+{
+	if (m_part.size() != 2)
+	{
+		feLogError("The block Schur preconditioner requires two partitions.");
+		return nullptr;
+	}
+
+	m_K = new BlockMatrix();
+	m_K->Partition(m_part, ntype, 0);
+	return m_K;
+}
+
+//-----------------------------------------------------------------------------
+void NativeBlockSchurPreconditioner::Destroy()
+{
+	if (m_Apc) m_Apc->Destroy();
+	vector<double>().swap(m_tu);
+	vector<double>().swap(m_tp);
+}
+
+//-----------------------------------------------------------------------------
+bool NativeBlockSchurPreconditioner::Factor()
+{
+	// the matrix may also have been set directly
+	if (m_K == nullptr) m_K = dynamic_cast<BlockMatrix*>(GetSparseMatrix());
+	if ((m_K == nullptr) || (m_K->Partitions() != 2)) return false;
+
+	// by default, the A block is approximated with algebraic multigrid
+	if (m_Apc == nullptr)
+	{
+		m_Apc = new NativeAMGPreconditioner(GetFEModel());
+		m_ownApc = true;
+	}
+	m_Apc->SetFEModel(GetFEModel());
+
+	// (re)build the A block preconditioner
+	BlockMatrix::BLOCK& A = m_K->Block(0, 0);
+	if (m_Apc->SetSparseMatrix(A.pA) == false) return false;
+	if (m_Apc->PreProcess() == false) return false;
+	if (m_Apc->Factor() == false) return false;
+
+	// approximate the Schur complement
+	if (BuildSchurDiagonal() == false) return false;
+
+	m_tu.resize(m_K->PartitionEquations(0));
+	m_tp.resize(m_K->PartitionEquations(1));
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// The Schur complement is approximated by S = diag(D - C diag(A)^-1 B), or by the lumped
+// mass matrix of the second partition's unknowns, scaled such that its trace matches
+// the trace of the diagonal approximation.
+bool NativeBlockSchurPreconditioner::BuildSchurDiagonal()
+{
+	BlockMatrix::BLOCK& A = m_K->Block(0, 0);
+	BlockMatrix::BLOCK& B = m_K->Block(0, 1);
+	BlockMatrix::BLOCK& C = m_K->Block(1, 0);
+	BlockMatrix::BLOCK& D = m_K->Block(1, 1);
+
+	const int n0 = m_K->PartitionEquations(0);
+	const int n1 = m_K->PartitionEquations(1);
+
+	// the off-diagonal blocks are always stored in row-based format
+	CompactMatrix* MB = B.pA;
+	CompactMatrix* MC = C.pA;
+	if ((MB == nullptr) || (MC == nullptr) || !MB->isRowBased() || !MC->isRowBased()) return false;
+
+	vector<double> Ainv(n0);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n0; ++i)
+	{
+		double aii = A.pA->diag(i);
+		Ainv[i] = (aii != 0.0 ? 1.0 / aii : 0.0);
+	}
+
+	// transpose of B, so that the columns of B can be merged with the rows of C
+	const int offB = MB->Offset();
+	const int* bp = MB->Pointers();
+	const int* bi = MB->Indices();
+	const double* bv = MB->Values();
+	const int nnzB = bp[n0] - offB;
+	vector<int> tp(n1 + 1, 0), ti(nnzB);
+	vector<double> tv(nnzB);
+	for (int k = 0; k < nnzB; ++k) tp[bi[k] - offB + 1]++;
+	for (int i = 0; i < n1; ++i) tp[i + 1] += tp[i];
+	vector<int> pos(tp.begin(), tp.end() - 1);
+	for (int r = 0; r < n0; ++r)
+	{
+		for (int k = bp[r] - offB; k < bp[r + 1] - offB; ++k)
+		{
+			int n = pos[bi[k] - offB]++;
+			ti[n] = r;
+			tv[n] = bv[k];
+		}
+	}
+
+	// S_ii = D_ii - sum_k C_ik B_ki / A_kk (the column indices are sorted in each row)
+	const int offC = MC->Offset();
+	const int* cp = MC->Pointers();
+	const int* ci = MC->Indices();
+	const double* cv = MC->Values();
+	vector<double> S(n1);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n1; ++i)
+	{
+		double s = (D.pA ? D.pA->diag(i) : 0.0);
+		int p = cp[i] - offC, p1 = cp[i + 1] - offC;
+		int q = tp[i], q1 = tp[i + 1];
+		while ((p < p1) && (q < q1))
+		{
+			const int k = ci[p] - offC;
+			if (k == ti[q]) { s -= cv[p] * tv[q] * Ainv[k]; ++p; ++q; }
+			else if (k < ti[q]) ++p;
+			else ++q;
+		}
+		S[i] = s;
+	}
+
+	if (m_schurPC == SCHUR_LUMPED_MASS)
+	{
+		vector<double> M;
+		if (BuildLumpedMass(M) == false) return false;
+
+		double trS = 0.0, trM = 0.0;
+		for (int i = 0; i < n1; ++i)
+		{
+			if (M[i] > 0.0) { trS += S[i]; trM += M[i]; }
+		}
+		if (trM > 0.0)
+		{
+			const double alpha = trS / trM;
+			if (m_printLevel > 0) feLog("Schur complement mass scale factor: %lg\n", alpha);
+			for (int i = 0; i < n1; ++i) if (M[i] > 0.0) S[i] = alpha*M[i];
+		}
+	}
+
+	// invert the approximation (singular rows are left unscaled)
+	m_Sinv.resize(n1);
+	int nzero = 0;
+	for (int i = 0; i < n1; ++i)
+	{
+		if (S[i] != 0.0) m_Sinv[i] = 1.0 / S[i];
+		else { m_Sinv[i] = 1.0; nzero++; }
+	}
+	if ((nzero > 0) && (m_printLevel > 0)) feLogWarning("%d zero diagonals in Schur complement approximation.", nzero);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Evaluates the row sums of the mass matrix (with unit density) for the equations in the
+// second partition, i.e. the integrals of the nodal shape functions over the solid domains.
+bool NativeBlockSchurPreconditioner::BuildLumpedMass(vector<double>& M)
+{
+	FEModel* fem = GetFEModel();
+	if (fem == nullptr) return false;
+	FEMesh& mesh = fem->GetMesh();
+
+	const int n0 = m_K->StartEquationIndex(1);
+	const int n1 = m_K->PartitionEquations(1);
+	M.assign(n1, 0.0);
+
+	for (int nd = 0; nd < mesh.Domains(); ++nd)
+	{
+		FESolidDomain* dom = dynamic_cast<FESolidDomain*>(&mesh.Domain(nd));
+		if (dom == nullptr) continue;
+
+		for (int j = 0; j < dom->Elements(); ++j)
+		{
+			FESolidElement& el = dom->Element(j);
+			const int nint = el.GaussPoints();
+			const int neln = el.Nodes();
+			const double* gw = el.GaussWeights();
+
+			for (int a = 0; a < neln; ++a)
+			{
+				double Va = 0.0;
+				for (int n = 0; n < nint; ++n) Va += el.H(n)[a] * dom->detJ0(el, n)*gw[n];
+
+				FENode& node = mesh.Node(el.m_node[a]);
+				for (int l = 0; l < node.dofs(); ++l)
+				{
+					int eq = node.m_ID[l];
+					if (eq < -1) eq = -eq - 2;
+					if ((eq >= n0) && (eq < n0 + n1)) M[eq - n0] += Va;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool NativeBlockSchurPreconditioner::BackSolve(double* x, double* y)
+{
+	if ((m_K == nullptr) || (m_Apc == nullptr)) return false;
+
+	BlockMatrix::BLOCK& B = m_K->Block(0, 1);
+	BlockMatrix::BLOCK& C = m_K->Block(1, 0);
+
+	const int n0 = m_K->PartitionEquations(0);
+	const int n1 = m_K->PartitionEquations(1);
+	double* xu = x;
+	double* xp = x + n0;
+	double* yu = y;
+	double* yp = y + n0;
+	const double* Sinv = &m_Sinv[0];
+
+	switch (m_method)
+	{
+	case BLOCK_DIAGONAL:
+	{
+		if (m_Apc->BackSolve(xu, yu) == false) return false;
+		for (int i = 0; i < n1; ++i) xp[i] = Sinv[i] * yp[i];
+	}
+	break;
+	case BLOCK_LOWER:
+	{
+		// xu = A^-1 yu, xp = S^-1 (yp - C xu)
+		if (m_Apc->BackSolve(xu, yu) == false) return false;
+		C.pA->mult_vector(xu, &m_tp[0]);
+		for (int i = 0; i < n1; ++i) xp[i] = Sinv[i] * (yp[i] - m_tp[i]);
+	}
+	break;
+	case BLOCK_UPPER:
+	{
+		// xp = S^-1 yp, xu = A^-1 (yu - B xp)
+		for (int i = 0; i < n1; ++i) xp[i] = Sinv[i] * yp[i];
+		B.pA->mult_vector(xp, &m_tu[0]);
+		for (int i = 0; i < n0; ++i) m_tu[i] = yu[i] - m_tu[i];
+		if (m_Apc->BackSolve(xu, &m_tu[0]) == false) return false;
+	}
+	break;
+	default:
+		return false;
+	}
+
+	return true;
+}
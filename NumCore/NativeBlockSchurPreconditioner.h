@@ -0,0 +1,101 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/Preconditioner.h>
+
+class BlockMatrix;
+
+//-----------------------------------------------------------------------------
+//! Block preconditioner for 2x2 (saddle-point) systems of the form
+//!
+//!   | A  B | |u|   |f|
+//!   | C  D | |p| = |g|
+//!
+//! which uses the partitions of the linear solver to define the blocks. The A block
+//! is approximated by a preconditioner (by default native algebraic multigrid), and the
+//! Schur complement S = D - C A^-1 B is approximated by a diagonal matrix. This is
+//! meant to be used as the "pc_left" preconditioner of the native FGMRES solver, which
+//! applies it on the right as a flexible preconditioner (see NativeFGMRESSolver). It 
+//! does not depend on MKL.
+class NativeBlockSchurPreconditioner : public Preconditioner
+{
+public:
+	// the form of the block preconditioner
+	enum Block_Method {
+		BLOCK_DIAGONAL,		// diag(A, S)
+		BLOCK_LOWER,		// [A 0; C S]
+		BLOCK_UPPER			// [A B; 0 S]
+	};
+
+	// the approximation of the Schur complement
+	enum Schur_Approximation {
+		SCHUR_DIAGONAL,		// diag(D - C diag(A)^-1 B)
+		SCHUR_LUMPED_MASS	// lumped mass matrix of the second partition's unknowns
+	};
+
+public:
+	NativeBlockSchurPreconditioner(FEModel* fem);
+	~NativeBlockSchurPreconditioner();
+
+	// create a preconditioner for a sparse matrix
+	bool Factor() override;
+
+	// apply to vector P x = y
+	bool BackSolve(double* x, double* y) override;
+
+	// create sparse matrix
+	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
+
+	// clean up
+	void Destroy() override;
+
+private:
+	// calculate the diagonal approximation of the Schur complement
+	bool BuildSchurDiagonal();
+
+	// calculate the lumped mass matrix of the unknowns of the second partition
+	bool BuildLumpedMass(vector<double>& M);
+
+private:
+	int		m_method;		// the block method (see Block_Method)
+	int		m_schurPC;		// Schur complement approximation (see Schur_Approximation)
+	int		m_printLevel;	// output level
+
+	LinearSolver*	m_Apc;	// preconditioner for the A block
+
+private:
+	BlockMatrix*	m_K;
+	bool			m_ownApc;	// the A block preconditioner was allocated by this class
+
+	vector<double>	m_Sinv;		// inverse of the Schur complement approximation
+	vector<double>	m_tu;		// temp buffers
+	vector<double>	m_tp;
+
+	DECLARE_FECORE_CLASS();
+};
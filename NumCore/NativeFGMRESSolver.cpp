@@ -0,0 +1,309 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "NativeFGMRESSolver.h"
+#include "CompactSymmMatrix.h"
+#include "CompactUnSymmMatrix.h"
+#include "BSRSparseMatrix.h"
+#include "MatrixTools.h"
+#include <FECore/Preconditioner.h>
+#include <FECore/log.h>
+
+BEGIN_FECORE_CLASS(NativeFGMRESSolver, IterativeLinearSolver)
+	ADD_PARAMETER(m_maxiter       , "max_iter");
+	ADD_PARAMETER(m_print_level   , "print_level");
+	ADD_PARAMETER(m_nrestart      , "max_restart");
+	ADD_PARAMETER(m_reltol        , "tol");
+	ADD_PARAMETER(m_abstol        , "abs_tol");
+	ADD_PARAMETER(m_maxIterFail   , "fail_max_iters");
+	ADD_PARAMETER(m_blockMatrix   , "block_matrix");
+
+	ADD_PROPERTY(m_P, "pc_left");
+	ADD_PROPERTY(m_R, "pc_right");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+NativeFGMRESSolver::NativeFGMRESSolver(FEModel* fem) : IterativeLinearSolver(fem), m_pA(nullptr)
+{
+	m_maxiter = 0; // use default min(N, 150)
+	m_nrestart = 0; // use default min(maxiter, 50)
+	m_print_level = 0;
+	m_reltol = 1e-6;
+	m_abstol = 0.0;
+	m_maxIterFail = true;
+	m_blockMatrix = false;
+
+	m_P = nullptr;
+	m_R = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void NativeFGMRESSolver::SetLeftPreconditioner(LinearSolver* P) { m_P = P; }
+void NativeFGMRESSolver::SetRightPreconditioner(LinearSolver* R) { m_R = R; }
+LinearSolver* NativeFGMRESSolver::GetLeftPreconditioner() { return m_P; }
+LinearSolver* NativeFGMRESSolver::GetRightPreconditioner() { return m_R; }
+
+//-----------------------------------------------------------------------------
+bool NativeFGMRESSolver::HasPreconditioner() const
+{
+	return ((m_P != nullptr) || (m_R != nullptr));
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* NativeFGMRESSolver::CreateSparseMatrix(Matrix_Type ntype)
+{
+	m_pA = nullptr;
+
+	// see if the preconditioner cares about the matrix format
+	if (m_P)
+	{
+		m_P->SetPartitions(m_part);
+		m_pA = m_P->CreateSparseMatrix(ntype);
+		return m_pA;
+	}
+	else if (m_R)
+	{
+		m_R->SetPartitions(m_part);
+		m_pA = m_R->CreateSparseMatrix(ntype);
+		return m_pA;
+	}
+
+	// we only need matrix-vector products, so any format will do
+	if (m_blockMatrix) m_pA = new BSRSparseMatrix(ntype == REAL_SYMMETRIC);
+	else if (ntype == REAL_SYMMETRIC) m_pA = new CompactSymmMatrix(0);
+	else m_pA = new CRSSparseMatrix(0);
+
+	return m_pA;
+}
+
+//-----------------------------------------------------------------------------
+bool NativeFGMRESSolver::SetSparseMatrix(SparseMatrix* pA)
+{
+	m_pA = pA;
+	return (m_pA != nullptr);
+}
+
+//-----------------------------------------------------------------------------
+int NativeFGMRESSolver::RestartSize(int N) const
+{
+	int maxIter = (m_maxiter > 0 ? m_maxiter : (N < 150 ? N : 150));
+	int M = (m_nrestart > 0 ? m_nrestart : (maxIter < 50 ? maxIter : 50));
+	if (M > maxIter) M = maxIter;
+	if (M > N) M = N;
+	return (M > 0 ? M : 1);
+}
+
+//-----------------------------------------------------------------------------
+bool NativeFGMRESSolver::PreProcess()
+{
+	if (m_pA == nullptr) return false;
+	int N = m_pA->Rows();
+	int M = RestartSize(N);
+
+	m_V.resize((size_t)(M + 1)*N);
+	m_Z.resize((size_t)M*N);
+	m_H.resize((M + 1)*M);
+	m_w.resize(N);
+	if (m_R) m_Rv.resize(N);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool NativeFGMRESSolver::Factor()
+{
+	if (m_pA == nullptr) return false;
+
+	// factor the preconditioners
+	LinearSolver* pc[2] = { m_P, m_R };
+	for (int i = 0; i < 2; ++i)
+	{
+		if (pc[i] == nullptr) continue;
+		Preconditioner* P = dynamic_cast<Preconditioner*>(pc[i]);
+		if (P && (P->GetSparseMatrix() == nullptr)) P->SetSparseMatrix(m_pA);
+		pc[i]->SetFEModel(GetFEModel());
+		if (pc[i]->PreProcess() == false) return false;
+		if (pc[i]->Factor() == false) return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool NativeFGMRESSolver::BackSolve(double* x, double* b)
+{
+	if (m_pA == nullptr) return false;
+
+	const int N = m_pA->Rows();
+	const int M = RestartSize(N);
+	const int maxIter = (m_maxiter > 0 ? m_maxiter : (N < 150 ? N : 150));
+	if ((int)m_Z.size() < M*N) PreProcess();
+
+	double* V = &m_V[0];
+	double* Z = &m_Z[0];
+	double* w = &m_w[0];
+	vector<double> g(M + 1), cs(M), sn(M), y(M);
+	double* h = &m_H[0];
+	auto H = [=](int i, int j) -> double& { return h[j*(M + 1) + i]; };
+
+	// zero solution vector
+	for (int i = 0; i < N; ++i) x[i] = 0.0;
+
+	// the initial residual is the rhs
+	double beta = sqrt(NumCore::dotProduct(N, b, b));
+	if (beta == 0.0) return true;
+	const double norm0 = beta;
+	const double tol = (m_reltol*norm0 > m_abstol ? m_reltol*norm0 : m_abstol);
+	for (int i = 0; i < N; ++i) V[i] = b[i];
+
+	if (m_print_level > 0) feLog("FGMRES:\n");
+
+	int iter = 0;
+	bool bconverged = false;
+	double resid = beta;
+	while ((iter < maxIter) && !bconverged)
+	{
+		// start a new cycle
+		for (int i = 0; i < N; ++i) V[i] /= beta;
+		for (int i = 0; i <= M; ++i) g[i] = 0.0;
+		g[0] = beta;
+
+		int k = 0;
+		for (int j = 0; j < M; ++j)
+		{
+			double* vj = V + (size_t)j*N;
+			double* zj = Z + (size_t)j*N;
+			double* vn = V + (size_t)(j + 1)*N;
+
+			// apply the (flexible) preconditioner
+			if (m_P)
+			{
+				if (m_P->mult_vector(vj, zj) == false) return false;
+			}
+			else for (int i = 0; i < N; ++i) zj[i] = vj[i];
+
+			// multiply with the matrix (and right preconditioner)
+			if (m_R)
+			{
+				m_R->mult_vector(zj, &m_Rv[0]);
+				m_pA->mult_vector(&m_Rv[0], w);
+			}
+			else m_pA->mult_vector(zj, w);
+
+			// modified Gram-Schmidt
+			for (int i = 0; i <= j; ++i)
+			{
+				double* vi = V + (size_t)i*N;
+				double hij = NumCore::dotProduct(N, w, vi);
+				H(i, j) = hij;
+				NumCore::axpy(N, -hij, vi, w);
+			}
+			double hn = sqrt(NumCore::dotProduct(N, w, w));
+			H(j + 1, j) = hn;
+			if (hn != 0.0)
+			{
+				for (int i = 0; i < N; ++i) vn[i] = w[i] / hn;
+			}
+
+			// apply the previous Givens rotations to the new column
+			for (int i = 0; i < j; ++i)
+			{
+				double t = cs[i] * H(i, j) + sn[i] * H(i + 1, j);
+				H(i + 1, j) = -sn[i] * H(i, j) + cs[i] * H(i + 1, j);
+				H(i, j) = t;
+			}
+
+			// calculate the new rotation
+			double a = H(j, j), c = H(j + 1, j);
+			double r = sqrt(a*a + c*c);
+			cs[j] = (r != 0.0 ? a / r : 1.0);
+			sn[j] = (r != 0.0 ? c / r : 0.0);
+			H(j, j) = r;
+			H(j + 1, j) = 0.0;
+			g[j + 1] = -sn[j] * g[j];
+			g[j] = cs[j] * g[j];
+
+			resid = fabs(g[j + 1]);
+			iter++;
+			k = j + 1;
+
+			if (m_print_level > 1) feLog("%3d = %lg (%lg)\n", iter, resid, tol);
+
+			if ((resid <= tol) || (hn == 0.0) || (iter >= maxIter)) break;
+		}
+
+		// solve the upper-triangular system H.y = g
+		for (int i = k - 1; i >= 0; --i)
+		{
+			double s = g[i];
+			for (int l = i + 1; l < k; ++l) s -= H(i, l)*y[l];
+			y[i] = (H(i, i) != 0.0 ? s / H(i, i) : 0.0);
+		}
+
+		// update the solution
+		for (int l = 0; l < k; ++l) NumCore::axpy(N, y[l], Z + (size_t)l*N, x);
+
+		// calculate the true residual for the next cycle
+		if (m_R)
+		{
+			m_R->mult_vector(x, &m_Rv[0]);
+			m_pA->mult_vector(&m_Rv[0], w);
+		}
+		else m_pA->mult_vector(x, w);
+		for (int i = 0; i < N; ++i) V[i] = b[i] - w[i];
+		beta = sqrt(NumCore::dotProduct(N, V, V));
+		resid = beta;
+		if ((beta <= tol) || (beta == 0.0)) bconverged = true;
+	}
+
+	if (m_R)
+	{
+		m_R->mult_vector(x, &m_Rv[0]);
+		for (int i = 0; i < N; ++i) x[i] = m_Rv[i];
+	}
+
+	if (m_print_level > 0)
+	{
+		feLog("%3d = %lg (%lg)\n", iter, resid, norm0);
+	}
+
+	// update stats
+	UpdateStats(iter);
+
+	return (m_maxIterFail ? bconverged : true);
+}
+
+//-----------------------------------------------------------------------------
+//! Clean up
+void NativeFGMRESSolver::Destroy()
+{
+	vector<double>().swap(m_V);
+	vector<double>().swap(m_Z);
+	vector<double>().swap(m_w);
+	vector<double>().swap(m_Rv);
+}
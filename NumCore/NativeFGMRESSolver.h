@@ -0,0 +1,119 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include <FECore/LinearSolver.h>
+#include <FECore/SparseMatrix.h>
+
+//-----------------------------------------------------------------------------
+//! Restarted flexible GMRES solver that does not depend on MKL.
+//! NOTE: Unlike the MKL fgmres solver, both preconditioners are applied on the right.
+//! The "pc_left" preconditioner P is the flexible one: it is applied to each Krylov 
+//! vector (z_j = P.v_j) and may vary between iterations (e.g. an inner iterative 
+//! solve or native_block_schur). The name was kept so that the same input works for 
+//! both fgmres solvers. The optional "pc_right" preconditioner R must be fixed. 
+//! With both, the system A.R.y = b is solved and the solution is x = R.y.
+class NativeFGMRESSolver : public IterativeLinearSolver
+{
+public:
+	//! constructor
+	NativeFGMRESSolver(FEModel* fem);
+
+	//! do any pre-processing (allocates temp storage)
+	bool PreProcess() override;
+
+	//! Factor the matrix
+	bool Factor() override;
+
+	//! Calculate the solution of RHS b and store solution in x
+	bool BackSolve(double* x, double* b) override;
+
+	//! Clean up
+	void Destroy() override;
+
+	//! Return a sparse matrix compatible with this solver
+	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
+
+	//! Set the sparse matrix
+	bool SetSparseMatrix(SparseMatrix* pA) override;
+
+	//! Set max nr of iterations
+	void SetMaxIterations(int n) { m_maxiter = n; }
+
+	//! Set the nr of non-restarted iterations
+	void SetNonRestartedIterations(int n) { m_nrestart = n; }
+
+	// Set the print level
+	void SetPrintLevel(int n) override { m_print_level = n; }
+
+	// set the relative convergence tolerance for the residual stopping test
+	void SetRelativeResidualTolerance(double tol) { m_reltol = tol; }
+
+	// set the absolute convergence tolerance for the residual stopping test
+	void SetAbsoluteResidualTolerance(double tol) { m_abstol = tol; }
+
+	//! fail if max iterations reached
+	void FailOnMaxIterations(bool b) { m_maxIterFail = b; }
+
+	//! see if the solver has a preconditioner
+	bool HasPreconditioner() const override;
+
+public:
+	// set the preconditioner
+	void SetLeftPreconditioner(LinearSolver* P) override;
+	void SetRightPreconditioner(LinearSolver* P) override;
+
+	// get the preconditioner
+	LinearSolver* GetLeftPreconditioner() override;
+	LinearSolver* GetRightPreconditioner() override;
+
+private:
+	// calculate the number of iterations before a restart
+	int RestartSize(int N) const;
+
+private:
+	int		m_maxiter;			// max nr of iterations
+	int		m_nrestart;			// max nr of non-restarted iterations
+	int		m_print_level;		// output level
+	double	m_reltol;			// relative residual convergence tolerance
+	double	m_abstol;			// absolute residual tolerance
+	bool	m_maxIterFail;
+	bool	m_blockMatrix;		// use a 3x3 block matrix when the preconditioner does not pick a format
+
+private:
+	SparseMatrix*	m_pA;		//!< the sparse matrix format
+	LinearSolver*	m_P;		//!< the flexible preconditioner ("pc_left", but applied on the right)
+	LinearSolver*	m_R;		//!< the fixed right preconditioner ("pc_right")
+
+	vector<double>	m_V;		//!< Krylov basis
+	vector<double>	m_Z;		//!< preconditioned Krylov basis
+	vector<double>	m_H;		//!< Hessenberg matrix
+	vector<double>	m_w;
+	vector<double>	m_Rv;		//!< used when a right preconditioner is used
+
+	DECLARE_FECORE_CLASS();
+};
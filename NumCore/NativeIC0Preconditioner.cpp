@@ -0,0 +1,211 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "NativeIC0Preconditioner.h"
+#include "CompactSymmMatrix.h"
+#include <FECore/log.h>
+
+BEGIN_FECORE_CLASS(NativeIC0Preconditioner, Preconditioner)
+	ADD_PARAMETER(m_shift    , "shift");
+	ADD_PARAMETER(m_maxShifts, "max_shifts");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+NativeIC0Preconditioner::NativeIC0Preconditioner(FEModel* fem) : Preconditioner(fem)
+{
+	m_shift = 0.0;
+	m_maxShifts = 10;
+
+	m_K = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* NativeIC0Preconditioner::CreateSparseMatrix(Matrix_Type ntype)
+{
+	if (ntype != REAL_SYMMETRIC) return nullptr;
+	m_K = new CompactSymmMatrix(0);
+	return m_K;
+}
+
+//-----------------------------------------------------------------------------
+bool NativeIC0Preconditioner::Factor()
+{
+	// the matrix may also have been set directly
+	if (m_K == nullptr) m_K = dynamic_cast<CompactSymmMatrix*>(GetSparseMatrix());
+	if (m_K == nullptr) return false;
+
+	// K stores the lower triangular part column by column, i.e. the rows of L^T.
+	// The factorization works on the rows of L, so we need the transposed structure as well.
+	const int N = m_K->Rows();
+	const int offset = m_K->Offset();
+	const int* cp = m_K->Pointers();
+	const int* ci = m_K->Indices();
+
+	m_rowPtr.assign(N + 1, 0);
+	for (int j = 0; j < N; ++j)
+	{
+		for (int k = cp[j] - offset; k < cp[j + 1] - offset; ++k) m_rowPtr[ci[k] - offset + 1]++;
+	}
+	for (int i = 0; i < N; ++i) m_rowPtr[i + 1] += m_rowPtr[i];
+
+	const int NNZ = m_rowPtr[N];
+	m_rowInd.resize(NNZ);
+	m_rowToCol.resize(NNZ);
+	vector<int> pos(m_rowPtr.begin(), m_rowPtr.end() - 1);
+	for (int j = 0; j < N; ++j)
+	{
+		// columns are visited in ascending order, so the row indices come out sorted
+		for (int k = cp[j] - offset; k < cp[j + 1] - offset; ++k)
+		{
+			int i = ci[k] - offset;
+			m_rowInd[pos[i]] = j;
+			m_rowToCol[pos[i]] = k;
+			pos[i]++;
+		}
+	}
+
+	// the diagonal must be the last entry of each row
+	for (int i = 0; i < N; ++i)
+	{
+		if ((m_rowPtr[i + 1] == m_rowPtr[i]) || (m_rowInd[m_rowPtr[i + 1] - 1] != i))
+		{
+			feLogError("IC0: Missing diagonal entry in row %d.", i + 1);
+			return false;
+		}
+	}
+
+	m_Lr.resize(NNZ);
+	m_Lc.resize(NNZ);
+	m_tmp.resize(N);
+
+	// build the level schedules
+	m_lower.Build(N, &m_rowPtr[0], &m_rowInd[0], 0, true);
+	m_upper.Build(N, cp, ci, offset, false);
+
+	// try to factor the matrix, increasing the shift each time it fails
+	double alpha = m_shift;
+	for (int n = 0; n <= m_maxShifts; ++n)
+	{
+		if (FactorShifted(alpha))
+		{
+			if (alpha > 0.0) feLog("IC0: Diagonal shift = %lg\n", alpha);
+			return true;
+		}
+		alpha = (alpha == 0.0 ? 1e-3 : 2.0*alpha);
+	}
+
+	feLogError("IC0: Factorization failed.");
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+bool NativeIC0Preconditioner::FactorShifted(double alpha)
+{
+	const int NNZ = (int)m_Lr.size();
+	const double* pa = m_K->Values();
+	const int* rp = &m_rowPtr[0];
+	const int* ri = &m_rowInd[0];
+	double* L = &m_Lr[0];
+	for (int k = 0; k < NNZ; ++k) L[k] = pa[m_rowToCol[k]];
+
+	// Row i of L only depends on the rows k<i for which l_ik != 0,
+	// which were all processed in earlier levels.
+	int nfail = 0;
+	m_lower.Sweep([&](int i) {
+		const int k0 = rp[i];
+		const int kd = rp[i + 1] - 1;
+		for (int k = k0; k < kd; ++k)
+		{
+			// l_ij = (a_ij - sum_m l_im*l_jm) / l_jj, where the sum runs over the common columns m < j
+			const int j = ri[k];
+			double s = L[k];
+			int p = k0, q = rp[j];
+			const int qd = rp[j + 1] - 1;
+			while ((p < k) && (q < qd))
+			{
+				if (ri[p] == ri[q]) { s -= L[p] * L[q]; ++p; ++q; }
+				else if (ri[p] < ri[q]) ++p;
+				else ++q;
+			}
+			L[k] = s / L[qd];
+		}
+
+		double d = L[kd] * (1.0 + alpha);
+		for (int k = k0; k < kd; ++k) d -= L[k] * L[k];
+		if (d > 0.0) L[kd] = sqrt(d);
+		else
+		{
+			// keep going so that all threads finish the sweep
+			L[kd] = 1.0;
+#pragma omp atomic
+			nfail++;
+		}
+	});
+	if (nfail > 0) return false;
+
+	// copy the values to the column-based storage for the backward substitution
+	const int* r2c = &m_rowToCol[0];
+	double* Lc = &m_Lc[0];
+#pragma omp parallel for schedule(static)
+	for (int k = 0; k < NNZ; ++k) Lc[r2c[k]] = L[k];
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool NativeIC0Preconditioner::BackSolve(double* x, double* y)
+{
+	if (m_K == nullptr) return false;
+
+	const int offset = m_K->Offset();
+	const int* cp = m_K->Pointers();
+	const int* ci = m_K->Indices();
+	const int* rp = &m_rowPtr[0];
+	const int* ri = &m_rowInd[0];
+	const double* Lr = &m_Lr[0];
+	const double* Lc = &m_Lc[0];
+	double* z = &m_tmp[0];
+
+	// forward substitution L z = y
+	m_lower.Sweep([=](int i) {
+		const int kd = rp[i + 1] - 1;
+		double s = y[i];
+		for (int k = rp[i]; k < kd; ++k) s -= Lr[k] * z[ri[k]];
+		z[i] = s / Lr[kd];
+	});
+
+	// backward substitution L^T x = z (the rows of L^T are the columns of L)
+	m_upper.Sweep([=](int i) {
+		const int k0 = cp[i] - offset;
+		double s = z[i];
+		for (int k = k0 + 1; k < cp[i + 1] - offset; ++k) s -= Lc[k] * x[ci[k] - offset];
+		x[i] = s / Lc[k0];
+	});
+
+	return true;
+}
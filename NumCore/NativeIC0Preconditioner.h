@@ -0,0 +1,75 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include <FECore/Preconditioner.h>
+#include "LevelSchedule.h"
+
+class CompactSymmMatrix;
+
+//-----------------------------------------------------------------------------
+//! Incomplete Cholesky factorization with zero fill-in that does not depend on MKL.
+//! The factorization and the triangular solves are parallelized with level scheduling.
+//! If the factorization breaks down (i.e. a non-positive pivot is found), it is
+//! restarted with a diagonal shift.
+class NativeIC0Preconditioner : public Preconditioner
+{
+public:
+	NativeIC0Preconditioner(FEModel* fem);
+
+	// create a preconditioner for a sparse matrix
+	bool Factor() override;
+
+	// apply to vector P x = y
+	bool BackSolve(double* x, double* y) override;
+
+	// create sparse matrix
+	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
+
+private:
+	// try to factor the matrix with the diagonal shifted by alpha*diag(K)
+	bool FactorShifted(double alpha);
+
+public:
+	double	m_shift;		// initial diagonal shift
+	int		m_maxShifts;	// max number of times the shift is increased
+
+private:
+	CompactSymmMatrix*	m_K;
+
+	// the factor L is stored in row-based format (the diagonal is the last entry of each row)
+	vector<int>		m_rowPtr;
+	vector<int>		m_rowInd;
+	vector<int>		m_rowToCol;	// location of each row entry in the column-based storage of K
+	vector<double>	m_Lr;		// values of L (row-based)
+	vector<double>	m_Lc;		// values of L (column-based, i.e. the structure of K)
+	vector<double>	m_tmp;
+	LevelSchedule	m_lower;	// schedule for the factorization and forward substitution
+	LevelSchedule	m_upper;	// schedule for the backward substitution
+
+	DECLARE_FECORE_CLASS();
+};
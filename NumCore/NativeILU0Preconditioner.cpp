@@ -0,0 +1,171 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "NativeILU0Preconditioner.h"
+#include "CompactUnSymmMatrix.h"
+#include <FECore/log.h>
+#include <FECore/sys.h>
+
+BEGIN_FECORE_CLASS(NativeILU0Preconditioner, Preconditioner)
+	ADD_PARAMETER(m_checkZeroDiagonal, "replace_zero_diagonal");
+	ADD_PARAMETER(m_zeroThreshold    , "zero_threshold");
+	ADD_PARAMETER(m_zeroReplace      , "zero_replace");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+NativeILU0Preconditioner::NativeILU0Preconditioner(FEModel* fem) : Preconditioner(fem)
+{
+	m_checkZeroDiagonal = true;
+	m_zeroThreshold = 1e-16;
+	m_zeroReplace = 1e-10;
+
+	m_K = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* NativeILU0Preconditioner::CreateSparseMatrix(Matrix_Type ntype)
+{
+	// The symmetric format only stores one half of the matrix, so the full storage is needed.
+	if (ntype == REAL_SYMMETRIC) return nullptr;
+	m_K = new CRSSparseMatrix(0);
+	return m_K;
+}
+
+//-----------------------------------------------------------------------------
+bool NativeILU0Preconditioner::Factor()
+{
+	// the matrix may also have been set directly
+	if (m_K == nullptr) m_K = dynamic_cast<CRSSparseMatrix*>(GetSparseMatrix());
+	if (m_K == nullptr) return false;
+
+	const int N = m_K->Rows();
+	const int NNZ = m_K->NonZeroes();
+	const int offset = m_K->Offset();
+	const double* pa = m_K->Values();
+	const int* ia = m_K->Pointers();
+	const int* ja = m_K->Indices();
+
+	// copy the matrix values and locate the diagonals
+	m_LU.assign(pa, pa + NNZ);
+	m_diag.assign(N, -1);
+	for (int i = 0; i < N; ++i)
+	{
+		for (int k = ia[i] - offset; k < ia[i + 1] - offset; ++k)
+		{
+			if (ja[k] - offset == i) { m_diag[i] = k; break; }
+		}
+		if (m_diag[i] == -1)
+		{
+			feLogError("ILU0: Missing diagonal entry in row %d.", i + 1);
+			return false;
+		}
+	}
+	m_tmp.resize(N);
+
+	// build the level schedules
+	m_lower.Build(N, ia, ja, offset, true);
+	m_upper.Build(N, ia, ja, offset, false);
+
+	// Do the factorization. Row i only depends on the rows k<i for which a_ik != 0,
+	// which were all processed in earlier levels.
+	double* LU = &m_LU[0];
+	const int* diag = &m_diag[0];
+	int nzero = 0;
+	const bool checkZero = m_checkZeroDiagonal;
+	const double zeroThreshold = m_zeroThreshold;
+	const double zeroReplace = m_zeroReplace;
+	const int nt = (m_lower.IsParallel() ? omp_get_max_threads() : 1);
+	vector< vector<int> > iw(nt, vector<int>(N, -1));
+	m_lower.Sweep([&](int i) {
+		int* w = &(iw[nt > 1 ? omp_get_thread_num() : 0][0]);
+		const int k0 = ia[i] - offset;
+		const int k1 = ia[i + 1] - offset;
+		for (int k = k0; k < k1; ++k) w[ja[k] - offset] = k;
+
+		for (int k = k0; k < diag[i]; ++k)
+		{
+			const int r = ja[k] - offset;
+			const double lik = LU[k] / LU[diag[r]];
+			LU[k] = lik;
+			for (int m = diag[r] + 1; m < ia[r + 1] - offset; ++m)
+			{
+				const int n = w[ja[m] - offset];
+				if (n >= 0) LU[n] -= lik*LU[m];
+			}
+		}
+
+		if (fabs(LU[diag[i]]) < zeroThreshold)
+		{
+			if (checkZero) LU[diag[i]] = (LU[diag[i]] < 0 ? -zeroReplace : zeroReplace);
+			else
+			{
+#pragma omp atomic
+				nzero++;
+			}
+		}
+
+		for (int k = k0; k < k1; ++k) w[ja[k] - offset] = -1;
+	});
+
+	if (nzero > 0)
+	{
+		feLogError("ILU0: Zero pivot encountered.");
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool NativeILU0Preconditioner::BackSolve(double* x, double* y)
+{
+	if (m_K == nullptr) return false;
+
+	const int offset = m_K->Offset();
+	const int* ia = m_K->Pointers();
+	const int* ja = m_K->Indices();
+	const double* LU = &m_LU[0];
+	const int* diag = &m_diag[0];
+	double* z = &m_tmp[0];
+
+	// forward substitution L z = y (L has unit diagonal)
+	m_lower.Sweep([=](int i) {
+		double s = y[i];
+		for (int k = ia[i] - offset; k < diag[i]; ++k) s -= LU[k] * z[ja[k] - offset];
+		z[i] = s;
+	});
+
+	// backward substitution U x = z
+	m_upper.Sweep([=](int i) {
+		double s = z[i];
+		for (int k = diag[i] + 1; k < ia[i + 1] - offset; ++k) s -= LU[k] * x[ja[k] - offset];
+		x[i] = s / LU[diag[i]];
+	});
+
+	return true;
+}
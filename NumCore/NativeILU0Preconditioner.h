@@ -0,0 +1,66 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include <FECore/Preconditioner.h>
+#include "LevelSchedule.h"
+
+class CRSSparseMatrix;
+
+//-----------------------------------------------------------------------------
+//! Incomplete LU factorization with zero fill-in that does not depend on MKL.
+//! The factorization and the triangular solves are parallelized with level scheduling.
+class NativeILU0Preconditioner : public Preconditioner
+{
+public:
+	NativeILU0Preconditioner(FEModel* fem);
+
+	// create a preconditioner for a sparse matrix
+	bool Factor() override;
+
+	// apply to vector P x = y
+	bool BackSolve(double* x, double* y) override;
+
+	// create sparse matrix
+	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
+
+public:
+	bool	m_checkZeroDiagonal;	// check for zero diagonals
+	double	m_zeroThreshold;		// threshold for zero diagonal check
+	double	m_zeroReplace;			// replacement value for zero diagonal
+
+private:
+	CRSSparseMatrix*	m_K;
+
+	vector<double>	m_LU;		// the factorization (L and U stored in the sparsity pattern of K)
+	vector<int>		m_diag;		// location of diagonal in each row
+	vector<double>	m_tmp;		// intermediate result of the forward solve
+	LevelSchedule	m_lower;	// schedule for the factorization and forward substitution
+	LevelSchedule	m_upper;	// schedule for the backward substitution
+
+	DECLARE_FECORE_CLASS();
+};
@@ -0,0 +1,218 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "NativePCGSolver.h"
+#include "CompactSymmMatrix.h"
+#include "BSRSparseMatrix.h"
+#include "MatrixTools.h"
+#include <FECore/Preconditioner.h>
+#include <FECore/log.h>
+
+//-----------------------------------------------------------------------------
+BEGIN_FECORE_CLASS(NativePCGSolver, IterativeLinearSolver)
+	ADD_PARAMETER(m_print_level, "print_level");
+	ADD_PARAMETER(m_tol, "tol");
+	ADD_PARAMETER(m_abstol, "abs_tol");
+	ADD_PARAMETER(m_maxiter, "max_iter");
+	ADD_PARAMETER(m_fail_max_iters, "fail_max_iters");
+	ADD_PARAMETER(m_blockMatrix, "block_matrix");
+	ADD_PROPERTY(m_P, "pc_left");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+NativePCGSolver::NativePCGSolver(FEModel* fem) : IterativeLinearSolver(fem), m_pA(nullptr), m_P(nullptr)
+{
+	m_maxiter = 0;
+	m_tol = 1e-5;
+	m_abstol = 0.0;
+	m_print_level = 0;
+	m_fail_max_iters = true;
+	m_blockMatrix = false;
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* NativePCGSolver::CreateSparseMatrix(Matrix_Type ntype)
+{
+	// CG requires a symmetric matrix
+	if (ntype != REAL_SYMMETRIC) return nullptr;
+
+	// let the preconditioner decide
+	m_pA = nullptr;
+	if (m_P)
+	{
+		m_P->SetPartitions(m_part);
+		m_pA = m_P->CreateSparseMatrix(ntype);
+	}
+	else if (m_blockMatrix) m_pA = new BSRSparseMatrix(true);
+	else m_pA = new CompactSymmMatrix(0);
+
+	return m_pA;
+}
+
+//-----------------------------------------------------------------------------
+bool NativePCGSolver::SetSparseMatrix(SparseMatrix* A)
+{
+	m_pA = A;
+	return (m_pA != nullptr);
+}
+
+//-----------------------------------------------------------------------------
+void NativePCGSolver::SetLeftPreconditioner(LinearSolver* P)
+{
+	m_P = P;
+}
+
+//-----------------------------------------------------------------------------
+LinearSolver* NativePCGSolver::GetLeftPreconditioner()
+{
+	return m_P;
+}
+
+//-----------------------------------------------------------------------------
+bool NativePCGSolver::HasPreconditioner() const
+{
+	return (m_P != nullptr);
+}
+
+//-----------------------------------------------------------------------------
+bool NativePCGSolver::PreProcess()
+{
+	if (m_pA == nullptr) return false;
+	int N = m_pA->Rows();
+	m_r.resize(N);
+	m_z.resize(N);
+	m_p.resize(N);
+	m_q.resize(N);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool NativePCGSolver::Factor()
+{
+	if (m_pA == nullptr) return false;
+	if (m_P)
+	{
+		Preconditioner* P = dynamic_cast<Preconditioner*>(m_P);
+		if (P && (P->GetSparseMatrix() == nullptr)) P->SetSparseMatrix(m_pA);
+		m_P->SetFEModel(GetFEModel());
+		if (m_P->PreProcess() == false) return false;
+		if (m_P->Factor() == false) return false;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool NativePCGSolver::BackSolve(double* x, double* b)
+{
+	if (m_pA == nullptr) return false;
+
+	const int N = m_pA->Rows();
+	if ((int)m_r.size() != N) PreProcess();
+	const int maxIter = (m_maxiter > 0 ? m_maxiter : N);
+
+	double* r = &m_r[0];
+	double* z = &m_z[0];
+	double* p = &m_p[0];
+	double* q = &m_q[0];
+
+	// assume initial guess is zero, so r0 = b
+	for (int i = 0; i < N; ++i) { x[i] = 0.0; r[i] = b[i]; }
+	double norm0 = sqrt(NumCore::dotProduct(N, r, r));
+
+	// if the norm is zero, there is nothing to do
+	if (norm0 == 0.0) return true;
+	const double tol = norm0*m_tol + m_abstol;
+
+	// z0 = P r0, p0 = z0
+	if (m_P)
+	{
+		if (m_P->mult_vector(r, z) == false) return false;
+	}
+	else for (int i = 0; i < N; ++i) z[i] = r[i];
+	for (int i = 0; i < N; ++i) p[i] = z[i];
+	double rz = NumCore::dotProduct(N, r, z);
+
+	int iter = 0;
+	double normi = norm0;
+	bool converged = false;
+	while (iter < maxIter)
+	{
+		m_pA->mult_vector(p, q);
+
+		double pq = NumCore::dotProduct(N, p, q);
+		if (pq == 0.0) break;
+		double alpha = rz / pq;
+
+		NumCore::axpy(N, alpha, p, x);
+		NumCore::axpy(N, -alpha, q, r);
+
+		normi = sqrt(NumCore::dotProduct(N, r, r));
+		iter++;
+
+		if (m_print_level > 1)
+		{
+			feLog("%d:%lg, %lg\n", iter, normi, tol);
+		}
+
+		// see if we have converged
+		if (normi <= tol) { converged = true; break; }
+
+		// apply preconditioner
+		if (m_P)
+		{
+			if (m_P->mult_vector(r, z) == false) return false;
+		}
+		else for (int i = 0; i < N; ++i) z[i] = r[i];
+
+		double rz_new = NumCore::dotProduct(N, r, z);
+		double beta = rz_new / rz;
+		rz = rz_new;
+
+#pragma omp parallel for schedule(static)
+		for (int i = 0; i < N; ++i) p[i] = z[i] + beta*p[i];
+	}
+
+	if (m_print_level == 1)
+	{
+		feLog("%d:%lg, %lg\n", iter, normi, norm0);
+	}
+
+	// update stats
+	UpdateStats(iter);
+
+	return (m_fail_max_iters ? converged : true);
+}
+
+//-----------------------------------------------------------------------------
+void NativePCGSolver::Destroy()
+{
+	vector<double>().swap(m_r);
+	vector<double>().swap(m_z);
+	vector<double>().swap(m_p);
+	vector<double>().swap(m_q);
+}
@@ -41,10 +41,17 @@ SOFTWARE.*/
 #include "BlockSolver.h"
 #include "BiCGStabSolver.h"
 #include "StrategySolver.h"
+#include "NativeFGMRESSolver.h"
+#include "NativePCGSolver.h"
+#include "NativeILU0Preconditioner.h"
+#include "NativeIC0Preconditioner.h"
+#include "NativeAMGPreconditioner.h"
+#include "NativeBlockSchurPreconditioner.h"
 #include <FECore/fecore_enum.h>
 #include <FECore/FECoreFactory.h>
 #include <FECore/FECoreKernel.h>
 #include "FEASTEigenSolver.h"
+#include "LOBPCGEigenSolver.h"
 
 //=============================================================================
 // Call this to initialize the NumCore module
@@ -64,14 +71,21 @@ void NumCore::InitModule()
 	REGISTER_FECORE_CLASS(BIPNSolver          , "bipn");
 	REGISTER_FECORE_CLASS(BiCGStabSolver      , "bicgstab");
 	REGISTER_FECORE_CLASS(StrategySolver      , "strategy");
+	REGISTER_FECORE_CLASS(NativeFGMRESSolver  , "native_fgmres");
+	REGISTER_FECORE_CLASS(NativePCGSolver     , "native_cg");
 
 	// register preconditioners
 	REGISTER_FECORE_CLASS(ILU0_Preconditioner, "ilu0");
 	REGISTER_FECORE_CLASS(ILUT_Preconditioner, "ilut");
 	REGISTER_FECORE_CLASS(IncompleteCholesky , "ichol");
+	REGISTER_FECORE_CLASS(NativeILU0Preconditioner, "native_ilu0");
+	REGISTER_FECORE_CLASS(NativeIC0Preconditioner , "native_ic0");
+	REGISTER_FECORE_CLASS(NativeAMGPreconditioner , "native_amg");
+	REGISTER_FECORE_CLASS(NativeBlockSchurPreconditioner, "native_block_schur");
 
 	// register eigen solvers
-	REGISTER_FECORE_CLASS(FEASTEigenSolver, "feast");
+	REGISTER_FECORE_CLASS(FEASTEigenSolver , "feast");
+	REGISTER_FECORE_CLASS(LOBPCGEigenSolver, "lobpcg");
 
 	// set default linear solver
 	// (Set this before the configuration is read in because
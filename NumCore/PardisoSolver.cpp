@@ -261,6 +261,36 @@ bool PardisoSolver::BackSolve(double* x, double* b)
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+bool PardisoSolver::BackSolveMulti(double* x, double* b, int nrhs, int ldb)
+{
+	// make sure we have work to do
+	if ((m_pA->Rows() == 0) || (nrhs == 0)) return true;
+
+	// pardiso requires the right-hand sides to be stored contiguously
+	if (ldb != m_n) return LinearSolver::BackSolveMulti(x, b, nrhs, ldb);
+
+	int phase = 33;
+
+	m_iparm[7] = 1;	/* Maximum number of iterative refinement steps */
+
+	int error = 0;
+	pardiso(m_pt, &m_maxfct, &m_mnum, &m_mtype, &phase, &m_n, m_pA->Values(), m_pA->Pointers(), m_pA->Indices(),
+		 NULL, &nrhs, m_iparm, &m_msglvl, b, x, &error);
+
+	if (error)
+	{
+		fprintf(stderr, "\nERROR during solution: ");
+		print_err(error);
+		exit(3);
+	}
+
+	// update stats
+	for (int i = 0; i < nrhs; ++i) UpdateStats(1);
+
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 // This algorithm (naively) estimates the condition number. It is based on the observation that
 // for a linear system of equations A.x = b, the following holds
@@ -330,6 +360,7 @@ PardisoSolver::~PardisoSolver() {}
 bool PardisoSolver::PreProcess() { return false; }
 bool PardisoSolver::Factor() { return false; }
 bool PardisoSolver::BackSolve(double* x, double* y) { return false; }
+bool PardisoSolver::BackSolveMulti(double* x, double* y, int nrhs, int ldy) { return false; }
 void PardisoSolver::Destroy() {}
 SparseMatrix* PardisoSolver::CreateSparseMatrix(Matrix_Type ntype) { return nullptr; }
 bool PardisoSolver::SetSparseMatrix(SparseMatrix* pA) { return false; }
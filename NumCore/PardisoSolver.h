@@ -44,6 +44,7 @@ public:
 	bool PreProcess() override;
 	bool Factor() override;
 	bool BackSolve(double* x, double* y) override;
+	bool BackSolveMulti(double* x, double* y, int nrhs, int ldy) override;
 	void Destroy() override;
 
 	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
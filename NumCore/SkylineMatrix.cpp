@@ -204,3 +204,33 @@ double SkylineMatrix::diag(int i)
 {
 	return m_pd[ m_ppointers[i] ];
 }
+
+//-----------------------------------------------------------------------------
+//! Multiply with a vector. Column j stores the entries of rows j-l+1 to j, where
+//! l is the height of the column.
+bool SkylineMatrix::mult_vector(double* x, double* r)
+{
+	const int N = m_nrow;
+	for (int i = 0; i < N; ++i) r[i] = 0.0;
+
+	for (int j = 0; j < N; ++j)
+	{
+		const int pj = m_ppointers[j];
+		const int mj = j + 1 - m_ppointers[j + 1] + pj;
+		const double xj = x[j];
+
+		// diagonal
+		double rj = m_pd[pj] * xj;
+
+		// off-diagonal entries of column j and row j
+		for (int i = mj; i < j; ++i)
+		{
+			const double aij = m_pd[pj + j - i];
+			r[i] += aij*xj;
+			rj += aij*x[i];
+		}
+		r[j] += rj;
+	}
+
+	return true;
+}
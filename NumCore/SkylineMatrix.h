@@ -65,6 +65,9 @@ public: // from SparseMatrix
 
 	double diag(int i) override;
 
+	//! multiply with vector
+	bool mult_vector(double* x, double* r) override;
+
 	double* values() { return m_pd; }
 	int* pointers() { return m_ppointers; }
 
@@ -28,21 +28,48 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "SkylineSolver.h"
+#include <FECore/log.h>
+#include <FECore/sys.h>
+#include <math.h>
+#include <float.h>
 
 //-----------------------------------------------------------------------------
 void colsol_factor(int N, double* values, int* pointers);
 void colsol_solve(int N, double* values, int* pointers, double* R);
+void colsol_factor(int N, float* values, int* pointers);
+void colsol_solve(int N, float* values, int* pointers, double* R);
+void colsol_solve(int N, double* values, int* pointers, double* R, int nrhs);
+void colsol_solve(int N, float* values, int* pointers, double* R, int nrhs);
 
 //-----------------------------------------------------------------------------
-SkylineSolver::SkylineSolver(FEModel* fem) : LinearSolver(fem), m_pA(0)
+BEGIN_FECORE_CLASS(SkylineSolver, LinearSolver)
+	ADD_PARAMETER(m_bmixed   , "mixed_precision");
+	ADD_PARAMETER(m_refineTol, "refine_tol");
+	ADD_PARAMETER(m_maxRefine, "max_refine");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+SkylineSolver::SkylineSolver(FEModel* fem) : LinearSolver(fem), m_pK(0), m_pA(0), m_pC(0)
 {
+	m_bmixed = false;
+	m_refineTol = 1e-10;
+	m_maxRefine = 10;
+	m_bfactorf = false;
 }
 
 //-----------------------------------------------------------------------------
 //! Create a sparse matrix
+//! In mixed precision mode, the matrix is assembled in compact form. A double precision
+//! skyline matrix is then never allocated (unless the single precision factorization fails).
 SparseMatrix* SkylineSolver::CreateSparseMatrix(Matrix_Type ntype)
 { 
-	return (m_pA = (ntype == REAL_SYMMETRIC? new SkylineMatrix() : 0)); 
+	m_pA = 0;
+	m_pC = 0;
+	if (ntype != REAL_SYMMETRIC) return (m_pK = 0);
+
+	if (m_bmixed) m_pK = m_pC = new CompactSymmMatrix(0);
+	else m_pK = m_pA = new SkylineMatrix();
+	return m_pK;
 }
 
 //-----------------------------------------------------------------------------
@@ -52,10 +79,98 @@ bool SkylineSolver::PreProcess()
 	return LinearSolver::PreProcess();
 }
 
+//-----------------------------------------------------------------------------
+//! Determine the skyline of the compact (lower triangular, column major) matrix.
+//! Entry (r,c) of the lower triangle is entry (c,r) of the upper triangle, so the
+//! height of skyline column r is set by the first column c that has an entry in row r.
+void SkylineSolver::BuildProfile()
+{
+	const int N = m_pC->Rows();
+	const int* pp = m_pC->Pointers();
+	const int* pi = m_pC->Indices();
+	const int offset = m_pC->Offset();
+
+	m_ptr.resize(N + 1);
+	for (int j = 0; j < N; ++j) m_ptr[j + 1] = j;
+	for (int c = 0; c < N; ++c)
+	{
+		for (int k = pp[c] - offset; k < pp[c + 1] - offset; ++k)
+		{
+			int r = pi[k] - offset;
+			if (c < m_ptr[r + 1]) m_ptr[r + 1] = c;
+		}
+	}
+
+	// convert the first rows into pointers
+	m_ptr[0] = 0;
+	for (int j = 0; j < N; ++j) m_ptr[j + 1] = m_ptr[j] + (j - m_ptr[j + 1] + 1);
+}
+
+//-----------------------------------------------------------------------------
+template <typename T> void SkylineSolver::CopyToProfile(vector<T>& v)
+{
+	const int N = m_pC->Rows();
+	const int* pp = m_pC->Pointers();
+	const int* pi = m_pC->Indices();
+	const double* pv = m_pC->Values();
+	const int offset = m_pC->Offset();
+
+	v.assign(m_ptr[N], (T)0);
+	for (int c = 0; c < N; ++c)
+	{
+		for (int k = pp[c] - offset; k < pp[c + 1] - offset; ++k)
+		{
+			int r = pi[k] - offset;
+			double a = pv[k];
+
+			// values that are too small for single precision are flushed to zero, since
+			// denormals would slow down the factorization considerably
+			if ((sizeof(T) == sizeof(float)) && (fabs(a) < FLT_MIN)) a = 0.0;
+			v[m_ptr[r] + r - c] = (T)a;
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 bool SkylineSolver::Factor()
 {
-	colsol_factor(m_pA->Rows(), m_pA->values(), m_pA->pointers());
+	m_bfactorf = false;
+	if (m_pC == 0) return FactorDouble();
+
+	// In mixed precision mode, the compact matrix is copied to a single precision skyline,
+	// so that the double precision matrix remains available for iterative refinement.
+	const int N = m_pC->Rows();
+	BuildProfile();
+	vector<double>().swap(m_LDd);
+	CopyToProfile(m_LDf);
+
+	colsol_factor(N, &m_LDf[0], &m_ptr[0]);
+
+	// make sure the factorization didn't break down
+	for (int i = 0; i < N; ++i)
+	{
+		float dii = m_LDf[m_ptr[i]];
+		if ((dii == 0.f) || ISNAN(dii) || (fabs(dii) > 1e38))
+		{
+			feLogWarning("Single precision factorization failed. Switching to double precision.");
+			return FactorDouble();
+		}
+	}
+
+	m_r.resize(N);
+	m_dx.resize(N);
+	m_bfactorf = true;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SkylineSolver::FactorDouble()
+{
+	vector<float>().swap(m_LDf);
+	m_bfactorf = false;
+	if (m_pC) CopyToProfile(m_LDd);
+	colsol_factor(m_pK->Rows(), DoubleFactor(), Pointers());
 	return true;
 }
 
@@ -64,16 +179,128 @@ bool SkylineSolver::BackSolve(double* x, double* b)
 {
 	// we need to make a copy of R since colsol overwrites the right hand side vector
 	// with the solution
-	int neq = m_pA->Rows();
+	int neq = m_pK->Rows();
 	for (int i=0; i<neq; ++i) x[i] = b[i];
-	colsol_solve(m_pA->Rows(), m_pA->values(), m_pA->pointers(), x);
+
+	if (m_bfactorf == false)
+	{
+		colsol_solve(neq, DoubleFactor(), Pointers(), x);
+		return true;
+	}
+
+	// solve with the single precision factorization, followed by iterative refinement 
+	// with the residual evaluated in double precision.
+	colsol_solve(neq, &m_LDf[0], Pointers(), x);
+	if (Refine(x, b)) return true;
+
+	// The iterative refinement did not converge, so we fall back to a double precision
+	// factorization. This factorization is used until the next call to Factor.
+	feLogWarning("Iterative refinement stalled. Switching to double precision factorization.");
+	FactorDouble();
+	for (int i = 0; i<neq; ++i) x[i] = b[i];
+	colsol_solve(neq, DoubleFactor(), Pointers(), x);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SkylineSolver::BackSolveMulti(double* x, double* b, int nrhs, int ldb)
+{
+	int neq = m_pK->Rows();
+	if (nrhs == 1) return BackSolve(x, b);
+
+	// The right-hand sides are processed in blocks. Within a block they are stored
+	// interleaved so that each entry of the factorization is applied to all of them at once.
+	const int NB = 16;
+	int nb = (nrhs < NB ? nrhs : NB);
+	m_X.resize((size_t)neq*nb);
+	for (int k0 = 0; k0 < nrhs; k0 += nb)
+	{
+		int m = (nrhs - k0 < nb ? nrhs - k0 : nb);
+		for (int k = 0; k < m; ++k)
+		{
+			const double* bk = b + (size_t)(k0 + k)*ldb;
+			for (int i = 0; i < neq; ++i) m_X[(size_t)i*m + k] = bk[i];
+		}
+
+		if (m_bfactorf) colsol_solve(neq, &m_LDf[0], Pointers(), &m_X[0], m);
+		else colsol_solve(neq, DoubleFactor(), Pointers(), &m_X[0], m);
+
+		for (int k = 0; k < m; ++k)
+		{
+			double* xk = x + (size_t)(k0 + k)*ldb;
+			for (int i = 0; i < neq; ++i) xk[i] = m_X[(size_t)i*m + k];
+		}
+	}
+
+	if (m_bfactorf)
+	{
+		// the iterative refinement is done one right-hand side at a time
+		for (int k = 0; k < nrhs; ++k)
+		{
+			size_t offset = (size_t)k*ldb;
+			if (Refine(x + offset, b + offset) == false)
+			{
+				feLogWarning("Iterative refinement stalled. Switching to double precision factorization.");
+				FactorDouble();
+				return BackSolveMulti(x, b, nrhs, ldb);
+			}
+		}
+	}
 
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+bool SkylineSolver::Refine(double* x, double* b)
+{
+	int neq = m_pK->Rows();
+	double normb = 0.0;
+	for (int i = 0; i < neq; ++i) normb += b[i] * b[i];
+	normb = sqrt(normb);
+	if (normb == 0.0) return true;
+
+	double normr_prev = 0.0;
+	for (int n = 0; n <= m_maxRefine; ++n)
+	{
+		// calculate the residual r = b - A*x
+		m_pK->mult_vector(x, &m_r[0]);
+		double normr = 0.0;
+		for (int i = 0; i < neq; ++i)
+		{
+			m_r[i] = b[i] - m_r[i];
+			normr += m_r[i] * m_r[i];
+		}
+		normr = sqrt(normr);
+		if (ISNAN(normr)) break;
+
+		// check for convergence
+		if (normr <= m_refineTol*normb) return true;
+
+		// check for stagnation
+		if ((n > 0) && (normr > 0.5*normr_prev)) break;
+		normr_prev = normr;
+
+		if (n == m_maxRefine) break;
+
+		// correct the solution
+		for (int i = 0; i < neq; ++i) m_dx[i] = m_r[i];
+		colsol_solve(neq, &m_LDf[0], Pointers(), &m_dx[0]);
+		for (int i = 0; i < neq; ++i) x[i] += m_dx[i];
+	}
+
+	return false;
+}
+
 //-----------------------------------------------------------------------------
 void SkylineSolver::Destroy()
 {
-	// Nothing to destroy
+	vector<float>().swap(m_LDf);
+	vector<double>().swap(m_LDd);
+	vector<int>().swap(m_ptr);
+	vector<double>().swap(m_r);
+	vector<double>().swap(m_dx);
+	vector<double>().swap(m_X);
+	m_bfactorf = false;
 	LinearSolver::Destroy();
 }
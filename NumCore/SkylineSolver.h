@@ -30,6 +30,7 @@ SOFTWARE.*/
 
 #include <FECore/LinearSolver.h>
 #include "SkylineMatrix.h"
+#include "CompactSymmMatrix.h"
 
 //-----------------------------------------------------------------------------
 //! Implements a linear solver that uses a skyline format
@@ -49,6 +50,9 @@ public:
 	//! Backsolve the linear system
 	bool BackSolve(double* x, double* b) override;
 
+	//! Backsolve the linear system for multiple right-hand sides
+	bool BackSolveMulti(double* x, double* b, int nrhs, int ldb) override;
+
 	//! Clean up
 	void Destroy() override;
 
@@ -56,5 +60,41 @@ public:
 	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
 
 private:
-	SkylineMatrix*	m_pA;
+	// factor the matrix in double precision (overwrites the skyline matrix)
+	bool FactorDouble();
+
+	// build the skyline profile of the compact matrix (mixed precision mode only)
+	void BuildProfile();
+
+	// copy the compact matrix into skyline storage (mixed precision mode only)
+	template <typename T> void CopyToProfile(vector<T>& v);
+
+	// iterative refinement of a solution obtained with the single precision factorization
+	// (returns false if the refinement did not converge)
+	bool Refine(double* x, double* b);
+
+	// skyline pointers and double precision factorization
+	int* Pointers() { return (m_pA ? m_pA->pointers() : &m_ptr[0]); }
+	double* DoubleFactor() { return (m_pA ? m_pA->values() : &m_LDd[0]); }
+
+private:
+	SparseMatrix*		m_pK;		//!< the assembled matrix
+	SkylineMatrix*		m_pA;		//!< the assembled matrix, if it is a skyline matrix
+	CompactSymmMatrix*	m_pC;		//!< the assembled matrix, if it is compact (mixed precision mode)
+
+	bool			m_bmixed;		//!< factor in single precision and use iterative refinement
+	double			m_refineTol;	//!< relative residual tolerance of iterative refinement
+	int				m_maxRefine;	//!< max nr of refinement iterations
+
+	// In mixed precision mode the matrix is assembled in compact form, which is used
+	// to evaluate the residuals of the iterative refinement. Only the factorization
+	// is stored in skyline format.
+	vector<int>		m_ptr;			//!< skyline pointers of the factorization
+	vector<float>	m_LDf;			//!< single precision factorization
+	vector<double>	m_LDd;			//!< double precision factorization (if single precision failed)
+	bool			m_bfactorf;		//!< the single precision factorization is used
+	vector<double>	m_r, m_dx;		//!< work vectors for iterative refinement
+	vector<double>	m_X;			//!< interleaved right-hand sides for multi-RHS backsolves
+
+	DECLARE_FECORE_CLASS();
 };